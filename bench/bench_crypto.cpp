@@ -0,0 +1,148 @@
+/**
+ * @file bench_crypto.cpp
+ * @brief Hashing, merkle root and ECDSA benchmarks
+ */
+
+#include "bench_util.h"
+#include "blockchain/merkle.h"
+#include "crypto/ecdsa.h"
+#include "crypto/hash.h"
+#include <benchmark/benchmark.h>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+void BM_SHA256(benchmark::State& state) {
+    FastRandom rng;
+    bytes data = rng.Bytes(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::Hash::SHA256(data));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(crypto::Hash::SHA256Implementation());
+}
+BENCHMARK(BM_SHA256)->Arg(32)->Arg(80)->Arg(1024)->Arg(1 << 20);
+
+void BM_DoubleSHA256(benchmark::State& state) {
+    FastRandom rng;
+    bytes data = rng.Bytes(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::Hash::DoubleSHA256(data));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DoubleSHA256)->Arg(64)->Arg(88)->Arg(1024);
+
+void BM_DoubleSHA256_64(benchmark::State& state) {
+    FastRandom rng;
+    size_t count = static_cast<size_t>(state.range(0));
+    bytes input = rng.Bytes(64 * count);
+    bytes output(32 * count);
+
+    for (auto _ : state) {
+        crypto::Hash::DoubleSHA256_64(output.data(), input.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(crypto::Hash::DoubleSHA256_64Implementation());
+}
+BENCHMARK(BM_DoubleSHA256_64)->Arg(1)->Arg(8)->Arg(1024);
+
+void BM_RIPEMD160(benchmark::State& state) {
+    FastRandom rng;
+    bytes data = rng.Bytes(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::Hash::RIPEMD160(data));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RIPEMD160)->Arg(32)->Arg(1024);
+
+void BM_Hash160(benchmark::State& state) {
+    FastRandom rng;
+    bytes pubKey = rng.Bytes(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::Hash::ComputeHash160(pubKey));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Hash160)->Arg(33)->Arg(65);
+
+void BM_Hash160Many(benchmark::State& state) {
+    FastRandom rng;
+    std::vector<bytes> pubKeys(static_cast<size_t>(state.range(0)));
+    for (bytes& pubKey : pubKeys) {
+        pubKey = rng.Bytes(33);
+    }
+    std::vector<Hash160> hashes(pubKeys.size());
+
+    for (auto _ : state) {
+        crypto::Hash::ComputeHash160Many(hashes.data(), pubKeys.data(), pubKeys.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(crypto::Hash::DoubleSHA256_64Implementation());
+}
+BENCHMARK(BM_Hash160Many)->Arg(1024);
+
+void BM_DoubleSHA256Many(benchmark::State& state) {
+    FastRandom rng;
+    std::vector<bytes> messages(static_cast<size_t>(state.range(0)));
+    for (bytes& message : messages) {
+        message = rng.Bytes(32);
+    }
+    std::vector<Hash256> hashes(messages.size());
+
+    for (auto _ : state) {
+        crypto::Hash::DoubleSHA256Many(hashes.data(), messages.data(), messages.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(crypto::Hash::DoubleSHA256_64Implementation());
+}
+BENCHMARK(BM_DoubleSHA256Many)->Arg(1024);
+
+void BM_MerkleRoot(benchmark::State& state) {
+    FastRandom rng;
+    std::vector<Hash256> leaves(static_cast<size_t>(state.range(0)));
+    for (auto& leaf : leaves) {
+        leaf = rng.NextHash();
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ComputeMerkleRoot(leaves));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MerkleRoot)->Arg(16)->Arg(1000)->Arg(10000);
+
+void BM_ECDSASign(benchmark::State& state) {
+    crypto::KeyPair key(crypto::Hash::SHA256(std::string("sign")));
+    FastRandom rng;
+    Hash256 message = rng.NextHash();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::ECDSA::Sign(message, key.privateKey));
+    }
+}
+BENCHMARK(BM_ECDSASign);
+
+void BM_ECDSAVerify(benchmark::State& state) {
+    crypto::KeyPair key(crypto::Hash::SHA256(std::string("verify")));
+    FastRandom rng;
+    Hash256 message = rng.NextHash();
+    bytes signature = crypto::ECDSA::Sign(message, key.privateKey);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crypto::ECDSA::Verify(message, signature, key.publicKey));
+    }
+}
+BENCHMARK(BM_ECDSAVerify);
+
+} // namespace
@@ -0,0 +1,151 @@
+/**
+ * @file bench_ibd.cpp
+ * @brief Initial block download replay benchmarks
+ *
+ * Replays generated chains through Blockchain::AcceptBlock onto a fresh
+ * in-memory chain. Funding and setup blocks are connected untimed; only
+ * the workload blocks are measured.
+ *
+ * Set DINARI_BENCH_CHAINDIR to a directory written by dinari-chaingen to
+ * also replay that chain (all blocks timed) as BM_IBDReplayStored.
+ */
+
+#include "chaingen.h"
+#include "blockchain/blockchain.h"
+#include "consensus/difficulty.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+// Process peak resident set size, in MiB
+double PeakRSSMiB() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;  // ru_maxrss is in KiB
+#endif
+}
+
+void Replay(benchmark::State& state, const GeneratedChain& chain, size_t timedFrom) {
+    size_t txs = 0;
+    size_t inputs = 0;
+    for (size_t i = timedFrom; i < chain.blocks.size(); ++i) {
+        const auto& transactions = chain.blocks[i].transactions;
+        for (size_t t = 1; t < transactions.size(); ++t) {
+            txs++;
+            inputs += transactions[t]->inputs.size();
+        }
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto blockchain = std::make_unique<Blockchain>();
+        bool ok = blockchain->Initialize(chain.genesis);
+        for (size_t i = 0; ok && i < timedFrom; ++i) {
+            ok = blockchain->AcceptBlock(chain.blocks[i]);
+        }
+        if (!ok) {
+            state.SkipWithError("setup block rejected");
+            break;
+        }
+        state.ResumeTiming();
+
+        for (size_t i = timedFrom; i < chain.blocks.size(); ++i) {
+            if (!blockchain->AcceptBlock(chain.blocks[i])) {
+                ok = false;
+                break;
+            }
+        }
+
+        state.PauseTiming();
+        blockchain.reset();
+        state.ResumeTiming();
+
+        if (!ok) {
+            state.SkipWithError("block rejected");
+            break;
+        }
+    }
+
+    auto rate = [](size_t count) {
+        return benchmark::Counter(static_cast<double>(count),
+                                  benchmark::Counter::kIsIterationInvariantRate);
+    };
+    state.counters["blocks/s"] = rate(chain.blocks.size() - timedFrom);
+    state.counters["tx/s"] = rate(txs);
+    state.counters["inputs/s"] = rate(inputs);
+    state.counters["peak_rss_MiB"] = PeakRSSMiB();
+}
+
+/**
+ * @brief Replay a generated chain
+ *
+ * Args: workload blocks, transactions per block, fan-in, fan-out,
+ * multisig output percentage, UTXO set size before the workload.
+ */
+void BM_IBDReplay(benchmark::State& state) {
+    static std::map<std::vector<int64_t>, GeneratedChain> chains;
+
+    std::vector<int64_t> key;
+    for (size_t i = 0; i < 6; ++i) {
+        key.push_back(state.range(i));
+    }
+
+    auto it = chains.find(key);
+    if (it == chains.end()) {
+        ChainGenParams params;
+        params.blocks = static_cast<size_t>(key[0]);
+        params.txsPerBlock = static_cast<size_t>(key[1]);
+        params.inputsPerTx = static_cast<size_t>(key[2]);
+        params.outputsPerTx = static_cast<size_t>(key[3]);
+        params.multisigPercent = static_cast<unsigned>(key[4]);
+        params.utxoSetSize = static_cast<size_t>(key[5]);
+        it = chains.emplace(key, ChainGenerator::Generate(params)).first;
+    }
+
+    Replay(state, it->second, it->second.workloadStart);
+}
+BENCHMARK(BM_IBDReplay)
+    ->ArgNames({"blocks", "txs", "in", "out", "msig", "utxos"})
+    ->Args({20, 100, 1, 2, 0, 0})
+    ->Args({20, 100, 2, 2, 10, 0})
+    ->Args({20, 100, 4, 1, 0, 0})
+    ->Args({20, 100, 1, 2, 0, 100000})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_IBDReplayStored(benchmark::State& state, const std::string& dataDir) {
+    static GeneratedChain chain;
+    static bool loaded = ChainGenerator::ReadFromBlockStore(dataDir, chain);
+    if (!loaded) {
+        state.SkipWithError("failed to read chain");
+        return;
+    }
+
+    DifficultyAdjuster::SetMinimumDifficultyMode(true);
+    Replay(state, chain, 0);
+}
+
+bool RegisterStoredReplay() {
+    const char* dataDir = std::getenv("DINARI_BENCH_CHAINDIR");
+    if (dataDir && *dataDir) {
+        benchmark::RegisterBenchmark("BM_IBDReplayStored", BM_IBDReplayStored, std::string(dataDir))
+            ->Unit(benchmark::kMillisecond);
+    }
+    return true;
+}
+const bool storedReplayRegistered = RegisterStoredReplay();
+
+} // namespace
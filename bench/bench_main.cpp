@@ -0,0 +1,24 @@
+/**
+ * @file bench_main.cpp
+ * @brief Benchmark runner
+ *
+ * Standard Google Benchmark flags apply; for machine-readable results use
+ * --benchmark_format=json or --benchmark_out=<file> --benchmark_out_format=json.
+ */
+
+#include "util/logger.h"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv) {
+    // Keep per-block and per-transaction logging out of the measurements
+    dinari::Logger::Instance().SetConsoleOutput(false);
+    dinari::Logger::Instance().SetLevel(dinari::LogLevel::ERROR);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
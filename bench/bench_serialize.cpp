@@ -0,0 +1,60 @@
+/**
+ * @file bench_serialize.cpp
+ * @brief Transaction and block (de)serialization benchmarks
+ */
+
+#include "bench_util.h"
+#include "util/serialize.h"
+#include <benchmark/benchmark.h>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+void BM_SerializeTransaction(benchmark::State& state) {
+    FastRandom rng;
+    Transaction tx = MakeRandomTransaction(rng, 2, 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Serialize(tx));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(tx.GetSize()));
+}
+BENCHMARK(BM_SerializeTransaction);
+
+void BM_DeserializeTransaction(benchmark::State& state) {
+    FastRandom rng;
+    bytes data = Serialize(MakeRandomTransaction(rng, 2, 2));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Deserialize<Transaction>(data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_DeserializeTransaction);
+
+void BM_SerializeBlock(benchmark::State& state) {
+    FastRandom rng;
+    Block block = MakeRandomBlock(rng, static_cast<size_t>(state.range(0)));
+    size_t size = block.GetSerializedSize();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Serialize(block));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_SerializeBlock)->Arg(100)->Arg(2000);
+
+void BM_DeserializeBlock(benchmark::State& state) {
+    FastRandom rng;
+    bytes data = Serialize(MakeRandomBlock(rng, static_cast<size_t>(state.range(0))));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Deserialize<Block>(data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_DeserializeBlock)->Arg(100)->Arg(2000);
+
+} // namespace
@@ -0,0 +1,70 @@
+#include "bench_util.h"
+#include "consensus/difficulty.h"
+#include "core/script.h"
+#include "crypto/hash.h"
+#include "util/time.h"
+#include <algorithm>
+
+namespace dinari {
+namespace bench {
+
+bytes FastRandom::Bytes(size_t count) {
+    bytes result(count);
+    for (size_t i = 0; i < count; i += 8) {
+        uint64_t value = engine();
+        size_t chunk = std::min<size_t>(8, count - i);
+        for (size_t j = 0; j < chunk; ++j) {
+            result[i + j] = static_cast<byte>(value >> (8 * j));
+        }
+    }
+    return result;
+}
+
+Hash256 FastRandom::NextHash() {
+    Hash256 hash;
+    bytes data = Bytes(hash.size());
+    std::copy(data.begin(), data.end(), hash.begin());
+    return hash;
+}
+
+bytes P2PKHScript(const crypto::KeyPair& key) {
+    return Script::CreateP2PKH(key.GetHash160()).GetCode();
+}
+
+Transaction MakeRandomTransaction(FastRandom& rng, size_t inputs, size_t outputs) {
+    TransactionBuilder builder;
+
+    for (size_t i = 0; i < inputs; ++i) {
+        // 72-byte signature and 33-byte pubkey pushes
+        builder.AddInput(rng.NextHash(), static_cast<TxOutIndex>(rng.Next() % 4),
+                         rng.Bytes(107));
+    }
+
+    for (size_t i = 0; i < outputs; ++i) {
+        Hash160 dest;
+        bytes data = rng.Bytes(dest.size());
+        std::copy(data.begin(), data.end(), dest.begin());
+        builder.AddOutput(static_cast<Amount>(1000 + rng.Next() % 100000000),
+                          Script::CreateP2PKH(dest).GetCode());
+    }
+
+    return builder.Build();
+}
+
+Block MakeRandomBlock(FastRandom& rng, size_t txCount) {
+    BlockBuilder builder;
+    builder.SetPrevBlockHash(rng.NextHash())
+           .SetTimestamp(Time::GetCurrentTime())
+           .SetBits(DifficultyAdjuster::GetMinimumDifficulty())
+           .SetCoinbase(MakeTransactionRef(
+               CreateCoinbaseTransaction(1, "", 0, GetBlockReward(1))));
+
+    for (size_t i = 0; i < txCount; ++i) {
+        builder.AddTransaction(MakeTransactionRef(MakeRandomTransaction(rng, 2, 2)));
+    }
+
+    return builder.Build();
+}
+
+} // namespace bench
+} // namespace dinari
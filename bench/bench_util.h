@@ -0,0 +1,54 @@
+/**
+ * @file bench_util.h
+ * @brief Shared fixtures for the benchmark suite
+ */
+
+#ifndef DINARI_BENCH_BENCH_UTIL_H
+#define DINARI_BENCH_BENCH_UTIL_H
+
+#include "blockchain/block.h"
+#include "core/transaction.h"
+#include "crypto/ecdsa.h"
+#include <random>
+#include <vector>
+
+namespace dinari {
+namespace bench {
+
+/**
+ * @brief Deterministic random source so runs are comparable
+ */
+class FastRandom {
+public:
+    explicit FastRandom(uint64_t seed = 0x44696e617269ULL) : engine(seed) {}
+
+    uint64_t Next() { return engine(); }
+    bytes Bytes(size_t count);
+    Hash256 NextHash();
+
+private:
+    std::mt19937_64 engine;
+};
+
+/**
+ * @brief P2PKH scriptPubKey paying to a key
+ */
+bytes P2PKHScript(const crypto::KeyPair& key);
+
+/**
+ * @brief Unsigned transaction with random prevouts and P2PKH outputs
+ *
+ * Inputs carry a dummy scriptSig of signature-plus-pubkey size, so the
+ * serialized size matches a real P2PKH spend.
+ */
+Transaction MakeRandomTransaction(FastRandom& rng, size_t inputs, size_t outputs);
+
+/**
+ * @brief Block of random transactions behind a coinbase
+ */
+Block MakeRandomBlock(FastRandom& rng, size_t txCount);
+
+} // namespace bench
+} // namespace dinari
+
+#endif // DINARI_BENCH_BENCH_UTIL_H
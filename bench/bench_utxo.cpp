@@ -0,0 +1,186 @@
+/**
+ * @file bench_utxo.cpp
+ * @brief UTXO set and mempool benchmarks
+ */
+
+#include "bench_util.h"
+#include "core/mempool.h"
+#include "core/script.h"
+#include "core/utxo.h"
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+/**
+ * @brief UTXO set of a given size, built once and shared between runs
+ *
+ * Only the most recently requested size is kept, so a 10M run does not
+ * hold the 1M set in memory as well.
+ */
+struct PopulatedUTXOSet {
+    std::unique_ptr<UTXOSet> set;
+    std::vector<OutPoint> outpoints;
+
+    static PopulatedUTXOSet& Get(size_t size) {
+        static std::map<size_t, PopulatedUTXOSet> cache;
+
+        auto it = cache.find(size);
+        if (it == cache.end()) {
+            cache.clear();
+            it = cache.emplace(size, Build(size)).first;
+        }
+        return it->second;
+    }
+
+private:
+    static PopulatedUTXOSet Build(size_t size) {
+        FastRandom rng(size);
+        PopulatedUTXOSet result;
+        result.set = std::make_unique<UTXOSet>();
+        result.outpoints.reserve(size);
+
+        for (size_t i = 0; i < size; ++i) {
+            OutPoint outpoint(rng.NextHash(), static_cast<TxOutIndex>(i % 4));
+            Hash160 dest{};
+            dest[0] = static_cast<byte>(i);
+            result.set->AddUTXO(outpoint, TxOut(50000, Script::CreateP2PKH(dest).GetCode()),
+                                static_cast<BlockHeight>(i / 1000), false);
+            result.outpoints.push_back(outpoint);
+        }
+        return result;
+    }
+};
+
+void BM_UTXOAdd(benchmark::State& state) {
+    PopulatedUTXOSet& populated = PopulatedUTXOSet::Get(static_cast<size_t>(state.range(0)));
+    FastRandom rng(1);
+    TxOut output(50000, Script::CreateP2PKH(Hash160{}).GetCode());
+
+    std::vector<OutPoint> added;
+    for (auto _ : state) {
+        OutPoint outpoint(rng.NextHash(), 0);
+        populated.set->AddUTXO(outpoint, output, 1, false);
+        added.push_back(outpoint);
+    }
+
+    // Leave the shared set at its original size
+    for (const auto& outpoint : added) {
+        populated.set->RemoveUTXO(outpoint);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UTXOAdd)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kNanosecond);
+
+void BM_UTXOLookup(benchmark::State& state) {
+    PopulatedUTXOSet& populated = PopulatedUTXOSet::Get(static_cast<size_t>(state.range(0)));
+    FastRandom rng(2);
+
+    for (auto _ : state) {
+        const OutPoint& outpoint = populated.outpoints[rng.Next() % populated.outpoints.size()];
+        benchmark::DoNotOptimize(populated.set->GetUTXOEntry(outpoint));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UTXOLookup)->Arg(1000000)->Arg(10000000);
+
+void BM_UTXOLookupMiss(benchmark::State& state) {
+    PopulatedUTXOSet& populated = PopulatedUTXOSet::Get(static_cast<size_t>(state.range(0)));
+    FastRandom rng(3);
+    OutPoint missing(rng.NextHash(), 7);
+
+    for (auto _ : state) {
+        missing.txHash[0]++;
+        benchmark::DoNotOptimize(populated.set->HasUTXO(missing));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UTXOLookupMiss)->Arg(1000000)->Arg(10000000);
+
+void BM_UTXORemove(benchmark::State& state) {
+    PopulatedUTXOSet& populated = PopulatedUTXOSet::Get(static_cast<size_t>(state.range(0)));
+    FastRandom rng(4);
+
+    for (auto _ : state) {
+        const OutPoint& outpoint = populated.outpoints[rng.Next() % populated.outpoints.size()];
+        UTXOEntry entry = *populated.set->GetUTXOEntry(outpoint);
+        populated.set->RemoveUTXO(outpoint);
+
+        state.PauseTiming();
+        populated.set->AddUTXO(outpoint, entry);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UTXORemove)->Arg(1000000)->Arg(10000000);
+
+/**
+ * @brief Signed one-in one-out transactions and the UTXO set they spend
+ */
+struct MempoolFixture {
+    UTXOSet utxos;
+    std::vector<TransactionRef> transactions;
+
+    explicit MempoolFixture(size_t count) {
+        crypto::KeyPair key(crypto::Hash::SHA256(std::string("mempool")));
+        bytes script = P2PKHScript(key);
+        FastRandom rng(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            OutPoint prevout(rng.NextHash(), 0);
+            Amount value = 10000000 + static_cast<Amount>(rng.Next() % 10000000);
+            utxos.AddUTXO(prevout, TxOut(value, script), 1, false);
+
+            // Varying fees so the template has something to sort. The
+            // mempool compares fee per byte against MIN_RELAY_TX_FEE, so
+            // every fee must clear MIN_RELAY_TX_FEE times the tx size.
+            Amount fee = 500000 + static_cast<Amount>(rng.Next() % 500000);
+            Transaction tx = TransactionBuilder()
+                .AddInput(prevout)
+                .AddOutput(value - fee, script)
+                .Build();
+            tx.inputs[0].scriptSig = SignTransactionInput(tx, 0, script, key.privateKey);
+            transactions.push_back(MakeTransactionRef(std::move(tx)));
+        }
+    }
+};
+
+void BM_MempoolAdd(benchmark::State& state) {
+    MempoolFixture fixture(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pool = std::make_unique<MemPool>();
+        state.ResumeTiming();
+
+        for (const auto& tx : fixture.transactions) {
+            pool->AddTransaction(tx, fixture.utxos, 200);
+        }
+
+        state.PauseTiming();
+        pool.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MempoolAdd)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+void BM_MempoolBlockTemplate(benchmark::State& state) {
+    MempoolFixture fixture(static_cast<size_t>(state.range(0)));
+    MemPool pool;
+    for (const auto& tx : fixture.transactions) {
+        pool.AddTransaction(tx, fixture.utxos, 200);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool.GetTransactionsForMining());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pool.Size()));
+}
+BENCHMARK(BM_MempoolBlockTemplate)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,36 @@
+/**
+ * @file bench_validation.cpp
+ * @brief Script verification benchmarks
+ */
+
+#include "bench_util.h"
+#include "core/script.h"
+#include <benchmark/benchmark.h>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+void BM_VerifyScriptP2PKH(benchmark::State& state) {
+    crypto::KeyPair key(crypto::Hash::SHA256(std::string("script")));
+    bytes script = P2PKHScript(key);
+    FastRandom rng;
+
+    Transaction tx = TransactionBuilder()
+        .AddInput(rng.NextHash(), 0)
+        .AddOutput(1000, script)
+        .Build();
+    tx.inputs[0].scriptSig = SignTransactionInput(tx, 0, script, key.privateKey);
+
+    for (auto _ : state) {
+        if (!VerifyScript(tx.inputs[0].scriptSig, script, tx, 0)) {
+            state.SkipWithError("script verification failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VerifyScriptP2PKH);
+
+} // namespace
@@ -0,0 +1,348 @@
+#include "chaingen.h"
+#include "bench_util.h"
+#include "consensus/difficulty.h"
+#include "core/script.h"
+#include "crypto/ecdsa.h"
+#include "crypto/hash.h"
+#include "storage/blockstore.h"
+#include "util/logger.h"
+#include <algorithm>
+#include <deque>
+
+namespace dinari {
+namespace bench {
+
+namespace {
+
+constexpr size_t KEY_COUNT = 16;
+constexpr size_t SETUP_FANOUT = 100;
+constexpr Amount TX_FEE = 1000;
+// Outputs are never made smaller than this so chains of splits stay spendable
+constexpr Amount MIN_OUTPUT_VALUE = 100 * DUST_THRESHOLD;
+// Headroom under the consensus limits for the coinbase and header
+constexpr size_t BLOCK_SIZE_BUDGET = MAX_BLOCK_SIZE - 4096;
+constexpr size_t BLOCK_SIGOPS_BUDGET = MAX_BLOCK_SIGOPS - 1000;
+
+struct Coin {
+    OutPoint outpoint;
+    Amount value;
+    size_t keyIndex;
+    BlockHeight spendableAt;
+};
+
+// Mirrors ConsensusValidator's sigop count, which scans raw script bytes
+size_t EstimateSigOps(const Transaction& tx) {
+    auto count = [](const bytes& script) {
+        size_t sigops = 0;
+        for (byte b : script) {
+            if (b == 0xac || b == 0xad) {
+                sigops++;
+            } else if (b == 0xae || b == 0xaf) {
+                sigops += 20;
+            }
+        }
+        return sigops;
+    };
+
+    size_t sigops = 0;
+    for (const auto& input : tx.inputs) {
+        sigops += count(input.scriptSig);
+    }
+    for (const auto& output : tx.outputs) {
+        sigops += count(output.scriptPubKey);
+    }
+    return sigops;
+}
+
+class Generator {
+public:
+    explicit Generator(const ChainGenParams& p)
+        : params(p), rng(p.seed), bits(DifficultyAdjuster::GetMinimumDifficulty()),
+          time(p.genesisTime) {
+        for (size_t i = 0; i < KEY_COUNT; ++i) {
+            keys.emplace_back(crypto::Hash::SHA256(
+                "dinari chaingen key " + std::to_string(p.seed) + "/" + std::to_string(i)));
+            scripts.push_back(P2PKHScript(keys.back()));
+        }
+        for (size_t i = 0; i + 2 < KEY_COUNT; i += 3) {
+            multisigScripts.push_back(Script::CreateMultisig(2, {
+                keys[i].publicKey, keys[i + 1].publicKey, keys[i + 2].publicKey}).GetCode());
+        }
+    }
+
+    GeneratedChain Run() {
+        chain.genesis = CreateGenesisBlock(time, bits, 0, "Dinari synthetic chain");
+        MineHeader(chain.genesis.header);
+        prevHash = chain.genesis.GetHash();
+
+        // Funding: enough coinbase-only blocks for the first to mature
+        for (size_t i = 0; i <= COINBASE_MATURITY; ++i) {
+            AddBlock([](std::vector<TransactionRef>&, BlockHeight) {});
+        }
+
+        // Setup: split coins until the target UTXO set size is reached
+        while (spendable.size() + immature.size() < params.utxoSetSize) {
+            size_t before = spendable.size() + immature.size();
+            AddBlock([this](std::vector<TransactionRef>& txs, BlockHeight height) {
+                FillBlock(txs, height, 1, SETUP_FANOUT, 0,
+                          params.utxoSetSize - (spendable.size() + immature.size()));
+            });
+            if (spendable.size() + immature.size() <= before) {
+                LOG_WARNING("ChainGen", "UTXO set stopped growing at " + std::to_string(before));
+                break;
+            }
+        }
+
+        chain.workloadStart = chain.blocks.size();
+        for (size_t i = 0; i < params.blocks; ++i) {
+            AddBlock([this](std::vector<TransactionRef>& txs, BlockHeight height) {
+                FillBlock(txs, height, params.inputsPerTx, params.outputsPerTx,
+                          params.multisigPercent, params.txsPerBlock);
+            });
+        }
+
+        return std::move(chain);
+    }
+
+private:
+    template <typename Fill>
+    void AddBlock(Fill fill) {
+        BlockHeight height = static_cast<BlockHeight>(chain.blocks.size() + 1);
+        time += TARGET_BLOCK_TIME;
+
+        // Coins from the previous block become spendable at this height
+        while (!immature.empty() && immature.front().spendableAt <= height) {
+            spendable.push_back(immature.front());
+            immature.pop_front();
+        }
+
+        std::vector<TransactionRef> txs;
+        pendingFees = 0;
+        pendingCoins.clear();
+        fill(txs, height);
+
+        // Coinbase split across the generator keys, claiming this block's fees
+        Transaction coinbase = CreateCoinbaseTransaction(height, "", 0, GetBlockReward(height) + pendingFees);
+        Amount total = coinbase.outputs[0].value;
+        coinbase.outputs.clear();
+        size_t outputs = std::max<size_t>(1, std::min<size_t>(
+            SETUP_FANOUT, static_cast<size_t>(total / MIN_OUTPUT_VALUE)));
+        Amount share = total / static_cast<Amount>(outputs);
+        for (size_t i = 0; i < outputs; ++i) {
+            Amount value = (i + 1 == outputs) ? total - share * static_cast<Amount>(outputs - 1) : share;
+            coinbase.outputs.emplace_back(value, scripts[i % KEY_COUNT]);
+        }
+        TransactionRef coinbaseRef = MakeTransactionRef(std::move(coinbase));
+
+        BlockBuilder builder;
+        builder.SetPrevBlockHash(prevHash)
+               .SetTimestamp(time)
+               .SetBits(bits)
+               .SetCoinbase(coinbaseRef);
+        for (const auto& tx : txs) {
+            builder.AddTransaction(tx);
+        }
+
+        for (size_t i = 0; i < coinbaseRef->outputs.size(); ++i) {
+            immature.push_back({OutPoint(coinbaseRef->GetHash(), static_cast<TxOutIndex>(i)),
+                                coinbaseRef->outputs[i].value, i % KEY_COUNT,
+                                height + COINBASE_MATURITY});
+        }
+        // Spends mature one block after coinbases created at the same height
+        // would, so keep the queue ordered by spendableAt
+        for (const auto& coin : pendingCoins) {
+            immature.push_front(coin);
+        }
+
+        Block block = builder.Build();
+        MineHeader(block.header);
+        prevHash = block.GetHash();
+        chain.blocks.push_back(std::move(block));
+    }
+
+    /**
+     * @brief Add up to `maxTxs` transactions spending random spendable coins
+     */
+    void FillBlock(std::vector<TransactionRef>& txs, BlockHeight height, size_t fanIn, size_t fanOut,
+                   unsigned multisigPercent, size_t maxTxs) {
+        size_t blockSize = 0;
+        size_t blockSigOps = 0;
+
+        size_t added = 0;
+        while (added < maxTxs && !spendable.empty()) {
+            TransactionBuilder txBuilder;
+            std::vector<Coin> spent;
+            Amount totalIn = 0;
+            for (size_t i = 0; i < fanIn && !spendable.empty(); ++i) {
+                size_t index = static_cast<size_t>(rng.Next() % spendable.size());
+                spent.push_back(spendable[index]);
+                spendable[index] = spendable.back();
+                spendable.pop_back();
+
+                txBuilder.AddInput(spent.back().outpoint);
+                totalIn += spent.back().value;
+            }
+
+            if (totalIn < TX_FEE + MIN_OUTPUT_VALUE) {
+                // Not worth spending; left in the UTXO set as dust
+                continue;
+            }
+            Amount available = totalIn - TX_FEE;
+            size_t outputs = std::max<size_t>(1, std::min<size_t>(
+                fanOut, static_cast<size_t>(available / MIN_OUTPUT_VALUE)));
+
+            Amount share = available / static_cast<Amount>(outputs);
+            std::vector<size_t> outputKeys;
+            for (size_t i = 0; i < outputs; ++i) {
+                Amount value = (i + 1 == outputs) ? available - share * static_cast<Amount>(outputs - 1) : share;
+                if (!multisigScripts.empty() && rng.Next() % 100 < multisigPercent) {
+                    txBuilder.AddOutput(value, multisigScripts[rng.Next() % multisigScripts.size()]);
+                    outputKeys.push_back(KEY_COUNT);
+                } else {
+                    size_t key = static_cast<size_t>(rng.Next() % KEY_COUNT);
+                    txBuilder.AddOutput(value, scripts[key]);
+                    outputKeys.push_back(key);
+                }
+            }
+
+            Transaction tx = txBuilder.Build();
+            std::vector<bytes> scriptSigs;
+            for (size_t i = 0; i < spent.size(); ++i) {
+                scriptSigs.push_back(SignTransactionInput(tx, i, scripts[spent[i].keyIndex],
+                                                          keys[spent[i].keyIndex].privateKey));
+            }
+            for (size_t i = 0; i < spent.size(); ++i) {
+                tx.inputs[i].scriptSig = std::move(scriptSigs[i]);
+            }
+
+            size_t txSize = tx.GetSize();
+            size_t txSigOps = EstimateSigOps(tx);
+            if (blockSize + txSize > BLOCK_SIZE_BUDGET ||
+                blockSigOps + txSigOps > BLOCK_SIGOPS_BUDGET) {
+                Restore(spent);
+                break;
+            }
+            blockSize += txSize;
+            blockSigOps += txSigOps;
+
+            TransactionRef txRef = MakeTransactionRef(std::move(tx));
+            for (size_t i = 0; i < outputKeys.size(); ++i) {
+                if (outputKeys[i] == KEY_COUNT) {
+                    continue;  // Multisig: unspendable here
+                }
+                pendingCoins.push_back({OutPoint(txRef->GetHash(), static_cast<TxOutIndex>(i)),
+                                        txRef->outputs[i].value, outputKeys[i], height + 1});
+            }
+
+            txs.push_back(std::move(txRef));
+            added++;
+            pendingFees += TX_FEE;
+            chain.transactions++;
+            chain.inputs += spent.size();
+        }
+    }
+
+    void Restore(const std::vector<Coin>& coins) {
+        spendable.insert(spendable.end(), coins.begin(), coins.end());
+    }
+
+    const ChainGenParams& params;
+    FastRandom rng;
+    const uint32_t bits;
+    Timestamp time;
+
+    std::vector<crypto::KeyPair> keys;
+    std::vector<bytes> scripts;             // P2PKH script per key
+    std::vector<bytes> multisigScripts;
+
+    std::vector<Coin> spendable;
+    std::deque<Coin> immature;              // Ordered by spendableAt
+    std::vector<Coin> pendingCoins;         // Created by the block being built
+    Amount pendingFees = 0;
+
+    GeneratedChain chain;
+    Hash256 prevHash;
+};
+
+} // namespace
+
+GeneratedChain ChainGenerator::Generate(const ChainGenParams& params) {
+    DifficultyAdjuster::SetMinimumDifficultyMode(true);
+    return Generator(params).Run();
+}
+
+bool ChainGenerator::WriteToBlockStore(const GeneratedChain& chain, const std::string& dataDir) {
+    BlockStore store;
+    if (!store.Open(dataDir)) {
+        LOG_ERROR("ChainGen", "Failed to open block store: " + dataDir);
+        return false;
+    }
+
+    boost::multiprecision::uint256_t work = chain.genesis.header.GetWork();
+    if (!store.WriteBlock(chain.genesis, 0)) {
+        LOG_ERROR("ChainGen", "Failed to write genesis block");
+        return false;
+    }
+
+    for (size_t i = 0; i < chain.blocks.size(); ++i) {
+        if (!store.WriteBlock(chain.blocks[i], static_cast<BlockHeight>(i + 1))) {
+            LOG_ERROR("ChainGen", "Failed to write block " + std::to_string(i + 1));
+            return false;
+        }
+        work += chain.blocks[i].header.GetWork();
+    }
+
+    const Block& tip = chain.blocks.empty() ? chain.genesis : chain.blocks.back();
+    if (!store.SetBestBlockHash(tip.GetHash()) ||
+        !store.SetChainHeight(static_cast<BlockHeight>(chain.blocks.size())) ||
+        !store.SetTotalWork(work)) {
+        LOG_ERROR("ChainGen", "Failed to write chain state");
+        return false;
+    }
+
+    return true;
+}
+
+bool ChainGenerator::ReadFromBlockStore(const std::string& dataDir, GeneratedChain& chain) {
+    BlockStore store;
+    if (!store.Open(dataDir)) {
+        LOG_ERROR("ChainGen", "Failed to open block store: " + dataDir);
+        return false;
+    }
+
+    auto height = store.GetChainHeight();
+    auto genesis = store.ReadBlock(0);
+    if (!height || !genesis) {
+        LOG_ERROR("ChainGen", "No chain found in " + dataDir);
+        return false;
+    }
+
+    chain = GeneratedChain();
+    chain.genesis = std::move(*genesis);
+
+    for (BlockHeight h = 1; h <= *height; ++h) {
+        auto block = store.ReadBlock(h);
+        if (!block) {
+            LOG_ERROR("ChainGen", "Missing block at height " + std::to_string(h));
+            return false;
+        }
+        for (size_t i = 1; i < block->transactions.size(); ++i) {
+            chain.transactions++;
+            chain.inputs += block->transactions[i]->inputs.size();
+        }
+        chain.blocks.push_back(std::move(*block));
+    }
+
+    return true;
+}
+
+void MineHeader(BlockHeader& header) {
+    header.hashCached = false;
+    while (!header.CheckProofOfWork()) {
+        ++header.nonce;
+        header.hashCached = false;
+    }
+}
+
+} // namespace bench
+} // namespace dinari
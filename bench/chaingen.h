@@ -0,0 +1,90 @@
+/**
+ * @file chaingen.h
+ * @brief Synthetic chain generator for replay benchmarks
+ */
+
+#ifndef DINARI_BENCH_CHAINGEN_H
+#define DINARI_BENCH_CHAINGEN_H
+
+#include "blockchain/block.h"
+#include <string>
+#include <vector>
+
+namespace dinari {
+namespace bench {
+
+/**
+ * @brief Shape of a generated chain
+ */
+struct ChainGenParams {
+    size_t blocks = 100;            // Workload blocks
+    size_t txsPerBlock = 100;       // Upper bound; blocks also stop at size/sigop limits
+    size_t inputsPerTx = 1;         // Fan-in
+    size_t outputsPerTx = 2;        // Fan-out
+    unsigned multisigPercent = 0;   // Share of outputs paying to 2-of-3 bare multisig
+    size_t utxoSetSize = 0;         // Spendable coins to create before the workload
+    uint64_t seed = 1;
+    Timestamp genesisTime = 1700000000;
+};
+
+/**
+ * @brief Generated blocks plus what they contain
+ */
+struct GeneratedChain {
+    Block genesis;
+    std::vector<Block> blocks;      // Excludes genesis
+    size_t workloadStart = 0;       // Index in `blocks` of the first workload block
+    size_t transactions = 0;        // Non-coinbase transactions in all blocks
+    size_t inputs = 0;              // Inputs of those transactions
+};
+
+/**
+ * @brief Builds minimum-difficulty chains that pass full validation
+ *
+ * The chain starts with COINBASE_MATURITY + 1 funding blocks whose
+ * coinbases pay to a small set of generator keys, then setup blocks of
+ * fan-out transactions until `utxoSetSize` spendable coins exist, then
+ * `blocks` workload blocks. Workload transactions spend randomly chosen
+ * coins with the configured fan-in and fan-out.
+ *
+ * Generation is driven by `seed`, so the same parameters give the same
+ * block structure, transaction shapes and sizes. ECDSA signatures use
+ * random nonces, so hashes differ between runs; write the chain out with
+ * WriteToBlockStore() to replay identical bytes.
+ *
+ * The script interpreter cannot execute OP_CHECKMULTISIG, so multisig
+ * outputs are never spent. They stay in the UTXO set, as bare multisig
+ * outputs tend to on real chains.
+ *
+ * Enables DifficultyAdjuster's minimum difficulty mode, which must stay
+ * on while the chain is replayed.
+ */
+class ChainGenerator {
+public:
+    static GeneratedChain Generate(const ChainGenParams& params);
+
+    /**
+     * @brief Store a chain as a node data directory would hold it
+     *
+     * Writes every block by height and sets the best block, chain height
+     * and total work, so Blockchain::Initialize() on the directory loads it.
+     */
+    static bool WriteToBlockStore(const GeneratedChain& chain, const std::string& dataDir);
+
+    /**
+     * @brief Read a chain written by WriteToBlockStore()
+     *
+     * Only `genesis`, `blocks`, `transactions` and `inputs` are filled.
+     */
+    static bool ReadFromBlockStore(const std::string& dataDir, GeneratedChain& chain);
+};
+
+/**
+ * @brief Increment the nonce until the header meets its own target
+ */
+void MineHeader(BlockHeader& header);
+
+} // namespace bench
+} // namespace dinari
+
+#endif // DINARI_BENCH_CHAINGEN_H
@@ -45,6 +45,8 @@ constexpr uint32_t TESTNET_MAGIC = 0xD5E6F7A8;
 constexpr size_t MAX_BLOCK_SIZE = 2 * 1024 * 1024;  // 2MB
 constexpr size_t MAX_BLOCK_SIGOPS = 20000;
 constexpr BlockHeight COINBASE_MATURITY = 100;  // Blocks before coinbase can be spent
+constexpr BlockHeight MIN_BLOCKS_TO_KEEP = 288;  // Block bodies a pruned node keeps below its tip
+constexpr uint64_t MIN_PRUNE_TARGET_MB = 600;  // MIN_BLOCKS_TO_KEEP full blocks plus headroom
 
 // Network parameters
 constexpr Port DEFAULT_PORT = 9333;
@@ -4,6 +4,7 @@
 #include "util/logger.h"
 #include "util/time.h"
 #include "dinari/constants.h"
+#include <algorithm>
 #include <sstream>
 #include <set>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -56,6 +57,7 @@ Hash256 BlockHeader::GetHash() const {
     }
 
     Serializer s;
+    s.Reserve(HEADER_SIZE);
     SerializeImpl(s);
     cachedHash = crypto::Hash::DoubleSHA256(s.GetData());
     hashCached = true;
@@ -126,7 +128,7 @@ void Block::SerializeImpl(Serializer& s) const {
     header.SerializeImpl(s);
     s.WriteCompactSize(transactions.size());
     for (const auto& tx : transactions) {
-        tx.SerializeImpl(s);
+        tx->SerializeImpl(s);
     }
 }
 
@@ -134,9 +136,13 @@ void Block::DeserializeImpl(Deserializer& d) {
     header.DeserializeImpl(d);
 
     uint64_t txCount = d.ReadCompactSize();
-    transactions.resize(txCount);
-    for (auto& tx : transactions) {
-        tx.DeserializeImpl(d);
+    transactions.clear();
+    // Every transaction takes at least 10 bytes, which bounds the reservation
+    transactions.reserve(std::min<uint64_t>(txCount, d.Remaining() / 10));
+    for (uint64_t i = 0; i < txCount; ++i) {
+        auto tx = std::make_shared<Transaction>();
+        tx->DeserializeImpl(d);
+        transactions.push_back(std::move(tx));
     }
 
     sizeCached = false;
@@ -154,9 +160,12 @@ size_t Block::GetSize() const {
 }
 
 size_t Block::GetSerializedSize() const {
-    Serializer s;
-    SerializeImpl(s);
-    return s.Size();
+    // Transaction sizes are cached, so only the count prefix is computed here
+    size_t size = BlockHeader::HEADER_SIZE + Serializer::GetCompactSizeSize(transactions.size());
+    for (const auto& tx : transactions) {
+        size += tx->GetSize();
+    }
+    return size;
 }
 
 bool Block::IsValid() const {
@@ -194,14 +203,14 @@ bool Block::IsValid() const {
 
 bool Block::CheckTransactions() const {
     // First transaction must be coinbase
-    if (!transactions[0].IsCoinbase()) {
+    if (!transactions[0]->IsCoinbase()) {
         LOG_ERROR("Block", "First transaction is not coinbase");
         return false;
     }
 
     // Only first transaction can be coinbase
     for (size_t i = 1; i < transactions.size(); ++i) {
-        if (transactions[i].IsCoinbase()) {
+        if (transactions[i]->IsCoinbase()) {
             LOG_ERROR("Block", "Non-first transaction is coinbase");
             return false;
         }
@@ -209,7 +218,7 @@ bool Block::CheckTransactions() const {
 
     // Check each transaction
     for (const auto& tx : transactions) {
-        if (!tx.IsValid()) {
+        if (!tx->IsValid()) {
             LOG_ERROR("Block", "Invalid transaction in block");
             return false;
         }
@@ -218,7 +227,7 @@ bool Block::CheckTransactions() const {
     // Check for duplicate transactions
     std::set<Hash256> txHashes;
     for (const auto& tx : transactions) {
-        Hash256 hash = tx.GetHash();
+        Hash256 hash = tx->GetHash();
         if (txHashes.count(hash)) {
             LOG_ERROR("Block", "Duplicate transaction in block");
             return false;
@@ -245,7 +254,7 @@ Hash256 Block::CalculateMerkleRoot() const {
     txHashes.reserve(transactions.size());
 
     for (const auto& tx : transactions) {
-        txHashes.push_back(tx.GetHash());
+        txHashes.push_back(tx->GetHash());
     }
 
     return crypto::Hash::ComputeMerkleRoot(txHashes);
@@ -255,18 +264,11 @@ const Transaction& Block::GetCoinbaseTransaction() const {
     if (transactions.empty()) {
         throw std::runtime_error("Block has no transactions");
     }
-    return transactions[0];
-}
-
-Transaction& Block::GetCoinbaseTransaction() {
-    if (transactions.empty()) {
-        throw std::runtime_error("Block has no transactions");
-    }
-    return transactions[0];
+    return *transactions[0];
 }
 
 bool Block::HasCoinbase() const {
-    return !transactions.empty() && transactions[0].IsCoinbase();
+    return !transactions.empty() && transactions[0]->IsCoinbase();
 }
 
 Amount Block::GetTotalFees(const UTXOSet& utxos) const {
@@ -274,7 +276,7 @@ Amount Block::GetTotalFees(const UTXOSet& utxos) const {
 
     // Skip coinbase (first transaction)
     for (size_t i = 1; i < transactions.size(); ++i) {
-        totalFees += transactions[i].GetFee(utxos);
+        totalFees += transactions[i]->GetFee(utxos);
     }
 
     return totalFees;
@@ -304,12 +306,78 @@ bool Block::operator==(const Block& other) const {
 
 // BlockIndex implementation
 
+namespace {
+
+// Clear the lowest set bit
+BlockHeight InvertLowestOne(BlockHeight n) {
+    return n & (n - 1);
+}
+
+// Height a block's skip pointer targets. Heights are spread so that any
+// ancestor is reachable in O(log n) skips, and consecutive blocks mostly
+// point to different heights.
+BlockHeight GetSkipHeight(BlockHeight height) {
+    if (height < 2) {
+        return 0;
+    }
+    return (height & 1) ? InvertLowestOne(InvertLowestOne(height - 1)) + 1
+                        : InvertLowestOne(height);
+}
+
+} // namespace
+
 void BlockIndex::UpdateChainWork() {
-    if (prev) {
-        chainWork = prev->chainWork + block->header.GetWork();
-    } else {
-        chainWork = block->header.GetWork();
+    ChainWork work(block->header.GetWork());
+    chainWork = prev ? prev->chainWork + work : work;
+}
+
+void BlockIndex::BuildSkip() {
+    skip = prev ? prev->GetAncestor(GetSkipHeight(height)) : nullptr;
+}
+
+BlockIndex* BlockIndex::GetAncestor(BlockHeight h) {
+    if (h > height) {
+        return nullptr;
     }
+
+    BlockIndex* walk = this;
+    BlockHeight walkHeight = height;
+    while (walkHeight > h) {
+        BlockHeight skipHeight = GetSkipHeight(walkHeight);
+        BlockHeight skipHeightPrev = GetSkipHeight(walkHeight - 1);
+
+        // Take the skip unless it overshoots, or stepping back once first
+        // would reach a skip that lands closer without overshooting
+        if (walk->skip &&
+            (skipHeight == h ||
+             (skipHeight > h && !(skipHeightPrev + 2 < skipHeight && skipHeightPrev >= h)))) {
+            walk = walk->skip;
+            walkHeight = skipHeight;
+        } else if (walk->prev) {
+            walk = walk->prev;
+            --walkHeight;
+        } else {
+            return nullptr;
+        }
+    }
+    return walk;
+}
+
+const BlockIndex* BlockIndex::GetAncestor(BlockHeight h) const {
+    return const_cast<BlockIndex*>(this)->GetAncestor(h);
+}
+
+// BlockIndexArena implementation
+
+BlockIndex* BlockIndexArena::Allocate(const SharedPtr<Block>& block, BlockHeight height) {
+    if (count % CHUNK_SIZE == 0) {
+        chunks.emplace_back(new BlockIndex[CHUNK_SIZE]);
+    }
+
+    BlockIndex* index = &chunks.back()[count % CHUNK_SIZE];
+    *index = BlockIndex(block, height);
+    ++count;
+    return index;
 }
 
 // BlockBuilder implementation
@@ -344,12 +412,12 @@ BlockBuilder& BlockBuilder::SetNonce(Nonce nonce) {
     return *this;
 }
 
-BlockBuilder& BlockBuilder::AddTransaction(const Transaction& tx) {
+BlockBuilder& BlockBuilder::AddTransaction(const TransactionRef& tx) {
     block.transactions.push_back(tx);
     return *this;
 }
 
-BlockBuilder& BlockBuilder::SetCoinbase(const Transaction& coinbase) {
+BlockBuilder& BlockBuilder::SetCoinbase(const TransactionRef& coinbase) {
     if (block.transactions.empty()) {
         block.transactions.push_back(coinbase);
     } else {
@@ -358,7 +426,7 @@ BlockBuilder& BlockBuilder::SetCoinbase(const Transaction& coinbase) {
     return *this;
 }
 
-BlockBuilder& BlockBuilder::SetTransactions(const std::vector<Transaction>& txs) {
+BlockBuilder& BlockBuilder::SetTransactions(const std::vector<TransactionRef>& txs) {
     block.transactions = txs;
     return *this;
 }
@@ -420,7 +488,7 @@ Block CreateGenesisBlock(Timestamp timestamp, uint32_t bits, Nonce nonce,
            .SetTimestamp(timestamp)
            .SetBits(bits)
            .SetNonce(nonce)
-           .SetCoinbase(coinbase);
+           .SetCoinbase(MakeTransactionRef(coinbase));
 
     Block genesis = builder.Build();
 
@@ -4,6 +4,7 @@
 #include "dinari/types.h"
 #include "core/transaction.h"
 #include "util/serialize.h"
+#include "chainwork.h"
 #include <vector>
 #include <memory>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -28,6 +29,9 @@ public:
     mutable Hash256 cachedHash;
     mutable bool hashCached;
 
+    // Serialized header size in bytes
+    static constexpr size_t HEADER_SIZE = 88;
+
     BlockHeader()
         : version(1)
         , timestamp(0)
@@ -73,7 +77,7 @@ public:
 class Block {
 public:
     BlockHeader header;
-    std::vector<Transaction> transactions;
+    std::vector<TransactionRef> transactions;   // Shared with mempool and relay
 
     // Cached size
     mutable size_t cachedSize;
@@ -104,7 +108,6 @@ public:
 
     // Get coinbase transaction
     const Transaction& GetCoinbaseTransaction() const;
-    Transaction& GetCoinbaseTransaction();
 
     // Check if block has coinbase
     bool HasCoinbase() const;
@@ -132,43 +135,43 @@ public:
 /**
  * @brief Block index entry
  *
- * Contains a block and metadata about its position in the chain.
+ * Contains a block and metadata about its position in the chain. Fields
+ * are ordered to pack without padding; entries live in a BlockIndexArena.
  */
 class BlockIndex {
 public:
+    // Bits of `status`
+    enum StatusFlags : uint32_t {
+        STATUS_VALID = 1 << 0,
+        STATUS_MAIN_CHAIN = 1 << 1,
+        STATUS_HAVE_DATA = 1 << 2,   // Whether we have the full block data
+    };
+
     // Block data
     SharedPtr<Block> block;
 
     // Chain metadata
-    BlockHeight height;
-    boost::multiprecision::uint256_t chainWork;        // Total work from genesis to this block
-    Amount moneySupply;         // Total money supply up to this block
     BlockIndex* prev;           // Previous block in chain
-    std::vector<BlockIndex*> next;  // Possible next blocks (for forks)
-
-    // Status flags
-    bool isValid;
-    bool isMainChain;
-    bool hasData;               // Whether we have the full block data
+    BlockIndex* skip;           // Further ancestor on this branch, for GetAncestor
+    ChainWork chainWork;        // Total work from genesis to this block
+    Amount moneySupply;         // Total money supply up to this block
+    BlockHeight height;
+    uint32_t status;            // StatusFlags
 
     BlockIndex()
-        : height(0)
-        , chainWork(0)
+        : prev(nullptr)
+        , skip(nullptr)
         , moneySupply(0)
-        , prev(nullptr)
-        , isValid(false)
-        , isMainChain(false)
-        , hasData(false) {}
+        , height(0)
+        , status(0) {}
 
     explicit BlockIndex(const SharedPtr<Block>& blk, BlockHeight h)
         : block(blk)
-        , height(h)
-        , chainWork(0)
-        , moneySupply(0)
         , prev(nullptr)
-        , isValid(false)
-        , isMainChain(false)
-        , hasData(true) {}
+        , skip(nullptr)
+        , moneySupply(0)
+        , height(h)
+        , status(STATUS_HAVE_DATA) {}
 
     // Get block hash
     Hash256 GetBlockHash() const {
@@ -188,8 +191,21 @@ public:
     // Calculate total work up to this block
     void UpdateChainWork();
 
-    // Check if this block is in the main chain
-    bool IsInMainChain() const { return isMainChain; }
+    // Set the skip pointer; call once prev is linked and prev's skip is built
+    void BuildSkip();
+
+    // Ancestor at the given height on this block's own branch (this block
+    // itself at its own height), in O(log n) steps; nullptr if above it
+    BlockIndex* GetAncestor(BlockHeight h);
+    const BlockIndex* GetAncestor(BlockHeight h) const;
+
+    // Status flags
+    bool IsValid() const { return status & STATUS_VALID; }
+    bool IsInMainChain() const { return status & STATUS_MAIN_CHAIN; }
+    bool HasData() const { return status & STATUS_HAVE_DATA; }
+    void SetStatus(uint32_t flag, bool value) {
+        status = value ? (status | flag) : (status & ~flag);
+    }
 
     // Get block header
     const BlockHeader& GetHeader() const {
@@ -198,6 +214,33 @@ public:
     }
 };
 
+/**
+ * @brief Storage for BlockIndex entries
+ *
+ * Entries are allocated from contiguous chunks and never move or get freed
+ * individually, so pointers to them stay valid while the arena lives.
+ */
+class BlockIndexArena {
+public:
+    BlockIndex* Allocate(const SharedPtr<Block>& block, BlockHeight height);
+
+    size_t Size() const { return count; }
+
+    // Visit every entry in allocation order
+    template<typename Fn>
+    void ForEach(Fn&& fn) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(chunks[i / CHUNK_SIZE][i % CHUNK_SIZE]);
+        }
+    }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    std::vector<std::unique_ptr<BlockIndex[]>> chunks;
+    size_t count = 0;
+};
+
 /**
  * @brief Block builder helper
  *
@@ -215,11 +258,11 @@ public:
     BlockBuilder& SetNonce(Nonce nonce);
 
     // Add transactions
-    BlockBuilder& AddTransaction(const Transaction& tx);
-    BlockBuilder& SetCoinbase(const Transaction& coinbase);
+    BlockBuilder& AddTransaction(const TransactionRef& tx);
+    BlockBuilder& SetCoinbase(const TransactionRef& coinbase);
 
     // Set all transactions
-    BlockBuilder& SetTransactions(const std::vector<Transaction>& txs);
+    BlockBuilder& SetTransactions(const std::vector<TransactionRef>& txs);
 
     // Build block (calculates merkle root)
     Block Build();
@@ -2,15 +2,58 @@
 #include "consensus/validation.h"
 #include "consensus/difficulty.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "dinari/constants.h"
 #include <algorithm>
 #include <boost/multiprecision/cpp_int.hpp>
 
 namespace dinari {
 
+namespace {
+
+/**
+ * @brief Block processing metrics, registered on first use
+ */
+struct BlockMetrics {
+    Histogram& quickCheck;
+    Histogram& persist;
+    Histogram& validate;
+    Histogram& connect;
+    Histogram& total;
+    Counter& accepted;
+    Counter& rejected;
+
+    static BlockMetrics& Get() {
+        static BlockMetrics metrics;
+        return metrics;
+    }
+
+private:
+    BlockMetrics()
+        : quickCheck(Stage("quick_check"))
+        , persist(Stage("persist"))
+        , validate(Stage("validate"))
+        , connect(Stage("connect"))
+        , total(Metrics::Instance().GetHistogram("dinari_block_accept_seconds",
+              "Total time to process a block in AcceptBlock"))
+        , accepted(Metrics::Instance().GetCounter("dinari_blocks_processed_total",
+              "Blocks processed by AcceptBlock", "result=\"accepted\""))
+        , rejected(Metrics::Instance().GetCounter("dinari_blocks_processed_total",
+              "Blocks processed by AcceptBlock", "result=\"rejected\"")) {}
+
+    static Histogram& Stage(const std::string& stage) {
+        return Metrics::Instance().GetHistogram("dinari_block_stage_seconds",
+            "Time spent in each block validation stage", "stage=\"" + stage + "\"");
+    }
+};
+
+} // namespace
+
 Blockchain::Blockchain()
     : persistenceEnabled(false)
+    , pruneTarget(0)
     , bestBlock(nullptr)
     , genesisBlock(nullptr) {
 }
@@ -42,7 +85,7 @@ bool Blockchain::Initialize(const Block& genesis, const std::string& dataDir) {
         // Try to load existing blockchain from disk
         if (LoadFromDisk()) {
             LOG_INFO("Blockchain", "Loaded existing blockchain from disk");
-            LOG_INFO("Blockchain", "Height: " + std::to_string(GetHeight()));
+            LOG_INFO("Blockchain", "Height: " + std::to_string(bestBlock->height));
             LOG_INFO("Blockchain", "Best block: " +
                      crypto::Hash::ToHex(bestBlock->GetBlockHash()).substr(0, 16) + "...");
             return true;
@@ -67,8 +110,8 @@ bool Blockchain::Initialize(const Block& genesis, const std::string& dataDir) {
 
     // Create genesis block index
     genesisBlock = CreateBlockIndex(genesisBlockPtr, 0);
-    genesisBlock->isMainChain = true;
-    genesisBlock->isValid = true;
+    genesisBlock->SetStatus(BlockIndex::STATUS_MAIN_CHAIN, true);
+    genesisBlock->SetStatus(BlockIndex::STATUS_VALID, true);
 
     // Set as best block
     bestBlock = genesisBlock;
@@ -114,27 +157,43 @@ bool Blockchain::Initialize(const Block& genesis, const std::string& dataDir) {
 }
 
 bool Blockchain::AcceptBlock(const Block& block) {
+    TRACE_SCOPE("Blockchain::AcceptBlock");
+    BlockMetrics& metrics = BlockMetrics::Get();
+    ScopedTimer totalTimer(metrics.total);
+
     std::lock_guard<std::mutex> lock(mutex);
 
+    bool accepted = AcceptBlockInternal(block);
+    (accepted ? metrics.accepted : metrics.rejected).Inc();
+    return accepted;
+}
+
+bool Blockchain::AcceptBlockInternal(const Block& block) {
+    BlockMetrics& metrics = BlockMetrics::Get();
+
     Hash256 blockHash = block.GetHash();
 
     LOG_INFO("Blockchain", "Processing block: " + crypto::Hash::ToHex(blockHash).substr(0, 16) + "...");
 
     // Check if we already have this block
-    if (HasBlock(blockHash)) {
+    if (HasBlockInternal(blockHash)) {
         LOG_DEBUG("Blockchain", "Block already exists");
         return false;
     }
 
     // Quick validation
-    auto quickResult = ContextCheckValidator::QuickBlockCheck(block);
+    ValidationResult quickResult = ValidationResult::Valid();
+    {
+        ScopedTimer timer(metrics.quickCheck);
+        quickResult = ContextCheckValidator::QuickBlockCheck(block);
+    }
     if (!quickResult) {
         LOG_ERROR("Blockchain", "Block failed quick validation: " + quickResult.error);
         return false;
     }
 
     // Find previous block
-    const BlockIndex* prevBlock = GetBlockIndex(block.header.prevBlockHash);
+    const BlockIndex* prevBlock = GetBlockIndexInternal(block.header.prevBlockHash);
 
     // If previous block not found, add to orphans
     if (!prevBlock) {
@@ -155,6 +214,7 @@ bool Blockchain::AcceptBlock(const Block& block) {
 
     // Persist block to disk if enabled
     if (persistenceEnabled) {
+        ScopedTimer timer(metrics.persist);
         if (!blockStore.WriteBlock(block, height)) {
             LOG_ERROR("Blockchain", "Failed to persist block to disk");
             return false;
@@ -165,22 +225,31 @@ bool Blockchain::AcceptBlock(const Block& block) {
     // Create block index
     BlockIndex* blockIndex = CreateBlockIndex(blockPtr, height);
     blockIndex->prev = const_cast<BlockIndex*>(prevBlock);
-    const_cast<BlockIndex*>(prevBlock)->next.push_back(blockIndex);
+    blockIndex->BuildSkip();
 
     // Full validation
-    auto validationResult = ConsensusValidator::ValidateBlock(
-        block, prevBlock, height, *this, utxos);
+    ValidationResult validationResult = ValidationResult::Valid();
+    {
+        ScopedTimer timer(metrics.validate);
+        validationResult = ConsensusValidator::ValidateBlock(
+            block, prevBlock, height, utxos);
+    }
 
     if (!validationResult) {
         LOG_ERROR("Blockchain", "Block validation failed: " + validationResult.error);
-        blockIndex->isValid = false;
+        blockIndex->SetStatus(BlockIndex::STATUS_VALID, false);
         return false;
     }
 
-    blockIndex->isValid = true;
+    blockIndex->SetStatus(BlockIndex::STATUS_VALID, true);
 
     // Connect block
-    if (!ConnectBlock(block, blockIndex)) {
+    bool connected;
+    {
+        ScopedTimer timer(metrics.connect);
+        connected = ConnectBlock(block, blockIndex);
+    }
+    if (!connected) {
         LOG_ERROR("Blockchain", "Failed to connect block");
         return false;
     }
@@ -201,9 +270,11 @@ bool Blockchain::AcceptBlock(const Block& block) {
             if (!blockStore.SetChainHeight(height)) {
                 LOG_ERROR("Blockchain", "Failed to persist chain height");
             }
-            if (!blockStore.SetTotalWork(blockIndex->chainWork)) {
+            if (!blockStore.SetTotalWork(blockIndex->chainWork.ToBigInt())) {
                 LOG_ERROR("Blockchain", "Failed to persist total work");
             }
+
+            PruneBlockStore();
         }
     }
 
@@ -216,6 +287,7 @@ bool Blockchain::AcceptBlock(const Block& block) {
 }
 
 bool Blockchain::ConnectBlock(const Block& block, BlockIndex* blockIndex) {
+    TRACE_SCOPE("Blockchain::ConnectBlock");
     // Update chain work
     blockIndex->UpdateChainWork();
 
@@ -243,11 +315,14 @@ bool Blockchain::ConnectBlock(const Block& block, BlockIndex* blockIndex) {
     // Remove transactions from mempool
     RemoveFromMempool(block);
 
+    NotifyBlockConnected(block, blockIndex->height);
+
     return true;
 }
 
 bool Blockchain::DisconnectBlock(BlockIndex* blockIndex) {
-    if (!blockIndex || !blockIndex->block) {
+    if (!blockIndex || !blockIndex->HasData()) {
+        LOG_ERROR("Blockchain", "Cannot disconnect a block without its data");
         return false;
     }
 
@@ -262,11 +337,12 @@ bool Blockchain::DisconnectBlock(BlockIndex* blockIndex) {
 
     // Add transactions back to mempool (except coinbase)
     for (size_t i = 1; i < blockIndex->block->transactions.size(); ++i) {
-        const auto& tx = blockIndex->block->transactions[i];
-        mempool.AddTransaction(tx, utxos, blockIndex->height);
+        mempool.AddTransaction(blockIndex->block->transactions[i], utxos, blockIndex->height);
     }
 
-    blockIndex->isMainChain = false;
+    blockIndex->SetStatus(BlockIndex::STATUS_MAIN_CHAIN, false);
+
+    NotifyBlockDisconnected(*blockIndex->block, blockIndex->height);
 
     return true;
 }
@@ -307,7 +383,7 @@ bool Blockchain::SetBestChain(BlockIndex* newTip) {
     LOG_INFO("Blockchain", "New best block: " +
              crypto::Hash::ToHex(newTip->GetBlockHash()).substr(0, 16) + "...");
     LOG_INFO("Blockchain", "Height: " + std::to_string(newTip->height));
-    LOG_INFO("Blockchain", "Chain work: " + newTip->chainWork.str());
+    LOG_INFO("Blockchain", "Chain work: " + newTip->chainWork.ToString());
 
     return true;
 }
@@ -346,7 +422,7 @@ bool Blockchain::Reorganize(BlockIndex* newTip) {
     LOG_INFO("Blockchain", "Connecting " + std::to_string(toConnect.size()) + " blocks");
 
     for (auto* block : toConnect) {
-        if (!block->block) {
+        if (!block->HasData()) {
             LOG_ERROR("Blockchain", "Block data missing during reorganization");
             return false;
         }
@@ -364,6 +440,9 @@ bool Blockchain::Reorganize(BlockIndex* newTip) {
 
 std::vector<BlockIndex*> Blockchain::FindPath(BlockIndex* from, BlockIndex* to) const {
     std::vector<BlockIndex*> path;
+    if (from && to && to->height > from->height) {
+        path.reserve(to->height - from->height);
+    }
 
     BlockIndex* current = to;
     while (current && current != from) {
@@ -384,28 +463,24 @@ const BlockIndex* Blockchain::FindFork(const BlockIndex* block1,
     }
 
     // Move both blocks to same height
-    const BlockIndex* b1 = block1;
-    const BlockIndex* b2 = block2;
-
-    while (b1->height > b2->height) {
-        b1 = b1->prev;
-    }
-
-    while (b2->height > b1->height) {
-        b2 = b2->prev;
-    }
-
-    // Move both back until they meet
-    while (b1 != b2) {
-        b1 = b1->prev;
-        b2 = b2->prev;
-
-        if (!b1 || !b2) {
-            return nullptr;
+    BlockHeight height = std::min(block1->height, block2->height);
+    const BlockIndex* b1 = block1->GetAncestor(height);
+    const BlockIndex* b2 = block2->GetAncestor(height);
+
+    // Move both back until they meet. Blocks at equal heights have skip
+    // pointers to equal heights, so differing skip targets mean the fork
+    // is further back still and both can jump.
+    while (b1 && b2 && b1 != b2) {
+        if (b1->skip && b2->skip && b1->skip != b2->skip) {
+            b1 = b1->skip;
+            b2 = b2->skip;
+        } else {
+            b1 = b1->prev;
+            b2 = b2->prev;
         }
     }
 
-    return b1;
+    return b1 == b2 ? b1 : nullptr;
 }
 
 void Blockchain::UpdateMainChain(BlockIndex* tip) {
@@ -413,14 +488,14 @@ void Blockchain::UpdateMainChain(BlockIndex* tip) {
     heightIndex.clear();
 
     // Mark all as not main chain
-    for (auto& [hash, index] : blockIndices) {
-        index->isMainChain = false;
-    }
+    blockArena.ForEach([](BlockIndex& index) {
+        index.SetStatus(BlockIndex::STATUS_MAIN_CHAIN, false);
+    });
 
     // Mark new main chain
     BlockIndex* current = tip;
     while (current) {
-        current->isMainChain = true;
+        current->SetStatus(BlockIndex::STATUS_MAIN_CHAIN, true);
         heightIndex[current->height] = current->GetBlockHash();
         current = current->prev;
     }
@@ -449,7 +524,9 @@ void Blockchain::ProcessOrphans(const Hash256& parentHash) {
     for (const auto& [hash, block] : orphanBlocks) {
         if (block->header.prevBlockHash == parentHash) {
             LOG_INFO("Blockchain", "Processing orphan block");
-            if (AcceptBlock(*block)) {
+            bool accepted = AcceptBlockInternal(*block);
+            (accepted ? BlockMetrics::Get().accepted : BlockMetrics::Get().rejected).Inc();
+            if (accepted) {
                 toRemove.push_back(hash);
             }
         }
@@ -463,20 +540,19 @@ void Blockchain::ProcessOrphans(const Hash256& parentHash) {
 BlockIndex* Blockchain::CreateBlockIndex(const SharedPtr<Block>& block, BlockHeight height) {
     Hash256 blockHash = block->GetHash();
 
-    auto index = std::make_unique<BlockIndex>(block, height);
-    BlockIndex* indexPtr = index.get();
+    BlockIndex* index = blockArena.Allocate(block, height);
+    blockIndices[blockHash] = index;
 
-    blockIndices[blockHash] = std::move(index);
-
-    return indexPtr;
+    return index;
 }
 
 bool Blockchain::UpdateUTXOs(const Block& block, BlockHeight height) {
+    TRACE_SCOPE("Blockchain::UpdateUTXOs");
     // Update in-memory UTXO set
     bool success = utxos.ApplyTransaction(block.GetCoinbaseTransaction(), height) &&
                    std::all_of(block.transactions.begin() + 1, block.transactions.end(),
-                              [&](const Transaction& tx) {
-                                  return utxos.ApplyTransaction(tx, height);
+                              [&](const TransactionRef& tx) {
+                                  return utxos.ApplyTransaction(*tx, height);
                               });
 
     if (!success) {
@@ -487,7 +563,7 @@ bool Blockchain::UpdateUTXOs(const Block& block, BlockHeight height) {
     if (persistenceEnabled) {
         // Index all transactions
         for (uint32_t txIdx = 0; txIdx < block.transactions.size(); ++txIdx) {
-            const auto& tx = block.transactions[txIdx];
+            const Transaction& tx = *block.transactions[txIdx];
 
             // Index transaction location
             if (!txIndex.IndexTransaction(tx, height, txIdx)) {
@@ -525,8 +601,8 @@ bool Blockchain::RevertUTXOs(const Block& block) {
     // For now, we'll just remove the outputs
 
     for (const auto& tx : block.transactions) {
-        Hash256 txHash = tx.GetHash();
-        for (size_t i = 0; i < tx.outputs.size(); ++i) {
+        Hash256 txHash = tx->GetHash();
+        for (size_t i = 0; i < tx->outputs.size(); ++i) {
             OutPoint outpoint(txHash, static_cast<TxOutIndex>(i));
             utxos.RemoveUTXO(outpoint);
         }
@@ -537,13 +613,14 @@ bool Blockchain::RevertUTXOs(const Block& block) {
 
 void Blockchain::RemoveFromMempool(const Block& block) {
     std::vector<Hash256> txHashes;
+    txHashes.reserve(block.transactions.size());
     for (const auto& tx : block.transactions) {
-        txHashes.push_back(tx.GetHash());
+        txHashes.push_back(tx->GetHash());
     }
     mempool.RemoveTransactions(txHashes);
 }
 
-const Block* Blockchain::GetBlock(const Hash256& hash) const {
+SharedPtr<Block> Blockchain::GetBlock(const Hash256& hash) const {
     std::lock_guard<std::mutex> lock(mutex);
 
     auto it = blocks.find(hash);
@@ -551,18 +628,21 @@ const Block* Blockchain::GetBlock(const Hash256& hash) const {
         return nullptr;
     }
 
-    return it->second.get();
+    return it->second;
 }
 
 const BlockIndex* Blockchain::GetBlockIndex(const Hash256& hash) const {
     std::lock_guard<std::mutex> lock(mutex);
+    return GetBlockIndexInternal(hash);
+}
 
+const BlockIndex* Blockchain::GetBlockIndexInternal(const Hash256& hash) const {
     auto it = blockIndices.find(hash);
     if (it == blockIndices.end()) {
         return nullptr;
     }
 
-    return it->second.get();
+    return it->second;
 }
 
 const BlockIndex* Blockchain::GetBlockIndex(BlockHeight height) const {
@@ -573,7 +653,7 @@ const BlockIndex* Blockchain::GetBlockIndex(BlockHeight height) const {
         return nullptr;
     }
 
-    return GetBlockIndex(it->second);
+    return GetBlockIndexInternal(it->second);
 }
 
 BlockHeight Blockchain::GetHeight() const {
@@ -583,19 +663,23 @@ BlockHeight Blockchain::GetHeight() const {
 
 boost::multiprecision::uint256_t Blockchain::GetChainWork() const {
     std::lock_guard<std::mutex> lock(mutex);
-    return bestBlock ? bestBlock->chainWork : boost::multiprecision::uint256_t(0);
+    return bestBlock ? bestBlock->chainWork.ToBigInt() : boost::multiprecision::uint256_t(0);
 }
 
 bool Blockchain::HasBlock(const Hash256& hash) const {
     std::lock_guard<std::mutex> lock(mutex);
+    return HasBlockInternal(hash);
+}
+
+bool Blockchain::HasBlockInternal(const Hash256& hash) const {
     return blocks.find(hash) != blocks.end();
 }
 
 bool Blockchain::IsOnMainChain(const Hash256& hash) const {
     std::lock_guard<std::mutex> lock(mutex);
 
-    const BlockIndex* index = GetBlockIndex(hash);
-    return index && index->isMainChain;
+    const BlockIndex* index = GetBlockIndexInternal(hash);
+    return index && index->IsInMainChain();
 }
 
 std::vector<Hash256> Blockchain::GetBlocksInRange(BlockHeight startHeight,
@@ -618,10 +702,10 @@ Blockchain::Stats Blockchain::GetStats() const {
     std::lock_guard<std::mutex> lock(mutex);
 
     Stats stats;
-    stats.height = GetHeight();
+    stats.height = bestBlock ? bestBlock->height : 0;
     stats.totalBlocks = blocks.size();
     stats.orphanBlocks = orphanBlocks.size();
-    stats.totalWork = GetChainWork();
+    stats.totalWork = bestBlock ? bestBlock->chainWork.ToBigInt() : boost::multiprecision::uint256_t(0);
     stats.bestBlockHash = bestBlock ? bestBlock->GetBlockHash() : Hash256{};
     stats.totalSupply = CalculateTotalSupply(stats.height);
     stats.utxoCount = utxos.GetSize();
@@ -635,11 +719,14 @@ bool Blockchain::ValidateChain() const {
 
     LOG_INFO("Blockchain", "Validating entire blockchain...");
 
-    // Start from genesis
+    // Start from genesis, or the first block a pruned store still has
     const BlockIndex* current = genesisBlock;
+    if (blockStore.GetPruneHeight() > 0) {
+        current = bestBlock->GetAncestor(blockStore.GetPruneHeight());
+    }
 
     while (current) {
-        if (!current->block) {
+        if (!current->HasData()) {
             LOG_ERROR("Blockchain", "Block data missing at height " +
                      std::to_string(current->height));
             return false;
@@ -647,7 +734,7 @@ bool Blockchain::ValidateChain() const {
 
         // Validate block
         auto result = ConsensusValidator::ValidateBlock(
-            *current->block, current->prev, current->height, *this, utxos);
+            *current->block, current->prev, current->height, utxos);
 
         if (!result) {
             LOG_ERROR("Blockchain", "Block validation failed at height " +
@@ -655,19 +742,9 @@ bool Blockchain::ValidateChain() const {
             return false;
         }
 
-        // Move to next
-        if (current->next.empty()) {
-            break;
-        }
-
-        // Follow main chain
-        current = nullptr;
-        for (auto* next : current->next) {
-            if (next->isMainChain) {
-                current = next;
-                break;
-            }
-        }
+        // Move to next main chain block
+        current = current->height < bestBlock->height
+            ? bestBlock->GetAncestor(current->height + 1) : nullptr;
     }
 
     LOG_INFO("Blockchain", "Blockchain validation successful");
@@ -684,22 +761,19 @@ std::vector<Hash256> Blockchain::GetBlockLocator(const BlockIndex* startBlock) c
         return locator;
     }
 
-    int step = 1;
+    BlockHeight step = 1;
     while (current) {
         locator.push_back(current->GetBlockHash());
-
-        // Exponentially increasing steps
-        for (int i = 0; i < step && current->prev; ++i) {
-            current = current->prev;
+        if (current->height == 0) {
+            break;
         }
 
+        // Exponentially increasing steps, ending on genesis
+        current = current->GetAncestor(current->height > step ? current->height - step : 0);
+
         if (locator.size() > 10) {
             step *= 2;
         }
-
-        if (!current->prev) {
-            break;
-        }
     }
 
     return locator;
@@ -709,8 +783,8 @@ const BlockIndex* Blockchain::FindCommonAncestor(const std::vector<Hash256>& loc
     std::lock_guard<std::mutex> lock(mutex);
 
     for (const auto& hash : locator) {
-        const BlockIndex* index = GetBlockIndex(hash);
-        if (index && index->isMainChain) {
+        const BlockIndex* index = GetBlockIndexInternal(hash);
+        if (index && index->IsInMainChain()) {
             return index;
         }
     }
@@ -729,6 +803,251 @@ Amount Blockchain::CalculateTotalSupply(BlockHeight height) const {
     return total;
 }
 
+void Blockchain::SetPruneTarget(uint64_t targetBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pruneTarget = targetBytes;
+}
+
+bool Blockchain::IsPruned() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pruneTarget > 0 || blockStore.GetPruneHeight() > 0;
+}
+
+BlockHeight Blockchain::GetPruneHeight() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blockStore.GetPruneHeight();
+}
+
+void Blockchain::PruneBlockStore() {
+    if (pruneTarget == 0 || !persistenceEnabled || !bestBlock ||
+        bestBlock->height < MIN_BLOCKS_TO_KEEP) {
+        return;
+    }
+
+    BlockHeight oldPruneHeight = blockStore.GetPruneHeight();
+    if (!blockStore.PruneToTarget(pruneTarget, bestBlock->height - MIN_BLOCKS_TO_KEEP)) {
+        LOG_ERROR("Blockchain", "Failed to prune block store");
+    }
+
+    BlockHeight newPruneHeight = blockStore.GetPruneHeight();
+    for (BlockHeight h = oldPruneHeight; h < newPruneHeight; ++h) {
+        DropBlockData(bestBlock->GetAncestor(h));
+    }
+
+    if (newPruneHeight > oldPruneHeight) {
+        LOG_DEBUG("Blockchain", "Pruned block data below height " + std::to_string(newPruneHeight));
+    }
+}
+
+void Blockchain::DropBlockData(BlockIndex* blockIndex) {
+    if (!blockIndex || !blockIndex->HasData()) {
+        return;
+    }
+
+    blocks.erase(blockIndex->GetBlockHash());
+
+    auto header = std::make_shared<Block>();
+    header->header = blockIndex->block->header;
+    blockIndex->block = header;
+    blockIndex->SetStatus(BlockIndex::STATUS_HAVE_DATA, false);
+}
+
+bool Blockchain::DumpUTXOSnapshot(const std::string& path, UTXOSnapshotMetadata& metadata) const {
+    std::vector<BlockHeader> headers;
+    std::vector<SnapshotCoin> coins;
+    crypto::MuHash3072 setHash;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!bestBlock) {
+            return false;
+        }
+
+        headers.resize(bestBlock->height + 1);
+        for (const BlockIndex* index = bestBlock; index; index = index->prev) {
+            headers[index->height] = index->block->header;
+        }
+
+        metadata.baseBlockHash = bestBlock->GetBlockHash();
+        metadata.baseHeight = bestBlock->height;
+        metadata.moneySupply = bestBlock->moneySupply;
+        setHash = utxos.GetSetHash();
+        coins = utxos.GetAllUTXOs();
+    }
+
+    // Finalizing, sorting, encoding and hashing happen without the chain lock
+    metadata.utxoSetHash = setHash.Finalize();
+    if (!UTXOSnapshot::Write(path, metadata, headers, coins)) {
+        LOG_ERROR("Blockchain", "Failed to write UTXO snapshot: " + path);
+        return false;
+    }
+
+    LOG_INFO("Blockchain", "Wrote UTXO snapshot of " + std::to_string(metadata.coinCount) +
+             " coins at height " + std::to_string(metadata.baseHeight));
+    return true;
+}
+
+bool Blockchain::LoadUTXOSnapshot(const std::string& path, UTXOSnapshotMetadata& metadata) {
+    uint32_t networkMagic = metadata.networkMagic;
+    Hash256 expectedUTXOSetHash = metadata.utxoSetHash;
+    if (expectedUTXOSetHash == Hash256{}) {
+        LOG_ERROR("Blockchain", "Loading a UTXO snapshot needs a trusted UTXO set hash");
+        return false;
+    }
+
+    std::vector<BlockHeader> headers;
+    std::vector<SnapshotCoin> coins;
+    if (!UTXOSnapshot::Read(path, metadata, headers, coins)) {
+        LOG_ERROR("Blockchain", "Failed to read UTXO snapshot: " + path);
+        return false;
+    }
+
+    if (metadata.networkMagic != networkMagic) {
+        LOG_ERROR("Blockchain", "UTXO snapshot is for a different network");
+        return false;
+    }
+
+    if (headers.empty() || headers.size() != static_cast<size_t>(metadata.baseHeight) + 1 ||
+        headers.back().GetHash() != metadata.baseBlockHash) {
+        LOG_ERROR("Blockchain", "UTXO snapshot headers do not end at its base block");
+        return false;
+    }
+
+    // Every header must pass the same checks as a header we received,
+    // including the retarget rules, so the chain is indexed off to the side
+    BlockIndexArena stagedIndexes;
+    BlockIndex* stagedTip = nullptr;
+    Amount scheduledSupply = 0;  // Rewards from height 1 to the base
+    for (size_t i = 0; i < headers.size(); ++i) {
+        auto blockPtr = std::make_shared<Block>();
+        blockPtr->header = headers[i];
+
+        BlockHeight height = static_cast<BlockHeight>(i);
+        if (stagedTip) {
+            auto result = ConsensusValidator::ValidateBlockHeader(headers[i], stagedTip);
+            if (!result) {
+                LOG_ERROR("Blockchain", "Invalid header in UTXO snapshot at height " +
+                          std::to_string(i) + ": " + result.error);
+                return false;
+            }
+            if (!SafeAdd(scheduledSupply, GetBlockReward(height), scheduledSupply)) {
+                scheduledSupply = MAX_MONEY;
+            }
+        }
+
+        BlockIndex* blockIndex = stagedIndexes.Allocate(blockPtr, height);
+        blockIndex->prev = stagedTip;
+        blockIndex->BuildSkip();
+        blockIndex->UpdateChainWork();
+        stagedTip = blockIndex;
+    }
+
+    // The file vouches only for itself; the coins must hash to the
+    // MuHash commitment the caller got from a node it trusts
+    if (metadata.utxoSetHash != expectedUTXOSetHash ||
+        UTXOSet::HashCoins(coins).Finalize() != expectedUTXOSetHash) {
+        LOG_ERROR("Blockchain", "UTXO snapshot coins do not match the trusted UTXO set hash");
+        return false;
+    }
+
+    // Unspendable outputs leave the set, so the coins can fall short of
+    // the supply but never exceed it
+    Amount coinTotal = 0;
+    for (const auto& coin : coins) {
+        if (!SafeAdd(coinTotal, coin.second.output.value, coinTotal) ||
+            coinTotal > metadata.moneySupply) {
+            LOG_ERROR("Blockchain", "UTXO snapshot coin total exceeds its money supply");
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!genesisBlock || bestBlock != genesisBlock) {
+        LOG_ERROR("Blockchain", "UTXO snapshots can only be loaded into a fresh chain");
+        return false;
+    }
+    if (headers[0].GetHash() != genesisBlock->GetBlockHash()) {
+        LOG_ERROR("Blockchain", "UTXO snapshot is for a different genesis block");
+        return false;
+    }
+
+    // The supply feeds the issuance cap for every later block, so it may
+    // not exceed what the reward schedule could have minted by the base
+    Amount maxSupply = MAX_MONEY;
+    if (!SafeAdd(genesisBlock->moneySupply, scheduledSupply, maxSupply)) {
+        maxSupply = MAX_MONEY;
+    }
+    if (!MoneyRange(metadata.moneySupply) || metadata.moneySupply > maxSupply) {
+        LOG_ERROR("Blockchain", "UTXO snapshot money supply exceeds the reward schedule");
+        return false;
+    }
+
+    // Persist first so a failed write leaves the in-memory chain untouched.
+    // The best block hash goes last: until it is written the store still
+    // names genesis as its tip.
+    if (persistenceEnabled) {
+        bool persisted = txIndex.ClearUTXOs() && txIndex.BulkLoadUTXOs(coins) &&
+                         blockStore.WriteHeaders(headers) &&
+                         blockStore.SetChainHeight(metadata.baseHeight) &&
+                         blockStore.SetTotalWork(stagedTip->chainWork.ToBigInt()) &&
+                         blockStore.SetBestBlockHash(metadata.baseBlockHash);
+        if (!persisted) {
+            LOG_ERROR("Blockchain", "Failed to persist UTXO snapshot, restoring the genesis state");
+
+            // Put back the genesis UTXOs and tip, which memory still holds
+            if (!txIndex.ClearUTXOs() || !txIndex.BulkLoadUTXOs(utxos.GetAllUTXOs()) ||
+                !blockStore.SetChainHeight(0) ||
+                !blockStore.SetTotalWork(genesisBlock->chainWork.ToBigInt()) ||
+                !blockStore.SetBestBlockHash(genesisBlock->GetBlockHash())) {
+                LOG_ERROR("Blockchain", "Failed to restore the genesis state on disk");
+            }
+
+            // Headers written before the failure replaced the genesis body
+            if (blockStore.GetPruneHeight() > 0) {
+                DropBlockData(genesisBlock);
+            }
+            return false;
+        }
+
+        // The store no longer has the genesis body either
+        DropBlockData(genesisBlock);
+    }
+
+    // Header-only indexes from genesis to the base, as for pruned blocks
+    BlockIndex* tip = genesisBlock;
+    for (BlockHeight h = 1; h <= metadata.baseHeight; ++h) {
+        auto blockPtr = std::make_shared<Block>();
+        blockPtr->header = headers[h];
+
+        BlockIndex* blockIndex = CreateBlockIndex(blockPtr, h);
+        blockIndex->SetStatus(BlockIndex::STATUS_VALID, true);
+        blockIndex->SetStatus(BlockIndex::STATUS_HAVE_DATA, false);
+        blockIndex->SetStatus(BlockIndex::STATUS_MAIN_CHAIN, true);
+        blockIndex->prev = tip;
+        blockIndex->BuildSkip();
+        blockIndex->UpdateChainWork();
+
+        Amount supply = tip->moneySupply;
+        if (!SafeAdd(tip->moneySupply, GetBlockReward(h), supply)) {
+            supply = MAX_MONEY;
+        }
+        blockIndex->moneySupply = h == metadata.baseHeight ? metadata.moneySupply : supply;
+
+        heightIndex[h] = blockIndex->GetBlockHash();
+        tip = blockIndex;
+    }
+
+    utxos.Clear();
+    utxos.AddUTXOs(coins);
+
+    bestBlock = tip;
+
+    LOG_INFO("Blockchain", "Loaded UTXO snapshot of " + std::to_string(coins.size()) +
+             " coins at height " + std::to_string(metadata.baseHeight));
+    return true;
+}
+
 bool Blockchain::LoadFromDisk() {
     if (!persistenceEnabled) {
         return false;
@@ -756,35 +1075,53 @@ bool Blockchain::LoadFromDisk() {
 
     LOG_INFO("Blockchain", "Loading " + std::to_string(chainHeight + 1) + " blocks...");
 
+    BlockHeight pruneHeight = blockStore.GetPruneHeight();
+    if (pruneHeight > 0) {
+        LOG_INFO("Blockchain", "Block data below height " + std::to_string(pruneHeight) +
+                 " has been pruned");
+    }
+
     // Load all blocks from genesis to tip
     for (BlockHeight h = 0; h <= chainHeight; ++h) {
-        auto blockOpt = blockStore.ReadBlock(h);
-        if (!blockOpt) {
-            LOG_ERROR("Blockchain", "Failed to load block at height " + std::to_string(h));
-            return false;
+        SharedPtr<Block> blockPtr;
+        if (h < pruneHeight) {
+            // Only the header is left of a pruned block
+            auto headerOpt = blockStore.ReadHeader(h);
+            if (!headerOpt) {
+                LOG_ERROR("Blockchain", "Failed to load header at height " + std::to_string(h));
+                return false;
+            }
+            blockPtr = std::make_shared<Block>();
+            blockPtr->header = *headerOpt;
+        } else {
+            auto blockOpt = blockStore.ReadBlock(h);
+            if (!blockOpt) {
+                LOG_ERROR("Blockchain", "Failed to load block at height " + std::to_string(h));
+                return false;
+            }
+            blockPtr = std::make_shared<Block>(std::move(*blockOpt));
         }
 
-        Block block = *blockOpt;
+        const Block& block = *blockPtr;
         Hash256 blockHash = block.GetHash();
 
-        // Store in memory cache
-        auto blockPtr = std::make_shared<Block>(block);
-        blocks[blockHash] = blockPtr;
-
         // Create block index
         BlockIndex* blockIndex = CreateBlockIndex(blockPtr, h);
-        blockIndex->isValid = true;
+        blockIndex->SetStatus(BlockIndex::STATUS_VALID, true);
+
+        // Store in memory cache
+        if (h < pruneHeight) {
+            blockIndex->SetStatus(BlockIndex::STATUS_HAVE_DATA, false);
+        } else {
+            blocks[blockHash] = blockPtr;
+        }
 
         // Link to previous block
         if (h > 0) {
-            auto prevHashOpt = blockStore.ReadBlock(h - 1);
-            if (prevHashOpt) {
-                Hash256 prevHash = prevHashOpt->GetHash();
-                const BlockIndex* prevIndex = GetBlockIndex(prevHash);
-                if (prevIndex) {
-                    blockIndex->prev = const_cast<BlockIndex*>(prevIndex);
-                    const_cast<BlockIndex*>(prevIndex)->next.push_back(blockIndex);
-                }
+            const BlockIndex* prevIndex = GetBlockIndexInternal(block.header.prevBlockHash);
+            if (prevIndex) {
+                blockIndex->prev = const_cast<BlockIndex*>(prevIndex);
+                blockIndex->BuildSkip();
             }
         } else {
             // This is genesis
@@ -797,7 +1134,8 @@ bool Blockchain::LoadFromDisk() {
         // Reconstruct money supply (approximate minted coins)
         Amount previousSupply = blockIndex->prev ? blockIndex->prev->moneySupply : 0;
         Amount expectedReward = GetBlockReward(h);
-        Amount coinbaseValue = block.HasCoinbase() ? block.GetCoinbaseTransaction().GetOutputValue() : 0;
+        Amount coinbaseValue = !blockIndex->HasData() ? expectedReward :
+            block.HasCoinbase() ? block.GetCoinbaseTransaction().GetOutputValue() : 0;
         Amount minted = std::min(expectedReward, coinbaseValue);
         Amount newSupply = previousSupply;
         if (!SafeAdd(previousSupply, minted, newSupply)) {
@@ -807,23 +1145,26 @@ bool Blockchain::LoadFromDisk() {
         blockIndex->moneySupply = newSupply;
 
         // Mark as main chain and add to height index
-        blockIndex->isMainChain = true;
+        blockIndex->SetStatus(BlockIndex::STATUS_MAIN_CHAIN, true);
         heightIndex[h] = blockHash;
 
-        // Load UTXO set from transaction index
-        for (uint32_t txIdx = 0; txIdx < block.transactions.size(); ++txIdx) {
-            const auto& tx = block.transactions[txIdx];
-            Hash256 txHash = tx.GetHash();
-
-            // Load outputs into in-memory UTXO set
-            for (size_t vout = 0; vout < tx.outputs.size(); ++vout) {
-                OutPoint outpoint(txHash, static_cast<TxOutIndex>(vout));
-
-                // Check if UTXO still exists (not spent)
-                if (txIndex.HasUTXO(outpoint)) {
-                    auto utxoOpt = txIndex.GetUTXO(outpoint);
-                    if (utxoOpt) {
-                        utxos.AddUTXO(outpoint, *utxoOpt, h, false);
+        // Load UTXO set from transaction index (a pruned store is loaded
+        // in one pass below, as old blocks can no longer be walked)
+        if (pruneHeight == 0) {
+            for (uint32_t txIdx = 0; txIdx < block.transactions.size(); ++txIdx) {
+                const Transaction& tx = *block.transactions[txIdx];
+                Hash256 txHash = tx.GetHash();
+
+                // Load outputs into in-memory UTXO set
+                for (size_t vout = 0; vout < tx.outputs.size(); ++vout) {
+                    OutPoint outpoint(txHash, static_cast<TxOutIndex>(vout));
+
+                    // Check if UTXO still exists (not spent)
+                    if (txIndex.HasUTXO(outpoint)) {
+                        auto utxoOpt = txIndex.GetUTXO(outpoint);
+                        if (utxoOpt) {
+                            utxos.AddUTXO(outpoint, *utxoOpt, h, txIdx == 0);
+                        }
                     }
                 }
             }
@@ -834,8 +1175,17 @@ bool Blockchain::LoadFromDisk() {
         }
     }
 
+    if (pruneHeight > 0) {
+        txIndex.ForEachUTXO([&](const OutPoint& outpoint, const TxOut& output) {
+            auto location = txIndex.GetTxLocation(outpoint.txHash);
+            BlockHeight height = location ? location->height : chainHeight;
+            bool isCoinbase = location && location->txIndex == 0;
+            utxos.AddUTXO(outpoint, output, height, isCoinbase);
+        });
+    }
+
     // Set best block
-    bestBlock = const_cast<BlockIndex*>(GetBlockIndex(bestHash));
+    bestBlock = const_cast<BlockIndex*>(GetBlockIndexInternal(bestHash));
 
     if (!bestBlock) {
         LOG_ERROR("Blockchain", "Failed to find best block");
@@ -865,6 +1215,52 @@ bool Blockchain::FlushToDisk() {
     return true;
 }
 
+void Blockchain::RegisterBlockConnectedCallback(BlockConnectedCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    blockConnectedCallbacks.push_back(std::move(callback));
+}
+
+void Blockchain::RegisterBlockDisconnectedCallback(BlockDisconnectedCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    blockDisconnectedCallbacks.push_back(std::move(callback));
+}
+
+void Blockchain::NotifyBlockConnected(const Block& block, BlockHeight height) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    for (const auto& callback : blockConnectedCallbacks) {
+        callback(block, height);
+    }
+}
+
+void Blockchain::NotifyBlockDisconnected(const Block& block, BlockHeight height) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    for (const auto& callback : blockDisconnectedCallbacks) {
+        callback(block, height);
+    }
+}
+
+SharedPtr<Block> Blockchain::GetBlockAtHeight(BlockHeight height) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = heightIndex.find(height);
+    if (it == heightIndex.end()) {
+        return nullptr;
+    }
+
+    return GetBlockData(it->second);
+}
+
+Hash256 Blockchain::GetBlockHash(BlockHeight height) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = heightIndex.find(height);
+    if (it == heightIndex.end()) {
+        return Hash256{};
+    }
+
+    return it->second;
+}
+
 SharedPtr<Block> Blockchain::GetBlockData(const Hash256& hash) const {
     // First check memory cache
     auto it = blocks.find(hash);
@@ -7,11 +7,13 @@
 #include "core/mempool.h"
 #include "storage/blockstore.h"
 #include "storage/txindex.h"
+#include "storage/utxosnapshot.h"
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <functional>
 
 namespace dinari {
 
@@ -28,6 +30,12 @@ namespace dinari {
  */
 class Blockchain {
 public:
+    /**
+     * @brief Callback when a block is connected to / disconnected from the chain
+     */
+    using BlockConnectedCallback = std::function<void(const Block&, BlockHeight)>;
+    using BlockDisconnectedCallback = std::function<void(const Block&, BlockHeight)>;
+
     Blockchain();
     ~Blockchain();
 
@@ -51,10 +59,12 @@ public:
     /**
      * @brief Get block by hash
      *
+     * The returned block stays valid after it is pruned from the chain.
+     *
      * @param hash Block hash
-     * @return Pointer to block (nullptr if not found)
+     * @return Shared block (nullptr if not found)
      */
-    const Block* GetBlock(const Hash256& hash) const;
+    SharedPtr<Block> GetBlock(const Hash256& hash) const;
 
     /**
      * @brief Get block index by hash
@@ -184,18 +194,110 @@ public:
      */
     const BlockIndex* FindCommonAncestor(const std::vector<Hash256>& locator) const;
 
+    /**
+     * @brief Register block connected callback
+     *
+     * Invoked (with the chain lock held) after a block's UTXO changes
+     * have been applied. Callbacks must not call back into Blockchain.
+     */
+    void RegisterBlockConnectedCallback(BlockConnectedCallback callback);
+
+    /**
+     * @brief Register block disconnected callback
+     *
+     * Invoked (with the chain lock held) after a block has been
+     * disconnected during a reorganization.
+     */
+    void RegisterBlockDisconnectedCallback(BlockDisconnectedCallback callback);
+
+    /**
+     * @brief Get main chain block at height
+     *
+     * @param height Block height
+     * @return Block pointer (nullptr if not found)
+     */
+    SharedPtr<Block> GetBlockAtHeight(BlockHeight height) const;
+
+    /**
+     * @brief Get main chain block hash at height
+     *
+     * @param height Block height
+     * @return Block hash (all zero if not found)
+     */
+    Hash256 GetBlockHash(BlockHeight height) const;
+
+    /**
+     * @brief Get persistent block store
+     */
+    const BlockStore& GetBlockStore() const { return blockStore; }
+
+    /**
+     * @brief Check if persistent storage is enabled
+     */
+    bool IsPersistent() const { return persistenceEnabled; }
+
+    /**
+     * @brief Cap the disk used by block bodies (0 keeps every block)
+     *
+     * Once the stored bodies exceed the target, the oldest are deleted,
+     * always keeping the last MIN_BLOCKS_TO_KEEP. Headers and the UTXO
+     * set are kept.
+     *
+     * @param targetBytes Target size of the stored block bodies
+     */
+    void SetPruneTarget(uint64_t targetBytes);
+
+    /**
+     * @brief Check if old block bodies are (or may be) missing
+     */
+    bool IsPruned() const;
+
+    /**
+     * @brief Lowest height whose block body is still stored
+     */
+    BlockHeight GetPruneHeight() const;
+
+    /**
+     * @brief Write the UTXO set at the current tip to a snapshot file
+     *
+     * @param path Snapshot file path
+     * @param metadata networkMagic is read; the rest is filled in
+     * @return true if the snapshot was written
+     */
+    bool DumpUTXOSnapshot(const std::string& path, UTXOSnapshotMetadata& metadata) const;
+
+    /**
+     * @brief Start the chain from a UTXO snapshot
+     *
+     * Only allowed while the chain holds just the genesis block. The
+     * snapshot's headers must link from our genesis and pass header
+     * validation, difficulty retargets included. Its coins must hash to a
+     * UTXO set hash obtained outside the file, and its money supply must
+     * cover the coins without exceeding the reward schedule. Blocks below
+     * the base are kept as headers only, like pruned blocks, and the node
+     * syncs forward from the base block.
+     *
+     * @param path Snapshot file path
+     * @param metadata networkMagic and the trusted utxoSetHash must match
+     *                 the snapshot's; the rest is filled in
+     * @return true if the chain now ends at the snapshot base
+     */
+    bool LoadUTXOSnapshot(const std::string& path, UTXOSnapshotMetadata& metadata);
+
 private:
     // Persistent storage
     BlockStore blockStore;
     TxIndex txIndex;
     bool persistenceEnabled;
+    uint64_t pruneTarget;
 
     // In-memory caches for performance
     // Block storage (hash -> block) - LRU cache (mutable for caching in const methods)
     mutable std::unordered_map<Hash256, SharedPtr<Block>> blocks;
 
-    // Block index storage (hash -> index)
-    std::unordered_map<Hash256, UniquePtr<BlockIndex>> blockIndices;
+    // Block index entries, and lookup by hash into them
+    BlockIndexArena blockArena;
+    std::unordered_map<Hash256, BlockIndex*> blockIndices;
 
     // Height index (height -> hash) for main chain
     std::map<BlockHeight, Hash256> heightIndex;
@@ -218,8 +320,24 @@ private:
     // Thread safety
     mutable std::mutex mutex;
 
+    // Block notification callbacks
+    std::vector<BlockConnectedCallback> blockConnectedCallbacks;
+    std::vector<BlockDisconnectedCallback> blockDisconnectedCallbacks;
+    mutable std::mutex callbackMutex;
+
     // Internal methods
 
+    /**
+     * @brief AcceptBlock body, called with mutex held
+     */
+    bool AcceptBlockInternal(const Block& block);
+
+    /**
+     * @brief HasBlock and GetBlockIndex bodies, called with mutex held
+     */
+    bool HasBlockInternal(const Hash256& hash) const;
+    const BlockIndex* GetBlockIndexInternal(const Hash256& hash) const;
+
     /**
      * @brief Validate and connect block
      *
@@ -332,6 +450,18 @@ private:
      */
     Amount CalculateTotalSupply(BlockHeight height) const;
 
+    /**
+     * @brief Prune block bodies beyond the target, dropping them from memory
+     */
+    void PruneBlockStore();
+
+    /**
+     * @brief Replace a block index's body with its header alone
+     *
+     * @param blockIndex Block whose body has been pruned
+     */
+    void DropBlockData(BlockIndex* blockIndex);
+
     /**
      * @brief Load blockchain state from disk
      *
@@ -353,6 +483,16 @@ private:
      * @return Block pointer
      */
     SharedPtr<Block> GetBlockData(const Hash256& hash) const;
+
+    /**
+     * @brief Notify listeners of a connected block
+     */
+    void NotifyBlockConnected(const Block& block, BlockHeight height);
+
+    /**
+     * @brief Notify listeners of a disconnected block
+     */
+    void NotifyBlockDisconnected(const Block& block, BlockHeight height);
 };
 
 } // namespace dinari
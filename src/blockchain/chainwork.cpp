@@ -0,0 +1,38 @@
+#include "chainwork.h"
+
+namespace dinari {
+
+ChainWork::ChainWork(const boost::multiprecision::uint256_t& value) : limbs{} {
+    boost::multiprecision::uint256_t temp = value;
+    for (uint64_t& limb : limbs) {
+        limb = static_cast<uint64_t>(temp & 0xffffffffffffffffULL);
+        temp >>= 64;
+    }
+}
+
+boost::multiprecision::uint256_t ChainWork::ToBigInt() const {
+    boost::multiprecision::uint256_t value = 0;
+    for (size_t i = limbs.size(); i-- > 0;) {
+        value <<= 64;
+        value |= limbs[i];
+    }
+    return value;
+}
+
+std::string ChainWork::ToString() const {
+    return ToBigInt().str();
+}
+
+std::string ChainWork::ToHex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(64, '0');
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        uint64_t limb = limbs[limbs.size() - 1 - i];
+        for (size_t nibble = 0; nibble < 16; ++nibble) {
+            hex[16 * i + nibble] = digits[(limb >> (60 - 4 * nibble)) & 0x0f];
+        }
+    }
+    return hex;
+}
+
+} // namespace dinari
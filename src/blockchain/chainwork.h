@@ -0,0 +1,69 @@
+#ifndef DINARI_BLOCKCHAIN_CHAINWORK_H
+#define DINARI_BLOCKCHAIN_CHAINWORK_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace dinari {
+
+/**
+ * @brief Fixed-width 256-bit accumulated proof-of-work
+ *
+ * Four 64-bit limbs, least significant first. Only the operations chain
+ * selection needs (add and compare) are provided inline; per-block work
+ * is still computed with boost in BlockHeader::GetWork and converted
+ * once.
+ */
+class ChainWork {
+public:
+    constexpr ChainWork() : limbs{} {}
+    explicit ChainWork(const boost::multiprecision::uint256_t& value);
+
+    // Convert for arithmetic beyond add/compare and for storage
+    boost::multiprecision::uint256_t ToBigInt() const;
+
+    // Decimal and (64-character, big-endian) hex representations
+    std::string ToString() const;
+    std::string ToHex() const;
+
+    bool IsZero() const {
+        return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    ChainWork& operator+=(const ChainWork& other) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < limbs.size(); ++i) {
+            uint64_t sum = limbs[i] + other.limbs[i];
+            uint64_t carryOut = sum < limbs[i];
+            limbs[i] = sum + carry;
+            carry = carryOut | (limbs[i] < sum);
+        }
+        return *this;
+    }
+
+    friend ChainWork operator+(ChainWork a, const ChainWork& b) { return a += b; }
+
+    friend bool operator==(const ChainWork& a, const ChainWork& b) { return a.limbs == b.limbs; }
+    friend bool operator!=(const ChainWork& a, const ChainWork& b) { return a.limbs != b.limbs; }
+
+    friend bool operator<(const ChainWork& a, const ChainWork& b) {
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i];
+            }
+        }
+        return false;
+    }
+    friend bool operator>(const ChainWork& a, const ChainWork& b) { return b < a; }
+    friend bool operator<=(const ChainWork& a, const ChainWork& b) { return !(b < a); }
+    friend bool operator>=(const ChainWork& a, const ChainWork& b) { return !(a < b); }
+
+private:
+    std::array<uint64_t, 4> limbs;
+};
+
+} // namespace dinari
+
+#endif // DINARI_BLOCKCHAIN_CHAINWORK_H
@@ -14,21 +14,9 @@ bool MerkleBranch::Verify(const Hash256& txHash, const Hash256& merkleRoot) cons
     int idx = index;
 
     for (const auto& branchHash : branch) {
-        bytes combined;
-        combined.reserve(64);
-
-        // Determine order based on index
-        if (idx & 1) {
-            // Odd index: branchHash is on the left
-            combined.insert(combined.end(), branchHash.begin(), branchHash.end());
-            combined.insert(combined.end(), hash.begin(), hash.end());
-        } else {
-            // Even index: branchHash is on the right
-            combined.insert(combined.end(), hash.begin(), hash.end());
-            combined.insert(combined.end(), branchHash.begin(), branchHash.end());
-        }
-
-        hash = crypto::Hash::DoubleSHA256(combined);
+        // Odd index: branchHash is on the left
+        hash = (idx & 1) ? crypto::Hash::MerkleHash(branchHash, hash)
+                         : crypto::Hash::MerkleHash(hash, branchHash);
         idx >>= 1;  // Move to parent level
     }
 
@@ -43,46 +31,20 @@ MerkleBranch BuildMerkleBranch(const std::vector<Hash256>& hashes, size_t index)
         return branch;
     }
 
-    std::vector<Hash256> level = hashes;
+    // Reduce one scratch level in place, noting each sibling on the way up
+    std::vector<Hash256> scratch((hashes.size() + 1) / 2);
+    const Hash256* level = hashes.data();
+    size_t count = hashes.size();
     size_t idx = index;
 
-    while (level.size() > 1) {
-        // Determine sibling index
-        size_t siblingIdx;
-        if (idx & 1) {
-            // Odd index: sibling is on the left
-            siblingIdx = idx - 1;
-        } else {
-            // Even index: sibling is on the right
-            siblingIdx = idx + 1;
-        }
-
-        // Add sibling to branch
-        if (siblingIdx < level.size()) {
-            branch.branch.push_back(level[siblingIdx]);
-        } else {
-            // If no sibling (odd number of nodes), duplicate the last one
-            branch.branch.push_back(level[idx]);
-        }
-
-        // Build next level
-        std::vector<Hash256> nextLevel;
-        for (size_t i = 0; i < level.size(); i += 2) {
-            bytes combined;
-            combined.reserve(64);
-            combined.insert(combined.end(), level[i].begin(), level[i].end());
-
-            if (i + 1 < level.size()) {
-                combined.insert(combined.end(), level[i + 1].begin(), level[i + 1].end());
-            } else {
-                // Duplicate if odd number
-                combined.insert(combined.end(), level[i].begin(), level[i].end());
-            }
-
-            nextLevel.push_back(crypto::Hash::DoubleSHA256(combined));
-        }
+    while (count > 1) {
+        // Sibling, or the node itself when it is the odd one out
+        size_t siblingIdx = idx ^ 1;
+        branch.branch.push_back(level[siblingIdx < count ? siblingIdx : idx]);
 
-        level = std::move(nextLevel);
+        crypto::Hash::ComputeMerkleLevel(scratch.data(), level, count);
+        level = scratch.data();
+        count = (count + 1) / 2;
         idx >>= 1;  // Move to parent level
     }
 
@@ -97,61 +59,59 @@ MerkleTree::MerkleTree(const std::vector<Hash256>& leaves)
 }
 
 void MerkleTree::Build(const std::vector<Hash256>& leaves) {
-    levels.clear();
+    nodes.clear();
+    levelOffsets.clear();
     leafCount = leaves.size();
 
     if (leaves.empty()) {
         return;
     }
 
-    // Add leaf level
-    levels.push_back(leaves);
-
-    // Build tree levels bottom-up
-    while (levels.back().size() > 1) {
-        const auto& currentLevel = levels.back();
-        std::vector<Hash256> nextLevel;
-
-        for (size_t i = 0; i < currentLevel.size(); i += 2) {
-            if (i + 1 < currentLevel.size()) {
-                nextLevel.push_back(ComputeParent(currentLevel[i], currentLevel[i + 1]));
-            } else {
-                // Odd number of nodes, duplicate the last one
-                nextLevel.push_back(ComputeParent(currentLevel[i], currentLevel[i]));
-            }
+    // Lay out every level in one buffer, leaves first
+    size_t total = 0;
+    for (size_t count = leafCount; ; count = (count + 1) / 2) {
+        levelOffsets.push_back(total);
+        total += count;
+        if (count == 1) {
+            break;
         }
+    }
+    levelOffsets.push_back(total);
+
+    nodes.resize(total);
+    std::copy(leaves.begin(), leaves.end(), nodes.begin());
 
-        levels.push_back(std::move(nextLevel));
+    for (size_t level = 0; level + 2 < levelOffsets.size(); ++level) {
+        crypto::Hash::ComputeMerkleLevel(&nodes[levelOffsets[level + 1]],
+                                         &nodes[levelOffsets[level]],
+                                         LevelSize(level));
     }
 }
 
 Hash256 MerkleTree::GetRoot() const {
-    if (levels.empty() || levels.back().empty()) {
+    if (nodes.empty()) {
         return Hash256{};
     }
-    return levels.back()[0];
+    return nodes.back();
 }
 
 MerkleBranch MerkleTree::GetBranch(size_t index) const {
     MerkleBranch branch;
     branch.index = static_cast<int>(index);
 
-    if (levels.empty() || index >= levels[0].size()) {
+    if (index >= leafCount) {
         return branch;
     }
 
     size_t idx = index;
 
     // Traverse from leaf to root, collecting sibling hashes
-    for (size_t level = 0; level < levels.size() - 1; ++level) {
-        size_t siblingIdx = (idx & 1) ? idx - 1 : idx + 1;
-
-        if (siblingIdx < levels[level].size()) {
-            branch.branch.push_back(levels[level][siblingIdx]);
-        } else {
-            // No sibling (odd number), use current node
-            branch.branch.push_back(levels[level][idx]);
-        }
+    for (size_t level = 0; level + 1 < GetDepth(); ++level) {
+        const Hash256* nodesAtLevel = &nodes[levelOffsets[level]];
+        size_t siblingIdx = idx ^ 1;
+
+        // No sibling (odd number), use current node
+        branch.branch.push_back(nodesAtLevel[siblingIdx < LevelSize(level) ? siblingIdx : idx]);
 
         idx >>= 1;  // Move to parent level
     }
@@ -160,12 +120,12 @@ MerkleBranch MerkleTree::GetBranch(size_t index) const {
 }
 
 bool MerkleTree::VerifyInclusion(const Hash256& txHash, size_t index) const {
-    if (levels.empty() || index >= levels[0].size()) {
+    if (index >= leafCount) {
         return false;
     }
 
     // Check if transaction hash matches at leaf level
-    if (levels[0][index] != txHash) {
+    if (nodes[index] != txHash) {
         return false;
     }
 
@@ -175,15 +135,7 @@ bool MerkleTree::VerifyInclusion(const Hash256& txHash, size_t index) const {
 }
 
 size_t MerkleTree::GetDepth() const {
-    return levels.size();
-}
-
-Hash256 MerkleTree::ComputeParent(const Hash256& left, const Hash256& right) {
-    bytes combined;
-    combined.reserve(64);
-    combined.insert(combined.end(), left.begin(), left.end());
-    combined.insert(combined.end(), right.begin(), right.end());
-    return crypto::Hash::DoubleSHA256(combined);
+    return levelOffsets.empty() ? 0 : levelOffsets.size() - 1;
 }
 
 } // namespace dinari
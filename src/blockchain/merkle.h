@@ -52,7 +52,7 @@ MerkleBranch BuildMerkleBranch(const std::vector<Hash256>& hashes, size_t index)
 /**
  * @brief Merkle tree (for efficient branch generation)
  *
- * Stores the complete Merkle tree structure.
+ * Stores the complete Merkle tree structure in one contiguous buffer.
  */
 class MerkleTree {
 public:
@@ -78,11 +78,11 @@ public:
     size_t GetLeafCount() const { return leafCount; }
 
 private:
-    std::vector<std::vector<Hash256>> levels;  // Tree levels (bottom to top)
-    size_t leafCount;
+    std::vector<Hash256> nodes;         // All levels, leaves first, root last
+    std::vector<size_t> levelOffsets;   // Start of each level in nodes, plus end
+    size_t leafCount = 0;
 
-    // Compute parent hash from two children
-    static Hash256 ComputeParent(const Hash256& left, const Hash256& right);
+    size_t LevelSize(size_t level) const { return levelOffsets[level + 1] - levelOffsets[level]; }
 };
 
 } // namespace dinari
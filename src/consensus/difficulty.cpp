@@ -4,19 +4,38 @@
 #include "util/logger.h"
 #include "dinari/constants.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 namespace dinari {
 
+namespace {
+
+std::atomic<bool> minimumDifficultyMode{false};
+
+} // namespace
+
+uint32_t DifficultyAdjuster::GetInitialDifficulty() {
+    return IsMinimumDifficultyMode() ? GetMinimumDifficulty() : INITIAL_DIFFICULTY;
+}
+
+void DifficultyAdjuster::SetMinimumDifficultyMode(bool enabled) {
+    minimumDifficultyMode.store(enabled);
+}
+
+bool DifficultyAdjuster::IsMinimumDifficultyMode() {
+    return minimumDifficultyMode.load(std::memory_order_relaxed);
+}
+
 bool DifficultyAdjuster::ShouldAdjustDifficulty(BlockHeight height) {
     // Adjust every DIFFICULTY_ADJUSTMENT_INTERVAL blocks
     return (height % DIFFICULTY_ADJUSTMENT_INTERVAL) == 0;
 }
 
-uint32_t DifficultyAdjuster::GetNextWorkRequired(const BlockIndex* lastBlock,
-                                                 const Blockchain& blockchain) {
-    // Genesis block or before first adjustment
-    if (!lastBlock || lastBlock->height < DIFFICULTY_ADJUSTMENT_INTERVAL) {
+uint32_t DifficultyAdjuster::GetNextWorkRequired(const BlockIndex* lastBlock) {
+    // Genesis block, before first adjustment, or no retargeting
+    if (!lastBlock || lastBlock->height < DIFFICULTY_ADJUSTMENT_INTERVAL ||
+        IsMinimumDifficultyMode()) {
         return GetInitialDifficulty();
     }
 
@@ -25,9 +44,10 @@ uint32_t DifficultyAdjuster::GetNextWorkRequired(const BlockIndex* lastBlock,
         return lastBlock->GetBits();
     }
 
-    // Find first block of adjustment period
+    // Find first block of adjustment period on lastBlock's own branch, which
+    // need not be the main chain
     BlockHeight firstHeight = lastBlock->height - DIFFICULTY_ADJUSTMENT_INTERVAL + 1;
-    const BlockIndex* firstBlock = GetBlockAtHeight(blockchain, firstHeight);
+    const BlockIndex* firstBlock = lastBlock->GetAncestor(firstHeight);
 
     if (!firstBlock) {
         LOG_ERROR("Difficulty", "Cannot find first block for adjustment");
@@ -206,18 +226,12 @@ bool DifficultyAdjuster::IsValidDifficulty(uint32_t bits) {
     return true;
 }
 
-const BlockIndex* DifficultyAdjuster::GetBlockAtHeight(const Blockchain& blockchain,
-                                                       BlockHeight height) {
-    return blockchain.GetBlockIndex(height);
-}
-
 // DifficultyCalculator implementation
 
 bool DifficultyCalculator::VerifyBlockDifficulty(const Block& block,
-                                                 const BlockIndex* prevBlock,
-                                                 const Blockchain& blockchain) {
+                                                 const BlockIndex* prevBlock) {
     // Get expected difficulty
-    uint32_t expectedBits = GetExpectedDifficulty(prevBlock, blockchain);
+    uint32_t expectedBits = GetExpectedDifficulty(prevBlock);
 
     // Check if block difficulty matches expected
     if (block.header.bits != expectedBits) {
@@ -231,8 +245,7 @@ bool DifficultyCalculator::VerifyBlockDifficulty(const Block& block,
     return CheckBlockDifficulty(block);
 }
 
-uint32_t DifficultyCalculator::GetExpectedDifficulty(const BlockIndex* prevBlock,
-                                                     const Blockchain& blockchain) {
+uint32_t DifficultyCalculator::GetExpectedDifficulty(const BlockIndex* prevBlock) {
     if (!prevBlock) {
         return DifficultyAdjuster::GetInitialDifficulty();
     }
@@ -240,7 +253,7 @@ uint32_t DifficultyCalculator::GetExpectedDifficulty(const BlockIndex* prevBlock
     // Check if adjustment is needed
     BlockHeight nextHeight = prevBlock->height + 1;
     if (DifficultyAdjuster::ShouldAdjustDifficulty(nextHeight)) {
-        return DifficultyAdjuster::GetNextWorkRequired(prevBlock, blockchain);
+        return DifficultyAdjuster::GetNextWorkRequired(prevBlock);
     }
 
     // No adjustment, use previous difficulty
@@ -19,12 +19,13 @@ public:
     /**
      * @brief Calculate next difficulty target
      *
+     * Earlier blocks of the period are reached through lastBlock's own
+     * ancestors, so no chain state is needed.
+     *
      * @param lastBlock Last block before adjustment
-     * @param blockchain Reference to blockchain for historical data
      * @return New difficulty target (compact format)
      */
-    static uint32_t GetNextWorkRequired(const BlockIndex* lastBlock,
-                                       const class Blockchain& blockchain);
+    static uint32_t GetNextWorkRequired(const BlockIndex* lastBlock);
 
     /**
      * @brief Check if it's time for difficulty adjustment
@@ -82,11 +83,25 @@ public:
     /**
      * @brief Get initial difficulty (mainnet)
      *
-     * @return Initial difficulty bits
+     * @return Initial difficulty bits, or the minimum difficulty when
+     *         minimum difficulty mode is enabled
      */
-    static constexpr uint32_t GetInitialDifficulty() {
-        return INITIAL_DIFFICULTY;
-    }
+    static uint32_t GetInitialDifficulty();
+
+    /**
+     * @brief Require only the minimum difficulty for every block
+     *
+     * Disables retargeting so synthetic chains can be mined instantly.
+     * For benchmarks and test tooling only; dinarid never enables it.
+     *
+     * @param enabled true to enable
+     */
+    static void SetMinimumDifficultyMode(bool enabled);
+
+    /**
+     * @brief Check if minimum difficulty mode is enabled
+     */
+    static bool IsMinimumDifficultyMode();
 
     /**
      * @brief Check if difficulty bits are valid
@@ -99,10 +114,6 @@ public:
 private:
     // Prevent instantiation
     DifficultyAdjuster() = delete;
-
-    // Helper to get block at specific height
-    static const BlockIndex* GetBlockAtHeight(const Blockchain& blockchain,
-                                             BlockHeight height);
 };
 
 /**
@@ -115,22 +126,18 @@ public:
      *
      * @param block Block to verify
      * @param prevBlock Previous block
-     * @param blockchain Blockchain reference
      * @return true if difficulty is correct
      */
     static bool VerifyBlockDifficulty(const Block& block,
-                                     const BlockIndex* prevBlock,
-                                     const Blockchain& blockchain);
+                                     const BlockIndex* prevBlock);
 
     /**
      * @brief Get expected difficulty for next block
      *
      * @param prevBlock Previous block
-     * @param blockchain Blockchain reference
      * @return Expected difficulty bits
      */
-    static uint32_t GetExpectedDifficulty(const BlockIndex* prevBlock,
-                                         const Blockchain& blockchain);
+    static uint32_t GetExpectedDifficulty(const BlockIndex* prevBlock);
 
     /**
      * @brief Check if block meets difficulty target
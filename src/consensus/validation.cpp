@@ -5,6 +5,7 @@
 #include "core/utxo.h"
 #include "util/logger.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "dinari/constants.h"
 
 namespace dinari {
@@ -12,8 +13,8 @@ namespace dinari {
 ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
                                                    const BlockIndex* prevBlock,
                                                    BlockHeight height,
-                                                   const Blockchain& blockchain,
                                                    const UTXOSet& utxos) {
+    TRACE_SCOPE("ConsensusValidator::ValidateBlock");
     // Quick checks first
     auto quickResult = ContextCheckValidator::QuickBlockCheck(block);
     if (!quickResult) {
@@ -21,7 +22,7 @@ ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
     }
 
     // Validate header
-    auto headerResult = ValidateBlockHeader(block.header, prevBlock, blockchain);
+    auto headerResult = ValidateBlockHeader(block.header, prevBlock);
     if (!headerResult) {
         return headerResult;
     }
@@ -39,14 +40,14 @@ ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
     }
 
     // First transaction must be coinbase
-    if (!block.transactions[0].IsCoinbase()) {
+    if (!block.transactions[0]->IsCoinbase()) {
         return ValidationResult::Invalid("First transaction must be coinbase");
     }
 
     // Validate coinbase
     Amount blockReward = GetBlockReward(height);
     Amount totalFees = block.GetTotalFees(utxos);
-    auto coinbaseResult = ValidateCoinbase(block.transactions[0], height,
+    auto coinbaseResult = ValidateCoinbase(*block.transactions[0], height,
                                           blockReward, totalFees);
     if (!coinbaseResult) {
         return coinbaseResult;
@@ -54,7 +55,7 @@ ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
 
     // Validate all transactions
     for (size_t i = 0; i < block.transactions.size(); ++i) {
-        const auto& tx = block.transactions[i];
+        const Transaction& tx = *block.transactions[i];
 
         // Coinbase already validated
         if (i == 0) continue;
@@ -83,7 +84,7 @@ ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
 
     // Validate money supply against cumulative issuance
     Amount previousSupply = prevBlock ? prevBlock->moneySupply : 0;
-    Amount coinbaseValue = block.transactions[0].GetOutputValue();
+    Amount coinbaseValue = block.transactions[0]->GetOutputValue();
     Amount minted = 0;
     if (coinbaseValue > totalFees) {
         minted = coinbaseValue - totalFees;
@@ -98,8 +99,7 @@ ValidationResult ConsensusValidator::ValidateBlock(const Block& block,
 }
 
 ValidationResult ConsensusValidator::ValidateBlockHeader(const BlockHeader& header,
-                                                         const BlockIndex* prevBlock,
-                                                         const Blockchain& blockchain) {
+                                                         const BlockIndex* prevBlock) {
     // Validate proof-of-work
     if (!header.CheckProofOfWork()) {
         return ValidationResult::Invalid("Invalid proof-of-work");
@@ -107,7 +107,7 @@ ValidationResult ConsensusValidator::ValidateBlockHeader(const BlockHeader& head
 
     // Validate difficulty
     if (prevBlock) {
-        uint32_t expectedBits = DifficultyCalculator::GetExpectedDifficulty(prevBlock, blockchain);
+        uint32_t expectedBits = DifficultyCalculator::GetExpectedDifficulty(prevBlock);
         if (header.bits != expectedBits) {
             return ValidationResult::Invalid("Incorrect difficulty target");
         }
@@ -208,7 +208,7 @@ ValidationResult ConsensusValidator::ValidateBlockSigOps(const Block& block) {
     size_t totalSigOps = 0;
 
     for (const auto& tx : block.transactions) {
-        totalSigOps += CountSigOps(tx);
+        totalSigOps += CountSigOps(*tx);
     }
 
     if (totalSigOps > MAX_BLOCK_SIGOPS) {
@@ -341,13 +341,13 @@ ValidationResult ContextCheckValidator::QuickBlockCheck(const Block& block) {
     }
 
     // First must be coinbase
-    if (!block.transactions[0].IsCoinbase()) {
+    if (!block.transactions[0]->IsCoinbase()) {
         return ValidationResult::Invalid("First transaction not coinbase");
     }
 
     // Only first can be coinbase
     for (size_t i = 1; i < block.transactions.size(); ++i) {
-        if (block.transactions[i].IsCoinbase()) {
+        if (block.transactions[i]->IsCoinbase()) {
             return ValidationResult::Invalid("Multiple coinbase transactions");
         }
     }
@@ -44,14 +44,12 @@ public:
      * @param block Block to validate
      * @param prevBlock Previous block in chain
      * @param height Block height
-     * @param blockchain Blockchain reference
      * @param utxos UTXO set
      * @return Validation result
      */
     static ValidationResult ValidateBlock(const Block& block,
                                          const BlockIndex* prevBlock,
                                          BlockHeight height,
-                                         const class Blockchain& blockchain,
                                          const class UTXOSet& utxos);
 
     /**
@@ -59,12 +57,10 @@ public:
      *
      * @param header Block header to validate
      * @param prevBlock Previous block
-     * @param blockchain Blockchain reference
      * @return Validation result
      */
     static ValidationResult ValidateBlockHeader(const BlockHeader& header,
-                                               const BlockIndex* prevBlock,
-                                               const Blockchain& blockchain);
+                                               const BlockIndex* prevBlock);
 
     /**
      * @brief Validate transaction in context
@@ -3,6 +3,7 @@
 #include "consensus/validation.h"
 #include "util/logger.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "dinari/constants.h"
 #include <algorithm>
 
@@ -14,14 +15,16 @@ MemPool::MemPool() : totalSize(0), totalFees(0) {
 MemPool::~MemPool() {
 }
 
-bool MemPool::AddTransaction(const Transaction& tx, const UTXOSet& utxos,
+bool MemPool::AddTransaction(const TransactionRef& txRef, const UTXOSet& utxos,
                              BlockHeight currentHeight) {
+    TRACE_SCOPE("MemPool::AddTransaction");
     std::lock_guard<std::mutex> lock(mutex);
 
+    const Transaction& tx = *txRef;
     Hash256 txHash = tx.GetHash();
 
     // Check if already in mempool
-    if (HasTransaction(txHash)) {
+    if (HasTransactionInternal(txHash)) {
         LOG_DEBUG("MemPool", "Transaction already in mempool: " + crypto::Hash::ToHex(txHash));
         return false;
     }
@@ -44,7 +47,7 @@ bool MemPool::AddTransaction(const Transaction& tx, const UTXOSet& utxos,
     double priority = tx.GetPriority(utxos, currentHeight);
 
     // Check if mempool is full
-    if (IsFull()) {
+    if (IsFullInternal()) {
         // Check if this transaction has higher fee rate than lowest
         Amount feeRate = fee / tx.GetSize();
         if (!feeIndex.empty()) {
@@ -54,12 +57,12 @@ bool MemPool::AddTransaction(const Transaction& tx, const UTXOSet& utxos,
                 return false;
             }
             // Remove lowest fee transaction
-            TrimToSize(MAX_MEMPOOL_SIZE - tx.GetSize());
+            TrimToSizeInternal(MAX_MEMPOOL_SIZE - tx.GetSize());
         }
     }
 
     // Create entry
-    MemPoolEntry entry(tx, fee, priority);
+    MemPoolEntry entry(txRef, fee, priority);
 
     // Add to storage
     transactions[txHash] = entry;
@@ -74,7 +77,7 @@ bool MemPool::AddTransaction(const Transaction& tx, const UTXOSet& utxos,
     LOG_INFO("MemPool", "Added transaction: " + crypto::Hash::ToHex(txHash).substr(0, 16) + "...");
     LOG_DEBUG("MemPool", "  Fee: " + FormatAmount(fee));
     LOG_DEBUG("MemPool", "  Size: " + std::to_string(entry.size) + " bytes");
-    LOG_DEBUG("MemPool", "  MemPool size: " + std::to_string(Size()) + " transactions");
+    LOG_DEBUG("MemPool", "  MemPool size: " + std::to_string(transactions.size()) + " transactions");
 
     return true;
 }
@@ -112,10 +115,14 @@ void MemPool::RemoveTransactions(const std::vector<Hash256>& txHashes) {
 
 bool MemPool::HasTransaction(const Hash256& txHash) const {
     std::lock_guard<std::mutex> lock(mutex);
+    return HasTransactionInternal(txHash);
+}
+
+bool MemPool::HasTransactionInternal(const Hash256& txHash) const {
     return transactions.find(txHash) != transactions.end();
 }
 
-const Transaction* MemPool::GetTransaction(const Hash256& txHash) const {
+TransactionRef MemPool::GetTransaction(const Hash256& txHash) const {
     std::lock_guard<std::mutex> lock(mutex);
 
     auto it = transactions.find(txHash);
@@ -123,7 +130,7 @@ const Transaction* MemPool::GetTransaction(const Hash256& txHash) const {
         return nullptr;
     }
 
-    return &it->second.tx;
+    return it->second.tx;
 }
 
 const MemPoolEntry* MemPool::GetEntry(const Hash256& txHash) const {
@@ -137,10 +144,10 @@ const MemPoolEntry* MemPool::GetEntry(const Hash256& txHash) const {
     return &it->second;
 }
 
-std::vector<Transaction> MemPool::GetAllTransactions() const {
+std::vector<TransactionRef> MemPool::GetAllTransactions() const {
     std::lock_guard<std::mutex> lock(mutex);
 
-    std::vector<Transaction> result;
+    std::vector<TransactionRef> result;
     result.reserve(transactions.size());
 
     for (const auto& [hash, entry] : transactions) {
@@ -150,11 +157,11 @@ std::vector<Transaction> MemPool::GetAllTransactions() const {
     return result;
 }
 
-std::vector<Transaction> MemPool::GetTransactionsForMining(size_t maxSize,
-                                                          size_t maxCount) const {
+std::vector<TransactionRef> MemPool::GetTransactionsForMining(size_t maxSize,
+                                                             size_t maxCount) const {
     std::lock_guard<std::mutex> lock(mutex);
 
-    std::vector<Transaction> result;
+    std::vector<TransactionRef> result;
     size_t currentSize = 0;
 
     // Sort by fee rate (descending)
@@ -212,7 +219,10 @@ void MemPool::Clear() {
 
 void MemPool::TrimToSize(size_t targetSize) {
     std::lock_guard<std::mutex> lock(mutex);
+    TrimToSizeInternal(targetSize);
+}
 
+void MemPool::TrimToSizeInternal(size_t targetSize) {
     while (totalSize > targetSize && !feeIndex.empty()) {
         // Remove transaction with lowest fee rate
         auto it = feeIndex.begin();
@@ -239,6 +249,10 @@ void MemPool::TrimToSize(size_t targetSize) {
 
 bool MemPool::IsFull() const {
     std::lock_guard<std::mutex> lock(mutex);
+    return IsFullInternal();
+}
+
+bool MemPool::IsFullInternal() const {
     return totalSize >= MAX_MEMPOOL_SIZE;
 }
 
@@ -349,7 +363,7 @@ bool MemPool::ValidateForMempool(const Transaction& tx, const UTXOSet& utxos,
 
 void MemPool::AddToIndices(const Hash256& txHash, const MemPoolEntry& entry) {
     // Add to input index
-    for (const auto& input : entry.tx.inputs) {
+    for (const auto& input : entry.tx->inputs) {
         if (!input.IsCoinbase()) {
             inputIndex[input.prevOut] = txHash;
         }
@@ -362,7 +376,7 @@ void MemPool::AddToIndices(const Hash256& txHash, const MemPoolEntry& entry) {
 
 void MemPool::RemoveFromIndices(const Hash256& txHash, const MemPoolEntry& entry) {
     // Remove from input index
-    for (const auto& input : entry.tx.inputs) {
+    for (const auto& input : entry.tx->inputs) {
         if (!input.IsCoinbase()) {
             inputIndex.erase(input.prevOut);
         }
@@ -14,11 +14,12 @@ namespace dinari {
 /**
  * @brief Memory pool entry
  *
- * Contains a transaction and metadata about when it was added and its priority.
+ * Contains a shared transaction and metadata about when it was added and
+ * its priority.
  */
 class MemPoolEntry {
 public:
-    Transaction tx;
+    TransactionRef tx;
     Timestamp timeAdded;
     Amount fee;
     size_t size;
@@ -26,11 +27,11 @@ public:
 
     MemPoolEntry() : timeAdded(0), fee(0), size(0), priority(0.0) {}
 
-    MemPoolEntry(const Transaction& transaction, Amount txFee, double txPriority)
+    MemPoolEntry(const TransactionRef& transaction, Amount txFee, double txPriority)
         : tx(transaction)
         , timeAdded(Time::GetCurrentTime())
         , fee(txFee)
-        , size(transaction.GetSize())
+        , size(transaction->GetSize())
         , priority(txPriority) {}
 
     // Get fee rate (fee per byte)
@@ -40,7 +41,7 @@ public:
 
     // Get transaction hash
     Hash256 GetHash() const {
-        return tx.GetHash();
+        return tx->GetHash();
     }
 };
 
@@ -58,12 +59,12 @@ public:
     /**
      * @brief Add transaction to mempool
      *
-     * @param tx Transaction to add
+     * @param tx Transaction to add; the mempool keeps a reference, not a copy
      * @param utxos UTXO set for validation
      * @param currentHeight Current blockchain height
      * @return true if added successfully
      */
-    bool AddTransaction(const Transaction& tx, const class UTXOSet& utxos,
+    bool AddTransaction(const TransactionRef& tx, const class UTXOSet& utxos,
                        BlockHeight currentHeight);
 
     /**
@@ -93,9 +94,10 @@ public:
      * @brief Get transaction from mempool
      *
      * @param txHash Transaction hash
-     * @return Pointer to transaction (nullptr if not found)
+     * @return Shared transaction (nullptr if not found), which stays valid
+     *         after it leaves the mempool
      */
-    const Transaction* GetTransaction(const Hash256& txHash) const;
+    TransactionRef GetTransaction(const Hash256& txHash) const;
 
     /**
      * @brief Get mempool entry
@@ -110,7 +112,7 @@ public:
      *
      * @return Vector of all transactions in mempool
      */
-    std::vector<Transaction> GetAllTransactions() const;
+    std::vector<TransactionRef> GetAllTransactions() const;
 
     /**
      * @brief Get transactions for mining (ordered by priority/fee)
@@ -119,7 +121,7 @@ public:
      * @param maxCount Maximum number of transactions
      * @return Vector of transactions for block template
      */
-    std::vector<Transaction> GetTransactionsForMining(size_t maxSize = MAX_BLOCK_SIZE,
+    std::vector<TransactionRef> GetTransactionsForMining(size_t maxSize = MAX_BLOCK_SIZE,
                                                      size_t maxCount = 10000) const;
 
     /**
@@ -213,6 +215,11 @@ private:
     size_t totalSize;
     Amount totalFees;
 
+    // Bodies of the public methods of the same name, called with mutex held
+    bool HasTransactionInternal(const Hash256& txHash) const;
+    bool IsFullInternal() const;
+    void TrimToSizeInternal(size_t targetSize);
+
     // Helper methods
     void AddToIndices(const Hash256& txHash, const MemPoolEntry& entry);
     void RemoveFromIndices(const Hash256& txHash, const MemPoolEntry& entry);
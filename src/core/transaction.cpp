@@ -44,7 +44,7 @@ bool TxOut::IsDust() const {
 }
 
 size_t TxOut::GetSize() const {
-    Serializer s;
+    Serializer s = Serializer::SizeComputer();
     SerializeImpl(s);
     return s.Size();
 }
@@ -103,7 +103,7 @@ void TxIn::DeserializeImpl(Deserializer& d) {
 }
 
 size_t TxIn::GetSize() const {
-    Serializer s;
+    Serializer s = Serializer::SizeComputer();
     SerializeImpl(s);
     return s.Size();
 }
@@ -149,6 +149,8 @@ void Transaction::SerializeImpl(Serializer& s) const {
 }
 
 void Transaction::DeserializeImpl(Deserializer& d) {
+    size_t start = d.Position();
+
     version = d.ReadUInt32();
 
     uint64_t inputCount = d.ReadCompactSize();
@@ -165,12 +167,20 @@ void Transaction::DeserializeImpl(Deserializer& d) {
 
     lockTime = d.ReadUInt32();
 
-    // Clear cached hash
-    hashCached = false;
+    // The bytes just read are exactly this transaction's serialization,
+    // so hash them in place rather than re-serializing later
+    ByteSpan wire = d.ReadSince(start);
+    cachedHash = crypto::Hash::DoubleSHA256(wire.data(), wire.size());
+    hashCached = true;
+    cachedSize = wire.size();
 }
 
 size_t Transaction::GetSize() const {
-    Serializer s;
+    if (hashCached) {
+        return cachedSize;
+    }
+
+    Serializer s = Serializer::SizeComputer();
     SerializeImpl(s);
     return s.Size();
 }
@@ -180,9 +190,13 @@ Hash256 Transaction::GetHash() const {
         return cachedHash;
     }
 
-    Serializer s;
+    // Size the buffer up front so serialization never reallocates
+    bytes buffer;
+    buffer.reserve(GetSize());
+    Serializer s(buffer);
     SerializeImpl(s);
-    cachedHash = crypto::Hash::DoubleSHA256(s.GetData());
+    cachedHash = crypto::Hash::DoubleSHA256(buffer);
+    cachedSize = buffer.size();
     hashCached = true;
 
     return cachedHash;
@@ -190,36 +204,7 @@ Hash256 Transaction::GetHash() const {
 
 Hash256 Transaction::GetSignatureHash(size_t inputIndex, const bytes& scriptCode,
                                      uint32_t hashType) const {
-    // Create a copy of the transaction for signature hashing
-    Serializer s;
-
-    s.WriteUInt32(version);
-    s.WriteCompactSize(inputs.size());
-
-    for (size_t i = 0; i < inputs.size(); ++i) {
-        // Serialize previous output
-        inputs[i].prevOut.SerializeImpl(s);
-
-        // Only include scriptCode for the input being signed
-        if (i == inputIndex) {
-            s.WriteCompactSize(scriptCode.size());
-            s.WriteBytes(scriptCode);
-        } else {
-            s.WriteCompactSize(0);  // Empty script
-        }
-
-        s.WriteUInt32(inputs[i].sequence);
-    }
-
-    s.WriteCompactSize(outputs.size());
-    for (const auto& output : outputs) {
-        output.SerializeImpl(s);
-    }
-
-    s.WriteUInt32(lockTime);
-    s.WriteUInt32(hashType);  // Append hash type
-
-    return crypto::Hash::DoubleSHA256(s.GetData());
+    return PrecomputedSignatureHash(*this).GetSignatureHash(inputIndex, scriptCode, hashType);
 }
 
 bool Transaction::IsValid() const {
@@ -433,6 +418,62 @@ bool Transaction::operator==(const Transaction& other) const {
     return GetHash() == other.GetHash();
 }
 
+// PrecomputedSignatureHash implementation
+
+PrecomputedSignatureHash::PrecomputedSignatureHash(const Transaction& tx) {
+    Serializer s;
+
+    s.WriteUInt32(tx.version);
+    s.WriteCompactSize(tx.inputs.size());
+
+    scriptOffsets.reserve(tx.inputs.size());
+    for (const auto& input : tx.inputs) {
+        // Serialize previous output
+        input.prevOut.SerializeImpl(s);
+
+        scriptOffsets.push_back(s.GetData().size());
+        s.WriteCompactSize(0);  // Empty script, replaced for the input being signed
+
+        s.WriteUInt32(input.sequence);
+    }
+
+    s.WriteCompactSize(tx.outputs.size());
+    for (const auto& output : tx.outputs) {
+        output.SerializeImpl(s);
+    }
+
+    s.WriteUInt32(tx.lockTime);
+
+    data = s.GetData();
+}
+
+Hash256 PrecomputedSignatureHash::GetSignatureHash(size_t inputIndex, const bytes& scriptCode,
+                                                   uint32_t hashType) const {
+    crypto::SHA256Hasher hasher;
+
+    if (inputIndex < scriptOffsets.size()) {
+        size_t offset = scriptOffsets[inputIndex];
+
+        Serializer script;
+        script.WriteCompactSize(scriptCode.size());
+        script.WriteBytes(scriptCode);
+
+        hasher.Update(data.data(), offset);
+        hasher.Update(script.GetData());
+        hasher.Update(data.data() + offset + 1, data.size() - offset - 1);
+    } else {
+        // Out of range index: every script stays empty
+        hasher.Update(data);
+    }
+
+    Serializer suffix;
+    suffix.WriteUInt32(hashType);  // Append hash type
+    hasher.Update(suffix.GetData());
+
+    Hash256 hash = hasher.Finalize();
+    return crypto::Hash::SHA256(hash.data(), hash.size());
+}
+
 // Helper functions
 
 Amount GetBlockReward(BlockHeight height) {
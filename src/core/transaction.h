@@ -49,7 +49,7 @@ public:
     Hash256 txHash;         // Hash of the transaction containing the output
     TxOutIndex index;       // Index of the output in that transaction
 
-    OutPoint() : index(0xFFFFFFFF) {}
+    OutPoint() : txHash{}, index(0xFFFFFFFF) {}
     OutPoint(const Hash256& hash, TxOutIndex idx) : txHash(hash), index(idx) {}
 
     // Serialization
@@ -127,11 +127,13 @@ public:
     std::vector<TxOut> outputs;     // Transaction outputs
     uint32_t lockTime;              // Lock time (0 = no lock)
 
-    // Cached hash (computed once)
+    // Cached hash and serialized size (computed together once, or taken
+    // from the wire bytes on deserialization; clear hashCached after edits)
     mutable Hash256 cachedHash;
     mutable bool hashCached;
+    mutable size_t cachedSize;      // Valid while hashCached
 
-    Transaction() : version(1), lockTime(0), cachedHash{}, hashCached(false) {}
+    Transaction() : version(1), lockTime(0), cachedHash{}, hashCached(false), cachedSize(0) {}
 
     // Serialization
     void SerializeImpl(Serializer& s) const;
@@ -178,6 +180,43 @@ public:
     bool operator!=(const Transaction& other) const { return !(*this == other); }
 };
 
+/**
+ * @brief Shared, immutable transaction
+ *
+ * Blocks, the mempool and relay messages hold transactions through this
+ * handle so that passing one along copies a pointer instead of the input
+ * and output vectors. The txid and size are filled in before the handle
+ * is shared, so holders on any thread read them without recomputing.
+ */
+using TransactionRef = SharedPtr<const Transaction>;
+
+inline TransactionRef MakeTransactionRef(Transaction tx = Transaction()) {
+    auto ref = std::make_shared<const Transaction>(std::move(tx));
+    ref->GetHash();
+    return ref;
+}
+
+/**
+ * @brief Signature hash data shared by all inputs of one transaction
+ *
+ * Serializes the transaction once with every input script empty. Each
+ * signature hash then splices one input's script code into that buffer
+ * while hashing, giving the same digest as Transaction::GetSignatureHash
+ * without re-serializing the transaction per input. Safe to use from
+ * several threads at once.
+ */
+class PrecomputedSignatureHash {
+public:
+    explicit PrecomputedSignatureHash(const Transaction& tx);
+
+    Hash256 GetSignatureHash(size_t inputIndex, const bytes& scriptCode,
+                             uint32_t hashType = 1) const;
+
+private:
+    bytes data;                         // Serialization with empty scripts, no hash type
+    std::vector<size_t> scriptOffsets;  // Offset of each input's empty script length
+};
+
 /**
  * @brief Create a coinbase transaction
  *
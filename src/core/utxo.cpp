@@ -1,7 +1,10 @@
 #include "utxo.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include <algorithm>
 #include <random>
+#include <limits>
+#include <thread>
 
 namespace dinari {
 
@@ -34,7 +37,7 @@ void UTXOEntry::DeserializeImpl(Deserializer& d) {
 
 // UTXOSet implementation
 
-UTXOSet::UTXOSet() {
+UTXOSet::UTXOSet() : totalValue(0), coinbaseCount(0) {
 }
 
 UTXOSet::~UTXOSet() {
@@ -43,7 +46,12 @@ UTXOSet::~UTXOSet() {
 void UTXOSet::AddUTXO(const OutPoint& outpoint, const UTXOEntry& entry) {
     std::lock_guard<std::mutex> lock(mutex);
 
-    utxos[outpoint] = entry;
+    auto [it, inserted] = utxos.try_emplace(outpoint, entry);
+    if (!inserted) {
+        TrackRemoved(outpoint, it->second);
+        it->second = entry;
+    }
+    TrackAdded(outpoint, entry);
 
     // Update address index
     if (auto addr = ExtractAddressFromScript(entry.output.scriptPubKey)) {
@@ -56,6 +64,28 @@ void UTXOSet::AddUTXO(const OutPoint& outpoint, const TxOut& output,
     AddUTXO(outpoint, UTXOEntry(output, height, isCoinbase));
 }
 
+void UTXOSet::AddUTXOs(const std::vector<std::pair<OutPoint, UTXOEntry>>& entries) {
+    crypto::MuHash3072 entriesHash = HashCoins(entries);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    utxos.reserve(utxos.size() + entries.size());
+    for (const auto& [outpoint, entry] : entries) {
+        auto [it, inserted] = utxos.try_emplace(outpoint, entry);
+        if (!inserted) {
+            TrackRemoved(outpoint, it->second);
+            it->second = entry;
+        }
+        TrackAdded(outpoint, entry, false);
+
+        if (auto addr = ExtractAddressFromScript(entry.output.scriptPubKey)) {
+            addressIndex[*addr].push_back(outpoint);
+        }
+    }
+
+    setHash *= entriesHash;
+}
+
 bool UTXOSet::RemoveUTXO(const OutPoint& outpoint) {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -73,20 +103,35 @@ bool UTXOSet::RemoveUTXO(const OutPoint& outpoint) {
         }
     }
 
+    TrackRemoved(outpoint, it->second);
     utxos.erase(it);
     return true;
 }
 
+namespace {
+
+// Counts a lookup by outcome; the references are resolved once
+bool RecordLookup(bool hit) {
+    static Counter& hits = Metrics::Instance().GetCounter(
+        "dinari_utxo_lookups_total", "UTXO set lookups", "result=\"hit\"");
+    static Counter& misses = Metrics::Instance().GetCounter(
+        "dinari_utxo_lookups_total", "UTXO set lookups", "result=\"miss\"");
+    (hit ? hits : misses).Inc();
+    return hit;
+}
+
+} // namespace
+
 bool UTXOSet::HasUTXO(const OutPoint& outpoint) const {
     std::lock_guard<std::mutex> lock(mutex);
-    return utxos.find(outpoint) != utxos.end();
+    return RecordLookup(utxos.find(outpoint) != utxos.end());
 }
 
 const TxOut* UTXOSet::GetUTXO(const OutPoint& outpoint) const {
     std::lock_guard<std::mutex> lock(mutex);
 
     auto it = utxos.find(outpoint);
-    if (it == utxos.end()) {
+    if (!RecordLookup(it != utxos.end())) {
         return nullptr;
     }
 
@@ -97,7 +142,7 @@ const UTXOEntry* UTXOSet::GetUTXOEntry(const OutPoint& outpoint) const {
     std::lock_guard<std::mutex> lock(mutex);
 
     auto it = utxos.find(outpoint);
-    if (it == utxos.end()) {
+    if (!RecordLookup(it != utxos.end())) {
         return nullptr;
     }
 
@@ -127,6 +172,7 @@ bool UTXOSet::ApplyTransaction(const Transaction& tx, BlockHeight height) {
                          input.prevOut.ToString());
                 return false;
             }
+            TrackRemoved(it->first, it->second);
             utxos.erase(it);
         }
     }
@@ -136,7 +182,12 @@ bool UTXOSet::ApplyTransaction(const Transaction& tx, BlockHeight height) {
     for (size_t i = 0; i < tx.outputs.size(); ++i) {
         OutPoint outpoint(txHash, static_cast<TxOutIndex>(i));
         UTXOEntry entry(tx.outputs[i], height, tx.IsCoinbase());
-        utxos[outpoint] = entry;
+        auto [it, inserted] = utxos.try_emplace(outpoint, entry);
+        if (!inserted) {
+            TrackRemoved(outpoint, it->second);
+            it->second = entry;
+        }
+        TrackAdded(outpoint, entry);
 
         // Update address index
         if (auto addr = ExtractAddressFromScript(tx.outputs[i].scriptPubKey)) {
@@ -155,7 +206,11 @@ bool UTXOSet::RevertTransaction(const Transaction& tx,
     Hash256 txHash = tx.GetHash();
     for (size_t i = 0; i < tx.outputs.size(); ++i) {
         OutPoint outpoint(txHash, static_cast<TxOutIndex>(i));
-        utxos.erase(outpoint);
+        auto it = utxos.find(outpoint);
+        if (it != utxos.end()) {
+            TrackRemoved(outpoint, it->second);
+            utxos.erase(it);
+        }
     }
 
     // Restore inputs that were spent
@@ -163,7 +218,12 @@ bool UTXOSet::RevertTransaction(const Transaction& tx,
         for (const auto& input : tx.inputs) {
             auto it = previousUTXOs.find(input.prevOut);
             if (it != previousUTXOs.end()) {
-                utxos[input.prevOut] = it->second;
+                auto [restored, inserted] = utxos.try_emplace(input.prevOut, it->second);
+                if (!inserted) {
+                    TrackRemoved(input.prevOut, restored->second);
+                    restored->second = it->second;
+                }
+                TrackAdded(input.prevOut, it->second);
             }
         }
     }
@@ -197,18 +257,110 @@ size_t UTXOSet::GetSize() const {
 
 Amount UTXOSet::GetTotalValue() const {
     std::lock_guard<std::mutex> lock(mutex);
+    return totalValue;
+}
 
-    Amount total = 0;
-    for (const auto& [outpoint, entry] : utxos) {
-        total += entry.output.value;
+Hash256 UTXOSet::GetCommitment() const {
+    // The modular inverse runs without the lock
+    return GetSetHash().Finalize();
+}
+
+crypto::MuHash3072 UTXOSet::GetSetHash() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return setHash;
+}
+
+namespace {
+
+// Coins below this many per thread are hashed inline
+constexpr size_t COINS_PER_HASH_THREAD = 4096;
+
+} // namespace
+
+crypto::MuHash3072 UTXOSet::HashCoins(const std::vector<std::pair<OutPoint, UTXOEntry>>& coins) {
+    auto hashRange = [&coins](size_t begin, size_t end) {
+        crypto::MuHash3072 hash;
+        for (size_t i = begin; i < end; ++i) {
+            hash.Insert(SerializeCoin(coins[i].first, coins[i].second));
+        }
+        return hash;
+    };
+
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                      coins.size() / COINS_PER_HASH_THREAD);
+    if (threads <= 1) {
+        return hashRange(0, coins.size());
+    }
+
+    // Products commute, so each thread hashes a range and the results are combined
+    size_t perThread = (coins.size() + threads - 1) / threads;
+    std::vector<crypto::MuHash3072> partial(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        size_t begin = std::min(coins.size(), t * perThread);
+        size_t end = std::min(coins.size(), begin + perThread);
+        workers.emplace_back([&partial, &hashRange, t, begin, end]() {
+            partial[t] = hashRange(begin, end);
+        });
+    }
+    partial[0] = hashRange(0, std::min(coins.size(), perThread));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t t = 1; t < threads; ++t) {
+        partial[0] *= partial[t];
     }
-    return total;
+    return partial[0];
 }
 
 void UTXOSet::Clear() {
     std::lock_guard<std::mutex> lock(mutex);
     utxos.clear();
     addressIndex.clear();
+    totalValue = 0;
+    coinbaseCount = 0;
+    coinbaseByHeight.clear();
+    setHash = crypto::MuHash3072();
+}
+
+bytes UTXOSet::SerializeCoin(const OutPoint& outpoint, const UTXOEntry& entry) {
+    bytes data;
+    data.reserve(32 + 4 + entry.output.GetSize() + 4 + 1);
+    Serializer s(data);
+    outpoint.SerializeImpl(s);
+    entry.SerializeImpl(s);
+    return data;
+}
+
+void UTXOSet::TrackAdded(const OutPoint& outpoint, const UTXOEntry& entry, bool hash) {
+    totalValue += entry.output.value;
+    if (entry.isCoinbase) {
+        coinbaseCount++;
+        coinbaseByHeight[entry.height]++;
+    }
+    if (hash) {
+        setHash.Insert(SerializeCoin(outpoint, entry));
+    }
+}
+
+void UTXOSet::TrackRemoved(const OutPoint& outpoint, const UTXOEntry& entry) {
+    totalValue -= entry.output.value;
+    if (entry.isCoinbase) {
+        coinbaseCount--;
+        auto it = coinbaseByHeight.find(entry.height);
+        if (it != coinbaseByHeight.end() && --it->second == 0) {
+            coinbaseByHeight.erase(it);
+        }
+    }
+    setHash.Remove(SerializeCoin(outpoint, entry));
+}
+
+std::vector<std::pair<OutPoint, UTXOEntry>> UTXOSet::GetAllUTXOs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<std::pair<OutPoint, UTXOEntry>>(utxos.begin(), utxos.end());
 }
 
 bool UTXOSet::Flush() {
@@ -228,32 +380,22 @@ UTXOSet::Stats UTXOSet::GetStats(BlockHeight currentHeight) const {
 
     Stats stats{};
     stats.totalUTXOs = utxos.size();
-
-    for (const auto& [outpoint, entry] : utxos) {
-        stats.totalValue += entry.output.value;
-
-        if (entry.isCoinbase) {
-            stats.coinbaseUTXOs++;
-        } else {
-            stats.regularUTXOs++;
-        }
-
-        if (entry.IsMature(currentHeight)) {
-            stats.matureUTXOs++;
-        } else {
-            stats.immatureUTXOs++;
-        }
+    stats.totalValue = totalValue;
+    stats.coinbaseUTXOs = coinbaseCount;
+    stats.regularUTXOs = utxos.size() - coinbaseCount;
+
+    // Only coinbases from the last COINBASE_MATURITY heights are immature
+    BlockHeight firstImmature = currentHeight >= COINBASE_MATURITY ?
+        currentHeight - COINBASE_MATURITY + 1 : 0;
+    for (auto it = coinbaseByHeight.lower_bound(firstImmature);
+         it != coinbaseByHeight.end() && it->first <= currentHeight; ++it) {
+        stats.immatureUTXOs += it->second;
     }
+    stats.matureUTXOs = utxos.size() - stats.immatureUTXOs;
 
     return stats;
 }
 
-void UTXOSet::Prune(BlockHeight keepDepth [[maybe_unused]]) {
-    // Note: UTXO pruning can be implemented for optimization after initial deployment
-    // This would typically be used in a pruned node
-    LOG_INFO("UTXO", "Pruning UTXO set (not yet implemented)");
-}
-
 bool UTXOSet::ValidateTransaction(const Transaction& tx, BlockHeight currentHeight) const {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -428,7 +570,10 @@ UTXOCache::CacheStats UTXOCache::GetStats() const {
 
 // CoinSelector implementation
 
-CoinSelector::CoinSelector(const UTXOSet& utxos) : utxos(utxos) {
+CoinSelector::CoinSelector() : utxos(nullptr) {
+}
+
+CoinSelector::CoinSelector(const UTXOSet& utxos) : utxos(&utxos) {
 }
 
 CoinSelector::SelectionResult CoinSelector::SelectCoins(
@@ -436,20 +581,52 @@ CoinSelector::SelectionResult CoinSelector::SelectCoins(
     const std::vector<OutPoint>& availableCoins,
     Strategy strategy) {
 
+    std::vector<Candidate> candidates;
+
+    if (utxos) {
+        // Look each coin up once; selection works on the cached values
+        candidates.reserve(availableCoins.size());
+        for (const auto& outpoint : availableCoins) {
+            const TxOut* utxo = utxos->GetUTXO(outpoint);
+            if (utxo) {
+                candidates.push_back(MakeCandidate(outpoint, *utxo, feeRate));
+            }
+        }
+    }
+
+    return SelectCoins(targetAmount, feeRate, std::move(candidates), strategy);
+}
+
+CoinSelector::SelectionResult CoinSelector::SelectCoins(
+    Amount targetAmount, Amount feeRate,
+    std::vector<Candidate> candidates,
+    Strategy strategy, size_t numOutputs) {
+
     switch (strategy) {
         case Strategy::LARGEST_FIRST:
-            return SelectLargestFirst(targetAmount, feeRate, availableCoins);
+            return SelectLargestFirst(targetAmount, feeRate, std::move(candidates), numOutputs);
         case Strategy::SMALLEST_FIRST:
-            return SelectSmallestFirst(targetAmount, feeRate, availableCoins);
+            return SelectSmallestFirst(targetAmount, feeRate, std::move(candidates), numOutputs);
         case Strategy::RANDOM:
-            return SelectRandom(targetAmount, feeRate, availableCoins);
+            return SelectRandom(targetAmount, feeRate, std::move(candidates), numOutputs);
         case Strategy::BRANCH_AND_BOUND:
-            return SelectBranchAndBound(targetAmount, feeRate, availableCoins);
+            return SelectBranchAndBound(targetAmount, feeRate, std::move(candidates), numOutputs);
         default:
             return SelectionResult{};
     }
 }
 
+CoinSelector::Candidate CoinSelector::MakeCandidate(const OutPoint& outpoint,
+                                                    const TxOut& output, Amount feeRate) {
+    Candidate candidate;
+    candidate.outpoint = outpoint;
+    candidate.value = output.value;
+    candidate.inputSize = INPUT_SIZE;
+    candidate.effectiveValue = static_cast<int64_t>(output.value) -
+                               static_cast<int64_t>(CalculateFee(INPUT_SIZE, feeRate));
+    return candidate;
+}
+
 Amount CoinSelector::CalculateFee(size_t txSize, Amount feeRate) {
     return (txSize * feeRate) / 1000;  // feeRate is per KB
 }
@@ -463,36 +640,25 @@ size_t CoinSelector::EstimateTransactionSize(size_t numInputs, size_t numOutputs
     // Each output: ~34 bytes (value + scriptPubKey)
     // LockTime: 4 bytes
 
-    return 10 + (numInputs * 148) + (numOutputs * 34);
+    return 10 + (numInputs * INPUT_SIZE) + (numOutputs * OUTPUT_SIZE);
 }
 
-CoinSelector::SelectionResult CoinSelector::SelectLargestFirst(
-    Amount target, Amount feeRate, std::vector<OutPoint> coins) {
+CoinSelector::SelectionResult CoinSelector::SelectInOrder(
+    Amount target, Amount feeRate, const std::vector<Candidate>& coins, size_t numOutputs) {
 
     SelectionResult result;
-    result.success = false;
-
-    // Sort coins by value (largest first)
-    std::sort(coins.begin(), coins.end(),
-        [this](const OutPoint& a, const OutPoint& b) {
-            const TxOut* utxoA = utxos.GetUTXO(a);
-            const TxOut* utxoB = utxos.GetUTXO(b);
-            if (!utxoA || !utxoB) return false;
-            return utxoA->value > utxoB->value;
-        });
 
     Amount total = 0;
-    size_t numOutputs = 2;  // Assume payment + change
+    size_t inputSize = 0;
+    size_t outputCount = numOutputs + 1;  // Payments + change
 
     for (const auto& coin : coins) {
-        const TxOut* utxo = utxos.GetUTXO(coin);
-        if (!utxo) continue;
-
-        result.selected.push_back(coin);
-        total += utxo->value;
+        result.selected.push_back(coin.outpoint);
+        total += coin.value;
+        inputSize += coin.inputSize;
 
         // Calculate fee
-        size_t txSize = EstimateTransactionSize(result.selected.size(), numOutputs);
+        size_t txSize = EstimateTransactionSize(0, outputCount) + inputSize;
         Amount fee = CalculateFee(txSize, feeRate);
 
         // Check if we have enough
@@ -505,42 +671,158 @@ CoinSelector::SelectionResult CoinSelector::SelectLargestFirst(
         }
     }
 
+    result.selected.clear();
     result.error = "Insufficient funds";
     return result;
 }
 
+CoinSelector::SelectionResult CoinSelector::SelectLargestFirst(
+    Amount target, Amount feeRate, std::vector<Candidate> coins, size_t numOutputs) {
+
+    // Sort coins by value (largest first)
+    std::sort(coins.begin(), coins.end(),
+        [](const Candidate& a, const Candidate& b) {
+            return a.value > b.value;
+        });
+
+    return SelectInOrder(target, feeRate, coins, numOutputs);
+}
+
 CoinSelector::SelectionResult CoinSelector::SelectSmallestFirst(
-    Amount target, Amount feeRate, std::vector<OutPoint> coins) {
+    Amount target, Amount feeRate, std::vector<Candidate> coins, size_t numOutputs) {
 
     // Sort coins by value (smallest first)
     std::sort(coins.begin(), coins.end(),
-        [this](const OutPoint& a, const OutPoint& b) {
-            const TxOut* utxoA = utxos.GetUTXO(a);
-            const TxOut* utxoB = utxos.GetUTXO(b);
-            if (!utxoA || !utxoB) return false;
-            return utxoA->value < utxoB->value;
+        [](const Candidate& a, const Candidate& b) {
+            return a.value < b.value;
         });
 
-    return SelectLargestFirst(target, feeRate, coins);  // Same logic after sorting
+    return SelectInOrder(target, feeRate, coins, numOutputs);
 }
 
 CoinSelector::SelectionResult CoinSelector::SelectRandom(
-    Amount target, Amount feeRate, std::vector<OutPoint> coins) {
+    Amount target, Amount feeRate, std::vector<Candidate> coins, size_t numOutputs) {
+
+    // Single random draw: skip coins that cost more to spend than they are worth
+    coins.erase(std::remove_if(coins.begin(), coins.end(),
+                               [](const Candidate& c) { return c.effectiveValue <= 0; }),
+                coins.end());
 
     // Shuffle coins randomly
     std::random_device rd;
     std::mt19937 g(rd());
     std::shuffle(coins.begin(), coins.end(), g);
 
-    return SelectLargestFirst(target, feeRate, coins);  // Same logic after shuffling
+    return SelectInOrder(target, feeRate, coins, numOutputs);
 }
 
 CoinSelector::SelectionResult CoinSelector::SelectBranchAndBound(
-    Amount target, Amount feeRate, std::vector<OutPoint> coins) {
-    // Note: Branch and Bound coin selection algorithm can be added for optimization
-    // For now, fall back to largest first
-    LOG_WARNING("CoinSelector", "Branch and Bound not implemented, using Largest First");
-    return SelectLargestFirst(target, feeRate, coins);
+    Amount target, Amount feeRate, std::vector<Candidate> coins, size_t numOutputs) {
+
+    // Only coins worth more than the fee to spend them can help
+    std::vector<Candidate> pool;
+    pool.reserve(coins.size());
+    for (const auto& coin : coins) {
+        if (coin.effectiveValue > 0) {
+            pool.push_back(coin);
+        }
+    }
+
+    // Explore largest effective values first
+    std::sort(pool.begin(), pool.end(),
+        [](const Candidate& a, const Candidate& b) {
+            return a.effectiveValue > b.effectiveValue;
+        });
+
+    // A changeless transaction must cover the payments plus the non-input fee;
+    // anything above that up to the cost of creating and later spending a
+    // change output is cheaper to drop into the fee
+    int64_t selectionTarget = static_cast<int64_t>(target) +
+        static_cast<int64_t>(CalculateFee(EstimateTransactionSize(0, numOutputs), feeRate));
+    int64_t costOfChange = static_cast<int64_t>(CalculateFee(OUTPUT_SIZE + INPUT_SIZE, feeRate));
+
+    int64_t available = 0;
+    for (const auto& coin : pool) {
+        available += coin.effectiveValue;
+    }
+
+    std::vector<size_t> current;
+    std::vector<size_t> best;
+    int64_t currentValue = 0;
+    int64_t bestExcess = std::numeric_limits<int64_t>::max();
+
+    if (available >= selectionTarget) {
+        size_t index = 0;
+        for (size_t tries = 0; tries < BNB_MAX_TRIES; ++tries, ++index) {
+            bool backtrack = false;
+
+            if (currentValue + available < selectionTarget ||
+                currentValue > selectionTarget + costOfChange) {
+                // Cannot reach the target, or already overshot it
+                backtrack = true;
+            } else if (currentValue >= selectionTarget) {
+                int64_t excess = currentValue - selectionTarget;
+                if (excess < bestExcess) {
+                    best = current;
+                    bestExcess = excess;
+                    if (excess == 0) {
+                        break;
+                    }
+                }
+                backtrack = true;
+            }
+
+            if (backtrack) {
+                if (current.empty()) {
+                    break;  // Search space exhausted
+                }
+
+                // Return coins skipped after the last inclusion to the lookahead
+                for (--index; index > current.back(); --index) {
+                    available += pool[index].effectiveValue;
+                }
+
+                // Try the branch that omits the last included coin
+                currentValue -= pool[index].effectiveValue;
+                current.pop_back();
+            } else {
+                const Candidate& coin = pool[index];
+                available -= coin.effectiveValue;
+
+                // Including a coin equal to one just omitted repeats an explored branch
+                if (current.empty() || index - 1 == current.back() ||
+                    coin.effectiveValue != pool[index - 1].effectiveValue) {
+                    current.push_back(index);
+                    currentValue += coin.effectiveValue;
+                }
+            }
+        }
+    }
+
+    if (!best.empty()) {
+        SelectionResult result;
+        for (size_t i : best) {
+            result.selected.push_back(pool[i].outpoint);
+            result.totalValue += pool[i].value;
+        }
+        // Changeless: the excess goes to the fee
+        result.fee = result.totalValue - target;
+        result.change = 0;
+        result.success = true;
+        return result;
+    }
+
+    // No changeless solution: fall back to single random draw and largest
+    // first, keeping whichever pays the lower fee
+    LOG_DEBUG("CoinSelector", "No changeless solution found, using fallback selection");
+
+    SelectionResult random = SelectRandom(target, feeRate, coins, numOutputs);
+    SelectionResult largest = SelectLargestFirst(target, feeRate, std::move(coins), numOutputs);
+
+    if (random.success && (!largest.success || random.fee <= largest.fee)) {
+        return random;
+    }
+    return largest;
 }
 
 } // namespace dinari
@@ -3,6 +3,7 @@
 
 #include "dinari/types.h"
 #include "transaction.h"
+#include "crypto/muhash.h"
 #include <map>
 #include <optional>
 #include <unordered_map>
@@ -44,6 +45,9 @@ public:
  * Maintains the set of all unspent transaction outputs in the blockchain.
  * This is the core data structure that determines which outputs can be spent.
  *
+ * Totals, the coinbase split and a MuHash of every coin are updated with
+ * each change, so statistics and the set commitment never scan the set.
+ *
  * Thread-safe for concurrent read/write access.
  */
 class UTXOSet {
@@ -56,6 +60,9 @@ public:
     void AddUTXO(const OutPoint& outpoint, const TxOut& output,
                 BlockHeight height, bool isCoinbase);
 
+    // Add many UTXOs under one lock (snapshot loading); hashed in parallel first
+    void AddUTXOs(const std::vector<std::pair<OutPoint, UTXOEntry>>& entries);
+
     // Remove a UTXO (when spent)
     bool RemoveUTXO(const OutPoint& outpoint);
 
@@ -86,9 +93,21 @@ public:
     // Get total value of all UTXOs
     Amount GetTotalValue() const;
 
+    // SHA-256 of the MuHash of every coin; equal sets give equal commitments
+    Hash256 GetCommitment() const;
+
+    // Copy of the running MuHash, for callers that finalize it later
+    crypto::MuHash3072 GetSetHash() const;
+
+    // MuHash of a list of coins, hashed on several threads for large lists
+    static crypto::MuHash3072 HashCoins(const std::vector<std::pair<OutPoint, UTXOEntry>>& coins);
+
     // Clear all UTXOs
     void Clear();
 
+    // Copy of every UTXO (snapshot writing)
+    std::vector<std::pair<OutPoint, UTXOEntry>> GetAllUTXOs() const;
+
     // Flush to disk (if using persistent storage)
     bool Flush();
 
@@ -106,9 +125,6 @@ public:
     };
     Stats GetStats(BlockHeight currentHeight) const;
 
-    // Memory management
-    void Prune(BlockHeight keepDepth);  // Remove old spent UTXOs from cache
-
     // Validation
     bool ValidateTransaction(const Transaction& tx, BlockHeight currentHeight) const;
 
@@ -119,10 +135,19 @@ private:
     // Address index (optional, for wallet queries)
     std::unordered_map<Hash160, std::vector<OutPoint>> addressIndex;
 
+    // Running totals, kept in step with utxos
+    Amount totalValue;
+    size_t coinbaseCount;
+    std::map<BlockHeight, size_t> coinbaseByHeight;  // For the maturity split
+    crypto::MuHash3072 setHash;
+
     // Thread safety
     mutable std::mutex mutex;
 
     // Helper methods
+    void TrackAdded(const OutPoint& outpoint, const UTXOEntry& entry, bool hash = true);
+    void TrackRemoved(const OutPoint& outpoint, const UTXOEntry& entry);
+    static bytes SerializeCoin(const OutPoint& outpoint, const UTXOEntry& entry);
     void BuildAddressIndex();
     std::optional<Hash160> ExtractAddressFromScript(const bytes& script) const;
 };
@@ -170,6 +195,9 @@ private:
  *
  * Selects UTXOs to use as inputs for a transaction.
  * Implements various coin selection strategies.
+ *
+ * Coin values are looked up once and kept in a flat candidate array, so
+ * sorting and searching never go back to the UTXO set.
  */
 class CoinSelector {
 public:
@@ -187,8 +215,28 @@ public:
         Amount change;
         bool success;
         std::string error;
+
+        SelectionResult() : totalValue(0), fee(0), change(0), success(false) {}
+    };
+
+    /**
+     * @brief Precomputed selection candidate
+     */
+    struct Candidate {
+        OutPoint outpoint;
+        Amount value;           // Output value
+        int64_t effectiveValue; // Value minus the fee to spend it
+        size_t inputSize;       // Estimated input size in bytes
     };
 
+    // Maximum number of branch and bound search steps
+    static constexpr size_t BNB_MAX_TRIES = 100000;
+
+    // Estimated size of a P2PKH input and output
+    static constexpr size_t INPUT_SIZE = 148;
+    static constexpr size_t OUTPUT_SIZE = 34;
+
+    CoinSelector();
     CoinSelector(const UTXOSet& utxos);
 
     // Select coins for a given target amount
@@ -196,24 +244,37 @@ public:
                                const std::vector<OutPoint>& availableCoins,
                                Strategy strategy = Strategy::BRANCH_AND_BOUND);
 
+    // Select coins from precomputed candidates (no UTXO set access)
+    SelectionResult SelectCoins(Amount targetAmount, Amount feeRate,
+                               std::vector<Candidate> candidates,
+                               Strategy strategy = Strategy::BRANCH_AND_BOUND,
+                               size_t numOutputs = 1);
+
+    // Build a candidate for an output
+    static Candidate MakeCandidate(const OutPoint& outpoint, const TxOut& output, Amount feeRate);
+
     // Calculate fee for transaction
-    Amount CalculateFee(size_t txSize, Amount feeRate);
+    static Amount CalculateFee(size_t txSize, Amount feeRate);
 
     // Estimate transaction size
-    size_t EstimateTransactionSize(size_t numInputs, size_t numOutputs);
+    static size_t EstimateTransactionSize(size_t numInputs, size_t numOutputs);
 
 private:
-    const UTXOSet& utxos;
+    const UTXOSet* utxos;
 
     // Selection strategies
     SelectionResult SelectLargestFirst(Amount target, Amount feeRate,
-                                      std::vector<OutPoint> coins);
+                                      std::vector<Candidate> coins, size_t numOutputs);
     SelectionResult SelectSmallestFirst(Amount target, Amount feeRate,
-                                       std::vector<OutPoint> coins);
+                                       std::vector<Candidate> coins, size_t numOutputs);
     SelectionResult SelectRandom(Amount target, Amount feeRate,
-                                std::vector<OutPoint> coins);
+                                std::vector<Candidate> coins, size_t numOutputs);
     SelectionResult SelectBranchAndBound(Amount target, Amount feeRate,
-                                        std::vector<OutPoint> coins);
+                                        std::vector<Candidate> coins, size_t numOutputs);
+
+    // Accumulate coins in the given order until target plus fee is covered
+    SelectionResult SelectInOrder(Amount target, Amount feeRate,
+                                  const std::vector<Candidate>& coins, size_t numOutputs);
 };
 
 } // namespace dinari
@@ -2,7 +2,9 @@
 #include "hash.h"
 #include "dinari/constants.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <vector>
 
 namespace dinari {
 namespace crypto {
@@ -30,90 +32,189 @@ const int8_t Base58::MAP[256] = {
     -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
 };
 
-std::string Base58::Encode(const bytes& data) {
-    if (data.empty()) {
-        return "";
+// The codec converts between bytes and base 58 via an intermediate big
+// number held in fixed-width limbs. Encoding folds in 32 bits of input at a
+// time and keeps base 58^5 limbs, each of which is later written out as five
+// digits; decoding folds in five digits at a time and keeps base 2^32 limbs.
+// That cuts the quadratic digit-by-byte work of the textbook algorithm by
+// roughly twenty times.
+
+namespace {
+
+static_assert(dinari::crypto::Base58::MAX_ADDRESS_LENGTH ==
+              dinari::crypto::Base58::MaxEncodedSize(25), "address buffer size");
+
+constexpr uint32_t BASE58_POW[6] = {1, 58, 3364, 195112, 11316496, 656356768};
+constexpr uint64_t LIMB_BASE = BASE58_POW[5];  // 58^5 < 2^30
+
+/**
+ * @brief Limb scratch space, on the stack unless the input is large
+ */
+class LimbBuffer {
+public:
+    explicit LimbBuffer(size_t count) {
+        if (count > stack.size()) {
+            heap.resize(count);
+            limbs = heap.data();
+        } else {
+            limbs = stack.data();
+        }
     }
 
-    // Count leading zeros
+    uint32_t& operator[](size_t i) { return limbs[i]; }
+
+private:
+    std::array<uint32_t, 128> stack;
+    std::vector<uint32_t> heap;
+    uint32_t* limbs;
+};
+
+} // namespace
+
+size_t Base58::Encode(char* out, const byte* data, size_t len) {
     size_t leadingZeros = 0;
-    while (leadingZeros < data.size() && data[leadingZeros] == 0) {
+    while (leadingZeros < len && data[leadingZeros] == 0) {
         ++leadingZeros;
     }
-
-    // Allocate enough space for result
-    size_t size = (data.size() - leadingZeros) * 138 / 100 + 1;
-    std::vector<byte> b58(size);
-
-    // Process the bytes
-    for (size_t i = leadingZeros; i < data.size(); ++i) {
-        int carry = data[i];
-        for (auto it = b58.rbegin(); it != b58.rend(); ++it) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
+    data += leadingZeros;
+    len -= leadingZeros;
+
+    // Each limb holds log2(58^5) > 29 bits
+    LimbBuffer limbs(len * 8 / 29 + 2);
+    size_t used = 0;
+
+    for (size_t pos = 0; pos < len;) {
+        // A partial word first, so the rest are whole 32-bit words
+        size_t take = (pos == 0 && len % 4 != 0) ? len % 4 : 4;
+        uint64_t carry = 0;
+        for (size_t k = 0; k < take; ++k) {
+            carry = (carry << 8) | data[pos + k];
         }
-    }
+        pos += take;
 
-    // Skip leading zeros in b58
-    auto it = b58.begin();
-    while (it != b58.end() && *it == 0) {
-        ++it;
+        const unsigned shift = static_cast<unsigned>(8 * take);
+        for (size_t i = 0; i < used; ++i) {
+            uint64_t value = (static_cast<uint64_t>(limbs[i]) << shift) + carry;
+            limbs[i] = static_cast<uint32_t>(value % LIMB_BASE);
+            carry = value / LIMB_BASE;
+        }
+        while (carry != 0) {
+            limbs[used++] = static_cast<uint32_t>(carry % LIMB_BASE);
+            carry /= LIMB_BASE;
+        }
     }
 
-    // Translate to Base58 alphabet
-    std::string result;
-    result.reserve(leadingZeros + (b58.end() - it));
-    result.assign(leadingZeros, '1');  // Leading zeros become '1'
+    // Leading zero bytes become '1's
+    char* o = out;
+    std::memset(o, '1', leadingZeros);
+    o += leadingZeros;
+
+    if (used > 0) {
+        // Most significant limb without its leading zero digits
+        char digits[5];
+        size_t count = 0;
+        for (uint32_t top = limbs[used - 1]; top != 0; top /= 58) {
+            digits[count++] = ALPHABET[top % 58];
+        }
+        while (count > 0) {
+            *o++ = digits[--count];
+        }
 
-    while (it != b58.end()) {
-        result += ALPHABET[*(it++)];
+        for (size_t i = used - 1; i-- > 0;) {
+            uint32_t limb = limbs[i];
+            for (int k = 4; k >= 0; --k) {
+                o[k] = ALPHABET[limb % 58];
+                limb /= 58;
+            }
+            o += 5;
+        }
     }
 
+    return static_cast<size_t>(o - out);
+}
+
+std::string Base58::Encode(const bytes& data) {
+    std::string result(MaxEncodedSize(data.size()), '\0');
+    result.resize(Encode(&result[0], data.data(), data.size()));
     return result;
 }
 
-bytes Base58::Decode(const std::string& encoded) {
-    if (encoded.empty()) {
-        return bytes();
-    }
+bool Base58::Decode(byte* out, size_t& outLen, const char* encoded, size_t len) {
+    outLen = 0;
 
-    // Count leading '1's
     size_t leadingOnes = 0;
-    while (leadingOnes < encoded.size() && encoded[leadingOnes] == '1') {
+    while (leadingOnes < len && encoded[leadingOnes] == '1') {
         ++leadingOnes;
     }
-
-    // Allocate enough space
-    size_t size = encoded.size() * 733 / 1000 + 1;
-    std::vector<byte> b256(size);
-
-    // Process characters
-    for (size_t i = leadingOnes; i < encoded.size(); ++i) {
-        int carry = MAP[static_cast<byte>(encoded[i])];
-        if (carry == -1) {
-            return bytes();  // Invalid character
+    encoded += leadingOnes;
+    len -= leadingOnes;
+
+    // Each digit holds log2(58) < 6 bits
+    LimbBuffer limbs(len * 6 / 32 + 2);
+    size_t used = 0;
+
+    for (size_t pos = 0; pos < len;) {
+        // A partial group first, so the rest are whole groups of five
+        size_t take = (pos == 0 && len % 5 != 0) ? len % 5 : 5;
+        uint64_t carry = 0;
+        for (size_t k = 0; k < take; ++k) {
+            int8_t digit = MAP[static_cast<byte>(encoded[pos + k])];
+            if (digit < 0) {
+                return false;
+            }
+            carry = carry * 58 + static_cast<uint64_t>(digit);
         }
+        pos += take;
 
-        for (auto it = b256.rbegin(); it != b256.rend(); ++it) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
+        const uint64_t multiplier = BASE58_POW[take];
+        for (size_t i = 0; i < used; ++i) {
+            uint64_t value = static_cast<uint64_t>(limbs[i]) * multiplier + carry;
+            limbs[i] = static_cast<uint32_t>(value);
+            carry = value >> 32;
+        }
+        while (carry != 0) {
+            limbs[used++] = static_cast<uint32_t>(carry);
+            carry >>= 32;
         }
     }
 
-    // Skip leading zeros
-    auto it = b256.begin();
-    while (it != b256.end() && *it == 0) {
-        ++it;
+    // Leading '1's become zero bytes
+    byte* o = out;
+    std::memset(o, 0, leadingOnes);
+    o += leadingOnes;
+
+    if (used > 0) {
+        // Most significant limb without its leading zero bytes
+        uint32_t top = limbs[used - 1];
+        int shift = 24;
+        while (shift > 0 && (top >> shift) == 0) {
+            shift -= 8;
+        }
+        for (; shift >= 0; shift -= 8) {
+            *o++ = static_cast<byte>(top >> shift);
+        }
+
+        for (size_t i = used - 1; i-- > 0;) {
+            uint32_t limb = limbs[i];
+            o[0] = static_cast<byte>(limb >> 24);
+            o[1] = static_cast<byte>(limb >> 16);
+            o[2] = static_cast<byte>(limb >> 8);
+            o[3] = static_cast<byte>(limb);
+            o += 4;
+        }
     }
 
-    // Create result with leading zeros
-    bytes result;
-    result.reserve(leadingOnes + (b256.end() - it));
-    result.assign(leadingOnes, 0);
-    result.insert(result.end(), it, b256.end());
+    outLen = static_cast<size_t>(o - out);
+    return true;
+}
 
+bytes Base58::Decode(const std::string& encoded) {
+    bytes result(encoded.size());
+    size_t length = 0;
+    if (!Decode(result.data(), length, encoded.data(), encoded.size())) {
+        return bytes();  // Invalid character
+    }
+    result.resize(length);
     return result;
 }
 
@@ -149,26 +250,41 @@ bool Base58::DecodeCheck(const std::string& encoded, bytes& result) {
     return true;
 }
 
+size_t Base58::EncodeAddress(char* out, const Hash160& hash, byte version) {
+    byte payload[25];
+    payload[0] = version;
+    std::memcpy(payload + 1, hash.data(), hash.size());
+
+    Hash256 checksum = Hash::DoubleSHA256(payload, 21);
+    std::memcpy(payload + 21, checksum.data(), 4);
+
+    return Encode(out, payload, sizeof(payload));
+}
+
 std::string Base58::EncodeAddress(const Hash160& hash, byte version) {
-    bytes data;
-    data.reserve(21);
-    data.push_back(version);
-    data.insert(data.end(), hash.begin(), hash.end());
-    return EncodeCheck(data);
+    char buffer[MAX_ADDRESS_LENGTH];
+    return std::string(buffer, EncodeAddress(buffer, hash, version));
 }
 
 bool Base58::DecodeAddress(const std::string& address, Hash160& hash, byte& version) {
-    bytes decoded;
-    if (!DecodeCheck(address, decoded)) {
+    // No 25-byte payload encodes to more than MAX_ADDRESS_LENGTH characters
+    if (address.size() > MAX_ADDRESS_LENGTH) {
+        return false;
+    }
+
+    byte payload[MAX_ADDRESS_LENGTH];
+    size_t length = 0;
+    if (!Decode(payload, length, address.data(), address.size()) || length != 25) {
         return false;
     }
 
-    if (decoded.size() != 21) {
+    Hash256 checksum = Hash::DoubleSHA256(payload, 21);
+    if (std::memcmp(checksum.data(), payload + 21, 4) != 0) {
         return false;
     }
 
-    version = decoded[0];
-    std::copy(decoded.begin() + 1, decoded.end(), hash.begin());
+    version = payload[0];
+    std::memcpy(hash.data(), payload + 1, hash.size());
     return true;
 }
 
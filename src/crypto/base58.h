@@ -26,6 +26,18 @@ public:
      */
     static std::string Encode(const bytes& data);
 
+    /**
+     * @brief Upper bound on Encode() output length for `len` input bytes
+     */
+    static constexpr size_t MaxEncodedSize(size_t len) { return len * 138 / 100 + 1; }
+
+    /**
+     * @brief Encode data into a caller buffer
+     * @param out Buffer of at least MaxEncodedSize(len) characters
+     * @return Characters written (no terminator)
+     */
+    static size_t Encode(char* out, const byte* data, size_t len);
+
     /**
      * @brief Decode Base58 string
      * @param encoded Base58 encoded string
@@ -33,6 +45,14 @@ public:
      */
     static bytes Decode(const std::string& encoded);
 
+    /**
+     * @brief Decode into a caller buffer
+     * @param out Buffer of at least `len` bytes (decoding never grows)
+     * @param outLen Bytes written
+     * @return false on a non-Base58 character
+     */
+    static bool Decode(byte* out, size_t& outLen, const char* encoded, size_t len);
+
     /**
      * @brief Encode data with checksum (Base58Check)
      * @param data Data to encode
@@ -57,6 +77,16 @@ public:
      */
     static std::string EncodeAddress(const Hash160& hash, byte version);
 
+    /**
+     * @brief Encode address into a caller buffer
+     * @param out Buffer of at least MAX_ADDRESS_LENGTH characters
+     * @return Characters written (no terminator)
+     */
+    static size_t EncodeAddress(char* out, const Hash160& hash, byte version);
+
+    // Longest encoding of a version byte, 20-byte hash and 4-byte checksum
+    static constexpr size_t MAX_ADDRESS_LENGTH = 35;  // MaxEncodedSize(25)
+
     /**
      * @brief Decode Dinari address
      * @param address Address string
@@ -85,15 +85,16 @@ bytes ECDSA::GetPublicKey(const Hash256& privkey, bool compressed) {
         EC_KEY_free(key);
         throw std::runtime_error("Failed to set private key");
     }
-    BN_free(bn_privkey);
 
     // Compute public key
     EC_POINT* pub_key = EC_POINT_new(secp256k1_group);
     if (!EC_POINT_mul(secp256k1_group, pub_key, bn_privkey, nullptr, nullptr, nullptr)) {
+        BN_free(bn_privkey);
         EC_POINT_free(pub_key);
         EC_KEY_free(key);
         throw std::runtime_error("Failed to compute public key");
     }
+    BN_free(bn_privkey);
 
     EC_KEY_set_public_key(key, pub_key);
 
@@ -399,11 +400,12 @@ Hash256 ECDSA::PrivKeyAdd(const Hash256& key1, const Hash256& key2) {
     BIGNUM* bn_key2 = BN_bin2bn(key2.data(), 32, nullptr);
     BIGNUM* bn_order = BN_new();
     BIGNUM* bn_result = BN_new();
+    BN_CTX* ctx = BN_CTX_new();
 
-    EC_GROUP_get_order(secp256k1_group, bn_order, nullptr);
+    EC_GROUP_get_order(secp256k1_group, bn_order, ctx);
 
     // result = (key1 + key2) mod order
-    BN_mod_add(bn_result, bn_key1, bn_key2, bn_order, nullptr);
+    BN_mod_add(bn_result, bn_key1, bn_key2, bn_order, ctx);
 
     Hash256 result;
     BN_bn2binpad(bn_result, result.data(), 32);
@@ -412,6 +414,7 @@ Hash256 ECDSA::PrivKeyAdd(const Hash256& key1, const Hash256& key2) {
     BN_free(bn_key2);
     BN_free(bn_order);
     BN_free(bn_result);
+    BN_CTX_free(ctx);
 
     return result;
 }
@@ -1,4 +1,7 @@
 #include "hash.h"
+#include "hex.h"
+#include "ripemd160.h"
+#include "sha256.h"
 
 // Suppress OpenSSL 3.0 deprecation warnings for now
 // TODO: Migrate to EVP API in future
@@ -13,10 +16,9 @@
 #pragma GCC diagnostic pop
 
 #include <stdexcept>
-#include <sstream>
-#include <iomanip>
 #include <cstring>
 #include <algorithm>
+#include <thread>
 #include <boost/multiprecision/cpp_int.hpp>
 
 namespace {
@@ -45,6 +47,41 @@ const uint256_t& MaxUint256() {
     static const uint256_t max = (uint256_t(1) << 256) - 1;
     return max;
 }
+
+static_assert(sizeof(dinari::Hash256) == 32, "merkle levels are hashed as packed 64-byte pairs");
+
+// Messages padded per batch call to the multi-lane one-block kernels
+constexpr size_t HASH_BATCH = 64;
+
+// SHA-256 of count (<= HASH_BATCH) messages; one-block messages share lanes
+void SHA256Batch(dinari::Hash256* digests, const dinari::bytes* inputs, size_t count) {
+    using dinari::crypto::SHA256Context;
+    unsigned char blocks[HASH_BATCH * 64];
+    unsigned char hashes[HASH_BATCH * 32];
+    size_t slots[HASH_BATCH];
+    size_t pending = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (inputs[i].size() <= SHA256Context::MAX_ONE_BLOCK) {
+            SHA256Context::PadOneBlock(blocks + 64 * pending, inputs[i].data(), inputs[i].size());
+            slots[pending++] = i;
+        } else {
+            digests[i] = dinari::crypto::Hash::SHA256(inputs[i]);
+        }
+    }
+
+    if (pending == 0) {
+        return;
+    }
+
+    SHA256Context::HashPaddedBlocks(hashes, blocks, pending);
+    for (size_t i = 0; i < pending; ++i) {
+        std::memcpy(digests[slots[i]].data(), hashes + 32 * i, 32);
+    }
+}
+
+// Merkle levels below this many pairs per thread are hashed inline
+constexpr size_t MERKLE_PAIRS_PER_THREAD = 4096;
 } // namespace
 
 namespace dinari {
@@ -61,7 +98,11 @@ Hash256 Hash::SHA256(const std::string& data) {
 
 Hash256 Hash::SHA256(const byte* data, size_t len) {
     Hash256 hash;
-    ::SHA256(data, len, hash.data());
+    if (len <= SHA256Context::MAX_ONE_BLOCK) {
+        SHA256Context::HashOneBlock(hash.data(), data, len);
+    } else {
+        SHA256Context().Write(data, len).Finalize(hash.data());
+    }
     return hash;
 }
 
@@ -71,8 +112,43 @@ Hash256 Hash::DoubleSHA256(const bytes& data) {
 }
 
 Hash256 Hash::DoubleSHA256(const byte* data, size_t len) {
-    Hash256 first = SHA256(data, len);
-    return SHA256(first.data(), first.size());
+    Hash256 hash;
+    if (len == 64) {
+        SHA256Context::DoubleHash64(hash.data(), data);
+    } else if (len <= SHA256Context::MAX_ONE_BLOCK) {
+        SHA256Context::DoubleHashOneBlock(hash.data(), data, len);
+    } else {
+        Hash256 first;
+        SHA256Context().Write(data, len).Finalize(first.data());
+        SHA256Context::HashOneBlock(hash.data(), first.data(), first.size());
+    }
+    return hash;
+}
+
+void Hash::DoubleSHA256_64(byte* output, const byte* input, size_t count) {
+    SHA256Context::DoubleHash64Many(output, input, count);
+}
+
+const char* Hash::DoubleSHA256_64Implementation() {
+    return SHA256Context::LanesImplementation();
+}
+
+void Hash::DoubleSHA256Many(Hash256* output, const bytes* inputs, size_t count) {
+    for (size_t start = 0; start < count; start += HASH_BATCH) {
+        size_t n = std::min(HASH_BATCH, count - start);
+        SHA256Batch(output + start, inputs + start, n);
+
+        // Every first-round digest is a one-block message
+        byte blocks[HASH_BATCH * 64];
+        for (size_t i = 0; i < n; ++i) {
+            SHA256Context::PadOneBlock(blocks + 64 * i, output[start + i].data(), 32);
+        }
+        SHA256Context::HashPaddedBlocks(output[start].data(), blocks, n);
+    }
+}
+
+const char* Hash::SHA256Implementation() {
+    return SHA256Context::Implementation();
 }
 
 // RIPEMD-160 implementations
@@ -82,7 +158,7 @@ Hash160 Hash::RIPEMD160(const bytes& data) {
 
 Hash160 Hash::RIPEMD160(const byte* data, size_t len) {
     Hash160 hash;
-    ::RIPEMD160(data, len, hash.data());
+    RIPEMD160Context().Write(data, len).Finalize(hash.data());
     return hash;
 }
 
@@ -93,26 +169,97 @@ Hash160 Hash::ComputeHash160(const bytes& data) {
 
 Hash160 Hash::ComputeHash160(const byte* data, size_t len) {
     Hash256 sha = SHA256(data, len);
-    return RIPEMD160(sha.data(), sha.size());
+    Hash160 hash;
+    RIPEMD160Context::Hash32(hash.data(), sha.data());
+    return hash;
+}
+
+void Hash::ComputeHash160Many(Hash160* output, const bytes* inputs, size_t count) {
+    Hash256 digests[HASH_BATCH];
+    for (size_t start = 0; start < count; start += HASH_BATCH) {
+        size_t n = std::min(HASH_BATCH, count - start);
+        SHA256Batch(digests, inputs + start, n);
+        for (size_t i = 0; i < n; ++i) {
+            RIPEMD160Context::Hash32(output[start + i].data(), digests[i].data());
+        }
+    }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+bool Hash::SelfTest() {
+    // Lengths 0-200 cover one block, 64 bytes, padding spilling into a
+    // second block and multi-block messages; 150 of them exercise the lanes
+    std::vector<bytes> messages;
+    uint32_t seed = 0x5eed1234;
+    for (size_t len = 0; len <= 200; ++len) {
+        bytes message(len);
+        for (byte& b : message) {
+            seed = seed * 1664525 + 1013904223;
+            b = static_cast<byte>(seed >> 24);
+        }
+        messages.push_back(std::move(message));
+    }
+
+    std::vector<Hash256> doubleHashes(messages.size());
+    std::vector<Hash160> hash160s(messages.size());
+    DoubleSHA256Many(doubleHashes.data(), messages.data(), messages.size());
+    ComputeHash160Many(hash160s.data(), messages.data(), messages.size());
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        const bytes& message = messages[i];
+
+        Hash256 sha;
+        Hash256 sha2;
+        Hash160 ripemd;
+        Hash160 hash160;
+        ::SHA256(message.data(), message.size(), sha.data());
+        ::SHA256(sha.data(), sha.size(), sha2.data());
+        ::RIPEMD160(message.data(), message.size(), ripemd.data());
+        ::RIPEMD160(sha.data(), sha.size(), hash160.data());
+
+        SHA256Hasher hasher;
+        hasher.Update(message.data(), i / 3);
+        hasher.Update(message.data() + i / 3, message.size() - i / 3);
+
+        if (SHA256(message) != sha || hasher.Finalize() != sha ||
+            DoubleSHA256(message) != sha2 || doubleHashes[i] != sha2 ||
+            RIPEMD160(message) != ripemd ||
+            ComputeHash160(message) != hash160 || hash160s[i] != hash160) {
+            return false;
+        }
+    }
+
+    // Enough 64-byte inputs to fill the widest lanes and leave a tail
+    bytes pairs(64 * 37);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        pairs[i] = static_cast<byte>(i * 131 + 7);
+    }
+    bytes pairHashes(32 * 37);
+    DoubleSHA256_64(pairHashes.data(), pairs.data(), 37);
+    for (size_t i = 0; i < 37; ++i) {
+        Hash256 sha;
+        Hash256 sha2;
+        ::SHA256(pairs.data() + 64 * i, 64, sha.data());
+        ::SHA256(sha.data(), sha.size(), sha2.data());
+        if (std::memcmp(pairHashes.data() + 32 * i, sha2.data(), 32) != 0) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
+#pragma GCC diagnostic pop
+
 // Hex conversion
 std::string Hash::ToHex(const Hash256& hash) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (const auto& byte : hash) {
-        ss << std::setw(2) << static_cast<int>(byte);
-    }
-    return ss.str();
+    return Hex::Encode(hash.data(), hash.size());
 }
 
 std::string Hash::ToHex(const Hash160& hash) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (const auto& byte : hash) {
-        ss << std::setw(2) << static_cast<int>(byte);
-    }
-    return ss.str();
+    return Hex::Encode(hash.data(), hash.size());
 }
 
 Hash256 Hash::FromHex256(const std::string& hex) {
@@ -121,9 +268,8 @@ Hash256 Hash::FromHex256(const std::string& hex) {
     }
 
     Hash256 hash;
-    for (size_t i = 0; i < 32; ++i) {
-        std::string byteString = hex.substr(i * 2, 2);
-        hash[i] = static_cast<byte>(std::stoul(byteString, nullptr, 16));
+    if (!Hex::Decode(hash.data(), hex.data(), hex.size())) {
+        throw std::invalid_argument("Invalid hex character in Hash256");
     }
     return hash;
 }
@@ -134,20 +280,66 @@ Hash160 Hash::FromHex160(const std::string& hex) {
     }
 
     Hash160 hash;
-    for (size_t i = 0; i < 20; ++i) {
-        std::string byteString = hex.substr(i * 2, 2);
-        hash[i] = static_cast<byte>(std::stoul(byteString, nullptr, 16));
+    if (!Hex::Decode(hash.data(), hex.data(), hex.size())) {
+        throw std::invalid_argument("Invalid hex character in Hash160");
     }
     return hash;
 }
 
 // Merkle tree functions
 Hash256 Hash::MerkleHash(const Hash256& left, const Hash256& right) {
-    bytes combined;
-    combined.reserve(64);
-    combined.insert(combined.end(), left.begin(), left.end());
-    combined.insert(combined.end(), right.begin(), right.end());
-    return DoubleSHA256(combined);
+    byte combined[64];
+    std::memcpy(combined, left.data(), 32);
+    std::memcpy(combined + 32, right.data(), 32);
+    return DoubleSHA256(combined, sizeof(combined));
+}
+
+void Hash::ComputeMerkleLevel(Hash256* parents, const Hash256* children, size_t count) {
+    size_t pairs = count / 2;
+    Hash256 odd{};
+    if (count & 1) {
+        // Read before the in-place pass below can overwrite it
+        odd = MerkleHash(children[count - 1], children[count - 1]);
+    }
+
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                      pairs / MERKLE_PAIRS_PER_THREAD);
+
+    if (threads <= 1) {
+        DoubleSHA256_64(parents->data(), children->data(), pairs);
+    } else {
+        // Workers must not overwrite each other's children, so hash out of place
+        std::vector<Hash256> scratch;
+        Hash256* out = parents;
+        if (parents < children + count && children < parents + pairs) {
+            scratch.resize(pairs);
+            out = scratch.data();
+        }
+
+        size_t perThread = (pairs + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) {
+            size_t begin = std::min(pairs, t * perThread);
+            size_t end = std::min(pairs, begin + perThread);
+            workers.emplace_back([out, children, begin, end]() {
+                DoubleSHA256_64(out[begin].data(), children[2 * begin].data(), end - begin);
+            });
+        }
+        DoubleSHA256_64(out->data(), children->data(), std::min(pairs, perThread));
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (out != parents) {
+            std::copy(scratch.begin(), scratch.end(), parents);
+        }
+    }
+
+    if (count & 1) {
+        parents[pairs] = odd;
+    }
 }
 
 Hash256 Hash::ComputeMerkleRoot(const std::vector<Hash256>& hashes) {
@@ -159,21 +351,14 @@ Hash256 Hash::ComputeMerkleRoot(const std::vector<Hash256>& hashes) {
         return hashes[0];
     }
 
-    std::vector<Hash256> level = hashes;
-
-    while (level.size() > 1) {
-        std::vector<Hash256> nextLevel;
+    // Hash the leaves into one scratch level, then reduce it in place
+    size_t count = (hashes.size() + 1) / 2;
+    std::vector<Hash256> level(count);
+    ComputeMerkleLevel(level.data(), hashes.data(), hashes.size());
 
-        for (size_t i = 0; i < level.size(); i += 2) {
-            if (i + 1 < level.size()) {
-                nextLevel.push_back(MerkleHash(level[i], level[i + 1]));
-            } else {
-                // If odd number of elements, duplicate the last one
-                nextLevel.push_back(MerkleHash(level[i], level[i]));
-            }
-        }
-
-        level = std::move(nextLevel);
+    while (count > 1) {
+        ComputeMerkleLevel(level.data(), level.data(), count);
+        count = (count + 1) / 2;
     }
 
     return level[0];
@@ -342,12 +527,9 @@ uint32_t Hash::TargetToCompact(const Hash256& target) {
 // SHA256Hasher implementation
 class SHA256Hasher::Impl {
 public:
-    SHA256_CTX ctx;
+    SHA256Context ctx;
 };
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-
 SHA256Hasher::SHA256Hasher() : pimpl(new Impl()) {
     Reset();
 }
@@ -359,7 +541,7 @@ void SHA256Hasher::Update(const bytes& data) {
 }
 
 void SHA256Hasher::Update(const byte* data, size_t len) {
-    SHA256_Update(&pimpl->ctx, data, len);
+    pimpl->ctx.Write(data, len);
 }
 
 void SHA256Hasher::Update(const std::string& data) {
@@ -368,15 +550,13 @@ void SHA256Hasher::Update(const std::string& data) {
 
 Hash256 SHA256Hasher::Finalize() {
     Hash256 hash;
-    SHA256_Final(hash.data(), &pimpl->ctx);
+    pimpl->ctx.Finalize(hash.data());
     return hash;
 }
 
 void SHA256Hasher::Reset() {
-    SHA256_Init(&pimpl->ctx);
+    pimpl->ctx.Reset();
 }
 
-#pragma GCC diagnostic pop
-
 } // namespace crypto
 } // namespace dinari
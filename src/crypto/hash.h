@@ -17,6 +17,10 @@ namespace crypto {
  * - Transaction IDs (double SHA-256)
  * - Address generation (Hash160)
  * - Merkle tree construction (double SHA-256)
+ *
+ * SHA-256 and RIPEMD-160 are computed in-tree (sha256.h, ripemd160.h);
+ * messages short enough for one block (pubkeys, digests, merkle pairs)
+ * take unbuffered fixed-length paths. HMAC and key derivation use OpenSSL.
  */
 
 class Hash {
@@ -39,6 +43,40 @@ public:
     static Hash256 DoubleSHA256(const bytes& data);
     static Hash256 DoubleSHA256(const byte* data, size_t len);
 
+    /**
+     * @brief Double SHA-256 of consecutive 64-byte inputs
+     *
+     * Hashes 4, 8 or 16 inputs at a time with the widest SIMD unit the
+     * CPU supports (SSE4.1, AVX2, AVX-512), falling back to one at a time.
+     *
+     * @param output count 32-byte hashes (may alias input)
+     * @param input count 64-byte inputs
+     * @param count Number of inputs
+     */
+    static void DoubleSHA256_64(byte* output, const byte* input, size_t count);
+
+    /**
+     * @brief Name of the DoubleSHA256_64 implementation in use
+     */
+    static const char* DoubleSHA256_64Implementation();
+
+    /**
+     * @brief Double SHA-256 of many independent messages
+     *
+     * Messages of up to 55 bytes are hashed several at a time on SIMD
+     * lanes; longer ones one by one.
+     *
+     * @param output count hashes
+     * @param inputs count messages
+     * @param count Number of messages
+     */
+    static void DoubleSHA256Many(Hash256* output, const bytes* inputs, size_t count);
+
+    /**
+     * @brief Name of the single-message SHA-256 implementation in use
+     */
+    static const char* SHA256Implementation();
+
     /**
      * @brief Compute RIPEMD-160 hash
      * @param data Input data
@@ -56,6 +94,28 @@ public:
     static dinari::Hash160 ComputeHash160(const bytes& data);
     static dinari::Hash160 ComputeHash160(const byte* data, size_t len);
 
+    /**
+     * @brief Hash160 of many independent messages (e.g. a batch of pubkeys)
+     *
+     * The SHA-256 half is batched as in DoubleSHA256Many.
+     *
+     * @param output count hashes
+     * @param inputs count messages
+     * @param count Number of messages
+     */
+    static void ComputeHash160Many(dinari::Hash160* output, const bytes* inputs, size_t count);
+
+    /**
+     * @brief Check the in-tree hash functions against OpenSSL
+     *
+     * Covers every length path (one block, 64 bytes, multi-block), the
+     * batched functions and incremental hashing, with whichever kernels
+     * this CPU selected. Meant to run once at startup.
+     *
+     * @return true if all results match
+     */
+    static bool SelfTest();
+
     /**
      * @brief Convert hash to hex string
      * @param hash Hash to convert
@@ -79,6 +139,23 @@ public:
      */
     static Hash256 ComputeMerkleRoot(const std::vector<Hash256>& hashes);
 
+    /**
+     * @brief Hash one merkle tree level into the level above
+     *
+     * An odd last child is paired with itself. Large levels are split
+     * across threads.
+     *
+     * @param parents (count + 1) / 2 output hashes (may alias children)
+     * @param children Child hashes
+     * @param count Number of children
+     */
+    static void ComputeMerkleLevel(Hash256* parents, const Hash256* children, size_t count);
+
+    /**
+     * @brief Hash of two merkle tree nodes
+     */
+    static Hash256 MerkleHash(const Hash256& left, const Hash256& right);
+
     /**
      * @brief HMAC-SHA256 (used in HD wallet key derivation)
      * @param key Key for HMAC
@@ -151,10 +228,6 @@ public:
      * @return Compact representation
      */
     static uint32_t TargetToCompact(const Hash256& target);
-
-private:
-    // Helper function for Merkle tree calculation
-    static Hash256 MerkleHash(const Hash256& left, const Hash256& right);
 };
 
 /**
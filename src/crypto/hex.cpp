@@ -0,0 +1,115 @@
+#include "hex.h"
+#include <array>
+#ifdef ENABLE_HEX_SIMD
+#include "hex_simd.h"
+#endif
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Nibble value of each character, -1 for non-hex characters
+constexpr std::array<int8_t, 256> MakeNibbleTable() {
+    std::array<int8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = -1;
+        if (c >= '0' && c <= '9') table[c] = static_cast<int8_t>(c - '0');
+        if (c >= 'a' && c <= 'f') table[c] = static_cast<int8_t>(c - 'a' + 10);
+        if (c >= 'A' && c <= 'F') table[c] = static_cast<int8_t>(c - 'A' + 10);
+    }
+    return table;
+}
+constexpr std::array<int8_t, 256> NIBBLES = MakeNibbleTable();
+
+// Vector hex kernels picked for this CPU
+struct HexKernels {
+    size_t (*encode)(char* out, const unsigned char* data, size_t len);
+    size_t (*decode)(unsigned char* out, const char* hex, size_t outLen);
+    const char* name;
+};
+
+HexKernels SelectHexKernels() {
+#ifdef ENABLE_HEX_SIMD
+    using namespace dinari::crypto::hex_simd;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {EncodeAVX2, DecodeAVX2, "avx2"};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {EncodeSSSE3, DecodeSSSE3, "ssse3"};
+    }
+#endif
+    return {nullptr, nullptr, "generic"};
+}
+
+const HexKernels& GetHexKernels() {
+    static const HexKernels kernels = SelectHexKernels();
+    return kernels;
+}
+
+} // namespace
+
+namespace dinari {
+namespace crypto {
+
+void Hex::Encode(char* out, const byte* data, size_t len) {
+    size_t done = 0;
+    const HexKernels& kernels = GetHexKernels();
+    if (kernels.encode) {
+        done = kernels.encode(out, data, len);
+    }
+
+    for (; done < len; ++done) {
+        out[2 * done] = HEX_DIGITS[data[done] >> 4];
+        out[2 * done + 1] = HEX_DIGITS[data[done] & 0x0f];
+    }
+}
+
+std::string Hex::Encode(const byte* data, size_t len) {
+    std::string result(2 * len, '\0');
+    Encode(&result[0], data, len);
+    return result;
+}
+
+std::string Hex::Encode(const bytes& data) {
+    return Encode(data.data(), data.size());
+}
+
+bool Hex::Decode(byte* out, const char* hex, size_t hexLen) {
+    if (hexLen % 2 != 0) {
+        return false;
+    }
+
+    size_t len = hexLen / 2;
+    size_t done = 0;
+    const HexKernels& kernels = GetHexKernels();
+    if (kernels.decode) {
+        done = kernels.decode(out, hex, len);
+    }
+
+    for (; done < len; ++done) {
+        int hi = NIBBLES[static_cast<unsigned char>(hex[2 * done])];
+        int lo = NIBBLES[static_cast<unsigned char>(hex[2 * done + 1])];
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[done] = static_cast<byte>((hi << 4) | lo);
+    }
+    return true;
+}
+
+bool Hex::Decode(const std::string& hex, bytes& result) {
+    bytes decoded(hex.size() / 2);
+    if (!Decode(decoded.data(), hex.data(), hex.size())) {
+        return false;
+    }
+    result = std::move(decoded);
+    return true;
+}
+
+const char* Hex::Implementation() {
+    return GetHexKernels().name;
+}
+
+} // namespace crypto
+} // namespace dinari
@@ -0,0 +1,55 @@
+#ifndef DINARI_CRYPTO_HEX_H
+#define DINARI_CRYPTO_HEX_H
+
+#include "dinari/types.h"
+#include <string>
+
+namespace dinari {
+namespace crypto {
+
+/**
+ * @brief Hexadecimal encoding and decoding
+ *
+ * The buffer-based functions do not allocate. Long inputs are processed
+ * with SSSE3 or AVX2 kernels when the CPU supports them, falling back to
+ * table lookups otherwise. Encoding produces lowercase; decoding accepts
+ * either case.
+ */
+class Hex {
+public:
+    /**
+     * @brief Encode `len` bytes into exactly 2 * len characters
+     *
+     * No terminator is written.
+     */
+    static void Encode(char* out, const byte* data, size_t len);
+
+    /**
+     * @brief Encode bytes to a string
+     */
+    static std::string Encode(const byte* data, size_t len);
+    static std::string Encode(const bytes& data);
+
+    /**
+     * @brief Decode `hexLen` characters into hexLen / 2 bytes
+     * @return false if hexLen is odd or a character is not a hex digit;
+     *         `out` is then unspecified
+     */
+    static bool Decode(byte* out, const char* hex, size_t hexLen);
+
+    /**
+     * @brief Decode a string
+     * @return false on odd length or a non-hex character
+     */
+    static bool Decode(const std::string& hex, bytes& result);
+
+    /**
+     * @brief Name of the kernel in use ("avx2", "ssse3" or "generic")
+     */
+    static const char* Implementation();
+};
+
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_HEX_H
@@ -0,0 +1,83 @@
+// Built with the AVX2 instruction set; only called after a runtime CPU check
+#include "hex_simd.h"
+#include <immintrin.h>
+
+namespace dinari {
+namespace crypto {
+namespace hex_simd {
+
+namespace {
+
+// Nibble values of 32 characters, or all-ones in `invalid` for non-hex ones
+__m256i CharsToNibbles(__m256i chars, __m256i& invalid) {
+    const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+
+    // Signed compares, so bytes >= 0x80 fall outside both ranges
+    __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+    __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+    __m256i digits = _mm256_and_si256(isDigit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0')));
+    __m256i letters = _mm256_and_si256(isLetter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)));
+
+    invalid = _mm256_or_si256(invalid, _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter),
+                                                           _mm256_set1_epi8(-1)));
+    return _mm256_or_si256(digits, letters);
+}
+
+} // anonymous namespace
+
+size_t EncodeAVX2(char* out, const unsigned char* data, size_t len) {
+    const __m256i table = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                           '0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    size_t done = 0;
+    for (; done + 32 <= len; done += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + done));
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(bytes, mask));
+
+        // Unpacks work within 128-bit lanes: low holds input bytes 0-7 and
+        // 16-23, high holds 8-15 and 24-31
+        __m256i low = _mm256_unpacklo_epi8(hi, lo);
+        __m256i high = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * done),
+                            _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * done + 32),
+                            _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    return done;
+}
+
+size_t DecodeAVX2(unsigned char* out, const char* hex, size_t outLen) {
+    // Pairs of nibbles (high first) to bytes: hi * 16 + lo
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+
+    size_t done = 0;
+    for (; done + 32 <= outLen; done += 32) {
+        __m256i invalid = _mm256_setzero_si256();
+        __m256i first = CharsToNibbles(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * done)), invalid);
+        __m256i second = CharsToNibbles(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * done + 32)), invalid);
+        if (_mm256_movemask_epi8(invalid) != 0) {
+            break;
+        }
+
+        // Packing is per 128-bit lane; restore the 64-bit quarters' order
+        __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                            _mm256_maddubs_epi16(second, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done),
+                            _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return done;
+}
+
+} // namespace hex_simd
+} // namespace crypto
+} // namespace dinari
@@ -0,0 +1,31 @@
+#ifndef DINARI_CRYPTO_HEX_SIMD_H
+#define DINARI_CRYPTO_HEX_SIMD_H
+
+#include <cstddef>
+
+namespace dinari {
+namespace crypto {
+namespace hex_simd {
+
+/**
+ * @brief Vector hex kernels
+ *
+ * Encode kernels consume whole blocks of BLOCK input bytes and return how
+ * many bytes they encoded; the caller finishes the tail. Decode kernels
+ * consume whole blocks of 2 * BLOCK characters and return how many bytes
+ * they produced, stopping early at a block containing a non-hex
+ * character so the scalar path can reject it.
+ *
+ * The kernels live in their own translation units built with the matching
+ * instruction set flags; callers must check CPU support first.
+ */
+size_t EncodeSSSE3(char* out, const unsigned char* data, size_t len);           // BLOCK 16
+size_t DecodeSSSE3(unsigned char* out, const char* hex, size_t outLen);         // BLOCK 16
+size_t EncodeAVX2(char* out, const unsigned char* data, size_t len);            // BLOCK 32
+size_t DecodeAVX2(unsigned char* out, const char* hex, size_t outLen);          // BLOCK 32
+
+} // namespace hex_simd
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_HEX_SIMD_H
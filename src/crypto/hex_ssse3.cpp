@@ -0,0 +1,72 @@
+// Built with the SSSE3 instruction set; only called after a runtime CPU check
+#include "hex_simd.h"
+#include <tmmintrin.h>
+
+namespace dinari {
+namespace crypto {
+namespace hex_simd {
+
+namespace {
+
+// Nibble values of 16 characters, or all-ones in `invalid` for non-hex ones
+__m128i CharsToNibbles(__m128i chars, __m128i& invalid) {
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+    // Signed compares, so bytes >= 0x80 fall outside both ranges
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                     _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    __m128i digits = _mm_and_si128(isDigit, _mm_sub_epi8(chars, _mm_set1_epi8('0')));
+    __m128i letters = _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)));
+
+    invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(isDigit, isLetter),
+                                                     _mm_set1_epi8(-1)));
+    return _mm_or_si128(digits, letters);
+}
+
+} // anonymous namespace
+
+size_t EncodeSSSE3(char* out, const unsigned char* data, size_t len) {
+    const __m128i table = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    size_t done = 0;
+    for (; done + 16 <= len; done += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + done));
+        __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(bytes, mask));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * done), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * done + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return done;
+}
+
+size_t DecodeSSSE3(unsigned char* out, const char* hex, size_t outLen) {
+    // Pairs of nibbles (high first) to bytes: hi * 16 + lo
+    const __m128i weights = _mm_set1_epi16(0x0110);
+
+    size_t done = 0;
+    for (; done + 16 <= outLen; done += 16) {
+        __m128i invalid = _mm_setzero_si128();
+        __m128i first = CharsToNibbles(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * done)), invalid);
+        __m128i second = CharsToNibbles(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * done + 16)), invalid);
+        if (_mm_movemask_epi8(invalid) != 0) {
+            break;
+        }
+
+        __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+                                         _mm_maddubs_epi16(second, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), bytes);
+    }
+    return done;
+}
+
+} // namespace hex_simd
+} // namespace crypto
+} // namespace dinari
@@ -0,0 +1,198 @@
+#include "muhash.h"
+#include "hash.h"
+#include "sha256.h"
+
+namespace dinari {
+namespace crypto {
+
+namespace {
+
+using Num = MuHash3072::Num;
+
+constexpr size_t LIMBS = MuHash3072::LIMBS;
+
+// The modulus is 2^3072 - PRIME_DIFF
+constexpr uint64_t PRIME_DIFF = 1103717;
+
+// a * b + c + d as a 128-bit value split into limbs; cannot overflow
+inline uint64_t MulAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t& high) {
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 t = static_cast<uint128>(a) * b + c + d;
+    high = static_cast<uint64_t>(t >> 64);
+    return static_cast<uint64_t>(t);
+#else
+    uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+    uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    uint64_t low = (mid << 32) | (ll & 0xFFFFFFFF);
+    high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    low += c;
+    high += low < c;
+    low += d;
+    high += low < d;
+    return low;
+#endif
+}
+
+Num One() {
+    Num n;
+    n.limbs[0] = 1;
+    return n;
+}
+
+bool IsOne(const Num& n) {
+    if (n.limbs[0] != 1) return false;
+    for (size_t i = 1; i < LIMBS; ++i) {
+        if (n.limbs[i] != 0) return false;
+    }
+    return true;
+}
+
+// True if n >= 2^3072 - PRIME_DIFF
+bool IsOverflow(const Num& n) {
+    if (n.limbs[0] < ~uint64_t(0) - (PRIME_DIFF - 1)) return false;
+    for (size_t i = 1; i < LIMBS; ++i) {
+        if (n.limbs[i] != ~uint64_t(0)) return false;
+    }
+    return true;
+}
+
+// Adds `value` to n; returns the carry out of the top limb
+uint64_t AddSmall(Num& n, uint64_t value) {
+    for (size_t i = 0; i < LIMBS && value; ++i) {
+        n.limbs[i] += value;
+        value = n.limbs[i] < value;
+    }
+    return value;
+}
+
+// n - p = n + PRIME_DIFF - 2^3072
+void SubtractPrime(Num& n) {
+    AddSmall(n, PRIME_DIFF);
+}
+
+Num MulMod(const Num& a, const Num& b) {
+    // Schoolbook product into 96 limbs
+    uint64_t product[2 * LIMBS] = {};
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            product[i + j] = MulAdd(a.limbs[i], b.limbs[j], product[i + j], carry, carry);
+        }
+        product[i + LIMBS] = carry;
+    }
+
+    // 2^3072 = PRIME_DIFF (mod p), so the high half folds down with a small multiply
+    Num r;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        r.limbs[i] = MulAdd(product[LIMBS + i], PRIME_DIFF, product[i], carry, carry);
+    }
+
+    // The remaining carry is at most 2^21, so carry * PRIME_DIFF fits one
+    // limb; adding it wraps at most once, leaving a small value to fix up
+    if (AddSmall(r, carry * PRIME_DIFF)) {
+        AddSmall(r, PRIME_DIFF);
+    }
+
+    if (IsOverflow(r)) {
+        SubtractPrime(r);
+    }
+    return r;
+}
+
+// x^(p-2) = x^-1 (mod p), four exponent bits at a time
+Num Inverse(const Num& x) {
+    Num powers[16];
+    powers[0] = One();
+    for (size_t i = 1; i < 16; ++i) {
+        powers[i] = MulMod(powers[i - 1], x);
+    }
+
+    // p - 2: every limb all ones except the lowest
+    const uint64_t lowLimb = ~uint64_t(0) - (PRIME_DIFF + 1);
+
+    Num result = One();
+    for (size_t nibble = LIMBS * 16; nibble-- > 0;) {
+        for (int i = 0; i < 4; ++i) {
+            result = MulMod(result, result);
+        }
+        uint64_t limb = nibble < 16 ? lowLimb : ~uint64_t(0);
+        unsigned digit = static_cast<unsigned>((limb >> ((nibble % 16) * 4)) & 0xF);
+        if (digit != 0) {
+            result = MulMod(result, powers[digit]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+MuHash3072::MuHash3072() : numerator(One()), denominator(One()) {
+}
+
+MuHash3072::Num MuHash3072::ToNum(const byte* data, size_t len) {
+    // Expand SHA256(data) to 384 bytes: SHA256(seed || i) for i = 0..11
+    constexpr size_t BLOCKS = BYTE_SIZE / SHA256Context::OUTPUT_SIZE;
+
+    Hash256 seed = Hash::SHA256(data, len);
+    byte message[33];
+    std::copy(seed.begin(), seed.end(), message);
+
+    byte padded[BLOCKS * 64];
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        message[32] = static_cast<byte>(i);
+        SHA256Context::PadOneBlock(padded + i * 64, message, sizeof(message));
+    }
+
+    byte expanded[BYTE_SIZE];
+    SHA256Context::HashPaddedBlocks(expanded, padded, BLOCKS);
+
+    Num num;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint64_t limb = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            limb |= static_cast<uint64_t>(expanded[i * 8 + j]) << (8 * j);
+        }
+        num.limbs[i] = limb;
+    }
+    if (IsOverflow(num)) {
+        SubtractPrime(num);
+    }
+    return num;
+}
+
+MuHash3072& MuHash3072::Insert(const byte* data, size_t len) {
+    numerator = MulMod(numerator, ToNum(data, len));
+    return *this;
+}
+
+MuHash3072& MuHash3072::Remove(const byte* data, size_t len) {
+    denominator = MulMod(denominator, ToNum(data, len));
+    return *this;
+}
+
+MuHash3072& MuHash3072::operator*=(const MuHash3072& other) {
+    numerator = MulMod(numerator, other.numerator);
+    denominator = MulMod(denominator, other.denominator);
+    return *this;
+}
+
+Hash256 MuHash3072::Finalize() const {
+    Num value = IsOne(denominator) ? numerator : MulMod(numerator, Inverse(denominator));
+
+    // Little-endian bytes of the full width
+    byte out[BYTE_SIZE];
+    for (size_t i = 0; i < LIMBS; ++i) {
+        for (size_t j = 0; j < 8; ++j) {
+            out[i * 8 + j] = static_cast<byte>(value.limbs[i] >> (8 * j));
+        }
+    }
+
+    return Hash::SHA256(out, sizeof(out));
+}
+
+} // namespace crypto
+} // namespace dinari
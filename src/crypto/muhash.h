@@ -0,0 +1,59 @@
+#ifndef DINARI_CRYPTO_MUHASH_H
+#define DINARI_CRYPTO_MUHASH_H
+
+#include "dinari/types.h"
+#include <array>
+
+namespace dinari {
+namespace crypto {
+
+/**
+ * @brief Rolling hash of a multiset (MuHash)
+ *
+ * Each element is expanded with SHA-256 to a number modulo the prime
+ * 2^3072 - 1103717 and multiplied in; removing an element multiplies its
+ * number into a separate denominator. Insert and Remove commute, so the
+ * digest depends only on the final contents, and two hashes can be
+ * combined. The single modular inverse is left to Finalize.
+ */
+class MuHash3072 {
+public:
+    static constexpr size_t BYTE_SIZE = 384;
+    static constexpr size_t LIMBS = BYTE_SIZE / 8;
+
+    // 3072-bit number, little-endian 64-bit limbs, always below the prime
+    struct Num {
+        std::array<uint64_t, LIMBS> limbs{};
+    };
+
+    // Hash of the empty set
+    MuHash3072();
+
+    MuHash3072& Insert(const byte* data, size_t len);
+    MuHash3072& Insert(const bytes& data) { return Insert(data.data(), data.size()); }
+
+    MuHash3072& Remove(const byte* data, size_t len);
+    MuHash3072& Remove(const bytes& data) { return Remove(data.data(), data.size()); }
+
+    // Hash of the union of both multisets
+    MuHash3072& operator*=(const MuHash3072& other);
+
+    /**
+     * @brief 32-byte digest of the set
+     *
+     * SHA-256 of the 3072-bit value. Costs one modular inverse
+     * regardless of how many elements the set holds.
+     */
+    Hash256 Finalize() const;
+
+private:
+    Num numerator;
+    Num denominator;
+
+    static Num ToNum(const byte* data, size_t len);
+};
+
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_MUHASH_H
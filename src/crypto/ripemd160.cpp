@@ -0,0 +1,183 @@
+#include "ripemd160.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t RIPEMD160_IV[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+// Message word order and rotation amounts of the left and right lines
+constexpr uint8_t LEFT_WORD[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+constexpr uint8_t RIGHT_WORD[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+constexpr uint8_t LEFT_ROTATE[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+constexpr uint8_t RIGHT_ROTATE[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+constexpr uint32_t LEFT_K[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+constexpr uint32_t RIGHT_K[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+inline uint32_t Rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+inline uint32_t ReadLE32(const unsigned char* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+inline void WriteLE32(unsigned char* p, uint32_t x) {
+    p[0] = static_cast<unsigned char>(x);
+    p[1] = static_cast<unsigned char>(x >> 8);
+    p[2] = static_cast<unsigned char>(x >> 16);
+    p[3] = static_cast<unsigned char>(x >> 24);
+}
+
+// The five boolean functions; the round number selecting one is public
+inline uint32_t F(int round, uint32_t x, uint32_t y, uint32_t z) {
+    switch (round) {
+        case 0: return x ^ y ^ z;
+        case 1: return (x & y) | (~x & z);
+        case 2: return (x | ~y) ^ z;
+        case 3: return (x & z) | (y & ~z);
+        default: return x ^ (y | ~z);
+    }
+}
+
+void TransformBlock(uint32_t s[5], const unsigned char* block) {
+    uint32_t x[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = ReadLE32(block + 4 * i);
+    }
+
+    uint32_t al = s[0], bl = s[1], cl = s[2], dl = s[3], el = s[4];
+    uint32_t ar = s[0], br = s[1], cr = s[2], dr = s[3], er = s[4];
+
+    // Fully unrolled, the round switch and table lookups fold into constants
+#pragma GCC unroll 80
+    for (int i = 0; i < 80; ++i) {
+        int round = i / 16;
+
+        uint32_t t = Rotl(al + F(round, bl, cl, dl) + x[LEFT_WORD[i]] + LEFT_K[round],
+                          LEFT_ROTATE[i]) + el;
+        al = el; el = dl; dl = Rotl(cl, 10); cl = bl; bl = t;
+
+        t = Rotl(ar + F(4 - round, br, cr, dr) + x[RIGHT_WORD[i]] + RIGHT_K[round],
+                 RIGHT_ROTATE[i]) + er;
+        ar = er; er = dr; dr = Rotl(cr, 10); cr = br; br = t;
+    }
+
+    uint32_t t = s[1] + cl + dr;
+    s[1] = s[2] + dl + er;
+    s[2] = s[3] + el + ar;
+    s[3] = s[4] + al + br;
+    s[4] = s[0] + bl + cr;
+    s[0] = t;
+}
+
+void WriteLength(unsigned char* block, uint64_t bits) {
+    WriteLE32(block + 56, static_cast<uint32_t>(bits));
+    WriteLE32(block + 60, static_cast<uint32_t>(bits >> 32));
+}
+
+void WriteDigest(unsigned char* out, const uint32_t s[5]) {
+    for (int i = 0; i < 5; ++i) {
+        WriteLE32(out + 4 * i, s[i]);
+    }
+}
+
+} // namespace
+
+namespace dinari {
+namespace crypto {
+
+RIPEMD160Context::RIPEMD160Context() {
+    Reset();
+}
+
+RIPEMD160Context& RIPEMD160Context::Reset() {
+    std::memcpy(state, RIPEMD160_IV, sizeof(state));
+    bytesHashed = 0;
+    return *this;
+}
+
+RIPEMD160Context& RIPEMD160Context::Write(const byte* data, size_t len) {
+    if (len == 0) {
+        return *this;
+    }
+
+    size_t used = bytesHashed % 64;
+    bytesHashed += len;
+
+    if (used > 0) {
+        size_t take = std::min(len, 64 - used);
+        std::memcpy(buffer + used, data, take);
+        data += take;
+        len -= take;
+        if (used + take < 64) {
+            return *this;
+        }
+        TransformBlock(state, buffer);
+    }
+
+    for (; len >= 64; data += 64, len -= 64) {
+        TransformBlock(state, data);
+    }
+
+    if (len > 0) {
+        std::memcpy(buffer, data, len);
+    }
+    return *this;
+}
+
+void RIPEMD160Context::Finalize(byte out[OUTPUT_SIZE]) {
+    uint64_t bits = bytesHashed * 8;
+    size_t used = bytesHashed % 64;
+
+    buffer[used++] = 0x80;
+    if (used > 56) {
+        std::memset(buffer + used, 0, 64 - used);
+        TransformBlock(state, buffer);
+        used = 0;
+    }
+    std::memset(buffer + used, 0, 56 - used);
+    WriteLength(buffer, bits);
+    TransformBlock(state, buffer);
+
+    WriteDigest(out, state);
+}
+
+void RIPEMD160Context::Hash32(byte out[OUTPUT_SIZE], const byte* data) {
+    byte block[64] = {};
+    std::memcpy(block, data, 32);
+    block[32] = 0x80;
+    WriteLength(block, 256);
+
+    uint32_t s[5];
+    std::memcpy(s, RIPEMD160_IV, sizeof(s));
+    TransformBlock(s, block);
+    WriteDigest(out, s);
+}
+
+} // namespace crypto
+} // namespace dinari
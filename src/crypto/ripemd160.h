@@ -0,0 +1,39 @@
+#ifndef DINARI_CRYPTO_RIPEMD160_H
+#define DINARI_CRYPTO_RIPEMD160_H
+
+#include "dinari/types.h"
+
+namespace dinari {
+namespace crypto {
+
+/**
+ * @brief In-tree RIPEMD-160
+ *
+ * Portable and free of data-dependent branches and table lookups.
+ * Hash32 is the second half of Hash160 and skips the buffering.
+ */
+class RIPEMD160Context {
+public:
+    static constexpr size_t OUTPUT_SIZE = 20;
+
+    RIPEMD160Context();
+
+    RIPEMD160Context& Write(const byte* data, size_t len);
+    void Finalize(byte out[OUTPUT_SIZE]);
+    RIPEMD160Context& Reset();
+
+    /**
+     * @brief RIPEMD-160 of a 32-byte message
+     */
+    static void Hash32(byte out[OUTPUT_SIZE], const byte* data);
+
+private:
+    uint32_t state[5];
+    byte buffer[64];
+    uint64_t bytesHashed;
+};
+
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_RIPEMD160_H
@@ -0,0 +1,252 @@
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include <algorithm>
+#include <cstring>
+#ifdef ENABLE_SHA256_SIMD
+#include "sha256_simd.h"
+#endif
+
+namespace {
+
+// Portable compression function: the lane-generic transform with one lane
+void TransformGeneric(uint32_t state[8], const unsigned char* input, size_t blocks) {
+    for (; blocks > 0; --blocks, input += 64) {
+        uint32_t w[16];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = ReadBE32(input + 4 * i);
+        }
+        Transform<uint32_t>(state, w);
+    }
+}
+
+// Compression function and multi-message kernels picked for this CPU
+struct SHA256Kernels {
+    void (*transform)(uint32_t state[8], const unsigned char* input, size_t blocks);
+    const char* name;
+    void (*doubleHash64)(unsigned char* output, const unsigned char* input);
+    void (*oneBlock)(unsigned char* output, const unsigned char* input);
+    size_t lanes;
+    const char* lanesName;
+};
+
+SHA256Kernels SelectSHA256Kernels() {
+    SHA256Kernels kernels{TransformGeneric, "generic", nullptr, nullptr, 1, "generic"};
+#ifdef ENABLE_SHA256_SIMD
+    using namespace dinari::crypto::sha256_simd;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) {
+        kernels.transform = TransformSHANI;
+        kernels.name = "sha-ni";
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.doubleHash64 = DoubleSHA256_64_AVX512;
+        kernels.oneBlock = SHA256_OneBlock_AVX512;
+        kernels.lanes = 16;
+        kernels.lanesName = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        kernels.doubleHash64 = DoubleSHA256_64_AVX2;
+        kernels.oneBlock = SHA256_OneBlock_AVX2;
+        kernels.lanes = 8;
+        kernels.lanesName = "avx2";
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        kernels.doubleHash64 = DoubleSHA256_64_SSE41;
+        kernels.oneBlock = SHA256_OneBlock_SSE41;
+        kernels.lanes = 4;
+        kernels.lanesName = "sse4.1";
+    }
+#endif
+    return kernels;
+}
+
+const SHA256Kernels& GetSHA256Kernels() {
+    static const SHA256Kernels kernels = SelectSHA256Kernels();
+    return kernels;
+}
+
+// Padding block of a 64-byte message
+constexpr unsigned char PADDING_64[64] = {
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x00
+};
+
+void WriteLength(unsigned char* block, uint64_t bits) {
+    WriteBE32(block + 56, static_cast<uint32_t>(bits >> 32));
+    WriteBE32(block + 60, static_cast<uint32_t>(bits));
+}
+
+void WriteDigest(unsigned char* out, const uint32_t state[8]) {
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(out + 4 * i, state[i]);
+    }
+}
+
+// Hash a 32-byte digest again; the state words go straight into the block
+void HashDigest(unsigned char* out, const uint32_t digest[8], const SHA256Kernels& kernels) {
+    unsigned char block[64] = {};
+    WriteDigest(block, digest);
+    block[32] = 0x80;
+    WriteLength(block, 256);
+
+    uint32_t state[8];
+    std::memcpy(state, SHA256_IV, sizeof(state));
+    kernels.transform(state, block, 1);
+    WriteDigest(out, state);
+}
+
+} // namespace
+
+namespace dinari {
+namespace crypto {
+
+SHA256Context::SHA256Context() {
+    Reset();
+}
+
+SHA256Context& SHA256Context::Reset() {
+    std::memcpy(state, SHA256_IV, sizeof(state));
+    bytesHashed = 0;
+    return *this;
+}
+
+SHA256Context& SHA256Context::Write(const byte* data, size_t len) {
+    if (len == 0) {
+        return *this;
+    }
+
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+    size_t used = bytesHashed % 64;
+    bytesHashed += len;
+
+    if (used > 0) {
+        size_t take = std::min(len, 64 - used);
+        std::memcpy(buffer + used, data, take);
+        data += take;
+        len -= take;
+        if (used + take < 64) {
+            return *this;
+        }
+        kernels.transform(state, buffer, 1);
+    }
+
+    if (len >= 64) {
+        kernels.transform(state, data, len / 64);
+        data += len - len % 64;
+        len %= 64;
+    }
+
+    if (len > 0) {
+        std::memcpy(buffer, data, len);
+    }
+    return *this;
+}
+
+void SHA256Context::Finalize(byte out[OUTPUT_SIZE]) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+    uint64_t bits = bytesHashed * 8;
+    size_t used = bytesHashed % 64;
+
+    buffer[used++] = 0x80;
+    if (used > 56) {
+        std::memset(buffer + used, 0, 64 - used);
+        kernels.transform(state, buffer, 1);
+        used = 0;
+    }
+    std::memset(buffer + used, 0, 56 - used);
+    WriteLength(buffer, bits);
+    kernels.transform(state, buffer, 1);
+
+    WriteDigest(out, state);
+}
+
+void SHA256Context::PadOneBlock(byte block[64], const byte* data, size_t len) {
+    if (len > 0) {
+        std::memcpy(block, data, len);
+    }
+    block[len] = 0x80;
+    std::memset(block + len + 1, 0, 55 - len);
+    WriteLength(block, static_cast<uint64_t>(len) * 8);
+}
+
+void SHA256Context::HashOneBlock(byte out[OUTPUT_SIZE], const byte* data, size_t len) {
+    byte block[64];
+    PadOneBlock(block, data, len);
+
+    uint32_t s[8];
+    std::memcpy(s, SHA256_IV, sizeof(s));
+    GetSHA256Kernels().transform(s, block, 1);
+    WriteDigest(out, s);
+}
+
+void SHA256Context::DoubleHashOneBlock(byte out[OUTPUT_SIZE], const byte* data, size_t len) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+    byte block[64];
+    PadOneBlock(block, data, len);
+
+    uint32_t s[8];
+    std::memcpy(s, SHA256_IV, sizeof(s));
+    kernels.transform(s, block, 1);
+    HashDigest(out, s, kernels);
+}
+
+void SHA256Context::DoubleHash64(byte out[OUTPUT_SIZE], const byte* data) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+    uint32_t s[8];
+    std::memcpy(s, SHA256_IV, sizeof(s));
+    kernels.transform(s, data, 1);
+    kernels.transform(s, PADDING_64, 1);
+    HashDigest(out, s, kernels);
+}
+
+void SHA256Context::DoubleHash64Many(byte* output, const byte* input, size_t count) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+
+    if (kernels.doubleHash64) {
+        while (count >= kernels.lanes) {
+            kernels.doubleHash64(output, input);
+            output += 32 * kernels.lanes;
+            input += 64 * kernels.lanes;
+            count -= kernels.lanes;
+        }
+    }
+
+    for (; count > 0; --count) {
+        DoubleHash64(output, input);
+        output += 32;
+        input += 64;
+    }
+}
+
+void SHA256Context::HashPaddedBlocks(byte* output, const byte* blocks, size_t count) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+
+    if (kernels.oneBlock) {
+        while (count >= kernels.lanes) {
+            kernels.oneBlock(output, blocks);
+            output += 32 * kernels.lanes;
+            blocks += 64 * kernels.lanes;
+            count -= kernels.lanes;
+        }
+    }
+
+    for (; count > 0; --count) {
+        uint32_t s[8];
+        std::memcpy(s, SHA256_IV, sizeof(s));
+        kernels.transform(s, blocks, 1);
+        WriteDigest(output, s);
+        output += 32;
+        blocks += 64;
+    }
+}
+
+const char* SHA256Context::Implementation() {
+    return GetSHA256Kernels().name;
+}
+
+const char* SHA256Context::LanesImplementation() {
+    return GetSHA256Kernels().lanesName;
+}
+
+} // namespace crypto
+} // namespace dinari
@@ -0,0 +1,92 @@
+#ifndef DINARI_CRYPTO_SHA256_H
+#define DINARI_CRYPTO_SHA256_H
+
+#include "dinari/types.h"
+
+namespace dinari {
+namespace crypto {
+
+/**
+ * @brief In-tree SHA-256
+ *
+ * The block compression function is picked once per process: the SHA
+ * extensions (SHA-NI) where the CPU has them, otherwise a portable
+ * version. Neither branches on or indexes tables with the data being
+ * hashed. The static helpers hash fixed-size messages without buffering;
+ * Hash in hash.h routes to them by length.
+ */
+class SHA256Context {
+public:
+    static constexpr size_t OUTPUT_SIZE = 32;
+
+    /** Longest message that fits one block with its padding */
+    static constexpr size_t MAX_ONE_BLOCK = 55;
+
+    SHA256Context();
+
+    SHA256Context& Write(const byte* data, size_t len);
+    void Finalize(byte out[OUTPUT_SIZE]);
+    SHA256Context& Reset();
+
+    /**
+     * @brief SHA-256 of a message of at most MAX_ONE_BLOCK bytes
+     */
+    static void HashOneBlock(byte out[OUTPUT_SIZE], const byte* data, size_t len);
+
+    /**
+     * @brief SHA256(SHA256(x)) of a message of at most MAX_ONE_BLOCK bytes
+     */
+    static void DoubleHashOneBlock(byte out[OUTPUT_SIZE], const byte* data, size_t len);
+
+    /**
+     * @brief SHA256(SHA256(x)) of a 64-byte message
+     */
+    static void DoubleHash64(byte out[OUTPUT_SIZE], const byte* data);
+
+    /**
+     * @brief SHA256(SHA256(x)) of `count` consecutive 64-byte messages
+     *
+     * Runs several messages per call on SIMD lanes where the CPU allows.
+     *
+     * @param output count 32-byte digests (may alias input)
+     */
+    static void DoubleHash64Many(byte* output, const byte* input, size_t count);
+
+    /**
+     * @brief Pad a message of at most MAX_ONE_BLOCK bytes into one block
+     *
+     * The result is the input layout of HashPaddedBlocks.
+     */
+    static void PadOneBlock(byte block[64], const byte* data, size_t len);
+
+    /**
+     * @brief SHA-256 of `count` messages each padded to one block
+     *
+     * Hashes several blocks per call with the widest SIMD unit the CPU
+     * supports, or one at a time with the selected compression function.
+     *
+     * @param output count consecutive 32-byte digests
+     * @param blocks count consecutive 64-byte padded blocks
+     */
+    static void HashPaddedBlocks(byte* output, const byte* blocks, size_t count);
+
+    /**
+     * @brief Name of the compression function in use
+     */
+    static const char* Implementation();
+
+    /**
+     * @brief Name of the multi-message kernels in use
+     */
+    static const char* LanesImplementation();
+
+private:
+    uint32_t state[8];
+    byte buffer[64];
+    uint64_t bytesHashed;
+};
+
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_SHA256_H
@@ -0,0 +1,23 @@
+// Built with the AVX512 instruction set; only called after a runtime CPU check
+#include "sha256_simd.h"
+#include "sha256_lanes.h"
+
+namespace dinari {
+namespace crypto {
+namespace sha256_simd {
+
+namespace {
+typedef uint32_t Vec __attribute__((vector_size(64)));
+} // anonymous namespace
+
+void DoubleSHA256_64_AVX512(unsigned char* output, const unsigned char* input) {
+    DoubleSHA256_64Lanes<Vec, 16>(output, input);
+}
+
+void SHA256_OneBlock_AVX512(unsigned char* output, const unsigned char* input) {
+    SHA256_OneBlockLanes<Vec, 16>(output, input);
+}
+
+} // namespace sha256_simd
+} // namespace crypto
+} // namespace dinari
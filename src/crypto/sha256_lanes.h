@@ -0,0 +1,164 @@
+#ifndef DINARI_CRYPTO_SHA256_LANES_H
+#define DINARI_CRYPTO_SHA256_LANES_H
+
+/**
+ * @brief Lane-parallel SHA-256 compression, shared by the SIMD kernels
+ *
+ * V is a GCC/Clang vector of uint32_t with one element per lane; the
+ * including translation unit's instruction set flags decide which
+ * registers it maps to. Everything here has internal linkage so that no
+ * code built with wider instructions can be shared with other units.
+ * Only include from the sha256*.cpp files; sha256.cpp instantiates
+ * Transform with plain uint32_t as its portable one-lane fallback.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline uint32_t ReadBE32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline void WriteBE32(unsigned char* p, uint32_t x) {
+    p[0] = static_cast<unsigned char>(x >> 24);
+    p[1] = static_cast<unsigned char>(x >> 16);
+    p[2] = static_cast<unsigned char>(x >> 8);
+    p[3] = static_cast<unsigned char>(x);
+}
+
+template<typename V>
+inline V Splat(uint32_t x) {
+    V v = {};
+    return v + x;
+}
+
+template<typename V>
+inline V Rotr(V x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// One SHA-256 compression of w into s, in every lane
+template<typename V>
+inline void Transform(V s[8], V w[16]) {
+    V a = s[0], b = s[1], c = s[2], d = s[3];
+    V e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            V w15 = w[(i - 15) & 15];
+            V w2 = w[(i - 2) & 15];
+            V sigma0 = Rotr(w15, 7) ^ Rotr(w15, 18) ^ (w15 >> 3);
+            V sigma1 = Rotr(w2, 17) ^ Rotr(w2, 19) ^ (w2 >> 10);
+            w[i & 15] += sigma0 + w[(i - 7) & 15] + sigma1;
+        }
+
+        V t1 = h + (Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25)) + (g ^ (e & (f ^ g))) +
+               Splat<V>(SHA256_K[i]) + w[i & 15];
+        V t2 = (Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22)) + ((a & b) | (c & (a | b)));
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+template<typename V>
+inline void Initialize(V s[8]) {
+    for (int i = 0; i < 8; ++i) {
+        s[i] = Splat<V>(SHA256_IV[i]);
+    }
+}
+
+// Message words of LANES consecutive 64-byte blocks, one block per lane
+template<typename V, size_t LANES>
+inline void LoadLanes(V w[16], const unsigned char* input) {
+    for (int i = 0; i < 16; ++i) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            w[i][lane] = ReadBE32(input + 64 * lane + 4 * i);
+        }
+    }
+}
+
+template<typename V, size_t LANES>
+inline void StoreLanes(unsigned char* output, const V s[8]) {
+    for (int i = 0; i < 8; ++i) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            WriteBE32(output + 32 * lane + 4 * i, s[i][lane]);
+        }
+    }
+}
+
+// SHA256(SHA256(x)) for LANES 64-byte inputs at once
+template<typename V, size_t LANES>
+inline void DoubleSHA256_64Lanes(unsigned char* output, const unsigned char* input) {
+    V w[16];
+    LoadLanes<V, LANES>(w, input);
+
+    // First hash: the 64-byte message, then its padding block
+    V s[8];
+    Initialize(s);
+    Transform(s, w);
+
+    w[0] = Splat<V>(0x80000000);
+    for (int i = 1; i < 15; ++i) {
+        w[i] = Splat<V>(0);
+    }
+    w[15] = Splat<V>(512);
+    Transform(s, w);
+
+    // Second hash: the 32-byte digest and padding fit one block
+    for (int i = 0; i < 8; ++i) {
+        w[i] = s[i];
+    }
+    w[8] = Splat<V>(0x80000000);
+    for (int i = 9; i < 15; ++i) {
+        w[i] = Splat<V>(0);
+    }
+    w[15] = Splat<V>(256);
+    Initialize(s);
+    Transform(s, w);
+
+    StoreLanes<V, LANES>(output, s);
+}
+
+// SHA256(x) for LANES messages that are already padded to one 64-byte block
+template<typename V, size_t LANES>
+inline void SHA256_OneBlockLanes(unsigned char* output, const unsigned char* input) {
+    V w[16];
+    LoadLanes<V, LANES>(w, input);
+
+    V s[8];
+    Initialize(s);
+    Transform(s, w);
+
+    StoreLanes<V, LANES>(output, s);
+}
+
+} // anonymous namespace
+
+#endif // DINARI_CRYPTO_SHA256_LANES_H
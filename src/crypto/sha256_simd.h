@@ -0,0 +1,45 @@
+#ifndef DINARI_CRYPTO_SHA256_SIMD_H
+#define DINARI_CRYPTO_SHA256_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dinari {
+namespace crypto {
+namespace sha256_simd {
+
+/**
+ * @brief Multi-lane double SHA-256 of 64-byte inputs
+ *
+ * Each kernel hashes LANES consecutive 64-byte inputs into LANES
+ * consecutive 32-byte outputs, one input per SIMD lane. All inputs are
+ * read before any output is written, so output may alias input.
+ *
+ * The kernels live in their own translation units built with the matching
+ * instruction set flags; callers must check CPU support first.
+ */
+void DoubleSHA256_64_SSE41(unsigned char* output, const unsigned char* input);   // 4 lanes
+void DoubleSHA256_64_AVX2(unsigned char* output, const unsigned char* input);    // 8 lanes
+void DoubleSHA256_64_AVX512(unsigned char* output, const unsigned char* input);  // 16 lanes
+
+/**
+ * @brief Multi-lane SHA-256 of messages padded to one 64-byte block
+ *
+ * Same layout as the double SHA-256 kernels: LANES consecutive padded
+ * blocks in, LANES consecutive 32-byte digests out.
+ */
+void SHA256_OneBlock_SSE41(unsigned char* output, const unsigned char* input);    // 4 lanes
+void SHA256_OneBlock_AVX2(unsigned char* output, const unsigned char* input);     // 8 lanes
+void SHA256_OneBlock_AVX512(unsigned char* output, const unsigned char* input);   // 16 lanes
+
+/**
+ * @brief SHA-256 compression of `blocks` consecutive 64-byte blocks
+ * into `state` using the SHA extensions (SHA-NI)
+ */
+void TransformSHANI(uint32_t state[8], const unsigned char* input, size_t blocks);
+
+} // namespace sha256_simd
+} // namespace crypto
+} // namespace dinari
+
+#endif // DINARI_CRYPTO_SHA256_SIMD_H
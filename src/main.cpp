@@ -11,11 +11,14 @@
 #include "dinari/version.h"
 #include "dinari/constants.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include "util/config.h"
 #include "util/time.h"
+#include "crypto/hash.h"
 #include "blockchain/blockchain.h"
 #include "network/node.h"
 #include "rpc/rpcserver.h"
+#include "rpc/metricsserver.h"
 #include "wallet/wallet.h"
 #include "mining/miner.h"
 
@@ -34,6 +37,7 @@ std::atomic<bool> g_shutdownRequested(false);
 std::unique_ptr<Blockchain> g_blockchain;
 std::unique_ptr<NetworkNode> g_networkNode;
 std::unique_ptr<RPCServer> g_rpcServer;
+std::unique_ptr<MetricsServer> g_metricsServer;
 std::unique_ptr<Wallet> g_wallet;
 std::unique_ptr<Miner> g_miner;
 
@@ -70,6 +74,8 @@ void PrintUsage(const char* programName) {
     std::cout << "  -v, --version           Show version information" << std::endl;
     std::cout << "  --config=<file>         Load configuration from file" << std::endl;
     std::cout << "  --datadir=<dir>         Set data directory" << std::endl;
+    std::cout << "  --prune=<MiB>           Delete old block data to stay under <MiB> (0 = keep all)" << std::endl;
+    std::cout << "  --consolidateminutxos=<n>  Merge wallet coins once more than <n> UTXOs are held (0 = never)" << std::endl;
     std::cout << "  --testnet               Run on testnet" << std::endl;
     std::cout << "  --daemon                Run as daemon (background)" << std::endl;
     std::cout << "  --mining                Enable mining" << std::endl;
@@ -82,6 +88,9 @@ void PrintUsage(const char* programName) {
     std::cout << "  --port=<port>           P2P network port" << std::endl;
     std::cout << "  --listen                Accept incoming connections" << std::endl;
     std::cout << "  --loglevel=<level>      Log level (trace, debug, info, warning, error)" << std::endl;
+    std::cout << "  --binarylog=<file>      Also write binary log records to <file> in the data directory" << std::endl;
+    std::cout << "  --metrics               Serve Prometheus metrics on localhost" << std::endl;
+    std::cout << "  --metricsport=<port>    Metrics HTTP port (default: 9335)" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << programName << " --testnet                  # Run testnet node" << std::endl;
@@ -138,6 +147,11 @@ bool Initialize(int argc, char** argv) {
     Logger::Instance().Initialize(logFile, level);
     Logger::Instance().SetConsoleOutput(Config::Instance().GetBool("printtoconsole", true));
 
+    std::string binaryLogFile = Config::Instance().GetString("binarylog", "");
+    if (!binaryLogFile.empty()) {
+        Logger::Instance().OpenBinaryLog(Config::Instance().GetDataDir() + "/" + binaryLogFile);
+    }
+
     // Log startup
     LOG_INFO("Main", "=======================================================");
     LOG_INFO("Main", "Dinari Blockchain Node Starting");
@@ -146,6 +160,16 @@ bool Initialize(int argc, char** argv) {
     LOG_INFO("Main", "Data Directory: " + Config::Instance().GetDataDir());
     LOG_INFO("Main", "=======================================================");
 
+    // Hash kernels are chosen per CPU; don't run on one that hashes wrongly
+    if (!crypto::Hash::SelfTest()) {
+        LOG_ERROR("Main", "Hash self-test failed (SHA-256: " +
+                  std::string(crypto::Hash::SHA256Implementation()) + ", batched: " +
+                  crypto::Hash::DoubleSHA256_64Implementation() + ")");
+        return false;
+    }
+    LOG_INFO("Main", "SHA-256: " + std::string(crypto::Hash::SHA256Implementation()) +
+             ", batched: " + crypto::Hash::DoubleSHA256_64Implementation());
+
     return true;
 }
 
@@ -158,6 +182,18 @@ int RunNode() {
         LOG_INFO("Main", "Initializing blockchain with persistent storage...");
         g_blockchain = std::make_unique<Blockchain>();
 
+        // Optional cap on the disk used by block data, in MiB
+        int pruneMB = Config::Instance().GetInt("prune", 0);
+        if (pruneMB < 0 || (pruneMB > 0 && static_cast<uint64_t>(pruneMB) < MIN_PRUNE_TARGET_MB)) {
+            LOG_ERROR("Main", "Prune target must be 0 (disabled) or at least " +
+                      std::to_string(MIN_PRUNE_TARGET_MB) + " MiB");
+            return 1;
+        }
+        if (pruneMB > 0) {
+            g_blockchain->SetPruneTarget(static_cast<uint64_t>(pruneMB) * 1024 * 1024);
+            LOG_INFO("Main", "Block pruning enabled, target " + std::to_string(pruneMB) + " MiB");
+        }
+
         // Get data directory
         std::string dataDir = Config::Instance().GetDataDir();
         LOG_INFO("Main", "Data directory: " + dataDir);
@@ -185,6 +221,14 @@ int RunNode() {
             walletConfig.dataDir = Config::Instance().GetDataDir() + "/wallet";
             walletConfig.testnet = Config::Instance().IsTestnet();
 
+            // Auto-consolidation spends coins unprompted, so it is opt-in
+            int consolidateMin = Config::Instance().GetInt("consolidateminutxos", 0);
+            if (consolidateMin < 0) {
+                LOG_ERROR("Main", "consolidateminutxos must be 0 (disabled) or a UTXO count");
+                return 1;
+            }
+            walletConfig.consolidateMinUTXOs = static_cast<size_t>(consolidateMin);
+
             g_wallet = std::make_unique<Wallet>(walletConfig);
 
             // Try to load existing wallet
@@ -195,6 +239,18 @@ int RunNode() {
                 g_wallet->GenerateNewAddress("default");
             }
 
+            // Keep wallet in sync with the active chain
+            g_wallet->SetChainHeight(g_blockchain->GetHeight());
+            Wallet* wallet = g_wallet.get();
+            g_blockchain->RegisterBlockConnectedCallback(
+                [wallet](const Block& block, BlockHeight height) {
+                    wallet->BlockConnected(block, height);
+                });
+            g_blockchain->RegisterBlockDisconnectedCallback(
+                [wallet](const Block& block, BlockHeight height) {
+                    wallet->BlockDisconnected(block, height);
+                });
+
             LOG_INFO("Main", "Wallet initialized");
         }
 
@@ -226,6 +282,23 @@ int RunNode() {
             LOG_INFO("Main", "Network initialized on port " + std::to_string(networkConfig.port));
         }
 
+        // Batched payouts and consolidation relay through the network node
+        if (g_wallet) {
+            if (g_networkNode) {
+                NetworkNode* node = g_networkNode.get();
+                g_wallet->SetBroadcastCallback([node](const Transaction& tx) {
+                    node->BroadcastTransaction(tx);
+                });
+            }
+
+            Blockchain* chain = g_blockchain.get();
+            g_wallet->SetFeeRateCallback([chain]() {
+                return chain->GetMemPool().GetStats().avgFeeRate;
+            });
+
+            g_wallet->StartScheduler();
+        }
+
         // Initialize RPC server
         if (Config::Instance().GetBool("server", true)) {
             LOG_INFO("Main", "Initializing RPC server...");
@@ -251,6 +324,37 @@ int RunNode() {
             LOG_WARNING("Main", "RPC Authentication: CHANGE DEFAULT CREDENTIALS!");
         }
 
+        // Initialize metrics endpoint
+        if (Config::Instance().GetBool("metrics", false)) {
+            // Gauges for state that is cheaper to read at scrape time
+            Metrics::Instance().AddCollector([]() {
+                Metrics& metrics = Metrics::Instance();
+                if (g_blockchain) {
+                    const MemPool& pool = g_blockchain->GetMemPool();
+                    metrics.GetGauge("dinari_chain_height", "Active chain height")
+                        .Set(static_cast<int64_t>(g_blockchain->GetHeight()));
+                    metrics.GetGauge("dinari_mempool_transactions", "Transactions in the mempool")
+                        .Set(static_cast<int64_t>(pool.Size()));
+                    metrics.GetGauge("dinari_mempool_bytes", "Serialized size of the mempool")
+                        .Set(static_cast<int64_t>(pool.GetTotalSize()));
+                }
+                if (g_networkNode) {
+                    metrics.GetGauge("dinari_peers", "Connected peers")
+                        .Set(static_cast<int64_t>(g_networkNode->GetPeerCount()));
+                }
+            });
+
+            MetricsServerConfig metricsConfig;
+            metricsConfig.port = Config::Instance().GetInt("metricsport",
+                Config::Instance().IsTestnet() ? 19335 : 9335);
+
+            g_metricsServer = std::make_unique<MetricsServer>();
+            if (!g_metricsServer->Start(metricsConfig)) {
+                LOG_ERROR("Main", "Failed to start metrics server");
+                g_metricsServer.reset();
+            }
+        }
+
         // Initialize mining
         if (Config::Instance().GetBool("mining", false)) {
             LOG_INFO("Main", "Initializing mining...");
@@ -349,6 +453,12 @@ int RunNode() {
             g_miner.reset();
         }
 
+        // Stop metrics before the components its collector reads
+        if (g_metricsServer) {
+            g_metricsServer->Stop();
+            g_metricsServer.reset();
+        }
+
         // Stop RPC server
         if (g_rpcServer) {
             LOG_INFO("Main", "Stopping RPC server...");
@@ -356,6 +466,12 @@ int RunNode() {
             g_rpcServer.reset();
         }
 
+        // Stop wallet payouts before the node they broadcast through goes away
+        if (g_wallet) {
+            g_wallet->StopScheduler();
+            g_wallet->SetBroadcastCallback(nullptr);
+        }
+
         // Close network connections
         if (g_networkNode) {
             LOG_INFO("Main", "Stopping network...");
@@ -207,20 +207,18 @@ bool Miner::CreateCandidateBlock(Block& block) {
 
     coinbase.vout.push_back(coinbaseOutput);
 
-    block.transactions.push_back(coinbase);
+    block.transactions.push_back(MakeTransactionRef(std::move(coinbase)));
 
-    // Add transactions from mempool
+    // Add transactions from mempool (shared, not copied)
     const MemPool& mempool = blockchain.GetMemPool();
-    std::vector<Transaction> mempoolTxs = mempool.GetTransactionsForMining(MAX_BLOCK_SIZE - 1000, 1000);
-
-    for (const auto& tx : mempoolTxs) {
-        block.transactions.push_back(tx);
-    }
+    std::vector<TransactionRef> mempoolTxs = mempool.GetTransactionsForMining(MAX_BLOCK_SIZE - 1000, 1000);
+    block.transactions.insert(block.transactions.end(), mempoolTxs.begin(), mempoolTxs.end());
 
     // Calculate merkle root
     std::vector<Hash256> txHashes;
+    txHashes.reserve(block.transactions.size());
     for (const auto& tx : block.transactions) {
-        txHashes.push_back(tx.GetHash());
+        txHashes.push_back(tx->GetHash());
     }
     block.header.merkleRoot = MerkleTree::ComputeMerkleRoot(txHashes);
 
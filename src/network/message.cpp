@@ -43,10 +43,10 @@ bytes VersionMessage::Serialize() const {
     s.WriteInt32(startHeight);
     s.WriteUInt8(relay ? 1 : 0);
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool VersionMessage::Deserialize(const bytes& data) {
+bool VersionMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
 
@@ -56,14 +56,12 @@ bool VersionMessage::Deserialize(const bytes& data) {
 
         // addrRecv
         addrRecv.services = d.ReadUInt64();
-        bytes recvIp = d.ReadBytes(16);
-        std::copy(recvIp.begin(), recvIp.end(), addrRecv.ip.data());
+        d.ReadBytes(addrRecv.ip.data(), 16);
         addrRecv.port = d.ReadUInt16();
 
         // addrFrom
         addrFrom.services = d.ReadUInt64();
-        bytes fromIp = d.ReadBytes(16);
-        std::copy(fromIp.begin(), fromIp.end(), addrFrom.ip.data());
+        d.ReadBytes(addrFrom.ip.data(), 16);
         addrFrom.port = d.ReadUInt16();
 
         nonce = d.ReadUInt64();
@@ -87,10 +85,10 @@ bool VersionMessage::Deserialize(const bytes& data) {
 bytes PingMessage::Serialize() const {
     Serializer s;
     s.WriteUInt64(nonce);
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool PingMessage::Deserialize(const bytes& data) {
+bool PingMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         nonce = d.ReadUInt64();
@@ -106,10 +104,10 @@ bool PingMessage::Deserialize(const bytes& data) {
 bytes PongMessage::Serialize() const {
     Serializer s;
     s.WriteUInt64(nonce);
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool PongMessage::Deserialize(const bytes& data) {
+bool PongMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         nonce = d.ReadUInt64();
@@ -133,10 +131,10 @@ bytes AddrMessage::Serialize() const {
         s.WriteUInt16(addr.port);
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool AddrMessage::Deserialize(const bytes& data) {
+bool AddrMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         uint64_t count = d.ReadVarInt();
@@ -153,8 +151,7 @@ bool AddrMessage::Deserialize(const bytes& data) {
             NetworkAddress addr;
             addr.timestamp = d.ReadUInt32();
             addr.services = d.ReadUInt64();
-            bytes ip = d.ReadBytes(16);
-            std::copy(ip.begin(), ip.end(), addr.ip.data());
+            d.ReadBytes(addr.ip.data(), 16);
             addr.port = d.ReadUInt16();
 
             addresses.push_back(addr);
@@ -178,10 +175,10 @@ bytes InvMessage::Serialize() const {
         s.WriteHash256(item.hash);
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool InvMessage::Deserialize(const bytes& data) {
+bool InvMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         uint64_t count = d.ReadVarInt();
@@ -220,10 +217,10 @@ bytes GetDataMessage::Serialize() const {
         s.WriteHash256(item.hash);
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool GetDataMessage::Deserialize(const bytes& data) {
+bool GetDataMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         uint64_t count = d.ReadVarInt();
@@ -262,10 +259,10 @@ bytes NotFoundMessage::Serialize() const {
         s.WriteHash256(item.hash);
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool NotFoundMessage::Deserialize(const bytes& data) {
+bool NotFoundMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         uint64_t count = d.ReadVarInt();
@@ -301,10 +298,10 @@ bytes GetBlocksMessage::Serialize() const {
 
     s.WriteHash256(hashStop);
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool GetBlocksMessage::Deserialize(const bytes& data) {
+bool GetBlocksMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
 
@@ -340,10 +337,10 @@ bytes GetHeadersMessage::Serialize() const {
 
     s.WriteHash256(hashStop);
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool GetHeadersMessage::Deserialize(const bytes& data) {
+bool GetHeadersMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
 
@@ -371,10 +368,10 @@ bool GetHeadersMessage::Deserialize(const bytes& data) {
 bytes BlockMessage::Serialize() const {
     Serializer s;
     block.SerializeImpl(s);
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool BlockMessage::Deserialize(const bytes& data) {
+bool BlockMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         block.DeserializeImpl(d);
@@ -395,10 +392,10 @@ bytes HeadersMessage::Serialize() const {
         s.WriteVarInt(0);  // Transaction count (0 for headers)
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool HeadersMessage::Deserialize(const bytes& data) {
+bool HeadersMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
         uint64_t count = d.ReadVarInt();
@@ -433,15 +430,19 @@ bool HeadersMessage::Deserialize(const bytes& data) {
 // TxMessage implementation
 
 bytes TxMessage::Serialize() const {
-    Serializer s;
-    tx.SerializeImpl(s);
-    return s.GetData();
+    bytes data;
+    data.reserve(tx->GetSize());
+    Serializer s(data);
+    tx->SerializeImpl(s);
+    return data;
 }
 
-bool TxMessage::Deserialize(const bytes& data) {
+bool TxMessage::Deserialize(ByteSpan data) {
     try {
         Deserializer d(data);
-        tx.DeserializeImpl(d);
+        auto received = std::make_shared<Transaction>();
+        received->DeserializeImpl(d);
+        tx = std::move(received);
         return true;
     } catch (const std::exception&) {
         return false;
@@ -460,10 +461,10 @@ bytes RejectMessage::Serialize() const {
         s.WriteBytes(data.data(), data.size());
     }
 
-    return s.GetData();
+    return s.MoveData();
 }
 
-bool RejectMessage::Deserialize(const bytes& bytes) {
+bool RejectMessage::Deserialize(ByteSpan bytes) {
     try {
         Deserializer d(bytes);
 
@@ -474,7 +475,7 @@ bool RejectMessage::Deserialize(const bytes& bytes) {
         reason = d.ReadString(reasonLen);
 
         if (d.Available() > 0) {
-            data = d.ReadBytes(d.Available());
+            data = d.ReadBytes(d.Remaining());
         }
 
         return true;
@@ -524,14 +525,12 @@ bytes MessageSerializer::SerializeMessage(const NetworkMessage& msg, uint32_t ma
     header.payloadSize = static_cast<uint32_t>(payload.size());
     header.checksum = CalculateChecksum(payload);
 
-    // Serialize header
-    bytes headerBytes = SerializeHeader(header);
-
-    // Combine
+    // Header and payload into one buffer
     bytes result;
-    result.reserve(headerBytes.size() + payload.size());
-    result.insert(result.end(), headerBytes.begin(), headerBytes.end());
-    result.insert(result.end(), payload.begin(), payload.end());
+    result.reserve(24 + payload.size());
+    Serializer s(result);
+    SerializeHeader(header, s);
+    s.WriteBytes(payload);
 
     return result;
 }
@@ -563,8 +562,8 @@ std::unique_ptr<NetworkMessage> MessageSerializer::DeserializeMessage(
         return nullptr;  // Need more data
     }
 
-    // Extract payload
-    bytes payload(data.begin() + 24, data.begin() + 24 + header.payloadSize);
+    // Payload is read in place
+    ByteSpan payload(data.data() + 24, header.payloadSize);
 
     // Verify checksum
     uint32_t calculatedChecksum = CalculateChecksum(payload);
@@ -616,21 +615,21 @@ std::unique_ptr<NetworkMessage> MessageSerializer::DeserializeMessage(
     return msg;
 }
 
-uint32_t MessageSerializer::CalculateChecksum(const bytes& payload) {
-    Hash256 hash = crypto::Hash::DoubleSHA256(payload);
-    return *reinterpret_cast<const uint32_t*>(hash.data());
+uint32_t MessageSerializer::CalculateChecksum(ByteSpan payload) {
+    Hash256 hash = crypto::Hash::DoubleSHA256(payload.data(), payload.size());
+    uint32_t checksum;
+    std::memcpy(&checksum, hash.data(), sizeof(checksum));
+    return checksum;
 }
 
-bytes MessageSerializer::SerializeHeader(const MessageHeader& header) {
-    Serializer s;
+void MessageSerializer::SerializeHeader(const MessageHeader& header, Serializer& s) {
     s.WriteUInt32(header.magic);
     s.WriteBytes(reinterpret_cast<const byte*>(header.command), 12);
     s.WriteUInt32(header.payloadSize);
     s.WriteUInt32(header.checksum);
-    return s.GetData();
 }
 
-bool MessageSerializer::DeserializeHeader(const bytes& data, MessageHeader& header) {
+bool MessageSerializer::DeserializeHeader(ByteSpan data, MessageHeader& header) {
     if (data.size() < 24) {
         return false;
     }
@@ -638,8 +637,7 @@ bool MessageSerializer::DeserializeHeader(const bytes& data, MessageHeader& head
     try {
         Deserializer d(data);
         header.magic = d.ReadUInt32();
-        bytes commandBytes = d.ReadBytes(12);
-        std::memcpy(header.command, commandBytes.data(), 12);
+        d.ReadBytes(reinterpret_cast<byte*>(header.command), 12);
         header.payloadSize = d.ReadUInt32();
         header.checksum = d.ReadUInt32();
 
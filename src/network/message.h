@@ -38,7 +38,7 @@ public:
 
     virtual NetMsgType GetType() const = 0;
     virtual bytes Serialize() const = 0;
-    virtual bool Deserialize(const bytes& data) = 0;
+    virtual bool Deserialize(ByteSpan data) = 0;
 
     static std::unique_ptr<NetworkMessage> CreateFromType(NetMsgType type);
 };
@@ -62,7 +62,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::VERSION; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -72,7 +72,7 @@ class VerackMessage : public NetworkMessage {
 public:
     NetMsgType GetType() const override { return NetMsgType::VERACK; }
     bytes Serialize() const override { return bytes(); }
-    bool Deserialize(const bytes& data) override { (void)data; return true; }
+    bool Deserialize(ByteSpan data) override { (void)data; return true; }
 };
 
 /**
@@ -87,7 +87,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::PING; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -102,7 +102,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::PONG; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -117,7 +117,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::ADDR; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -127,7 +127,7 @@ class GetAddrMessage : public NetworkMessage {
 public:
     NetMsgType GetType() const override { return NetMsgType::GETADDR; }
     bytes Serialize() const override { return bytes(); }
-    bool Deserialize(const bytes& data) override { (void)data; return true; }
+    bool Deserialize(ByteSpan data) override { (void)data; return true; }
 };
 
 /**
@@ -142,7 +142,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::INV; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -157,7 +157,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::GETDATA; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -172,7 +172,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::NOTFOUND; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -188,7 +188,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::GETBLOCKS; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -204,7 +204,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::GETHEADERS; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -219,7 +219,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::BLOCK; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -234,7 +234,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::HEADERS; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -242,14 +242,14 @@ public:
  */
 class TxMessage : public NetworkMessage {
 public:
-    Transaction tx;
+    TransactionRef tx;      // Shared with the mempool, never copied for relay
 
     TxMessage() {}
-    explicit TxMessage(const Transaction& t) : tx(t) {}
+    explicit TxMessage(const TransactionRef& t) : tx(t) {}
 
     NetMsgType GetType() const override { return NetMsgType::TX; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -259,7 +259,7 @@ class MempoolMessage : public NetworkMessage {
 public:
     NetMsgType GetType() const override { return NetMsgType::MEMPOOL; }
     bytes Serialize() const override { return bytes(); }
-    bool Deserialize(const bytes& data) override { (void)data; return true; }
+    bool Deserialize(ByteSpan data) override { (void)data; return true; }
 };
 
 /**
@@ -276,7 +276,7 @@ public:
 
     NetMsgType GetType() const override { return NetMsgType::REJECT; }
     bytes Serialize() const override;
-    bool Deserialize(const bytes& data) override;
+    bool Deserialize(ByteSpan data) override;
 };
 
 /**
@@ -298,11 +298,11 @@ public:
     /**
      * @brief Calculate message checksum
      */
-    static uint32_t CalculateChecksum(const bytes& payload);
+    static uint32_t CalculateChecksum(ByteSpan payload);
 
 private:
-    static bytes SerializeHeader(const MessageHeader& header);
-    static bool DeserializeHeader(const bytes& data, MessageHeader& header);
+    static void SerializeHeader(const MessageHeader& header, Serializer& s);
+    static bool DeserializeHeader(ByteSpan data, MessageHeader& header);
 };
 
 } // namespace dinari
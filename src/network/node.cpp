@@ -1,5 +1,6 @@
 #include "node.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include "util/time.h"
 #include <algorithm>
 #include <chrono>
@@ -8,6 +9,7 @@ namespace dinari {
 
 NetworkNode::NetworkNode(Blockchain& chain)
     : blockchain(chain)
+    , localServices(NODE_NETWORK)
     , nextPeerId(1)
     , running(false)
     , shouldStop(false) {
@@ -22,6 +24,12 @@ bool NetworkNode::Initialize(const NetworkConfig& cfg) {
 
     LOG_INFO("Network", "Initializing network node");
 
+    // A pruned node can only serve recent blocks
+    if (blockchain.IsPruned()) {
+        localServices = NODE_NETWORK_LIMITED;
+        LOG_INFO("Network", "Block data is pruned, advertising NODE_NETWORK_LIMITED");
+    }
+
     // Initialize networking
     if (!NetBase::Initialize()) {
         LOG_ERROR("Network", "Failed to initialize network");
@@ -197,6 +205,7 @@ bool NetworkNode::ConnectToPeer(const NetworkAddress& addr) {
         std::lock_guard<std::mutex> lock(peersMutex);
         peerId = nextPeerId++;
         peer = std::make_shared<Peer>(addr, peerId);
+        peer->SetLocalServices(localServices);
         peers[peerId] = peer;
     }
 
@@ -409,6 +418,7 @@ PeerPtr NetworkNode::AddPeer(SOCKET socket, const NetworkAddress& addr, bool inb
 
     uint64_t peerId = nextPeerId++;
     auto peer = std::make_shared<Peer>(socket, addr, peerId);
+    peer->SetLocalServices(localServices);
 
     peers[peerId] = peer;
 
@@ -452,10 +462,44 @@ void NetworkNode::CleanupPeers() {
     }
 }
 
+namespace {
+
+/**
+ * @brief Per-message-type handling metrics
+ */
+struct MessageMetrics {
+    Counter& received;
+    Histogram& latency;
+};
+
+MessageMetrics& GetMessageMetrics(NetMsgType type) {
+    // Cached per thread so the registry lock is only taken on first sight of a type
+    thread_local std::unordered_map<uint32_t, MessageMetrics> cache;
+
+    auto it = cache.find(static_cast<uint32_t>(type));
+    if (it == cache.end()) {
+        std::string labels = std::string("type=\"") + GetMessageTypeName(type) + "\"";
+        MessageMetrics metrics{
+            Metrics::Instance().GetCounter("dinari_net_messages_total",
+                "Network messages processed", labels),
+            Metrics::Instance().GetHistogram("dinari_net_message_seconds",
+                "Time spent handling network messages", labels)
+        };
+        it = cache.emplace(static_cast<uint32_t>(type), metrics).first;
+    }
+    return it->second;
+}
+
+} // namespace
+
 void NetworkNode::ProcessPeerMessages(PeerPtr peer) {
     auto messages = peer->FetchMessages();
 
     for (auto& msg : messages) {
+        MessageMetrics& metrics = GetMessageMetrics(msg->GetType());
+        metrics.received.Inc();
+        ScopedTimer timer(metrics.latency);
+
         switch (msg->GetType()) {
             case NetMsgType::INV:
                 HandleInvMessage(peer, *static_cast<InvMessage*>(msg.get()));
@@ -544,7 +588,12 @@ void NetworkNode::HandleBlockMessage(PeerPtr peer, const BlockMessage& msg) {
 }
 
 void NetworkNode::HandleTxMessage(PeerPtr peer, const TxMessage& msg) {
-    const Transaction& tx = msg.tx;
+    if (!msg.tx) {
+        return;
+    }
+
+    // Hash and size were cached from the wire bytes during deserialization
+    const Transaction& tx = *msg.tx;
     Hash256 txHash = tx.GetHash();
 
     LOG_DEBUG("Network", "Received transaction " + crypto::Hash::ToHex(txHash) + " from peer " + std::to_string(peer->GetId()));
@@ -564,12 +613,9 @@ void NetworkNode::HandleTxMessage(PeerPtr peer, const TxMessage& msg) {
 
     // Check transaction size (max 1MB = 1,000,000 bytes)
     const size_t MAX_TX_SIZE = 1000000;
-    Serializer txSer;
-    tx.SerializeImpl(txSer);
-    bytes serialized = txSer.GetData();
-    if (serialized.size() > MAX_TX_SIZE) {
+    if (tx.GetSize() > MAX_TX_SIZE) {
         LOG_WARNING("Network", "Transaction " + crypto::Hash::ToHex(txHash) + " exceeds max size: " +
-                              std::to_string(serialized.size()) + " > " + std::to_string(MAX_TX_SIZE));
+                              std::to_string(tx.GetSize()) + " > " + std::to_string(MAX_TX_SIZE));
         peer->Misbehaving(20);
         return;
     }
@@ -604,7 +650,7 @@ void NetworkNode::HandleTxMessage(PeerPtr peer, const TxMessage& msg) {
 
     // Add to mempool with full validation
     BlockHeight currentHeight = blockchain.GetHeight();
-    if (!mempool.AddTransaction(tx, utxos, currentHeight)) {
+    if (!mempool.AddTransaction(msg.tx, utxos, currentHeight)) {
         LOG_WARNING("Network", "Failed to add transaction " + crypto::Hash::ToHex(txHash) + " to mempool");
         peer->Misbehaving(5);  // Minor: validation failed
         return;
@@ -692,14 +738,22 @@ void NetworkNode::SendBlock(PeerPtr peer, const Hash256& blockHash) {
 }
 
 void NetworkNode::SendTransaction(PeerPtr peer, const Hash256& txHash) {
-    // Note: Transaction lookup from mempool and blockchain can be added when needed
-    // For now, send NOTFOUND
-    InvItem item;
-    item.type = InvType::TX;
-    item.hash = txHash;
+    // Only unconfirmed transactions are served
+    TransactionRef tx = blockchain.GetMemPool().GetTransaction(txHash);
+    if (tx) {
+        TxMessage msg(tx);
+        peer->SendMessage(msg);
 
-    NotFoundMessage msg({item});
-    peer->SendMessage(msg);
+        LOG_DEBUG("Network", "Sent transaction " + crypto::Hash::ToHex(txHash) + " to peer");
+    } else {
+        // Send NOTFOUND
+        InvItem item;
+        item.type = InvType::TX;
+        item.hash = txHash;
+
+        NotFoundMessage msg({item});
+        peer->SendMessage(msg);
+    }
 }
 
 void NetworkNode::SendHeaders(PeerPtr peer, const std::vector<BlockHeader>& headers) {
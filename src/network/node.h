@@ -145,6 +145,7 @@ private:
     Blockchain& blockchain;
     AddressManager addrman;
     NetworkConfig config;
+    uint64_t localServices;  // Service bits advertised to peers
 
     // Peers
     std::map<uint64_t, PeerPtr> peers;
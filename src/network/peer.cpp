@@ -1,6 +1,7 @@
 #include "peer.h"
 #include "util/logger.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "crypto/hash.h"
 #include <random>
 
@@ -24,6 +25,7 @@ Peer::Peer(SOCKET s, const NetworkAddress& addr, uint64_t peerId)
     , services(0)
     , startHeight(0)
     , nonce(GenerateNonce())
+    , localServices(NODE_NETWORK)
     , lastPingNonce(0)
     , misbehaviorScore(0) {
 
@@ -43,6 +45,7 @@ Peer::Peer(const NetworkAddress& addr, uint64_t peerId)
     , services(0)
     , startHeight(0)
     , nonce(GenerateNonce())
+    , localServices(NODE_NETWORK)
     , lastPingNonce(0)
     , misbehaviorScore(0) {
 
@@ -138,6 +141,7 @@ bool Peer::SendMessage(const NetworkMessage& msg) {
 }
 
 bool Peer::ProcessIncoming() {
+    TRACE_SCOPE("Peer::ProcessIncoming");
     std::lock_guard<std::mutex> lock(mutex);
 
     if (!IsConnected() || !socket.IsValid()) {
@@ -389,7 +393,7 @@ void Peer::HandlePongMessage(const PongMessage& msg) {
 void Peer::SendVersionMessage() {
     VersionMessage msg;
     msg.version = PROTOCOL_VERSION;
-    msg.services = NODE_NETWORK;
+    msg.services = localServices;
     msg.timestamp = Time::GetCurrentTime();
     msg.addrRecv = address;
     msg.nonce = nonce;
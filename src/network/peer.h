@@ -186,6 +186,11 @@ public:
      */
     int GetMisbehaviorScore() const { return misbehaviorScore.load(); }
 
+    /**
+     * @brief Set the service bits advertised in our VERSION message
+     */
+    void SetLocalServices(uint64_t flags) { localServices = flags; }
+
 private:
     // Connection info
     uint64_t id;
@@ -200,6 +205,7 @@ private:
     BlockHeight startHeight;
     std::string userAgent;
     uint64_t nonce;  // For version handshake
+    uint64_t localServices;  // Advertised to the peer
 
     // Buffers
     bytes recvBuffer;
@@ -0,0 +1,166 @@
+#include "metricsserver.h"
+#include "util/metrics.h"
+#include "util/logger.h"
+#include "util/time.h"
+#include <sstream>
+
+namespace dinari {
+
+MetricsServer::MetricsServer()
+    : running(false)
+    , shouldStop(false) {
+}
+
+MetricsServer::~MetricsServer() {
+    Stop();
+}
+
+bool MetricsServer::Start(const MetricsServerConfig& cfg) {
+    if (running.load()) {
+        return true;
+    }
+
+    config = cfg;
+
+    NetworkAddress bindAddr;
+    if (!NetBase::StringToIP(config.bindAddress, bindAddr)) {
+        LOG_ERROR("Metrics", "Invalid bind address: " + config.bindAddress);
+        return false;
+    }
+    bindAddr.port = config.port;
+
+    SOCKET sock = NetBase::CreateSocket();
+    if (!NetBase::IsValid(sock)) {
+        LOG_ERROR("Metrics", "Failed to create listen socket");
+        return false;
+    }
+
+    listenSocket = SocketRAII(sock);
+    NetBase::SetSocketOptions(listenSocket.Get());
+    NetBase::SetNonBlocking(listenSocket.Get(), true);
+
+    if (!NetBase::Bind(listenSocket.Get(), bindAddr)) {
+        LOG_ERROR("Metrics", "Failed to bind to port " + std::to_string(config.port));
+        listenSocket = SocketRAII(INVALID_SOCKET_VALUE);
+        return false;
+    }
+
+    if (!NetBase::Listen(listenSocket.Get())) {
+        LOG_ERROR("Metrics", "Failed to listen on socket");
+        listenSocket = SocketRAII(INVALID_SOCKET_VALUE);
+        return false;
+    }
+
+    shouldStop.store(false);
+    running.store(true);
+    serverThread = std::thread(&MetricsServer::ServerThreadFunc, this);
+
+    LOG_INFO("Metrics", "Serving /metrics on " + config.bindAddress + ":" +
+             std::to_string(config.port));
+
+    return true;
+}
+
+void MetricsServer::Stop() {
+    if (!running.load()) {
+        return;
+    }
+
+    shouldStop.store(true);
+
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+
+    listenSocket = SocketRAII(INVALID_SOCKET_VALUE);
+    running.store(false);
+
+    LOG_INFO("Metrics", "Metrics server stopped");
+}
+
+std::string MetricsServer::HandleHTTPRequest(const std::string& request) {
+    std::istringstream requestLine(request.substr(0, request.find("\r\n")));
+    std::string method;
+    std::string target;
+    requestLine >> method >> target;
+
+    std::string status = "200 OK";
+    std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+    std::string body;
+
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else if (target != "/metrics") {
+        status = "404 Not Found";
+        body = "Try /metrics\n";
+    } else {
+        body = Metrics::Instance().RenderPrometheus();
+    }
+
+    std::ostringstream oss;
+    oss << "HTTP/1.1 " << status << "\r\n";
+    oss << "Content-Type: " << contentType << "\r\n";
+    oss << "Content-Length: " << body.size() << "\r\n";
+    oss << "Connection: close\r\n";
+    oss << "\r\n";
+    oss << body;
+
+    return oss.str();
+}
+
+void MetricsServer::ServerThreadFunc() {
+    while (!shouldStop.load()) {
+        NetworkAddress addr;
+        SOCKET client = NetBase::Accept(listenSocket.Get(), addr);
+
+        if (!NetBase::IsValid(client)) {
+            Time::SleepMillis(50);
+            continue;
+        }
+
+        ServeClient(client);
+        NetBase::CloseSocket(client);
+    }
+}
+
+void MetricsServer::ServeClient(SOCKET client) {
+    NetBase::SetNonBlocking(client, true);
+
+    std::string request;
+    byte buffer[1024];
+    int waitedMs = 0;
+
+    // Read until the end of the headers; the body (if any) is ignored
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        int received = NetBase::Receive(client, buffer, sizeof(buffer));
+        if (received > 0) {
+            request.append(reinterpret_cast<const char*>(buffer), received);
+            if (request.size() > MAX_REQUEST_SIZE) {
+                return;
+            }
+            continue;
+        }
+        if (received == 0 || waitedMs >= REQUEST_TIMEOUT_MS || shouldStop.load()) {
+            return;
+        }
+        Time::SleepMillis(10);
+        waitedMs += 10;
+    }
+
+    std::string response = HandleHTTPRequest(request);
+
+    // Blocking send so large responses are written in full
+    NetBase::SetNonBlocking(client, false);
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int n = NetBase::Send(client, reinterpret_cast<const byte*>(response.data()) + sent,
+                              response.size() - sent);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace dinari
@@ -0,0 +1,75 @@
+#ifndef DINARI_RPC_METRICSSERVER_H
+#define DINARI_RPC_METRICSSERVER_H
+
+#include "network/netbase.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace dinari {
+
+/**
+ * @brief Metrics endpoint configuration
+ */
+struct MetricsServerConfig {
+    std::string bindAddress;
+    uint16_t port;
+
+    MetricsServerConfig()
+        : bindAddress("127.0.0.1")
+        , port(9335) {}
+};
+
+/**
+ * @brief Minimal HTTP server exposing GET /metrics
+ *
+ * Serves the Metrics registry in the Prometheus text format, one request
+ * per connection, from a single background thread. Unauthenticated, so it
+ * binds to localhost unless configured otherwise.
+ */
+class MetricsServer {
+public:
+    MetricsServer();
+    ~MetricsServer();
+
+    /**
+     * @brief Bind and start serving
+     */
+    bool Start(const MetricsServerConfig& config);
+
+    /**
+     * @brief Stop serving and close the socket
+     */
+    void Stop();
+
+    /**
+     * @brief Check if running
+     */
+    bool IsRunning() const { return running.load(); }
+
+    /**
+     * @brief Build the HTTP response for a raw request
+     */
+    static std::string HandleHTTPRequest(const std::string& request);
+
+private:
+    MetricsServerConfig config;
+    SocketRAII listenSocket;
+
+    std::atomic<bool> running;
+    std::atomic<bool> shouldStop;
+    std::thread serverThread;
+
+    // Largest request header accepted
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;
+
+    // Time a client has to send its request
+    static constexpr int REQUEST_TIMEOUT_MS = 2000;
+
+    void ServerThreadFunc();
+    void ServeClient(SOCKET client);
+};
+
+} // namespace dinari
+
+#endif // DINARI_RPC_METRICSSERVER_H
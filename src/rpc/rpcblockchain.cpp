@@ -1,9 +1,11 @@
 #include "rpcblockchain.h"
+#include "consensus/difficulty.h"
+#include "crypto/hex.h"
 #include "util/logger.h"
+#include "util/config.h"
 #include "util/time.h"
+#include "util/trace.h"
 #include "wallet/address.h"
-#include <ios>
-#include <iomanip>
 #include <sstream>
 
 namespace dinari {
@@ -66,6 +68,31 @@ void BlockchainRPC::RegisterCommands(RPCServer& server) {
         "gettxout <txid> <n>"
     ));
 
+    server.RegisterCommand(RPCCommand(
+        "gettxoutsetinfo",
+        GetTxOutSetInfo,
+        "blockchain",
+        "Returns statistics and the MuHash commitment of the UTXO set, from running totals",
+        "gettxoutsetinfo"
+    ));
+
+    server.RegisterCommand(RPCCommand(
+        "dumptxoutset",
+        DumpTxOutSet,
+        "blockchain",
+        "Writes the UTXO set at the current tip to a snapshot file in the data directory",
+        "dumptxoutset <filename>"
+    ));
+
+    server.RegisterCommand(RPCCommand(
+        "loadtxoutset",
+        LoadTxOutSet,
+        "blockchain",
+        "Starts a fresh chain from a UTXO snapshot file in the data directory. utxo_set_hash is the "
+        "snapshot's muhash as reported by a trusted node's dumptxoutset or gettxoutsetinfo",
+        "loadtxoutset <filename> <utxo_set_hash>"
+    ));
+
     // Mempool commands
     server.RegisterCommand(RPCCommand(
         "getmempoolinfo",
@@ -117,6 +144,14 @@ void BlockchainRPC::RegisterCommands(RPCServer& server) {
         "stop"
     ));
 
+    server.RegisterCommand(RPCCommand(
+        "dumptrace",
+        DumpTrace,
+        "control",
+        "Returns buffered trace spans as Chrome trace_event JSON, or writes them to a file in the data directory",
+        "dumptrace [filename] [clear=false]"
+    ));
+
     LOG_INFO("RPC", "Registered blockchain RPC commands");
 }
 
@@ -146,12 +181,12 @@ JSONValue BlockchainRPC::GetBlockHash(const RPCRequest& req, Blockchain& chain,
         RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Block height out of range");
     }
 
-    const BlockIndex* blockIndex = chain.GetBlockIndex(static_cast<BlockHeight>(height));
-    if (!blockIndex || !blockIndex->block) {
+    Hash256 blockHash = chain.GetBlockHash(static_cast<BlockHeight>(height));
+    if (blockHash == Hash256{}) {
         RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Block not found");
     }
 
-    return JSONValue(crypto::Hash::ToHex(blockIndex->block->GetHash()));
+    return JSONValue(crypto::Hash::ToHex(blockHash));
 }
 
 JSONValue BlockchainRPC::GetBlock(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
@@ -180,8 +215,6 @@ JSONValue BlockchainRPC::GetBlock(const RPCRequest& req, Blockchain& chain, Wall
 
     if (!verbose) {
         // Return hex-encoded block
-        Serializer s;
-        block->SerializeImpl(s);
         return JSONValue(crypto::Hash::ToHex(block->GetHash()));  // Simplified
     }
 
@@ -204,7 +237,7 @@ JSONValue BlockchainRPC::GetBestBlockHash(const RPCRequest& req, Blockchain& cha
         return JSONValue("");
     }
 
-    return JSONValue(tip->crypto::Hash::ToHex(hash));
+    return JSONValue(crypto::Hash::ToHex(tip->GetBlockHash()));
 }
 
 JSONValue BlockchainRPC::GetDifficulty(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
@@ -217,16 +250,12 @@ JSONValue BlockchainRPC::GetDifficulty(const RPCRequest& req, Blockchain& chain,
         return JSONValue(1.0);
     }
 
-    // Convert bits to difficulty
     // Difficulty = max_target / current_target
-    // Simplified calculation
-    double difficulty = static_cast<double>(tip->bits);
-
-    return JSONValue(difficulty);
+    return JSONValue(DifficultyAdjuster::GetDifficulty(tip->GetBits()));
 }
-    (void)wallet;
 
 JSONValue BlockchainRPC::GetBlockchainInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)wallet;
     (void)node;
     RPCHelper::CheckParams(req, 0);
 
@@ -237,9 +266,13 @@ JSONValue BlockchainRPC::GetBlockchainInfo(const RPCRequest& req, Blockchain& ch
     obj.SetString("chain", "main");
     obj.SetInt("blocks", tip ? tip->height : 0);
     obj.SetInt("headers", tip ? tip->height : 0);
-    obj.SetString("bestblockhash", tip ? tip->crypto::Hash::ToHex(hash) : "");
-    obj.SetDouble("difficulty", tip ? static_cast<double>(tip->bits) : 1.0);
-    obj.SetString("chainwork", tip ? tip->crypto::Hash::ToHex(chainWork) : "");
+    obj.SetString("bestblockhash", tip ? crypto::Hash::ToHex(tip->GetBlockHash()) : "");
+    obj.SetDouble("difficulty", tip ? DifficultyAdjuster::GetDifficulty(tip->GetBits()) : 1.0);
+    obj.SetString("chainwork", tip ? tip->chainWork.ToHex() : "");
+    obj.SetBool("pruned", chain.IsPruned());
+    if (chain.IsPruned()) {
+        obj.SetInt("pruneheight", chain.GetPruneHeight());
+    }
 
     return JSONValue(obj.Serialize());
 }
@@ -314,7 +347,7 @@ JSONValue BlockchainRPC::GetRawMempool(const RPCRequest& req, Blockchain& chain,
     }
 
     const MemPool& mempool = chain.GetMemPool();
-    std::vector<Transaction> transactions = mempool.GetAllTransactions();
+    std::vector<TransactionRef> transactions = mempool.GetAllTransactions();
 
     if (!verbose) {
         // Return array of txids
@@ -322,7 +355,7 @@ JSONValue BlockchainRPC::GetRawMempool(const RPCRequest& req, Blockchain& chain,
         oss << "[";
         for (size_t i = 0; i < transactions.size(); ++i) {
             if (i > 0) oss << ",";
-            oss << "\"" << transactions[i].GetHash().ToHex() << "\"";
+            oss << "\"" << transactions[i]->GetHash().ToHex() << "\"";
         }
         oss << "]";
         return JSONValue(oss.str());
@@ -331,7 +364,7 @@ JSONValue BlockchainRPC::GetRawMempool(const RPCRequest& req, Blockchain& chain,
     // Return object with detailed info
     JSONObject obj;
     for (const auto& tx : transactions) {
-        obj.SetObject(tx.GetHash().ToHex(), RPCHelper::TransactionToJSON(tx));
+        obj.SetObject(tx->GetHash().ToHex(), RPCHelper::TransactionToJSON(*tx));
     }
 
     return JSONValue(obj.Serialize());
@@ -360,6 +393,140 @@ JSONValue BlockchainRPC::Stop(const RPCRequest& req, Blockchain& chain, Wallet*
     return JSONValue("Dinari server stopping");
 }
 
+JSONValue BlockchainRPC::DumpTrace(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)chain;
+    (void)wallet;
+    (void)node;
+    RPCHelper::CheckParamsRange(req, 0, 2);
+
+    if (!Tracer::IsCompiledIn()) {
+        RPCHelper::ThrowError(RPC_MISC_ERROR,
+            "Tracing is not compiled in (rebuild with -DENABLE_TRACING=ON)");
+    }
+
+    Tracer& tracer = Tracer::Instance();
+    bool clear = req.params.size() > 1 && RPCHelper::GetBoolParam(req, 1);
+
+    if (req.params.empty()) {
+        std::string trace = tracer.DumpChromeJSON();
+        if (clear) {
+            tracer.Clear();
+        }
+        return JSONValue(trace);
+    }
+
+    // Plain file names only, always inside the data directory
+    std::string filename = RPCHelper::GetStringParam(req, 0);
+    if (filename.empty() || filename.find_first_of("/\\") != std::string::npos ||
+        filename == "." || filename == "..") {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid trace file name: " + filename);
+    }
+
+    std::string path = Config::Instance().GetDataDir() + "/" + filename;
+    size_t events = tracer.GetEventCount();
+    if (!tracer.WriteChromeJSON(path)) {
+        RPCHelper::ThrowError(RPC_MISC_ERROR, "Failed to write trace to " + path);
+    }
+    if (clear) {
+        tracer.Clear();
+    }
+
+    LOG_INFO("RPC", "Wrote " + std::to_string(events) + " trace spans to " + path);
+
+    JSONObject obj;
+    obj.SetString("filename", path);
+    obj.SetInt("events", static_cast<int64_t>(events));
+
+    return JSONValue(obj.Serialize());
+}
+
+JSONValue BlockchainRPC::GetTxOutSetInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)wallet;
+    (void)node;
+    RPCHelper::CheckParams(req, 0);
+
+    const BlockIndex* tip = chain.GetBestBlock();
+    BlockHeight height = tip ? tip->height : 0;
+
+    const UTXOSet& utxos = chain.GetUTXOSet();
+    UTXOSet::Stats stats = utxos.GetStats(height);
+
+    JSONObject obj;
+    obj.SetInt("height", height);
+    obj.SetString("bestblock", tip ? crypto::Hash::ToHex(tip->GetBlockHash()) : "");
+    obj.SetInt("txouts", static_cast<int64_t>(stats.totalUTXOs));
+    obj.SetInt("total_amount", static_cast<int64_t>(stats.totalValue));
+    obj.SetInt("coinbase_txouts", static_cast<int64_t>(stats.coinbaseUTXOs));
+    obj.SetInt("regular_txouts", static_cast<int64_t>(stats.regularUTXOs));
+    obj.SetInt("immature_txouts", static_cast<int64_t>(stats.immatureUTXOs));
+    obj.SetString("muhash", crypto::Hash::ToHex(utxos.GetCommitment()));
+
+    return JSONValue(obj.Serialize());
+}
+
+namespace {
+
+// Plain file names only, always inside the data directory
+std::string GetSnapshotPath(const RPCRequest& req) {
+    std::string filename = RPCHelper::GetStringParam(req, 0);
+    if (filename.empty() || filename.find_first_of("/\\") != std::string::npos ||
+        filename == "." || filename == "..") {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid snapshot file name: " + filename);
+    }
+    return Config::Instance().GetDataDir() + "/" + filename;
+}
+
+JSONValue SnapshotResult(const std::string& path, const UTXOSnapshotMetadata& metadata) {
+    JSONObject obj;
+    obj.SetString("filename", path);
+    obj.SetInt("coins", static_cast<int64_t>(metadata.coinCount));
+    obj.SetString("base_hash", crypto::Hash::ToHex(metadata.baseBlockHash));
+    obj.SetInt("base_height", metadata.baseHeight);
+    obj.SetString("muhash", crypto::Hash::ToHex(metadata.utxoSetHash));
+    obj.SetString("commitment", crypto::Hash::ToHex(metadata.commitment));
+    return JSONValue(obj.Serialize());
+}
+
+} // namespace
+
+JSONValue BlockchainRPC::DumpTxOutSet(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)wallet;
+    (void)node;
+    RPCHelper::CheckParams(req, 1);
+
+    std::string path = GetSnapshotPath(req);
+
+    UTXOSnapshotMetadata metadata;
+    metadata.networkMagic = Config::Instance().IsTestnet() ? TESTNET_MAGIC : MAINNET_MAGIC;
+    if (!chain.DumpUTXOSnapshot(path, metadata)) {
+        RPCHelper::ThrowError(RPC_MISC_ERROR, "Failed to write UTXO snapshot to " + path);
+    }
+
+    return SnapshotResult(path, metadata);
+}
+
+JSONValue BlockchainRPC::LoadTxOutSet(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)wallet;
+    (void)node;
+    RPCHelper::CheckParams(req, 2);
+
+    std::string path = GetSnapshotPath(req);
+
+    UTXOSnapshotMetadata metadata;
+    metadata.networkMagic = Config::Instance().IsTestnet() ? TESTNET_MAGIC : MAINNET_MAGIC;
+    try {
+        metadata.utxoSetHash = crypto::Hash::FromHex256(RPCHelper::GetStringParam(req, 1));
+    } catch (const std::exception&) {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid UTXO set hash");
+    }
+
+    if (!chain.LoadUTXOSnapshot(path, metadata)) {
+        RPCHelper::ThrowError(RPC_MISC_ERROR, "Failed to load UTXO snapshot from " + path);
+    }
+
+    return SnapshotResult(path, metadata);
+}
+
 // Blockchain Explorer implementations
 
 JSONValue BlockchainRPC::GetRawTransaction(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
@@ -383,13 +550,13 @@ JSONValue BlockchainRPC::GetRawTransaction(const RPCRequest& req, Blockchain& ch
 
     // First, check mempool
     const MemPool& mempool = chain.GetMemPool();
-    Transaction tx;
+    TransactionRef txRef = mempool.GetTransaction(txid);
     bool found = false;
     BlockHeight txHeight = 0;
     Hash256 blockHash;
     int confirmations = 0;
 
-    if (mempool.GetTransaction(txid, tx)) {
+    if (txRef) {
         found = true;
         confirmations = 0; // Unconfirmed
     } else {
@@ -404,8 +571,8 @@ JSONValue BlockchainRPC::GetRawTransaction(const RPCRequest& req, Blockchain& ch
 
                 if (block) {
                     for (const auto& transaction : block->transactions) {
-                        if (transaction.GetHash() == txid) {
-                            tx = transaction;
+                        if (transaction->GetHash() == txid) {
+                            txRef = transaction;
                             found = true;
                             txHeight = height;
                             blockHash = bhash;
@@ -424,14 +591,11 @@ JSONValue BlockchainRPC::GetRawTransaction(const RPCRequest& req, Blockchain& ch
         RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Transaction not found");
     }
 
+    const Transaction& tx = *txRef;
+
     if (!verbose) {
         // Return hex-encoded transaction
-        bytes serialized = tx.Serialize();
-        std::ostringstream oss;
-        for (byte b : serialized) {
-            oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-        }
-        return JSONValue(oss.str());
+        return JSONValue(crypto::Hex::Encode(tx.Serialize()));
     }
 
     // Return JSON object with transaction details
@@ -522,13 +686,11 @@ JSONValue BlockchainRPC::ListBlocks(const RPCRequest& req, Blockchain& chain, Wa
     bool first = true;
 
     for (int64_t height = startHeight; height <= endHeight; ++height) {
-        const BlockIndex* blockIndex = chain.GetBlockIndex(static_cast<BlockHeight>(height));
-        if (!blockIndex || !blockIndex->block) {
-            continue;  // Skip if block not found
+        auto block = chain.GetBlockAtHeight(static_cast<BlockHeight>(height));
+        if (!block) {
+            continue;  // Skip if block not found or pruned
         }
 
-        auto block = blockIndex->block;
-
         if (!first) oss << ",";
         first = false;
 
@@ -537,9 +699,7 @@ JSONValue BlockchainRPC::ListBlocks(const RPCRequest& req, Blockchain& chain, Wa
         oss << "\"hash\":\"" << crypto::Hash::ToHex(block->GetHash()) << "\",";
         oss << "\"timestamp\":" << block->header.timestamp << ",";
         oss << "\"tx_count\":" << block->transactions.size() << ",";
-        Serializer s;
-        block->SerializeImpl(s);
-        oss << "\"size\":" << s.GetData().size() << ",";
+        oss << "\"size\":" << block->GetSize() << ",";
         oss << "\"bits\":" << block->header.bits << ",";
         oss << "\"nonce\":" << block->header.nonce << ",";
         oss << "\"merkleroot\":\"" << crypto::Hash::ToHex(block->header.merkleRoot) << "\",";
@@ -548,17 +708,17 @@ JSONValue BlockchainRPC::ListBlocks(const RPCRequest& req, Blockchain& chain, Wa
         oss << "\"transactions\":[";
         for (size_t i = 0; i < block->transactions.size(); ++i) {
             if (i > 0) oss << ",";
-            oss << "\"" << crypto::Hash::ToHex(block->transactions[i].GetHash()) << "\"";
+            oss << "\"" << crypto::Hash::ToHex(block->transactions[i]->GetHash()) << "\"";
         }
         oss << "],";
 
         // Extract miner address from coinbase (first transaction)
         std::string minerAddress = "unknown";
-        if (!block->transactions.empty() && block->transactions[0].IsCoinbase()) {
+        if (!block->transactions.empty() && block->transactions[0]->IsCoinbase()) {
             // Try to extract address from first output
-            if (!block->transactions[0].outputs.empty()) {
+            if (!block->transactions[0]->outputs.empty()) {
                 Address addr;
-                if (AddressGenerator::ExtractAddress(block->transactions[0].outputs[0].scriptPubKey, addr)) {
+                if (AddressGenerator::ExtractAddress(block->transactions[0]->outputs[0].scriptPubKey, addr)) {
                     minerAddress = addr.ToString();
                 }
             }
@@ -37,6 +37,9 @@ private:
     static JSONValue GetDifficulty(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue GetBlockchainInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue GetTxOut(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue GetTxOutSetInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue DumpTxOutSet(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue LoadTxOutSet(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
 
     // Mempool commands
     static JSONValue GetMempoolInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
@@ -49,6 +52,7 @@ private:
     // Utility commands
     static JSONValue Help(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue Stop(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue DumpTrace(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
 };
 
 } // namespace dinari
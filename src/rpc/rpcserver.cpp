@@ -1,5 +1,6 @@
 #include "rpcserver.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include "util/serialize.h"
 #include "util/security.h"
 #include <sstream>
@@ -321,8 +322,20 @@ RPCResponse RPCServer::ExecuteCommand(const RPCRequest& request) {
                                       "Wallet not loaded");
         }
 
-        // Execute command
-        response.result = command.handler(request, blockchain, wallet, networkNode);
+        // Execute command. Only registered methods get a label, which keeps
+        // the series count bounded whatever clients send.
+        std::string labels = "method=\"" + request.method + "\"";
+        Metrics::Instance().GetCounter("dinari_rpc_calls_total",
+            "RPC calls by method", labels).Inc();
+        try {
+            ScopedTimer timer(Metrics::Instance().GetHistogram("dinari_rpc_call_seconds",
+                "RPC call latency by method", labels));
+            response.result = command.handler(request, blockchain, wallet, networkNode);
+        } catch (...) {
+            Metrics::Instance().GetCounter("dinari_rpc_errors_total",
+                "RPC calls that failed by method", labels).Inc();
+            throw;
+        }
         response.isError = false;
 
         LOG_DEBUG("RPC", "Executed command: " + request.method);
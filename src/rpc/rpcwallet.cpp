@@ -88,12 +88,31 @@ void WalletRPC::RegisterCommands(RPCServer& server) {
         true
     ));
 
+    server.RegisterCommand(RPCCommand(
+        "sendmany",
+        SendMany,
+        "wallet",
+        "Send to multiple addresses in a single transaction",
+        "sendmany {\"<address>\":<amount>,...} [comment]",
+        true
+    ));
+
+    server.RegisterCommand(RPCCommand(
+        "queuepayment",
+        QueuePayment,
+        "wallet",
+        "Queue a payment for the next batched payout transaction",
+        "queuepayment <address> <amount>",
+        true
+    ));
+
     server.RegisterCommand(RPCCommand(
         "listtransactions",
         ListTransactions,
         "wallet",
-        "Returns up to 'count' most recent transactions",
-        "listtransactions [count=10]",
+        "Returns up to 'count' most recent transactions, skipping 'skip' and stopping below "
+        "'since_height'. Pass the oldest txid of a page as 'after_txid' to fetch the page before it",
+        "listtransactions [count=10] [skip=0] [since_height=0] [after_txid]",
         true
     ));
 
@@ -106,6 +125,15 @@ void WalletRPC::RegisterCommands(RPCServer& server) {
         true
     ));
 
+    server.RegisterCommand(RPCCommand(
+        "abandontransaction",
+        AbandonTransaction,
+        "wallet",
+        "Mark an unconfirmed in-wallet transaction as abandoned, making its inputs spendable again",
+        "abandontransaction <txid>",
+        true
+    ));
+
     // Wallet management
     server.RegisterCommand(RPCCommand(
         "getwalletinfo",
@@ -166,8 +194,8 @@ void WalletRPC::RegisterCommands(RPCServer& server) {
         "importprivkey",
         ImportPrivKey,
         "wallet",
-        "Adds a private key to your wallet",
-        "importprivkey <privkey> [label]",
+        "Adds a private key to your wallet and rescans the chain for its coins",
+        "importprivkey <privkey> [label] [rescan=true]",
         true
     ));
 
@@ -497,10 +525,109 @@ JSONValue WalletRPC::SendToken(const RPCRequest& req, Blockchain& chain, Wallet*
     return JSONValue(response.Serialize());
 }
 
-JSONValue WalletRPC::ListTransactions(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+JSONValue WalletRPC::SendMany(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)chain;
+    RPCHelper::CheckParamsRange(req, 1, 2);
+
+    if (!wallet) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Wallet not loaded");
+    }
+
+    if (wallet->IsLocked()) {
+        RPCHelper::ThrowError(RPC_WALLET_UNLOCK_NEEDED, "Error: Please enter the wallet passphrase with walletpassphrase first");
+    }
+
+    // Parse {"address": amount, ...}
+    std::string amountsJson = RPCHelper::GetStringParam(req, 0);
+    JSONObject amounts;
+    try {
+        amounts = JSONObject::Parse(amountsJson);
+    } catch (const std::exception&) {
+        RPCHelper::ThrowError(RPC_PARSE_ERROR, "Invalid JSON in amounts");
+    }
+
+    std::map<Address, Amount> recipients;
+    Amount total = 0;
+
+    for (const auto& entry : amounts.GetData()) {
+        Address toAddr(entry.first);
+        if (!toAddr.IsValid()) {
+            RPCHelper::ThrowError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid Dinari address: " + entry.first);
+        }
+
+        if (!entry.second.IsNumber()) {
+            RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid amount for " + entry.first);
+        }
+
+        // Convert amount to satoshis
+        double amount = entry.second.GetDouble();
+        Amount amountSatoshis = static_cast<Amount>(amount * COIN);
+
+        if (amount <= 0 || amountSatoshis > MAX_MONEY || total + amountSatoshis > MAX_MONEY) {
+            RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid amount for " + entry.first);
+        }
+
+        recipients[toAddr] = amountSatoshis;
+        total += amountSatoshis;
+    }
+
+    if (recipients.empty()) {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "No recipients");
+    }
+
+    Transaction tx;
+    if (!wallet->SendTransaction(recipients, 10, tx)) {  // 10 sat/byte fee rate
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Failed to create transaction");
+    }
+
+    // Broadcast transaction
+    if (node) {
+        node->BroadcastTransaction(tx);
+    }
+
+    LOG_INFO("RPC", "Sent " + std::to_string(total) + " satoshis to " +
+             std::to_string(recipients.size()) + " recipients");
+
+    return JSONValue(crypto::Hash::ToHex(tx.GetHash()));
+}
+
+JSONValue WalletRPC::QueuePayment(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
     (void)chain;
     (void)node;
-    RPCHelper::CheckParamsRange(req, 0, 1);
+    RPCHelper::CheckParams(req, 2);
+
+    if (!wallet) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Wallet not loaded");
+    }
+
+    std::string addrStr = RPCHelper::GetStringParam(req, 0);
+    double amount = RPCHelper::GetDoubleParam(req, 1);
+
+    Address toAddr(addrStr);
+    if (!toAddr.IsValid()) {
+        RPCHelper::ThrowError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid Dinari address");
+    }
+
+    // Convert amount to satoshis
+    Amount amountSatoshis = static_cast<Amount>(amount * COIN);
+
+    if (amount <= 0 || amountSatoshis > MAX_MONEY) {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid amount");
+    }
+
+    if (!wallet->QueuePayment(toAddr, amountSatoshis)) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Failed to queue payment");
+    }
+
+    JSONObject obj;
+    obj.SetInt("queued_recipients", static_cast<int64_t>(wallet->GetQueuedPaymentCount()));
+
+    return JSONValue(obj.Serialize());
+}
+
+JSONValue WalletRPC::ListTransactions(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)node;
+    RPCHelper::CheckParamsRange(req, 0, 4);
 
     if (!wallet) {
         RPCHelper::ThrowError(RPC_WALLET_ERROR, "Wallet not loaded");
@@ -511,17 +638,41 @@ JSONValue WalletRPC::ListTransactions(const RPCRequest& req, Blockchain& chain,
         count = RPCHelper::GetIntParam(req, 0);
     }
 
-    std::vector<Transaction> transactions = wallet->GetTransactions();
+    int64_t skip = 0;
+    if (req.params.size() > 1) {
+        skip = RPCHelper::GetIntParam(req, 1);
+    }
 
+    int64_t sinceHeight = 0;
+    if (req.params.size() > 2) {
+        sinceHeight = RPCHelper::GetIntParam(req, 2);
+    }
+
+    if (count < 0 || skip < 0 || sinceHeight < 0) {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Negative count, skip or since_height");
+    }
+
+    Hash256 after;
+    bool hasCursor = req.params.size() > 3;
+    if (hasCursor) {
+        try {
+            after = crypto::Hash::FromHex256(RPCHelper::GetStringParam(req, 3));
+        } catch (const std::exception&) {
+            RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid transaction id");
+        }
+    }
+
+    std::vector<Wallet::WalletTx> page = wallet->ListTransactions(
+        static_cast<size_t>(count), static_cast<size_t>(skip),
+        static_cast<BlockHeight>(sinceHeight), hasCursor ? &after : nullptr);
+
+    // Oldest first within the page
     std::ostringstream oss;
     oss << "[";
 
-    size_t start = transactions.size() > static_cast<size_t>(count) ?
-                   transactions.size() - count : 0;
-
-    for (size_t i = start; i < transactions.size(); ++i) {
-        if (i > start) oss << ",";
-        oss << RPCHelper::TransactionToJSON(transactions[i]).Serialize();
+    for (auto it = page.rbegin(); it != page.rend(); ++it) {
+        if (it != page.rbegin()) oss << ",";
+        oss << WalletTxToJSON(*it, chain).Serialize();
     }
 
     oss << "]";
@@ -530,7 +681,6 @@ JSONValue WalletRPC::ListTransactions(const RPCRequest& req, Blockchain& chain,
 }
 
 JSONValue WalletRPC::GetTransaction(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
-    (void)chain;  // Unused
     (void)node;   // Unused
     RPCHelper::CheckParams(req, 1);
 
@@ -547,12 +697,52 @@ JSONValue WalletRPC::GetTransaction(const RPCRequest& req, Blockchain& chain, Wa
         RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid transaction id");
     }
 
-    // Note: Wallet transaction history lookup requires indexed transaction database
+    Wallet::WalletTx wtx;
+    if (!wallet->GetWalletTransaction(txid, wtx)) {
+        RPCHelper::ThrowError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid or non-wallet transaction id");
+    }
 
-    JSONObject obj;
-    obj.SetString("txid", txidStr);
+    return JSONValue(WalletTxToJSON(wtx, chain).Serialize());
+}
 
-    return JSONValue(obj.Serialize());
+JSONValue WalletRPC::AbandonTransaction(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
+    (void)chain;  // Unused
+    (void)node;   // Unused
+    RPCHelper::CheckParams(req, 1);
+
+    if (!wallet) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Wallet not loaded");
+    }
+
+    Hash256 txid;
+    try {
+        txid = crypto::Hash::FromHex256(RPCHelper::GetStringParam(req, 0));
+    } catch (const std::exception&) {
+        RPCHelper::ThrowError(RPC_INVALID_PARAMETER, "Invalid transaction id");
+    }
+
+    Wallet::WalletTx wtx;
+    if (!wallet->GetWalletTransaction(txid, wtx)) {
+        RPCHelper::ThrowError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid or non-wallet transaction id");
+    }
+
+    if (!wallet->AbandonTransaction(txid)) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR,
+                              "Transaction is confirmed or has unabandoned wallet descendants");
+    }
+
+    return JSONValue(true);
+}
+
+JSONObject WalletRPC::WalletTxToJSON(const Wallet::WalletTx& wtx, const Blockchain& chain) {
+    JSONObject obj = RPCHelper::TransactionToJSON(wtx.tx);
+
+    BlockHeight tip = chain.GetHeight();
+    int64_t confirmations = (wtx.height > 0 && wtx.height <= tip) ? tip - wtx.height + 1 : 0;
+    obj.SetInt("height", wtx.height);
+    obj.SetInt("confirmations", confirmations);
+
+    return obj;
 }
 
 JSONValue WalletRPC::GetWalletInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
@@ -571,6 +761,8 @@ JSONValue WalletRPC::GetWalletInfo(const RPCRequest& req, Blockchain& chain, Wal
     obj.SetInt("address_count", info.addressCount);
     obj.SetInt("utxo_count", info.utxoCount);
     obj.SetDouble("balance", static_cast<double>(info.balance) / COIN);
+    obj.SetDouble("unconfirmed_balance", static_cast<double>(info.unconfirmedBalance) / COIN);
+    obj.SetDouble("immature_balance", static_cast<double>(info.immatureBalance) / COIN);
     obj.SetBool("encrypted", info.encrypted);
     obj.SetBool("locked", info.locked);
     obj.SetBool("hd_enabled", info.hdEnabled);
@@ -681,7 +873,6 @@ JSONValue WalletRPC::WalletPassphraseChange(const RPCRequest& req, Blockchain& c
 }
 
 JSONValue WalletRPC::ImportMnemonic(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
-    (void)chain;  // Unused parameter
     (void)node;   // Unused parameter
     RPCHelper::CheckParamsRange(req, 1, 2);
 
@@ -708,13 +899,18 @@ JSONValue WalletRPC::ImportMnemonic(const RPCRequest& req, Blockchain& chain, Wa
         RPCHelper::ThrowError(RPC_WALLET_ERROR, "Failed to import mnemonic");
     }
 
+    // Pick up coins already sent to the derived addresses
+    if (!wallet->RescanBlockchain(chain)) {
+        return JSONValue("Mnemonic imported, but the rescan failed: block data below height " +
+                         std::to_string(chain.GetPruneHeight()) + " is pruned");
+    }
+
     return JSONValue("Mnemonic imported successfully");
 }
 
 JSONValue WalletRPC::ImportPrivKey(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node) {
-    (void)chain;  // Unused in this function
     (void)node;   // Unused in this function
-    RPCHelper::CheckParamsRange(req, 1, 2);
+    RPCHelper::CheckParamsRange(req, 1, 3);
 
     if (!wallet) {
         RPCHelper::ThrowError(RPC_WALLET_ERROR, "Wallet not loaded");
@@ -731,6 +927,16 @@ JSONValue WalletRPC::ImportPrivKey(const RPCRequest& req, Blockchain& chain, Wal
         label = RPCHelper::GetStringParam(req, 1);
     }
 
+    bool rescan = true;
+    if (req.params.size() > 2) {
+        rescan = RPCHelper::GetBoolParam(req, 2);
+    }
+
+    if (rescan && chain.GetPruneHeight() > 0) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Rescan is disabled: block data below height " +
+                              std::to_string(chain.GetPruneHeight()) + " is pruned");
+    }
+
     Hash256 privKey;
     try {
         privKey = crypto::Hash::FromHex256(privKeyStr);
@@ -742,6 +948,10 @@ JSONValue WalletRPC::ImportPrivKey(const RPCRequest& req, Blockchain& chain, Wal
         RPCHelper::ThrowError(RPC_WALLET_ERROR, "Failed to import private key");
     }
 
+    if (rescan && !wallet->RescanBlockchain(chain)) {
+        RPCHelper::ThrowError(RPC_WALLET_ERROR, "Key imported, but the rescan failed on missing block data");
+    }
+
     return JSONValue(true);
 }
 
@@ -42,8 +42,11 @@ private:
     // Transactions
     static JSONValue SendToAddress(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue SendToken(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue SendMany(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue QueuePayment(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue ListTransactions(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue GetTransaction(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+    static JSONValue AbandonTransaction(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
 
     // Wallet management
     static JSONValue GetWalletInfo(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
@@ -56,6 +59,9 @@ private:
     static JSONValue GetMnemonic(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue ImportMnemonic(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
     static JSONValue ImportPrivKey(const RPCRequest& req, Blockchain& chain, Wallet* wallet, NetworkNode* node);
+
+    // Helpers
+    static JSONObject WalletTxToJSON(const Wallet::WalletTx& wtx, const Blockchain& chain);
 };
 
 } // namespace dinari
@@ -1,16 +1,67 @@
 #include "blockstore.h"
-#include "serialization/serializer.h"
+#include "util/serialize.h"
+#include <algorithm>
 #include <filesystem>
 
 namespace dinari {
 
+namespace {
+
+bytes EncodeUInt64(uint64_t value) {
+    bytes data(sizeof(uint64_t));
+    for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+        data[i] = static_cast<byte>((value >> (8 * i)) & 0xFF);
+    }
+    return data;
+}
+
+uint64_t DecodeUInt64(const bytes& data) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < std::min(data.size(), sizeof(uint64_t)); ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
 bool BlockStore::Open(const std::string& dataDir) {
     // Create blocks subdirectory
     std::filesystem::path blocksPath = std::filesystem::path(dataDir) / "blocks";
     std::filesystem::create_directories(blocksPath);
 
     db = std::make_unique<Database>();
-    return db->Open(blocksPath.string(), true);
+    if (!db->Open(blocksPath.string(), true)) {
+        return false;
+    }
+
+    return LoadPruneState();
+}
+
+bool BlockStore::LoadPruneState() {
+    auto pruneBytes = db->Read(bytes{PREFIX_PRUNE});
+    pruneHeight = pruneBytes ? static_cast<BlockHeight>(DecodeUInt64(*pruneBytes)) : 0;
+
+    auto sizeBytes = db->Read(bytes{PREFIX_SIZE});
+    if (sizeBytes) {
+        blockDataSize = DecodeUInt64(*sizeBytes);
+        return true;
+    }
+
+    // Store written before sizes were tracked: total the bodies once
+    blockDataSize = 0;
+    auto iter = db->NewIterator();
+    if (!iter) return false;
+
+    for (iter->Seek(bytes{PREFIX_BLOCK}); iter->Valid(); iter->Next()) {
+        bytes key = iter->Key();
+        if (key.empty() || key[0] != PREFIX_BLOCK) {
+            break;
+        }
+        blockDataSize += iter->Value().size();
+    }
+
+    return db->Write(bytes{PREFIX_SIZE}, EncodeUInt64(blockDataSize));
 }
 
 void BlockStore::Close() {
@@ -50,17 +101,32 @@ bytes BlockStore::MakeWorkKey() const {
     return bytes{PREFIX_WORK};
 }
 
+bytes BlockStore::MakeHeaderKey(BlockHeight height) const {
+    bytes key = MakeBlockKey(height);
+    key[0] = PREFIX_HEADER;
+    return key;
+}
+
 bool BlockStore::WriteBlock(const Block& block, BlockHeight height) {
     if (!db || !db->IsOpen()) return false;
 
-    // Serialize block
-    bytes blockData = Serializer::Serialize(block);
+    // Serialize block into a buffer sized up front
+    bytes blockData;
+    blockData.reserve(block.GetSize());
+    Serializer s(blockData);
+    block.SerializeImpl(s);
 
     // Create batch for atomic write
     Database::Batch batch;
 
-    // Write block data: b<height> → block
-    batch.Put(MakeBlockKey(height), blockData);
+    // Write block data: b<height> → block, replacing any body at this height
+    bytes blockKey = MakeBlockKey(height);
+    uint64_t newSize = blockDataSize + blockData.size();
+    if (auto existing = db->Read(blockKey)) {
+        newSize -= std::min<uint64_t>(existing->size(), newSize);
+    }
+    batch.Put(blockKey, blockData);
+    batch.Put(bytes{PREFIX_SIZE}, EncodeUInt64(newSize));
 
     // Write hash index: h<hash> → height
     Hash256 blockHash = block.GetHash();
@@ -70,7 +136,12 @@ bool BlockStore::WriteBlock(const Block& block, BlockHeight height) {
     }
     batch.Put(MakeHashKey(blockHash), heightBytes);
 
-    return db->WriteBatch(batch);
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
+
+    blockDataSize = newSize;
+    return true;
 }
 
 std::optional<Block> BlockStore::ReadBlock(BlockHeight height) const {
@@ -80,7 +151,7 @@ std::optional<Block> BlockStore::ReadBlock(BlockHeight height) const {
     if (!blockData) return std::nullopt;
 
     try {
-        return Serializer::Deserialize<Block>(*blockData);
+        return Deserialize<Block>(*blockData);
     } catch (const std::exception& e) {
         return std::nullopt;
     }
@@ -195,17 +266,136 @@ bool BlockStore::DeleteBlock(BlockHeight height) {
     if (!db || !db->IsOpen()) return false;
 
     // Read block to get hash
-    auto block = ReadBlock(height);
-    if (!block) return false;
+    auto blockData = db->Read(MakeBlockKey(height));
+    if (!blockData) return false;
+
+    Hash256 blockHash;
+    try {
+        blockHash = Deserialize<Block>(*blockData).GetHash();
+    } catch (const std::exception&) {
+        return false;
+    }
 
-    Hash256 blockHash = block->GetHash();
+    uint64_t newSize = blockDataSize - std::min<uint64_t>(blockData->size(), blockDataSize);
 
     // Create batch for atomic delete
     Database::Batch batch;
     batch.Delete(MakeBlockKey(height));
     batch.Delete(MakeHashKey(blockHash));
+    batch.Put(bytes{PREFIX_SIZE}, EncodeUInt64(newSize));
+
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
+
+    blockDataSize = newSize;
+    return true;
+}
+
+std::optional<BlockHeader> BlockStore::ReadHeader(BlockHeight height) const {
+    if (!db || !db->IsOpen()) return std::nullopt;
+
+    // Pruned heights keep a header record; others have the header at the
+    // front of the body
+    auto data = db->Read(height < pruneHeight ? MakeHeaderKey(height) : MakeBlockKey(height));
+    if (!data || data->size() < BlockHeader::HEADER_SIZE) return std::nullopt;
+
+    try {
+        Deserializer d(data->data(), BlockHeader::HEADER_SIZE);
+        BlockHeader header;
+        header.DeserializeImpl(d);
+        return header;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+bool BlockStore::PruneBlock(BlockHeight height) {
+    Database::Batch batch;
+    uint64_t newSize = blockDataSize;
+
+    // A height with no body (never stored) is simply stepped over
+    auto blockData = db->Read(MakeBlockKey(height));
+    if (blockData) {
+        if (blockData->size() < BlockHeader::HEADER_SIZE) {
+            return false;
+        }
+
+        bytes headerData(blockData->begin(), blockData->begin() + BlockHeader::HEADER_SIZE);
+        batch.Put(MakeHeaderKey(height), headerData);
+        batch.Delete(MakeBlockKey(height));
+
+        newSize -= std::min<uint64_t>(blockData->size(), newSize);
+        batch.Put(bytes{PREFIX_SIZE}, EncodeUInt64(newSize));
+    }
+
+    batch.Put(bytes{PREFIX_PRUNE}, EncodeUInt64(height + 1));
+
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
+
+    blockDataSize = newSize;
+    pruneHeight = height + 1;
+    return true;
+}
+
+bool BlockStore::PruneToTarget(uint64_t targetBytes, BlockHeight lastPrunable) {
+    if (!db || !db->IsOpen()) return false;
+
+    while (blockDataSize > targetBytes && pruneHeight <= lastPrunable) {
+        if (!PruneBlock(pruneHeight)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BlockStore::WriteHeaders(const std::vector<BlockHeader>& headers) {
+    if (!db || !db->IsOpen()) return false;
+
+    constexpr size_t BATCH_SIZE = 10000;
+
+    Database::Batch batch;
+    uint64_t newSize = blockDataSize;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        BlockHeight height = static_cast<BlockHeight>(i);
+
+        bytes headerData;
+        headerData.reserve(BlockHeader::HEADER_SIZE);
+        Serializer s(headerData);
+        headers[i].SerializeImpl(s);
+        batch.Put(MakeHeaderKey(height), headerData);
+
+        bytes heightBytes(sizeof(BlockHeight));
+        for (size_t j = 0; j < sizeof(BlockHeight); ++j) {
+            heightBytes[j] = static_cast<byte>((height >> (8 * j)) & 0xFF);
+        }
+        batch.Put(MakeHashKey(headers[i].GetHash()), heightBytes);
+
+        if (auto existing = db->Read(MakeBlockKey(height))) {
+            newSize -= std::min<uint64_t>(existing->size(), newSize);
+            batch.Delete(MakeBlockKey(height));
+        }
+
+        if ((i + 1) % BATCH_SIZE == 0) {
+            if (!db->WriteBatch(batch, false)) return false;
+            batch.Clear();
+        }
+    }
+
+    BlockHeight newPruneHeight = std::max<BlockHeight>(pruneHeight, static_cast<BlockHeight>(headers.size()));
+    batch.Put(bytes{PREFIX_SIZE}, EncodeUInt64(newSize));
+    batch.Put(bytes{PREFIX_PRUNE}, EncodeUInt64(newPruneHeight));
+
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
 
-    return db->WriteBatch(batch);
+    blockDataSize = newSize;
+    pruneHeight = newPruneHeight;
+    return true;
 }
 
 std::string BlockStore::GetStats() const {
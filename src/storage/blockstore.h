@@ -18,6 +18,9 @@ namespace dinari {
  * - Block hash → Height
  * - Best block hash
  * - Total chain work
+ *
+ * Block bodies below the prune height have been deleted; only their
+ * headers and hash index entries remain.
  */
 class BlockStore {
 public:
@@ -101,6 +104,47 @@ public:
      */
     bool DeleteBlock(BlockHeight height);
 
+    /**
+     * @brief Read block header by height
+     *
+     * Also works for heights whose body has been pruned.
+     */
+    std::optional<BlockHeader> ReadHeader(BlockHeight height) const;
+
+    /**
+     * @brief Prune the oldest block bodies until the stored bodies fit
+     *
+     * Deletes bodies from the prune height upward while their total size
+     * exceeds targetBytes, never above lastPrunable. Headers and hash
+     * index entries are kept.
+     *
+     * @param targetBytes Size the stored bodies should fit in
+     * @param lastPrunable Highest height that may be pruned
+     * @return false on a storage error
+     */
+    bool PruneToTarget(uint64_t targetBytes, BlockHeight lastPrunable);
+
+    /**
+     * @brief Store a header-only chain from genesis
+     *
+     * Used when loading a UTXO snapshot: every height gets its header and
+     * hash index entry, any stored bodies at those heights are dropped and
+     * the prune height moves past the last header.
+     *
+     * @param headers Headers indexed by height
+     */
+    bool WriteHeaders(const std::vector<BlockHeader>& headers);
+
+    /**
+     * @brief Lowest height that still has its body (0 if never pruned)
+     */
+    BlockHeight GetPruneHeight() const { return pruneHeight; }
+
+    /**
+     * @brief Total serialized size of the stored block bodies
+     */
+    uint64_t GetBlockDataSize() const { return blockDataSize; }
+
     /**
      * @brief Get database statistics
      */
@@ -114,18 +158,29 @@ public:
 private:
     std::unique_ptr<Database> db;
 
+    // Persisted under PREFIX_SIZE / PREFIX_PRUNE, updated with each write
+    uint64_t blockDataSize = 0;
+    BlockHeight pruneHeight = 0;
+
     // Key prefixes
     static constexpr char PREFIX_BLOCK = 'b';      // b<height> → block
     static constexpr char PREFIX_HASH = 'h';       // h<hash> → height
     static constexpr char PREFIX_BEST = 'B';       // B → best block hash
     static constexpr char PREFIX_HEIGHT = 'H';     // H → chain height
     static constexpr char PREFIX_WORK = 'W';       // W → total work
+    static constexpr char PREFIX_HEADER = 'x';     // x<height> → header of a pruned block
+    static constexpr char PREFIX_SIZE = 'S';       // S → total block body bytes
+    static constexpr char PREFIX_PRUNE = 'P';      // P → prune height
 
     bytes MakeBlockKey(BlockHeight height) const;
     bytes MakeHashKey(const Hash256& hash) const;
     bytes MakeBestKey() const;
     bytes MakeHeightKey() const;
     bytes MakeWorkKey() const;
+    bytes MakeHeaderKey(BlockHeight height) const;
+
+    bool LoadPruneState();
+    bool PruneBlock(BlockHeight height);
 };
 
 } // namespace dinari
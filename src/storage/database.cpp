@@ -1,4 +1,5 @@
 #include "database.h"
+#include "util/metrics.h"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 #include <leveldb/iterator.h>
@@ -9,6 +10,41 @@
 namespace dinari {
 
 // Database implementation
+namespace {
+
+/**
+ * @brief Database I/O metrics, shared by all Database instances
+ */
+struct DatabaseMetrics {
+    Histogram& readLatency;
+    Histogram& writeLatency;
+    Histogram& batchLatency;
+    Counter& bytesRead;
+    Counter& bytesWritten;
+
+    static DatabaseMetrics& Get() {
+        static DatabaseMetrics metrics;
+        return metrics;
+    }
+
+private:
+    DatabaseMetrics()
+        : readLatency(Operation("read"))
+        , writeLatency(Operation("write"))
+        , batchLatency(Operation("write_batch"))
+        , bytesRead(Metrics::Instance().GetCounter("dinari_db_bytes_total",
+              "Bytes read from and written to the database", "direction=\"read\""))
+        , bytesWritten(Metrics::Instance().GetCounter("dinari_db_bytes_total",
+              "Bytes read from and written to the database", "direction=\"write\"")) {}
+
+    static Histogram& Operation(const std::string& op) {
+        return Metrics::Instance().GetHistogram("dinari_db_operation_seconds",
+            "Database operation latency", "op=\"" + op + "\"");
+    }
+};
+
+} // namespace
+
 bool Database::Open(const std::string& path, bool createIfMissing) {
     leveldb::Options options;
     options.create_if_missing = createIfMissing;
@@ -33,6 +69,8 @@ void Database::Close() {
     db.reset();
 }
 
+Database::Database() = default;
+
 Database::~Database() {
     Close();
 }
@@ -46,6 +84,10 @@ bool Database::Write(const bytes& key, const bytes& value) {
     leveldb::WriteOptions options;
     options.sync = false; // Set to true for critical operations
 
+    DatabaseMetrics& metrics = DatabaseMetrics::Get();
+    ScopedTimer timer(metrics.writeLatency);
+    metrics.bytesWritten.Inc(key.size() + value.size());
+
     leveldb::Status status = db->Put(options, keySlice, valueSlice);
     return status.ok();
 }
@@ -57,12 +99,17 @@ std::optional<bytes> Database::Read(const bytes& key) const {
 
     std::string value;
     leveldb::ReadOptions options;
+
+    DatabaseMetrics& metrics = DatabaseMetrics::Get();
+    ScopedTimer timer(metrics.readLatency);
     leveldb::Status status = db->Get(options, keySlice, &value);
 
     if (!status.ok()) {
         return std::nullopt;
     }
 
+    metrics.bytesRead.Inc(value.size());
+
     bytes result(value.begin(), value.end());
     return result;
 }
@@ -103,11 +150,15 @@ void Database::Batch::Clear() {
     batch->Clear();
 }
 
-bool Database::WriteBatch(const Batch& batch) {
+bool Database::WriteBatch(const Batch& batch, bool sync) {
     if (!db) return false;
 
     leveldb::WriteOptions options;
-    options.sync = true; // Batch writes are synced for consistency
+    options.sync = sync; // Batch writes are synced for consistency unless asked otherwise
+
+    DatabaseMetrics& metrics = DatabaseMetrics::Get();
+    ScopedTimer timer(metrics.batchLatency);
+    metrics.bytesWritten.Inc(batch.batch->ApproximateSize());
 
     leveldb::Status status = db->Write(options, batch.batch.get());
     return status.ok();
@@ -79,8 +79,9 @@ public:
 
     /**
      * @brief Write batch atomically
+     * @param sync Wait for the write to reach disk
      */
-    bool WriteBatch(const Batch& batch);
+    bool WriteBatch(const Batch& batch, bool sync = true);
 
     /**
      * @brief Iterator for scanning database
@@ -120,7 +121,7 @@ public:
      */
     void Compact();
 
-    Database() = default;
+    Database();
     ~Database();
 
     // No copy
@@ -1,5 +1,6 @@
 #include "txindex.h"
 #include "serialization/serializer.h"
+#include "util/trace.h"
 #include <filesystem>
 
 namespace dinari {
@@ -224,6 +225,113 @@ std::vector<std::pair<OutPoint, TxOut>> TxIndex::GetUTXOsForAddress(const Addres
     return utxos;
 }
 
+void TxIndex::ForEachUTXO(const std::function<void(const OutPoint&, const TxOut&)>& fn) const {
+    if (!db || !db->IsOpen()) return;
+
+    auto iter = db->NewIterator();
+    if (!iter) return;
+
+    for (iter->Seek(bytes{PREFIX_UTXO}); iter->Valid(); iter->Next()) {
+        bytes key = iter->Key();
+        if (key.empty() || key[0] != PREFIX_UTXO) {
+            break;
+        }
+        if (key.size() != 1 + 32 + 4) {
+            continue;
+        }
+
+        // Extract outpoint from key
+        OutPoint outpoint;
+        std::copy(key.begin() + 1, key.begin() + 33, outpoint.txHash.begin());
+        outpoint.index = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            outpoint.index |= static_cast<uint32_t>(key[33 + i]) << (8 * i);
+        }
+
+        try {
+            TxOut output = Serializer::Deserialize<TxOut>(iter->Value());
+            fn(outpoint, output);
+        } catch (const std::exception&) {
+            // Skip invalid entries
+        }
+    }
+}
+
+bool TxIndex::ClearUTXOs() {
+    if (!db || !db->IsOpen()) return false;
+
+    constexpr size_t BATCH_SIZE = 10000;
+
+    for (char prefix : {PREFIX_UTXO, PREFIX_ADDR_UTXO}) {
+        auto iter = db->NewIterator();
+        if (!iter) return false;
+
+        Database::Batch batch;
+        size_t pending = 0;
+        for (iter->Seek(bytes{static_cast<byte>(prefix)}); iter->Valid(); iter->Next()) {
+            bytes key = iter->Key();
+            if (key.empty() || key[0] != static_cast<byte>(prefix)) {
+                break;
+            }
+            batch.Delete(key);
+            if (++pending == BATCH_SIZE) {
+                if (!db->WriteBatch(batch, false)) return false;
+                batch.Clear();
+                pending = 0;
+            }
+        }
+        if (pending > 0 && !db->WriteBatch(batch, false)) {
+            return false;
+        }
+    }
+
+    return db->Delete(MakeUTXOCountKey());
+}
+
+bool TxIndex::BulkLoadUTXOs(const std::vector<std::pair<OutPoint, UTXOEntry>>& coins) {
+    if (!db || !db->IsOpen()) return false;
+
+    constexpr size_t BATCH_SIZE = 10000;
+
+    Database::Batch batch;
+    size_t pending = 0;
+    for (size_t i = 0; i < coins.size(); ++i) {
+        const auto& [outpoint, entry] = coins[i];
+
+        bytes outputData = Serializer::Serialize(entry.output);
+        batch.Put(MakeUTXOKey(outpoint), outputData);
+        batch.Put(MakeAddressUTXOKey(entry.output.scriptPubKey, outpoint), outputData);
+
+        // One location per transaction; its outputs are adjacent
+        if (i == 0 || coins[i - 1].first.txHash != outpoint.txHash) {
+            uint32_t txIndex = entry.isCoinbase ? 0 : TxLocation::UNKNOWN_INDEX;
+            bytes locationData(sizeof(BlockHeight) + sizeof(uint32_t));
+            for (size_t j = 0; j < sizeof(BlockHeight); ++j) {
+                locationData[j] = static_cast<byte>((entry.height >> (8 * j)) & 0xFF);
+            }
+            for (size_t j = 0; j < sizeof(uint32_t); ++j) {
+                locationData[sizeof(BlockHeight) + j] = static_cast<byte>((txIndex >> (8 * j)) & 0xFF);
+            }
+            batch.Put(MakeTxLocationKey(outpoint.txHash), locationData);
+        }
+
+        if (++pending == BATCH_SIZE) {
+            if (!db->WriteBatch(batch, false)) return false;
+            batch.Clear();
+            pending = 0;
+        }
+    }
+
+    // Final batch is synced along with the count
+    bytes countData(sizeof(size_t));
+    for (size_t i = 0; i < sizeof(size_t); ++i) {
+        countData[i] = static_cast<byte>((coins.size() >> (8 * i)) & 0xFF);
+    }
+    batch.Put(MakeUTXOCountKey(), countData);
+
+    return db->WriteBatch(batch);
+}
+
 size_t TxIndex::GetUTXOSetSize() const {
     if (!db || !db->IsOpen()) return 0;
 
@@ -260,6 +368,7 @@ bool TxIndex::UpdateUTXOCount(int delta) {
 }
 
 bool TxIndex::ApplyUTXOBatch(const UTXOBatch& batch) {
+    TRACE_SCOPE("TxIndex::ApplyUTXOBatch");
     if (!db || !db->IsOpen()) return false;
 
     Database::Batch dbBatch;
@@ -5,6 +5,7 @@
 #include "dinari/types.h"
 #include "core/transaction.h"
 #include "core/utxo.h"
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -20,6 +21,9 @@ struct TxLocation {
     BlockHeight height;
     uint32_t txIndex;  // Index within block
 
+    // Position of a non-coinbase transaction known only from a UTXO snapshot
+    static constexpr uint32_t UNKNOWN_INDEX = 0xFFFFFFFF;
+
     TxLocation() : height(0), txIndex(0) {}
     TxLocation(BlockHeight h, uint32_t idx) : height(h), txIndex(idx) {}
 };
@@ -90,6 +94,11 @@ public:
      */
     std::vector<std::pair<OutPoint, TxOut>> GetUTXOsForAddress(const Address& address) const;
 
+    /**
+     * @brief Visit every UTXO in the set
+     */
+    void ForEachUTXO(const std::function<void(const OutPoint&, const TxOut&)>& fn) const;
+
     /**
      * @brief Get UTXO set size
      */
@@ -108,6 +117,20 @@ public:
      */
     bool ApplyUTXOBatch(const UTXOBatch& batch);
 
+    /**
+     * @brief Remove every UTXO and address entry
+     */
+    bool ClearUTXOs();
+
+    /**
+     * @brief Load UTXOs in bulk from a snapshot
+     *
+     * Writes the coins (sorted by outpoint) in large unsynced batches and
+     * updates the UTXO count once. Each coin's transaction is recorded at
+     * its height, with txIndex 0 for coinbases and UNKNOWN_INDEX otherwise.
+     */
+    bool BulkLoadUTXOs(const std::vector<std::pair<OutPoint, UTXOEntry>>& coins);
+
     /**
      * @brief Remove transaction from index (for reorg)
      */
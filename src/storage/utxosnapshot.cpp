@@ -0,0 +1,330 @@
+#include "utxosnapshot.h"
+#include "crypto/hash.h"
+#include "util/logger.h"
+#include "util/serialize.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace dinari {
+
+namespace {
+
+// Size of the fixed file header: magic, version, metadata, counts
+constexpr size_t FILE_HEADER_SIZE = 4 + 4 + 4 + 32 + 4 + 8 + 8 + 32 + 4 + 4;
+
+// Largest chunk payload accepted from a file
+constexpr uint32_t MAX_CHUNK_PAYLOAD = 64 * 1024 * 1024;
+
+// Chunks below this many per thread are decoded inline
+constexpr size_t CHUNKS_PER_THREAD = 4;
+
+void SerializeMetadata(Serializer& s, const UTXOSnapshotMetadata& metadata) {
+    s.WriteUInt32(metadata.networkMagic);
+    s.WriteHash256(metadata.baseBlockHash);
+    s.WriteUInt32(metadata.baseHeight);
+    s.WriteUInt64(metadata.moneySupply);
+    s.WriteUInt64(metadata.coinCount);
+    s.WriteHash256(metadata.utxoSetHash);
+}
+
+// Commits to the metadata, all headers and every chunk in order
+Hash256 ComputeCommitment(const UTXOSnapshotMetadata& metadata, const Hash256& headersHash,
+                          const std::vector<Hash256>& chunkHashes) {
+    bytes data;
+    Serializer s(data);
+    SerializeMetadata(s, metadata);
+    s.WriteHash256(headersHash);
+    for (const auto& chunkHash : chunkHashes) {
+        s.WriteHash256(chunkHash);
+    }
+    return crypto::Hash::DoubleSHA256(data);
+}
+
+size_t ChunkCount(uint64_t coinCount) {
+    return static_cast<size_t>((coinCount + UTXOSnapshot::COINS_PER_CHUNK - 1) /
+                               UTXOSnapshot::COINS_PER_CHUNK);
+}
+
+// Sorted coins [begin, end) with the outputs of each txid grouped
+void EncodeChunk(bytes& payload, const SnapshotCoin* begin, const SnapshotCoin* end) {
+    payload.clear();
+    Serializer s(payload);
+
+    while (begin != end) {
+        const SnapshotCoin* groupEnd = begin;
+        while (groupEnd != end && groupEnd->first.txHash == begin->first.txHash) {
+            ++groupEnd;
+        }
+
+        s.WriteHash256(begin->first.txHash);
+        s.WriteCompactSize(static_cast<uint64_t>(groupEnd - begin));
+        for (; begin != groupEnd; ++begin) {
+            s.WriteCompactSize(begin->first.index);
+            begin->second.SerializeImpl(s);
+        }
+    }
+}
+
+bool DecodeChunk(const bytes& payload, SnapshotCoin* out, size_t count) {
+    try {
+        Deserializer d(payload);
+        size_t decoded = 0;
+
+        while (decoded < count) {
+            Hash256 txHash = d.ReadHash256();
+            uint64_t outputs = d.ReadCompactSize();
+            if (outputs == 0 || outputs > count - decoded) {
+                return false;
+            }
+
+            for (uint64_t i = 0; i < outputs; ++i, ++decoded) {
+                uint64_t index = d.ReadCompactSize();
+                if (index > std::numeric_limits<TxOutIndex>::max()) {
+                    return false;
+                }
+                out[decoded].first = OutPoint(txHash, static_cast<TxOutIndex>(index));
+                out[decoded].second.DeserializeImpl(d);
+
+                if (decoded > 0 && !(out[decoded - 1].first < out[decoded].first)) {
+                    return false;
+                }
+            }
+        }
+
+        return !d.Available();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool ReadExact(std::ifstream& file, bytes& buffer, size_t len) {
+    buffer.resize(len);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(len));
+    return static_cast<size_t>(file.gcount()) == len;
+}
+
+} // namespace
+
+bool UTXOSnapshot::Write(const std::string& path, UTXOSnapshotMetadata& metadata,
+                         const std::vector<BlockHeader>& headers,
+                         std::vector<SnapshotCoin>& coins) {
+    if (headers.size() != static_cast<size_t>(metadata.baseHeight) + 1) {
+        LOG_ERROR("Snapshot", "Header count does not match the base height");
+        return false;
+    }
+
+    std::sort(coins.begin(), coins.end(),
+              [](const SnapshotCoin& a, const SnapshotCoin& b) { return a.first < b.first; });
+    metadata.coinCount = coins.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("Snapshot", "Cannot create snapshot file: " + path);
+        return false;
+    }
+
+    size_t chunkCount = ChunkCount(coins.size());
+
+    bytes buffer;
+    Serializer s(buffer);
+    s.WriteUInt32(MAGIC);
+    s.WriteUInt32(VERSION);
+    SerializeMetadata(s, metadata);
+    s.WriteUInt32(static_cast<uint32_t>(headers.size()));
+    s.WriteUInt32(static_cast<uint32_t>(chunkCount));
+
+    size_t headersStart = buffer.size();
+    for (const auto& header : headers) {
+        header.SerializeImpl(s);
+    }
+    Hash256 headersHash = crypto::Hash::DoubleSHA256(buffer.data() + headersStart,
+                                                     buffer.size() - headersStart);
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+    // Stream the coins one chunk at a time
+    std::vector<Hash256> chunkHashes;
+    chunkHashes.reserve(chunkCount);
+    bytes payload;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const SnapshotCoin* begin = coins.data() + i * COINS_PER_CHUNK;
+        const SnapshotCoin* end = coins.data() + std::min(coins.size(), (i + 1) * COINS_PER_CHUNK);
+        EncodeChunk(payload, begin, end);
+        chunkHashes.push_back(crypto::Hash::DoubleSHA256(payload));
+
+        buffer.clear();
+        Serializer chunk(buffer);
+        chunk.WriteUInt32(static_cast<uint32_t>(end - begin));
+        chunk.WriteUInt32(static_cast<uint32_t>(payload.size()));
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        file.write(reinterpret_cast<const char*>(chunkHashes.back().data()), 32);
+    }
+
+    metadata.commitment = ComputeCommitment(metadata, headersHash, chunkHashes);
+    file.write(reinterpret_cast<const char*>(metadata.commitment.data()), 32);
+
+    file.flush();
+    if (!file) {
+        LOG_ERROR("Snapshot", "Failed to write snapshot file: " + path);
+        return false;
+    }
+
+    return true;
+}
+
+bool UTXOSnapshot::Read(const std::string& path, UTXOSnapshotMetadata& metadata,
+                        std::vector<BlockHeader>& headers,
+                        std::vector<SnapshotCoin>& coins) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        LOG_ERROR("Snapshot", "Cannot open snapshot file: " + path);
+        return false;
+    }
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    bytes buffer;
+    uint32_t headerCount = 0;
+    uint32_t chunkCount = 0;
+    if (!ReadExact(file, buffer, FILE_HEADER_SIZE)) {
+        LOG_ERROR("Snapshot", "Snapshot file is truncated");
+        return false;
+    }
+
+    {
+        Deserializer d(buffer);
+        if (d.ReadUInt32() != MAGIC || d.ReadUInt32() != VERSION) {
+            LOG_ERROR("Snapshot", "Not a version " + std::to_string(VERSION) + " UTXO snapshot");
+            return false;
+        }
+        metadata.networkMagic = d.ReadUInt32();
+        metadata.baseBlockHash = d.ReadHash256();
+        metadata.baseHeight = d.ReadUInt32();
+        metadata.moneySupply = d.ReadUInt64();
+        metadata.coinCount = d.ReadUInt64();
+        metadata.utxoSetHash = d.ReadHash256();
+        headerCount = d.ReadUInt32();
+        chunkCount = d.ReadUInt32();
+    }
+
+    if (headerCount != static_cast<uint64_t>(metadata.baseHeight) + 1 ||
+        chunkCount != ChunkCount(metadata.coinCount) ||
+        uint64_t(headerCount) * BlockHeader::HEADER_SIZE > fileSize) {
+        LOG_ERROR("Snapshot", "Snapshot header counts are inconsistent");
+        return false;
+    }
+
+    // Headers
+    if (!ReadExact(file, buffer, static_cast<size_t>(headerCount) * BlockHeader::HEADER_SIZE)) {
+        LOG_ERROR("Snapshot", "Snapshot file is truncated");
+        return false;
+    }
+    Hash256 headersHash = crypto::Hash::DoubleSHA256(buffer);
+    headers.resize(headerCount);
+    {
+        Deserializer d(buffer);
+        for (auto& header : headers) {
+            header.DeserializeImpl(d);
+        }
+    }
+
+    // Chunk payloads are read in order, then verified and decoded in
+    // parallel. The vectors grow as chunks arrive so that a corrupt count
+    // cannot force a huge allocation up front.
+    std::vector<bytes> payloads;
+    std::vector<Hash256> chunkHashes;
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        if (!ReadExact(file, buffer, 8)) {
+            LOG_ERROR("Snapshot", "Snapshot file is truncated");
+            return false;
+        }
+        Deserializer d(buffer);
+        uint32_t chunkCoins = d.ReadUInt32();
+        uint32_t payloadSize = d.ReadUInt32();
+
+        uint64_t expectedCoins = std::min<uint64_t>(COINS_PER_CHUNK,
+                                                    metadata.coinCount - uint64_t(i) * COINS_PER_CHUNK);
+        if (chunkCoins != expectedCoins || payloadSize > MAX_CHUNK_PAYLOAD ||
+            payloadSize > fileSize) {
+            LOG_ERROR("Snapshot", "Snapshot chunk " + std::to_string(i) + " is malformed");
+            return false;
+        }
+
+        payloads.emplace_back();
+        chunkHashes.emplace_back();
+        if (!ReadExact(file, payloads.back(), payloadSize) || !ReadExact(file, buffer, 32)) {
+            LOG_ERROR("Snapshot", "Snapshot file is truncated");
+            return false;
+        }
+        std::copy(buffer.begin(), buffer.end(), chunkHashes.back().begin());
+    }
+
+    if (!ReadExact(file, buffer, 32)) {
+        LOG_ERROR("Snapshot", "Snapshot file is truncated");
+        return false;
+    }
+    std::copy(buffer.begin(), buffer.end(), metadata.commitment.begin());
+
+    if (ComputeCommitment(metadata, headersHash, chunkHashes) != metadata.commitment) {
+        LOG_ERROR("Snapshot", "Snapshot commitment does not match its contents");
+        return false;
+    }
+
+    coins.clear();
+    coins.resize(metadata.coinCount);
+
+    std::atomic<bool> failed(false);
+    auto decodeRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && !failed; ++i) {
+            size_t first = i * COINS_PER_CHUNK;
+            size_t count = std::min<size_t>(COINS_PER_CHUNK, coins.size() - first);
+            if (crypto::Hash::DoubleSHA256(payloads[i]) != chunkHashes[i] ||
+                !DecodeChunk(payloads[i], coins.data() + first, count)) {
+                failed = true;
+            }
+            bytes().swap(payloads[i]);
+        }
+    };
+
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                      chunkCount / CHUNKS_PER_THREAD);
+    if (threads <= 1) {
+        decodeRange(0, chunkCount);
+    } else {
+        size_t perThread = (chunkCount + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) {
+            size_t begin = std::min<size_t>(chunkCount, t * perThread);
+            size_t end = std::min<size_t>(chunkCount, begin + perThread);
+            workers.emplace_back(decodeRange, begin, end);
+        }
+        decodeRange(0, std::min<size_t>(chunkCount, perThread));
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    if (failed) {
+        coins.clear();
+        LOG_ERROR("Snapshot", "Snapshot chunk failed verification");
+        return false;
+    }
+
+    // Each chunk is in order; so must be the seams between them
+    for (size_t i = COINS_PER_CHUNK; i < coins.size(); i += COINS_PER_CHUNK) {
+        if (!(coins[i - 1].first < coins[i].first)) {
+            coins.clear();
+            LOG_ERROR("Snapshot", "Snapshot coins are out of order");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace dinari
@@ -0,0 +1,72 @@
+#ifndef DINARI_STORAGE_UTXOSNAPSHOT_H
+#define DINARI_STORAGE_UTXOSNAPSHOT_H
+
+#include "dinari/types.h"
+#include "blockchain/block.h"
+#include "core/utxo.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dinari {
+
+/**
+ * @brief What a UTXO set snapshot was taken from
+ */
+struct UTXOSnapshotMetadata {
+    uint32_t networkMagic = 0;
+    Hash256 baseBlockHash{};        // Tip the coins are the UTXO set of
+    BlockHeight baseHeight = 0;
+    Amount moneySupply = 0;         // Money supply at the base block
+    uint64_t coinCount = 0;
+    Hash256 utxoSetHash{};          // UTXOSet::GetCommitment() of the coins
+    Hash256 commitment{};           // Hash over the metadata, headers and every chunk
+};
+
+using SnapshotCoin = std::pair<OutPoint, UTXOEntry>;
+
+/**
+ * @brief UTXO set snapshot file
+ *
+ * The file holds the metadata, the block headers from genesis to the
+ * base block, then the coins sorted by outpoint in chunks of up to
+ * COINS_PER_CHUNK. Outputs of one transaction share a single txid within
+ * a chunk. Each chunk carries its own double-SHA256 and the trailer is
+ * the commitment, so chunks can be verified and decoded independently.
+ */
+class UTXOSnapshot {
+public:
+    static constexpr uint32_t MAGIC = 0x54555844;  // "DXUT"
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t COINS_PER_CHUNK = 16384;
+
+    /**
+     * @brief Write a snapshot
+     *
+     * @param metadata Snapshot description; coinCount and commitment are filled in
+     * @param headers Headers from genesis to the base block
+     * @param coins The UTXO set at the base block (sorted in place)
+     * @return true if the file was written
+     */
+    static bool Write(const std::string& path, UTXOSnapshotMetadata& metadata,
+                      const std::vector<BlockHeader>& headers,
+                      std::vector<SnapshotCoin>& coins);
+
+    /**
+     * @brief Read and verify a snapshot
+     *
+     * Chunks are hashed and decoded on several threads. Fails if any
+     * chunk or the commitment does not match, or the coins are not in
+     * strictly increasing outpoint order.
+     *
+     * @param coins Receives the coins sorted by outpoint
+     * @return true if the whole file was read and verified
+     */
+    static bool Read(const std::string& path, UTXOSnapshotMetadata& metadata,
+                     std::vector<BlockHeader>& headers,
+                     std::vector<SnapshotCoin>& coins);
+};
+
+} // namespace dinari
+
+#endif // DINARI_STORAGE_UTXOSNAPSHOT_H
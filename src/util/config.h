@@ -91,6 +91,7 @@ namespace config {
     constexpr const char* WALLET_DIR = "walletdir";
     constexpr const char* DISABLE_WALLET = "disablewallet";
     constexpr const char* KEY_POOL = "keypool";
+    constexpr const char* CONSOLIDATE_MIN_UTXOS = "consolidateminutxos";
 
     // Mining
     constexpr const char* MINING = "mining";
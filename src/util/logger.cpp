@@ -3,9 +3,50 @@
 #include <chrono>
 #include <iomanip>
 #include <ctime>
+#include <cstdio>
+#include <iterator>
 
 namespace dinari {
 
+namespace {
+
+void AppendCompactSize(std::string& out, uint64_t value) {
+    if (value < 0xFD) {
+        out.push_back(static_cast<char>(value));
+        return;
+    }
+
+    size_t width = value <= 0xFFFF ? 2 : (value <= 0xFFFFFFFFULL ? 4 : 8);
+    out.push_back(static_cast<char>(width == 2 ? 0xFD : (width == 4 ? 0xFE : 0xFF)));
+    for (size_t i = 0; i < width; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+bool ReadCompactSize(const std::string& data, size_t& pos, uint64_t& value) {
+    if (pos >= data.size()) {
+        return false;
+    }
+
+    uint8_t first = static_cast<uint8_t>(data[pos++]);
+    size_t width = first < 0xFD ? 0 : (first == 0xFD ? 2 : (first == 0xFE ? 4 : 8));
+    if (width == 0) {
+        value = first;
+        return true;
+    }
+
+    if (data.size() - pos < width) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < width; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (8 * i);
+    }
+    return true;
+}
+
+} // namespace
+
 Logger& Logger::Instance() {
     static Logger instance;
     return instance;
@@ -15,7 +56,17 @@ Logger::Logger()
     : currentLevel(LogLevel::INFO)
     , consoleEnabled(true)
     , fileEnabled(true)
+    , cachedSecond(-1)
+    , slots(new Slot[QUEUE_CAPACITY])
+    , enqueuePos(0)
+    , dequeuePos(0)
+    , writtenCount(0)
+    , running(false)
+    , writerSleeping(false)
 {
+    for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
 }
 
 Logger::~Logger() {
@@ -23,111 +74,373 @@ Logger::~Logger() {
 }
 
 void Logger::Initialize(const std::string& logFilePath, LogLevel level) {
-    std::lock_guard<std::mutex> lock(mutex);
+    StopWriter();
 
-    currentLevel = level;
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
 
-    if (logFile.is_open()) {
-        logFile.close();
-    }
+        currentLevel = level;
+
+        if (logFile.is_open()) {
+            logFile.close();
+        }
 
-    logFile.open(logFilePath, std::ios::out | std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "Failed to open log file: " << logFilePath << std::endl;
-        fileEnabled = false;
-    } else {
-        fileEnabled = true;
-        logFile << "\n=== Dinari Blockchain Log Started at " << GetTimestamp() << " ===\n" << std::endl;
+        logFile.open(logFilePath, std::ios::out | std::ios::app);
+        if (!logFile.is_open()) {
+            std::cerr << "Failed to open log file: " << logFilePath << std::endl;
+            fileEnabled = false;
+        } else {
+            fileEnabled = true;
+            logFile << "\n=== Dinari Blockchain Log Started at " << GetTimestamp() << " ===\n" << std::endl;
+        }
     }
+
+    running = true;
+    writer = std::thread(&Logger::WriterThread, this);
 }
 
 void Logger::SetLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(mutex);
     currentLevel = level;
 }
 
-void Logger::Log(LogLevel level, const std::string& category, const std::string& message) {
-    if (level < currentLevel) {
+void Logger::Log(LogLevel level, const std::string& category, std::string message) {
+    if (!IsEnabled(level)) {
         return;  // Don't log messages below current level
     }
 
-    std::lock_guard<std::mutex> lock(mutex);
+    LogRecord record;
+    record.timeMicros = NowMicros();
+    record.level = level;
+    record.category = category;
+    record.message = std::move(message);
 
-    std::string formatted = FormatMessage(level, category, message);
+    if (!running) {
+        // No writer yet (or already stopped): write directly
+        std::lock_guard<std::mutex> lock(outputMutex);
+        WriteRecords({std::move(record)});
+        return;
+    }
 
-    // Console output
-    if (consoleEnabled) {
-        if (level >= LogLevel::ERROR) {
-            std::cerr << formatted << std::endl;
-        } else {
-            std::cout << formatted << std::endl;
-        }
+    // Back off while the writer catches up rather than drop records
+    while (!TryPush(record)) {
+        WakeWriter();
+        std::this_thread::yield();
     }
 
-    // File output
-    if (fileEnabled && logFile.is_open()) {
-        logFile << formatted << std::endl;
+    if (writerSleeping) {
+        WakeWriter();
     }
+
+    if (level == LogLevel::FATAL) {
+        Flush();
+    }
+}
+
+void Logger::Trace(const std::string& category, std::string message) {
+    Log(LogLevel::TRACE, category, std::move(message));
 }
 
-void Logger::Trace(const std::string& category, const std::string& message) {
-    Log(LogLevel::TRACE, category, message);
+void Logger::Debug(const std::string& category, std::string message) {
+    Log(LogLevel::DEBUG, category, std::move(message));
 }
 
-void Logger::Debug(const std::string& category, const std::string& message) {
-    Log(LogLevel::DEBUG, category, message);
+void Logger::Info(const std::string& category, std::string message) {
+    Log(LogLevel::INFO, category, std::move(message));
 }
 
-void Logger::Info(const std::string& category, const std::string& message) {
-    Log(LogLevel::INFO, category, message);
+void Logger::Warning(const std::string& category, std::string message) {
+    Log(LogLevel::WARNING, category, std::move(message));
 }
 
-void Logger::Warning(const std::string& category, const std::string& message) {
-    Log(LogLevel::WARNING, category, message);
+void Logger::Error(const std::string& category, std::string message) {
+    Log(LogLevel::ERROR, category, std::move(message));
 }
 
-void Logger::Error(const std::string& category, const std::string& message) {
-    Log(LogLevel::ERROR, category, message);
+void Logger::Fatal(const std::string& category, std::string message) {
+    Log(LogLevel::FATAL, category, std::move(message));
 }
 
-void Logger::Fatal(const std::string& category, const std::string& message) {
-    Log(LogLevel::FATAL, category, message);
+bool Logger::OpenBinaryLog(const std::string& path) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    if (binaryLog.is_open()) {
+        binaryLog.close();
+    }
+
+    binaryLog.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!binaryLog.is_open()) {
+        std::cerr << "Failed to open binary log file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Logger::ReadBinaryLog(const std::string& path, std::vector<LogRecord>& records) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    while (data.size() - pos >= 9) {
+        LogRecord record;
+        uint64_t time = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            time |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+        }
+        record.timeMicros = static_cast<int64_t>(time);
+        record.level = static_cast<LogLevel>(static_cast<uint8_t>(data[pos + 8]));
+        size_t next = pos + 9;
+
+        uint64_t len = 0;
+        if (!ReadCompactSize(data, next, len) || data.size() - next < len) {
+            break;
+        }
+        record.category.assign(data, next, len);
+        next += len;
+
+        if (!ReadCompactSize(data, next, len) || data.size() - next < len) {
+            break;
+        }
+        record.message.assign(data, next, len);
+        next += len;
+
+        records.push_back(std::move(record));
+        pos = next;
+    }
+
+    return true;
 }
 
 void Logger::Flush() {
-    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        uint64_t target = enqueuePos.load();
+
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerCv.notify_one();
+        flushedCv.wait(lock, [&]() { return writtenCount.load() >= target || !running; });
+    }
+
+    std::lock_guard<std::mutex> lock(outputMutex);
     if (logFile.is_open()) {
         logFile.flush();
     }
+    if (binaryLog.is_open()) {
+        binaryLog.flush();
+    }
 }
 
 void Logger::Close() {
-    std::lock_guard<std::mutex> lock(mutex);
+    StopWriter();
+
+    std::lock_guard<std::mutex> lock(outputMutex);
     if (logFile.is_open()) {
         logFile << "\n=== Dinari Blockchain Log Closed at " << GetTimestamp() << " ===\n" << std::endl;
         logFile.close();
     }
+    if (binaryLog.is_open()) {
+        binaryLog.close();
+    }
 }
 
-std::string Logger::FormatMessage(LogLevel level, const std::string& category, const std::string& message) {
-    std::ostringstream oss;
-    oss << "[" << GetTimestamp() << "] "
-        << "[" << LevelToString(level) << "] "
-        << "[" << category << "] "
-        << message;
-    return oss.str();
+bool Logger::TryPush(LogRecord& record) {
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot& slot = slots[pos & (QUEUE_CAPACITY - 1)];
+        uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq - pos);
+
+        if (diff == 0) {
+            // Slot is free for this position; claim it
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = std::move(record);
+                slot.sequence.store(pos + 1);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full: the writer has not freed this slot yet
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Logger::TryPop(LogRecord& record) {
+    Slot& slot = slots[dequeuePos & (QUEUE_CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+        return false;
+    }
+
+    record = std::move(slot.record);
+    slot.record = LogRecord();
+    slot.sequence.store(dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+}
+
+bool Logger::HasPending() const {
+    const Slot& slot = slots[dequeuePos & (QUEUE_CAPACITY - 1)];
+    return slot.sequence.load() == dequeuePos + 1;
+}
+
+void Logger::WakeWriter() {
+    // Taking the lock orders this wake-up after the writer's last pending check
+    { std::lock_guard<std::mutex> lock(writerMutex); }
+    writerCv.notify_one();
+}
+
+void Logger::WriterThread() {
+    std::vector<LogRecord> batch;
+    batch.reserve(MAX_BATCH);
+
+    for (;;) {
+        LogRecord record;
+        while (batch.size() < MAX_BATCH && TryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+
+        if (!batch.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                WriteRecords(batch);
+            }
+            writtenCount += batch.size();
+            batch.clear();
+
+            std::lock_guard<std::mutex> lock(writerMutex);
+            flushedCv.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(writerMutex);
+        if (!running) {
+            break;
+        }
+
+        writerSleeping = true;
+        writerCv.wait_for(lock, std::chrono::milliseconds(WRITER_IDLE_MS),
+                          [this]() { return !running || HasPending(); });
+        writerSleeping = false;
+    }
+
+    // Drain anything pushed before running was cleared
+    LogRecord record;
+    while (TryPop(record)) {
+        batch.push_back(std::move(record));
+    }
+    if (!batch.empty()) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        WriteRecords(batch);
+        writtenCount += batch.size();
+    }
+}
+
+void Logger::StopWriter() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+        writerCv.notify_one();
+        flushedCv.notify_all();
+    }
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+void Logger::WriteRecords(const std::vector<LogRecord>& records) {
+    std::string fileText;
+    std::string consoleText;
+    std::string errorText;
+    std::string binary;
+
+    bool toConsole = consoleEnabled;
+    bool toFile = fileEnabled && logFile.is_open();
+    bool toBinary = binaryLog.is_open();
+
+    for (const auto& record : records) {
+        if (toConsole || toFile) {
+            std::string formatted;
+            formatted.reserve(40 + record.category.size() + record.message.size());
+            formatted += '[';
+            formatted += FormatTimestamp(record.timeMicros);
+            formatted += "] [";
+            formatted += LevelToString(record.level);
+            formatted += "] [";
+            formatted += record.category;
+            formatted += "] ";
+            formatted += record.message;
+            formatted += '\n';
+
+            if (toConsole) {
+                (record.level >= LogLevel::ERROR ? errorText : consoleText) += formatted;
+            }
+            if (toFile) {
+                fileText += formatted;
+            }
+        }
+
+        if (toBinary) {
+            uint64_t time = static_cast<uint64_t>(record.timeMicros);
+            for (size_t i = 0; i < 8; ++i) {
+                binary.push_back(static_cast<char>(time >> (8 * i)));
+            }
+            binary.push_back(static_cast<char>(record.level));
+            AppendCompactSize(binary, record.category.size());
+            binary += record.category;
+            AppendCompactSize(binary, record.message.size());
+            binary += record.message;
+        }
+    }
+
+    // One write and one flush per output for the whole batch
+    if (!consoleText.empty()) {
+        std::cout << consoleText << std::flush;
+    }
+    if (!errorText.empty()) {
+        std::cerr << errorText << std::flush;
+    }
+    if (!fileText.empty()) {
+        logFile << fileText;
+        logFile.flush();
+    }
+    if (!binary.empty()) {
+        binaryLog.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+        binaryLog.flush();
+    }
+}
+
+std::string Logger::FormatTimestamp(int64_t timeMicros) {
+    int64_t seconds = timeMicros / 1000000;
+    int64_t ms = (timeMicros / 1000) % 1000;
+
+    // localtime is comparatively slow; reuse the text while the second is unchanged
+    if (seconds != cachedSecond) {
+        std::time_t t = static_cast<std::time_t>(seconds);
+        std::ostringstream oss;
+        oss << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S");
+        cachedSecondText = oss.str();
+        cachedSecond = seconds;
+    }
+
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%03d", static_cast<int>(ms));
+    return cachedSecondText + fraction;
 }
 
 std::string Logger::GetTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+    return FormatTimestamp(NowMicros());
+}
+
+int64_t Logger::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
 std::string Logger::LevelToString(LogLevel level) {
@@ -6,6 +6,11 @@
 #include <mutex>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
 
 namespace dinari {
 
@@ -13,7 +18,12 @@ namespace dinari {
  * @brief Logging system for Dinari blockchain
  *
  * Thread-safe logging with multiple severity levels.
- * Logs to both console and file.
+ * Logs to console, a text file and optionally a binary record file.
+ *
+ * Once initialized, callers only push records into a lock-free ring
+ * buffer; a background writer thread formats them and writes each batch
+ * with one call per output. The LOG_* macros check the level before
+ * evaluating their arguments, so disabled messages cost one atomic load.
  */
 
 enum class LogLevel {
@@ -25,27 +35,42 @@ enum class LogLevel {
     FATAL
 };
 
+/**
+ * @brief One log message as queued and as stored in a binary log
+ */
+struct LogRecord {
+    int64_t timeMicros;         // Wall clock time of the call (µs since epoch)
+    LogLevel level;
+    std::string category;
+    std::string message;
+
+    LogRecord() : timeMicros(0), level(LogLevel::INFO) {}
+};
+
 class Logger {
 public:
     static Logger& Instance();
 
-    // Initialize logger
+    // Initialize logger and start the background writer
     void Initialize(const std::string& logFile, LogLevel level = LogLevel::INFO);
 
     // Set log level
     void SetLevel(LogLevel level);
 
     // Get log level
-    LogLevel GetLevel() const { return currentLevel; }
+    LogLevel GetLevel() const { return currentLevel.load(std::memory_order_relaxed); }
+
+    // Check if a level would be logged
+    bool IsEnabled(LogLevel level) const { return level >= GetLevel(); }
 
     // Log functions
-    void Log(LogLevel level, const std::string& category, const std::string& message);
-    void Trace(const std::string& category, const std::string& message);
-    void Debug(const std::string& category, const std::string& message);
-    void Info(const std::string& category, const std::string& message);
-    void Warning(const std::string& category, const std::string& message);
-    void Error(const std::string& category, const std::string& message);
-    void Fatal(const std::string& category, const std::string& message);
+    void Log(LogLevel level, const std::string& category, std::string message);
+    void Trace(const std::string& category, std::string message);
+    void Debug(const std::string& category, std::string message);
+    void Info(const std::string& category, std::string message);
+    void Warning(const std::string& category, std::string message);
+    void Error(const std::string& category, std::string message);
+    void Fatal(const std::string& category, std::string message);
 
     // Enable/disable console output
     void SetConsoleOutput(bool enabled) { consoleEnabled = enabled; }
@@ -53,10 +78,31 @@ public:
     // Enable/disable file output
     void SetFileOutput(bool enabled) { fileEnabled = enabled; }
 
-    // Flush logs to disk
+    /**
+     * @brief Also write every record to a binary log
+     *
+     * Each record is an 8-byte timestamp in microseconds, a 1-byte level
+     * and compact-size prefixed category and message strings, all little
+     * endian. Cheaper to write and to filter than the text log.
+     *
+     * @param path Binary log file (appended to)
+     * @return true if the file was opened
+     */
+    bool OpenBinaryLog(const std::string& path);
+
+    /**
+     * @brief Read back a file written by OpenBinaryLog()
+     *
+     * @param path Binary log file
+     * @param records Output records (a truncated last record is ignored)
+     * @return true if the file could be read
+     */
+    static bool ReadBinaryLog(const std::string& path, std::vector<LogRecord>& records);
+
+    // Wait until everything logged so far has been written, then flush to disk
     void Flush();
 
-    // Close logger
+    // Stop the writer and close logger
     void Close();
 
 private:
@@ -66,24 +112,78 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    std::string FormatMessage(LogLevel level, const std::string& category, const std::string& message);
+    /**
+     * @brief Ring buffer slot
+     *
+     * The sequence number tells producers and the writer whose turn the
+     * slot is: equal to the position when free, position + 1 once filled.
+     */
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        LogRecord record;
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 8192;          // Power of two
+    static constexpr size_t MAX_BATCH = 512;                // Records per write
+    static constexpr int WRITER_IDLE_MS = 100;              // Wake-up interval when idle
+
+    bool TryPush(LogRecord& record);
+    bool TryPop(LogRecord& record);
+    bool HasPending() const;
+    void WakeWriter();
+    void WriterThread();
+    void StopWriter();
+
+    // Format and write records; caller holds outputMutex
+    void WriteRecords(const std::vector<LogRecord>& records);
+
+    std::string FormatTimestamp(int64_t timeMicros);
     std::string GetTimestamp();
+    static int64_t NowMicros();
     std::string LevelToString(LogLevel level);
 
-    LogLevel currentLevel;
-    bool consoleEnabled;
-    bool fileEnabled;
+    std::atomic<LogLevel> currentLevel;
+    std::atomic<bool> consoleEnabled;
+    std::atomic<bool> fileEnabled;
+
+    // Outputs, touched by the writer thread and by Initialize/Close
     std::ofstream logFile;
-    std::mutex mutex;
+    std::ofstream binaryLog;
+    std::mutex outputMutex;
+
+    // Timestamp prefix cache ("YYYY-MM-DD HH:MM:SS" for cachedSecond)
+    int64_t cachedSecond;
+    std::string cachedSecondText;
+
+    // MPSC ring buffer
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<uint64_t> enqueuePos;
+    alignas(64) uint64_t dequeuePos;        // Writer only
+    std::atomic<uint64_t> writtenCount;     // Records popped and written
+
+    // Background writer
+    std::thread writer;
+    std::atomic<bool> running;
+    std::atomic<bool> writerSleeping;
+    std::mutex writerMutex;
+    std::condition_variable writerCv;
+    std::condition_variable flushedCv;
 };
 
-// Convenience macros
-#define LOG_TRACE(category, message) dinari::Logger::Instance().Trace(category, message)
-#define LOG_DEBUG(category, message) dinari::Logger::Instance().Debug(category, message)
-#define LOG_INFO(category, message) dinari::Logger::Instance().Info(category, message)
-#define LOG_WARNING(category, message) dinari::Logger::Instance().Warning(category, message)
-#define LOG_ERROR(category, message) dinari::Logger::Instance().Error(category, message)
-#define LOG_FATAL(category, message) dinari::Logger::Instance().Fatal(category, message)
+// Convenience macros; the message is only built when the level is enabled
+#define DINARI_LOG(level, category, message)                                    \
+    do {                                                                        \
+        if (dinari::Logger::Instance().IsEnabled(level)) {                      \
+            dinari::Logger::Instance().Log(level, category, message);           \
+        }                                                                       \
+    } while (0)
+
+#define LOG_TRACE(category, message) DINARI_LOG(dinari::LogLevel::TRACE, category, message)
+#define LOG_DEBUG(category, message) DINARI_LOG(dinari::LogLevel::DEBUG, category, message)
+#define LOG_INFO(category, message) DINARI_LOG(dinari::LogLevel::INFO, category, message)
+#define LOG_WARNING(category, message) DINARI_LOG(dinari::LogLevel::WARNING, category, message)
+#define LOG_ERROR(category, message) DINARI_LOG(dinari::LogLevel::ERROR, category, message)
+#define LOG_FATAL(category, message) DINARI_LOG(dinari::LogLevel::FATAL, category, message)
 
 // Stream-style logging
 class LogStream {
@@ -107,13 +207,14 @@ private:
     std::stringstream stream;
 };
 
-// Stream-style macros
-#define LOG_STREAM(level, category) dinari::LogStream(level, category)
-#define LOG_TRACE_STREAM(category) dinari::LogStream(dinari::LogLevel::TRACE, category)
-#define LOG_DEBUG_STREAM(category) dinari::LogStream(dinari::LogLevel::DEBUG, category)
-#define LOG_INFO_STREAM(category) dinari::LogStream(dinari::LogLevel::INFO, category)
-#define LOG_WARNING_STREAM(category) dinari::LogStream(dinari::LogLevel::WARNING, category)
-#define LOG_ERROR_STREAM(category) dinari::LogStream(dinari::LogLevel::ERROR, category)
+// Stream-style macros; the streamed values are skipped when the level is disabled
+#define LOG_STREAM(level, category) \
+    if (!dinari::Logger::Instance().IsEnabled(level)) {} else dinari::LogStream(level, category)
+#define LOG_TRACE_STREAM(category) LOG_STREAM(dinari::LogLevel::TRACE, category)
+#define LOG_DEBUG_STREAM(category) LOG_STREAM(dinari::LogLevel::DEBUG, category)
+#define LOG_INFO_STREAM(category) LOG_STREAM(dinari::LogLevel::INFO, category)
+#define LOG_WARNING_STREAM(category) LOG_STREAM(dinari::LogLevel::WARNING, category)
+#define LOG_ERROR_STREAM(category) LOG_STREAM(dinari::LogLevel::ERROR, category)
 
 } // namespace dinari
 
@@ -0,0 +1,229 @@
+#include "metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace dinari {
+
+namespace {
+
+// Threads get shards round-robin on first use
+size_t ThreadShard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+std::string FormatValue(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+}
+
+void AppendSample(std::string& out, const std::string& name, const std::string& labels,
+                  const std::string& value) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+} // namespace
+
+// Counter
+
+Counter::Counter() {
+    for (auto& cell : cells) {
+        cell.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Counter::Inc(uint64_t amount) {
+    cells[ThreadShard()].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Counter::Value() const {
+    uint64_t total = 0;
+    for (const auto& cell : cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::Render(const std::string& name, const std::string& labels, std::string& out) const {
+    AppendSample(out, name, labels, std::to_string(Value()));
+}
+
+// Gauge
+
+void Gauge::Render(const std::string& name, const std::string& labels, std::string& out) const {
+    AppendSample(out, name, labels, std::to_string(Value()));
+}
+
+// Histogram
+
+Histogram::Histogram(std::vector<double> bucketBounds) : bounds(std::move(bucketBounds)) {
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    for (auto& shard : shards) {
+        shard.counts.reset(new std::atomic<uint64_t>[bounds.size() + 1]);
+        for (size_t i = 0; i <= bounds.size(); ++i) {
+            shard.counts[i].store(0, std::memory_order_relaxed);
+        }
+        shard.count.store(0, std::memory_order_relaxed);
+        shard.sum.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::Observe(double value) {
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+
+    Shard& shard = shards[ThreadShard()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+
+    // Shards are rarely shared, so this loop almost never retries
+    double sum = shard.sum.load(std::memory_order_relaxed);
+    while (!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::GetSnapshot() const {
+    Snapshot snapshot;
+    snapshot.bucketCounts.assign(bounds.size() + 1, 0);
+    snapshot.count = 0;
+    snapshot.sum = 0.0;
+
+    for (const auto& shard : shards) {
+        for (size_t i = 0; i <= bounds.size(); ++i) {
+            snapshot.bucketCounts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += shard.count.load(std::memory_order_relaxed);
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+void Histogram::Render(const std::string& name, const std::string& labels, std::string& out) const {
+    Snapshot snapshot = GetSnapshot();
+    std::string prefix = labels.empty() ? "" : labels + ",";
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        cumulative += snapshot.bucketCounts[i];
+        AppendSample(out, name + "_bucket", prefix + "le=\"" + FormatValue(bounds[i]) + "\"",
+                     std::to_string(cumulative));
+    }
+    // Derive +Inf from the buckets so it always matches them, even mid-update
+    cumulative += snapshot.bucketCounts[bounds.size()];
+    AppendSample(out, name + "_bucket", prefix + "le=\"+Inf\"", std::to_string(cumulative));
+    AppendSample(out, name + "_sum", labels, FormatValue(snapshot.sum));
+    AppendSample(out, name + "_count", labels, std::to_string(cumulative));
+}
+
+// Metrics registry
+
+Metrics& Metrics::Instance() {
+    static Metrics instance;
+    return instance;
+}
+
+Counter& Metrics::GetCounter(const std::string& name, const std::string& help,
+                             const std::string& labels) {
+    return static_cast<Counter&>(GetOrCreate(name, help, labels, Type::COUNTER, []() {
+        return std::unique_ptr<Metric>(new Counter());
+    }));
+}
+
+Gauge& Metrics::GetGauge(const std::string& name, const std::string& help,
+                         const std::string& labels) {
+    return static_cast<Gauge&>(GetOrCreate(name, help, labels, Type::GAUGE, []() {
+        return std::unique_ptr<Metric>(new Gauge());
+    }));
+}
+
+Histogram& Metrics::GetHistogram(const std::string& name, const std::string& help,
+                                 const std::string& labels,
+                                 const std::vector<double>& buckets) {
+    return static_cast<Histogram&>(GetOrCreate(name, help, labels, Type::HISTOGRAM, [&buckets]() {
+        return std::unique_ptr<Metric>(new Histogram(buckets));
+    }));
+}
+
+void Metrics::AddCollector(std::function<void()> collector) {
+    std::lock_guard<std::mutex> lock(mutex);
+    collectors.push_back(std::move(collector));
+}
+
+std::string Metrics::RenderPrometheus() {
+    std::vector<std::function<void()>> toRun;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        toRun = collectors;
+    }
+
+    // Collectors may create metrics, so they run without the registry lock
+    for (const auto& collector : toRun) {
+        collector();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string out;
+    for (const auto& [name, family] : families) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        out += "# TYPE " + name + " " + TypeName(family.type) + "\n";
+        for (const auto& [labels, metric] : family.series) {
+            metric->Render(name, labels, out);
+        }
+    }
+    return out;
+}
+
+const std::vector<double>& Metrics::DefaultLatencyBuckets() {
+    static const std::vector<double> buckets = {
+        0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005,
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+        0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+    };
+    return buckets;
+}
+
+Metric& Metrics::GetOrCreate(const std::string& name, const std::string& help,
+                             const std::string& labels, Type type,
+                             const std::function<std::unique_ptr<Metric>()>& create) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto familyIt = families.find(name);
+    if (familyIt == families.end()) {
+        familyIt = families.emplace(name, Family{type, help, {}}).first;
+    } else if (familyIt->second.type != type) {
+        throw std::invalid_argument("Metric " + name + " already registered as " +
+                                    TypeName(familyIt->second.type));
+    }
+
+    auto& series = familyIt->second.series;
+    auto it = series.find(labels);
+    if (it == series.end()) {
+        it = series.emplace(labels, create()).first;
+    }
+    return *it->second;
+}
+
+const char* Metrics::TypeName(Type type) {
+    switch (type) {
+        case Type::COUNTER:   return "counter";
+        case Type::GAUGE:     return "gauge";
+        case Type::HISTOGRAM: return "histogram";
+        default:              return "untyped";
+    }
+}
+
+} // namespace dinari
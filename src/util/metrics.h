@@ -0,0 +1,218 @@
+#ifndef DINARI_UTIL_METRICS_H
+#define DINARI_UTIL_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dinari {
+
+/**
+ * @brief Lightweight process metrics
+ *
+ * Counters, gauges and fixed-bucket histograms that hot paths can update
+ * without locks. Counters and histograms are split into cache-line sized
+ * shards picked per thread, so threads updating the same metric do not
+ * contend; shards are summed only when the metrics are exported.
+ *
+ * Metrics are created once through the Metrics registry and live for the
+ * whole process, so call sites keep a reference, usually in a
+ * function-local static:
+ *
+ *     static Counter& lookups = Metrics::Instance().GetCounter(
+ *         "dinari_utxo_lookups_total", "UTXO set lookups");
+ *     lookups.Inc();
+ */
+
+// Number of per-thread shards in counters and histograms
+constexpr size_t METRIC_SHARDS = 16;
+
+/**
+ * @brief Base class for exported metrics
+ */
+class Metric {
+public:
+    virtual ~Metric() = default;
+
+    /**
+     * @brief Append Prometheus text samples
+     * @param name Metric family name
+     * @param labels Label set without braces (may be empty)
+     * @param out Output text
+     */
+    virtual void Render(const std::string& name, const std::string& labels,
+                        std::string& out) const = 0;
+};
+
+/**
+ * @brief Monotonically increasing counter
+ */
+class Counter : public Metric {
+public:
+    Counter();
+
+    void Inc(uint64_t amount = 1);
+    uint64_t Value() const;
+
+    void Render(const std::string& name, const std::string& labels,
+                std::string& out) const override;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value;
+    };
+    Cell cells[METRIC_SHARDS];
+};
+
+/**
+ * @brief Value that can go up and down
+ */
+class Gauge : public Metric {
+public:
+    Gauge() : value(0) {}
+
+    void Set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+    void Add(int64_t delta) { value.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t Value() const { return value.load(std::memory_order_relaxed); }
+
+    void Render(const std::string& name, const std::string& labels,
+                std::string& out) const override;
+
+private:
+    std::atomic<int64_t> value;
+};
+
+/**
+ * @brief Distribution of observed values over fixed buckets
+ *
+ * Buckets are upper bounds (inclusive), ascending; an implicit +Inf
+ * bucket catches the rest. Durations are observed in seconds.
+ */
+class Histogram : public Metric {
+public:
+    explicit Histogram(std::vector<double> bucketBounds);
+
+    void Observe(double value);
+
+    /**
+     * @brief Snapshot of the summed shards
+     */
+    struct Snapshot {
+        std::vector<uint64_t> bucketCounts;     // Per bucket (not cumulative), +Inf last
+        uint64_t count;
+        double sum;
+    };
+    Snapshot GetSnapshot() const;
+
+    const std::vector<double>& GetBounds() const { return bounds; }
+
+    void Render(const std::string& name, const std::string& labels,
+                std::string& out) const override;
+
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> counts;
+        std::atomic<uint64_t> count;
+        std::atomic<double> sum;
+    };
+
+    std::vector<double> bounds;
+    Shard shards[METRIC_SHARDS];
+};
+
+/**
+ * @brief Observes the lifetime of a scope, in seconds, into a histogram
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& h)
+        : histogram(h), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        histogram.Observe(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Process-wide metrics registry and Prometheus exporter
+ */
+class Metrics {
+public:
+    static Metrics& Instance();
+
+    /**
+     * @brief Get or create a metric
+     *
+     * The same name and labels always return the same object. Labels use
+     * Prometheus syntax without braces, e.g. "method=\"getblock\"".
+     * Asking for an existing name with a different type throws
+     * std::invalid_argument.
+     */
+    Counter& GetCounter(const std::string& name, const std::string& help,
+                        const std::string& labels = "");
+    Gauge& GetGauge(const std::string& name, const std::string& help,
+                    const std::string& labels = "");
+    Histogram& GetHistogram(const std::string& name, const std::string& help,
+                            const std::string& labels = "",
+                            const std::vector<double>& buckets = DefaultLatencyBuckets());
+
+    /**
+     * @brief Register a callback run before each export
+     *
+     * Used to refresh gauges for state that is cheaper to read on demand
+     * (mempool size, peer count) than to track on every change.
+     */
+    void AddCollector(std::function<void()> collector);
+
+    /**
+     * @brief Render all metrics in the Prometheus text exposition format
+     */
+    std::string RenderPrometheus();
+
+    /**
+     * @brief Latency buckets from 10µs to 10s
+     */
+    static const std::vector<double>& DefaultLatencyBuckets();
+
+private:
+    Metrics() = default;
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Metric>> series;  // Labels -> metric
+    };
+
+    Metric& GetOrCreate(const std::string& name, const std::string& help,
+                        const std::string& labels, Type type,
+                        const std::function<std::unique_ptr<Metric>()>& create);
+
+    static const char* TypeName(Type type);
+
+    std::map<std::string, Family> families;
+    std::vector<std::function<void()>> collectors;
+    std::mutex mutex;
+};
+
+} // namespace dinari
+
+#endif // DINARI_UTIL_METRICS_H
@@ -1,8 +1,15 @@
 #include "security.h"
 #include <openssl/rand.h>
+#include <openssl/crypto.h>
 #include <algorithm>
 #include <stdexcept>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 namespace dinari {
 
 // Base64 character set
@@ -115,6 +122,12 @@ bytes Security::SecureRandomBytes(size_t length) {
     return result;
 }
 
+void Security::SecureWipe(void* ptr, size_t len) {
+    if (ptr && len > 0) {
+        OPENSSL_cleanse(ptr, len);
+    }
+}
+
 // RateLimiter implementation
 
 bool RateLimiter::CheckLimit(const std::string& key, size_t maxRequests, size_t windowSeconds) {
@@ -186,4 +199,61 @@ bool RateLimiter::IsBanned(const std::string& key) {
     return now < it->second.banUntil;
 }
 
+// LockedBuffer implementation
+
+LockedBuffer::LockedBuffer(size_t size)
+    : ptr(new byte[size > 0 ? size : 1]())
+    , len(size)
+    , locked(false) {
+#ifdef _WIN32
+    locked = VirtualLock(ptr.get(), len) != 0;
+#else
+    locked = mlock(ptr.get(), len) == 0;
+#endif
+}
+
+LockedBuffer::~LockedBuffer() {
+    Security::SecureWipe(ptr.get(), len);
+
+    if (locked) {
+#ifdef _WIN32
+        VirtualUnlock(ptr.get(), len);
+#else
+        munlock(ptr.get(), len);
+#endif
+    }
+}
+
+// LockedSlotPool implementation
+
+LockedSlotPool::LockedSlotPool(size_t size, size_t perArena)
+    : slotSize(size)
+    , slotsPerArena(perArena > 0 ? perArena : 1) {
+}
+
+byte* LockedSlotPool::Allocate() {
+    if (freeSlots.empty()) {
+        arenas.push_back(std::make_unique<LockedBuffer>(slotSize * slotsPerArena));
+        byte* base = arenas.back()->data();
+        for (size_t i = slotsPerArena; i > 0; --i) {
+            freeSlots.push_back(base + (i - 1) * slotSize);
+        }
+    }
+
+    byte* slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+}
+
+void LockedSlotPool::Free(byte* slot) {
+    Security::SecureWipe(slot, slotSize);
+    freeSlots.push_back(slot);
+}
+
+void LockedSlotPool::Clear() {
+    // LockedBuffer wipes each arena as it is released
+    freeSlots.clear();
+    arenas.clear();
+}
+
 } // namespace dinari
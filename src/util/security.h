@@ -7,6 +7,8 @@
 #include <map>
 #include <mutex>
 #include <chrono>
+#include <memory>
+#include <vector>
 
 namespace dinari {
 
@@ -35,11 +37,78 @@ public:
      */
     static bytes SecureRandomBytes(size_t length);
 
+    /**
+     * @brief Overwrite memory holding a secret (not optimized away)
+     */
+    static void SecureWipe(void* ptr, size_t len);
+
 private:
     static const std::string base64_chars;
     static bool IsBase64(unsigned char c);
 };
 
+/**
+ * @brief Fixed-size buffer for secrets, pinned in RAM and wiped on release
+ *
+ * The pages are locked so secrets are never written to swap. If locking
+ * fails (e.g. RLIMIT_MEMLOCK) the buffer still works and is still wiped.
+ */
+class LockedBuffer {
+public:
+    explicit LockedBuffer(size_t size);
+    ~LockedBuffer();
+
+    // Non-copyable
+    LockedBuffer(const LockedBuffer&) = delete;
+    LockedBuffer& operator=(const LockedBuffer&) = delete;
+
+    byte* data() { return ptr.get(); }
+    const byte* data() const { return ptr.get(); }
+    size_t size() const { return len; }
+
+    /**
+     * @brief Check if the pages are locked in RAM
+     */
+    bool IsLocked() const { return locked; }
+
+private:
+    std::unique_ptr<byte[]> ptr;
+    size_t len;
+    bool locked;
+};
+
+/**
+ * @brief Fixed-size secret slots carved from locked arenas
+ *
+ * Many small secrets share a few locked pages instead of locking a page
+ * each. Freed slots are wiped and reused. Not thread-safe.
+ */
+class LockedSlotPool {
+public:
+    explicit LockedSlotPool(size_t slotSize, size_t slotsPerArena = 128);
+
+    /**
+     * @brief Get a zeroed slot of slotSize bytes
+     */
+    byte* Allocate();
+
+    /**
+     * @brief Wipe a slot and return it to the pool
+     */
+    void Free(byte* slot);
+
+    /**
+     * @brief Wipe and release every slot
+     */
+    void Clear();
+
+private:
+    size_t slotSize;
+    size_t slotsPerArena;
+    std::vector<std::unique_ptr<LockedBuffer>> arenas;
+    std::vector<byte*> freeSlots;
+};
+
 /**
  * @brief Rate limiter for preventing DoS attacks
  */
@@ -6,26 +6,19 @@ namespace dinari {
 
 // Serializer implementations
 
-void Serializer::WriteUInt8(uint8_t value) {
-    data.push_back(value);
-}
-
 void Serializer::WriteUInt16(uint16_t value) {
     value = htole16(value);
-    const byte* ptr = reinterpret_cast<const byte*>(&value);
-    data.insert(data.end(), ptr, ptr + sizeof(value));
+    WriteRaw(&value, sizeof(value));
 }
 
 void Serializer::WriteUInt32(uint32_t value) {
     value = htole32(value);
-    const byte* ptr = reinterpret_cast<const byte*>(&value);
-    data.insert(data.end(), ptr, ptr + sizeof(value));
+    WriteRaw(&value, sizeof(value));
 }
 
 void Serializer::WriteUInt64(uint64_t value) {
     value = htole64(value);
-    const byte* ptr = reinterpret_cast<const byte*>(&value);
-    data.insert(data.end(), ptr, ptr + sizeof(value));
+    WriteRaw(&value, sizeof(value));
 }
 
 void Serializer::WriteInt32(int32_t value) {
@@ -60,49 +53,22 @@ void Serializer::WriteCompactSize(uint64_t size) {
     WriteVarInt(size);
 }
 
-void Serializer::WriteBytes(const bytes& value) {
-    data.insert(data.end(), value.begin(), value.end());
-}
-
-void Serializer::WriteBytes(const byte* ptr, size_t len) {
-    data.insert(data.end(), ptr, ptr + len);
-}
-
 void Serializer::WriteString(const std::string& value) {
     WriteCompactSize(value.size());
-    data.insert(data.end(), value.begin(), value.end());
-}
-
-void Serializer::WriteHash256(const Hash256& hash) {
-    data.insert(data.end(), hash.begin(), hash.end());
-}
-
-void Serializer::WriteHash160(const Hash160& hash) {
-    data.insert(data.end(), hash.begin(), hash.end());
+    WriteRaw(value.data(), value.size());
 }
 
 // Deserializer implementations
 
-void Deserializer::CheckAvailable(size_t size) const {
-    if (pos + size > data.size()) {
-        throw std::runtime_error("Deserializer: not enough data");
-    }
-}
-
 void Deserializer::Skip(size_t count) {
     CheckAvailable(count);
     pos += count;
 }
 
-uint8_t Deserializer::ReadUInt8() {
-    CheckAvailable(1);
-    return data[pos++];
-}
-
 uint16_t Deserializer::ReadUInt16() {
     CheckAvailable(2);
     uint16_t value;
-    std::memcpy(&value, &data[pos], sizeof(value));
+    std::memcpy(&value, buf + pos, sizeof(value));
     pos += sizeof(value);
     return le16toh(value);
 }
@@ -110,7 +76,7 @@ uint16_t Deserializer::ReadUInt16() {
 uint32_t Deserializer::ReadUInt32() {
     CheckAvailable(4);
     uint32_t value;
-    std::memcpy(&value, &data[pos], sizeof(value));
+    std::memcpy(&value, buf + pos, sizeof(value));
     pos += sizeof(value);
     return le32toh(value);
 }
@@ -118,7 +84,7 @@ uint32_t Deserializer::ReadUInt32() {
 uint64_t Deserializer::ReadUInt64() {
     CheckAvailable(8);
     uint64_t value;
-    std::memcpy(&value, &data[pos], sizeof(value));
+    std::memcpy(&value, buf + pos, sizeof(value));
     pos += sizeof(value);
     return le64toh(value);
 }
@@ -155,37 +121,46 @@ uint64_t Deserializer::ReadCompactSize() {
 
 bytes Deserializer::ReadBytes(size_t len) {
     CheckAvailable(len);
-    bytes result(data.begin() + pos, data.begin() + pos + len);
+    bytes result(buf + pos, buf + pos + len);
     pos += len;
     return result;
 }
 
+void Deserializer::ReadBytes(byte* out, size_t len) {
+    CheckAvailable(len);
+    std::memcpy(out, buf + pos, len);
+    pos += len;
+}
+
 std::string Deserializer::ReadString(size_t len) {
     CheckAvailable(len);
-    std::string result(data.begin() + pos, data.begin() + pos + len);
+    std::string result(reinterpret_cast<const char*>(buf + pos), len);
+    pos += len;
+    return result;
+}
+
+ByteSpan Deserializer::ReadSpan(size_t len) {
+    CheckAvailable(len);
+    ByteSpan result(buf + pos, len);
     pos += len;
     return result;
 }
 
 Hash256 Deserializer::ReadHash256() {
-    CheckAvailable(32);
     Hash256 hash;
-    std::memcpy(hash.data(), &data[pos], 32);
-    pos += 32;
+    ReadBytes(hash.data(), hash.size());
     return hash;
 }
 
 Hash160 Deserializer::ReadHash160() {
-    CheckAvailable(20);
     Hash160 hash;
-    std::memcpy(hash.data(), &data[pos], 20);
-    pos += 20;
+    ReadBytes(hash.data(), hash.size());
     return hash;
 }
 
 bytes Deserializer::ReadRemaining() {
-    bytes result(data.begin() + pos, data.end());
-    pos = data.size();
+    bytes result(buf + pos, buf + length);
+    pos = length;
     return result;
 }
 
@@ -22,25 +22,90 @@ namespace dinari {
  * - Custom types with Serialize/Deserialize methods
  */
 
+/**
+ * @brief Non-owning view of a byte range
+ *
+ * The viewed buffer must outlive the span.
+ */
+class ByteSpan {
+public:
+    ByteSpan() : ptr(nullptr), len(0) {}
+    ByteSpan(const byte* data, size_t size) : ptr(data), len(size) {}
+    ByteSpan(const bytes& data) : ptr(data.data()), len(data.size()) {}
+
+    const byte* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    const byte* begin() const { return ptr; }
+    const byte* end() const { return ptr + len; }
+    byte operator[](size_t i) const { return ptr[i]; }
+
+    ByteSpan subspan(size_t offset, size_t count) const { return ByteSpan(ptr + offset, count); }
+    bytes ToBytes() const { return bytes(ptr, ptr + len); }
+
+private:
+    const byte* ptr;
+    size_t len;
+};
+
+/**
+ * @brief Binary writer
+ *
+ * Writes into its own buffer, appends to a caller-provided buffer (which
+ * can be reserved or reused across calls), or only counts bytes when
+ * created with SizeComputer().
+ */
 class Serializer {
 public:
-    Serializer() = default;
+    Serializer() : target(nullptr), sizeOnly(false), written(0) {}
 
-    // Get serialized data
-    const bytes& GetData() const { return data; }
-    bytes&& MoveData() { return std::move(data); }
+    /**
+     * @brief Append to a caller-provided buffer
+     */
+    explicit Serializer(bytes& buffer) : target(&buffer), sizeOnly(false), written(0) {}
 
-    // Get current size
-    size_t Size() const { return data.size(); }
+    /**
+     * @brief Serializer that stores nothing and only counts bytes
+     */
+    static Serializer SizeComputer() {
+        Serializer s;
+        s.sizeOnly = true;
+        return s;
+    }
 
-    // Clear data
-    void Clear() { data.clear(); }
+    bool IsSizeOnly() const { return sizeOnly; }
+
+    // Get serialized data
+    const bytes& GetData() const { return target ? *target : data; }
+    bytes&& MoveData() { return std::move(target ? *target : data); }
+
+    // Get number of bytes written
+    size_t Size() const { return written; }
+
+    // Clear data written by this serializer
+    void Clear() {
+        if (!sizeOnly) {
+            bytes& buf = Buffer();
+            buf.resize(buf.size() - written);
+        }
+        written = 0;
+    }
 
     // Reserve space
-    void Reserve(size_t size) { data.reserve(size); }
+    void Reserve(size_t size) {
+        if (!sizeOnly) {
+            Buffer().reserve(Buffer().size() + size);
+        }
+    }
 
     // Write basic types
-    void WriteUInt8(uint8_t value);
+    void WriteUInt8(uint8_t value) {
+        ++written;
+        if (!sizeOnly) {
+            Buffer().push_back(value);
+        }
+    }
     void WriteUInt16(uint16_t value);
     void WriteUInt32(uint32_t value);
     void WriteUInt64(uint64_t value);
@@ -52,13 +117,14 @@ public:
     void WriteVarInt(uint64_t value);
 
     // Write bytes and strings
-    void WriteBytes(const bytes& value);
-    void WriteBytes(const byte* data, size_t len);
+    void WriteBytes(const bytes& value) { WriteRaw(value.data(), value.size()); }
+    void WriteBytes(const byte* data, size_t len) { WriteRaw(data, len); }
+    void WriteBytes(ByteSpan value) { WriteRaw(value.data(), value.size()); }
     void WriteString(const std::string& value);
 
     // Write hash types
-    void WriteHash256(const Hash256& hash);
-    void WriteHash160(const Hash160& hash);
+    void WriteHash256(const Hash256& hash) { WriteRaw(hash.data(), hash.size()); }
+    void WriteHash160(const Hash160& hash) { WriteRaw(hash.data(), hash.size()); }
 
     // Write vector with size prefix
     template<typename T>
@@ -71,18 +137,54 @@ public:
     template<typename T>
     void WriteObject(const T& obj);
 
+    /**
+     * @brief Number of bytes WriteCompactSize() emits for a value
+     */
+    static size_t GetCompactSizeSize(uint64_t size) {
+        return size < 0xFD ? 1 : size <= 0xFFFF ? 3 : size <= 0xFFFFFFFF ? 5 : 9;
+    }
+
 private:
     bytes data;
+    bytes* target;      // Caller-provided buffer, if any
+    bool sizeOnly;
+    size_t written;
+
+    bytes& Buffer() { return target ? *target : data; }
+
+    void WriteRaw(const void* ptr, size_t len) {
+        written += len;
+        if (!sizeOnly && len > 0) {
+            bytes& buf = Buffer();
+            size_t offset = buf.size();
+            buf.resize(offset + len);
+            std::memcpy(buf.data() + offset, ptr, len);
+        }
+    }
 };
 
+/**
+ * @brief Binary reader over a borrowed byte range
+ *
+ * Constructed from an lvalue buffer or pointer/length, it reads in place
+ * without copying; the buffer must outlive the deserializer. A temporary
+ * buffer is moved in and owned instead.
+ */
 class Deserializer {
 public:
-    explicit Deserializer(const bytes& data) : data(data), pos(0) {}
-    explicit Deserializer(bytes&& data) : data(std::move(data)), pos(0) {}
+    explicit Deserializer(const bytes& data) : buf(data.data()), length(data.size()), pos(0) {}
+    explicit Deserializer(bytes&& data)
+        : owned(std::move(data)), buf(owned.data()), length(owned.size()), pos(0) {}
+    explicit Deserializer(ByteSpan data) : buf(data.data()), length(data.size()), pos(0) {}
+    Deserializer(const byte* data, size_t len) : buf(data), length(len), pos(0) {}
+
+    // Non-copyable (a copy of an owning reader would point into the original)
+    Deserializer(const Deserializer&) = delete;
+    Deserializer& operator=(const Deserializer&) = delete;
 
     // Check if more data available
-    bool Available() const { return pos < data.size(); }
-    size_t Remaining() const { return data.size() - pos; }
+    bool Available() const { return pos < length; }
+    size_t Remaining() const { return length - pos; }
     size_t Position() const { return pos; }
 
     // Skip bytes
@@ -92,7 +194,10 @@ public:
     void Reset() { pos = 0; }
 
     // Read basic types
-    uint8_t ReadUInt8();
+    uint8_t ReadUInt8() {
+        CheckAvailable(1);
+        return buf[pos++];
+    }
     uint16_t ReadUInt16();
     uint32_t ReadUInt32();
     uint64_t ReadUInt64();
@@ -105,8 +210,20 @@ public:
 
     // Read bytes and strings
     bytes ReadBytes(size_t len);
+    void ReadBytes(byte* out, size_t len);
     std::string ReadString(size_t len);
 
+    /**
+     * @brief Read bytes in place without copying
+     * @return View into the underlying buffer
+     */
+    ByteSpan ReadSpan(size_t len);
+
+    /**
+     * @brief View of the bytes read since an earlier Position()
+     */
+    ByteSpan ReadSince(size_t start) const { return ByteSpan(buf + start, pos - start); }
+
     // Read hash types
     Hash256 ReadHash256();
     Hash160 ReadHash160();
@@ -126,10 +243,16 @@ public:
     bytes ReadRemaining();
 
 private:
-    bytes data;
+    bytes owned;        // Only used when constructed from a temporary
+    const byte* buf;
+    size_t length;
     size_t pos;
 
-    void CheckAvailable(size_t size) const;
+    void CheckAvailable(size_t size) const {
+        if (size > length - pos) {
+            throw std::runtime_error("Deserializer: not enough data");
+        }
+    }
 };
 
 // Helper functions for quick serialization/deserialization
@@ -142,7 +265,7 @@ bytes Serialize(const T& obj) {
 }
 
 template<typename T>
-T Deserialize(const bytes& data) {
+T Deserialize(ByteSpan data) {
     Deserializer d(data);
     return d.ReadObject<T>();
 }
@@ -157,13 +280,13 @@ public:
         return s.MoveData();
     }
 
-    void Deserialize(const bytes& data) {
+    void Deserialize(ByteSpan data) {
         Deserializer d(data);
         static_cast<Derived*>(this)->DeserializeImpl(d);
     }
 
     size_t GetSerializedSize() const {
-        Serializer s;
+        Serializer s = Serializer::SizeComputer();
         static_cast<const Derived*>(this)->SerializeImpl(s);
         return s.Size();
     }
@@ -0,0 +1,205 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace dinari {
+
+/**
+ * @brief Registers the thread's buffer on first use and retires it on exit
+ */
+struct ThreadBufferHolder {
+    std::shared_ptr<Tracer::ThreadBuffer> buffer;
+
+    ~ThreadBufferHolder() {
+        if (buffer) {
+            Tracer::Instance().Retire(buffer);
+        }
+    }
+};
+
+namespace {
+
+void AppendEscaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) >= 0x20) {
+                    out += c;
+                }
+                break;
+        }
+    }
+}
+
+// Chrome expects microseconds; keep nanosecond precision as decimals
+void AppendMicros(std::string& out, uint64_t nanos) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03u",
+                  static_cast<unsigned long long>(nanos / 1000),
+                  static_cast<unsigned>(nanos % 1000));
+    out += buf;
+}
+
+} // namespace
+
+Tracer& Tracer::Instance() {
+    static Tracer instance;
+    return instance;
+}
+
+uint64_t Tracer::NowNanos() {
+    static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - traceEpoch).count());
+}
+
+void Tracer::Record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    if (buffer.events.empty()) {
+        buffer.events.resize(TRACE_BUFFER_CAPACITY);
+    }
+
+    buffer.events[buffer.next] = TraceEvent{name, startNs, endNs - startNs};
+    if (++buffer.next == buffer.events.size()) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+std::string Tracer::DumpChromeJSON() const {
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = buffers;
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    auto separator = [&]() {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+    };
+
+    for (const auto& buffer : snapshot) {
+        std::vector<TraceEvent> events;
+        uint32_t tid;
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            tid = buffer->threadId;
+            threadName = buffer->threadName;
+            if (buffer->wrapped) {
+                events.assign(buffer->events.begin() + buffer->next, buffer->events.end());
+            }
+            events.insert(events.end(), buffer->events.begin(),
+                          buffer->events.begin() + buffer->next);
+        }
+
+        std::string tidText = std::to_string(tid);
+
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tidText +
+               ",\"args\":{\"name\":\"";
+        AppendEscaped(out, threadName.empty() ? "thread " + tidText : threadName);
+        out += "\"}}";
+
+        for (const auto& event : events) {
+            separator();
+            out += "{\"name\":\"";
+            AppendEscaped(out, event.name);
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tidText + ",\"ts\":";
+            AppendMicros(out, event.startNs);
+            out += ",\"dur\":";
+            AppendMicros(out, event.durationNs);
+            out += '}';
+        }
+    }
+
+    out += "]}";
+    return out;
+}
+
+bool Tracer::WriteChromeJSON(const std::string& path) const {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << DumpChromeJSON();
+    return static_cast<bool>(file);
+}
+
+void Tracer::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+        [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            return buffer->retired;
+        }), buffers.end());
+}
+
+size_t Tracer::GetEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t count = 0;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->wrapped ? buffer->events.size() : buffer->next;
+    }
+    return count;
+}
+
+Tracer::ThreadBuffer& Tracer::LocalBuffer() {
+    thread_local ThreadBufferHolder holder;
+
+    if (!holder.buffer) {
+        holder.buffer = std::make_shared<ThreadBuffer>();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        holder.buffer->threadId = nextThreadId++;
+        buffers.push_back(holder.buffer);
+    }
+
+    return *holder.buffer;
+}
+
+void Tracer::Retire(const std::shared_ptr<ThreadBuffer>& buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer->retired = true;
+
+    // Keep the spans of recently exited threads, dropping the oldest
+    size_t retiredCount = std::count_if(buffers.begin(), buffers.end(),
+        [](const std::shared_ptr<ThreadBuffer>& b) { return b->retired; });
+
+    for (auto it = buffers.begin(); it != buffers.end() && retiredCount > MAX_RETIRED_BUFFERS;) {
+        if ((*it)->retired) {
+            it = buffers.erase(it);
+            --retiredCount;
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace dinari
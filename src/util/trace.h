@@ -0,0 +1,159 @@
+#ifndef DINARI_UTIL_TRACE_H
+#define DINARI_UTIL_TRACE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dinari {
+
+/**
+ * @brief Scoped hot-path tracing
+ *
+ * TRACE_SCOPE("name") records the lifetime of the enclosing scope as a
+ * span. Spans go into a fixed-size ring buffer owned by the recording
+ * thread, so only the most recent TRACE_BUFFER_CAPACITY spans per thread
+ * are kept. Tracer::DumpChromeJSON() renders them in the Chrome
+ * trace_event format, loadable in chrome://tracing or Perfetto.
+ *
+ * Spans are compiled in only when DINARI_ENABLE_TRACING is defined
+ * (cmake -DENABLE_TRACING=ON); otherwise TRACE_SCOPE expands to nothing.
+ * Span names must be string literals, as only the pointer is stored.
+ */
+
+// Spans kept per thread
+constexpr size_t TRACE_BUFFER_CAPACITY = 8192;
+
+/**
+ * @brief One completed span
+ */
+struct TraceEvent {
+    const char* name;
+    uint64_t startNs;       // Relative to the tracer epoch
+    uint64_t durationNs;
+};
+
+/**
+ * @brief Collects spans from all threads
+ */
+class Tracer {
+public:
+    static Tracer& Instance();
+
+    /**
+     * @brief Whether spans are compiled into this build
+     */
+    static constexpr bool IsCompiledIn() {
+#ifdef DINARI_ENABLE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Nanoseconds since the tracer epoch (monotonic)
+     */
+    static uint64_t NowNanos();
+
+    /**
+     * @brief Record a completed span on the calling thread
+     */
+    void Record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief Name the calling thread in dumped traces
+     */
+    void SetThreadName(const std::string& name);
+
+    /**
+     * @brief Render all buffered spans as Chrome trace_event JSON
+     */
+    std::string DumpChromeJSON() const;
+
+    /**
+     * @brief Write DumpChromeJSON() to a file
+     * @return true if written
+     */
+    bool WriteChromeJSON(const std::string& path) const;
+
+    /**
+     * @brief Discard all buffered spans
+     */
+    void Clear();
+
+    /**
+     * @brief Number of buffered spans across all threads
+     */
+    size_t GetEventCount() const;
+
+private:
+    Tracer() = default;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Per-thread ring of spans
+     *
+     * Written by its owning thread; the mutex is only contended while a
+     * dump is copying the ring out.
+     */
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        size_t next = 0;            // Slot for the next event
+        bool wrapped = false;
+        uint32_t threadId = 0;
+        std::string threadName;
+        bool retired = false;       // Owning thread has exited (guarded by Tracer::mutex)
+    };
+
+    // Exited threads whose spans are still kept for dumping
+    static constexpr size_t MAX_RETIRED_BUFFERS = 64;
+
+    ThreadBuffer& LocalBuffer();
+    void Retire(const std::shared_ptr<ThreadBuffer>& buffer);
+
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t nextThreadId = 1;
+
+    friend struct ThreadBufferHolder;
+};
+
+/**
+ * @brief Records its own lifetime as a span
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* spanName)
+        : name(spanName), startNs(Tracer::NowNanos()) {}
+
+    ~TraceScope() {
+        Tracer::Instance().Record(name, startNs, Tracer::NowNanos());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t startNs;
+};
+
+} // namespace dinari
+
+#define DINARI_TRACE_CONCAT_INNER(a, b) a##b
+#define DINARI_TRACE_CONCAT(a, b) DINARI_TRACE_CONCAT_INNER(a, b)
+
+#ifdef DINARI_ENABLE_TRACING
+#define TRACE_SCOPE(name) \
+    ::dinari::TraceScope DINARI_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#endif
+
+#endif // DINARI_UTIL_TRACE_H
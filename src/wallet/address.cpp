@@ -93,6 +93,7 @@ bool AddressBook::AddAddress(const Address& addr, const AddressMetadata& metadat
     std::lock_guard<std::mutex> lock(mutex);
 
     addresses[addr] = metadata;
+    UpdateOwnedHash(addr);
 
     LOG_DEBUG("AddressBook", "Added address: " + addr.ToString());
 
@@ -117,6 +118,7 @@ bool AddressBook::RemoveAddress(const Address& addr) {
     }
 
     addresses.erase(it);
+    UpdateOwnedHash(addr);
 
     LOG_DEBUG("AddressBook", "Removed address: " + addr.ToString());
 
@@ -172,6 +174,7 @@ bool AddressBook::SetIsMine(const Address& addr, bool isMine) {
     }
 
     it->second.isMine = isMine;
+    UpdateOwnedHash(addr);
     return true;
 }
 
@@ -186,6 +189,40 @@ bool AddressBook::IsMine(const Address& addr) const {
     return it->second.isMine;
 }
 
+bool AddressBook::IsMineHash(const Hash160& hash, AddressType type) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ownedHashes.count(OwnershipKey(hash, type)) > 0;
+}
+
+Address AddressBook::OwnershipKey(const Hash160& hash, AddressType type) {
+    if (type == AddressType::P2PK) {
+        type = AddressType::P2PKH;
+    }
+    return Address(hash, type);
+}
+
+void AddressBook::UpdateOwnedHash(const Address& addr) {
+    Address key = OwnershipKey(addr.GetHash(), addr.GetType());
+
+    // A key hash is owned if either of its address types is mine
+    std::vector<AddressType> types;
+    if (key.GetType() == AddressType::P2SH) {
+        types = {AddressType::P2SH};
+    } else {
+        types = {AddressType::P2PKH, AddressType::P2PK};
+    }
+
+    for (AddressType type : types) {
+        auto it = addresses.find(Address(addr.GetHash(), type));
+        if (it != addresses.end() && it->second.isMine) {
+            ownedHashes.insert(key);
+            return;
+        }
+    }
+
+    ownedHashes.erase(key);
+}
+
 std::vector<Address> AddressBook::GetAllAddresses() const {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -196,6 +233,7 @@ std::vector<Address> AddressBook::GetAllAddresses() const {
         result.push_back(pair.first);
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -210,6 +248,7 @@ std::vector<Address> AddressBook::GetAddressesByType(AddressType type) const {
         }
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -224,9 +263,15 @@ std::vector<Address> AddressBook::GetMyAddresses() const {
         }
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
+std::unordered_set<Address> AddressBook::GetMyHashes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ownedHashes;
+}
+
 std::vector<Address> AddressBook::GetChangeAddresses() const {
     std::lock_guard<std::mutex> lock(mutex);
 
@@ -238,6 +283,7 @@ std::vector<Address> AddressBook::GetChangeAddresses() const {
         }
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -252,6 +298,7 @@ std::vector<Address> AddressBook::GetReceivingAddresses() const {
         }
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -263,6 +310,7 @@ size_t AddressBook::GetAddressCount() const {
 void AddressBook::Clear() {
     std::lock_guard<std::mutex> lock(mutex);
     addresses.clear();
+    ownedHashes.clear();
     LOG_INFO("AddressBook", "Cleared all addresses");
 }
 
@@ -310,6 +358,17 @@ bytes AddressGenerator::GenerateScriptPubKey(const Address& addr) {
 }
 
 bool AddressGenerator::ExtractAddress(const bytes& scriptPubKey, Address& addr) {
+    Hash160 hash;
+    AddressType type;
+    if (!ExtractScriptHash(scriptPubKey, hash, type)) {
+        return false;
+    }
+
+    addr = Address(hash, type);
+    return true;
+}
+
+bool AddressGenerator::ExtractScriptHash(const bytes& scriptPubKey, Hash160& hash, AddressType& type) {
     if (scriptPubKey.empty()) {
         return false;
     }
@@ -322,10 +381,8 @@ bool AddressGenerator::ExtractAddress(const bytes& scriptPubKey, Address& addr)
         scriptPubKey[23] == static_cast<byte>(OpCode::OP_EQUALVERIFY) &&
         scriptPubKey[24] == static_cast<byte>(OpCode::OP_CHECKSIG)) {
 
-        Hash160 hash;
         std::copy(scriptPubKey.begin() + 3, scriptPubKey.begin() + 23, hash.begin());
-
-        addr = Address(hash, AddressType::P2PKH);
+        type = AddressType::P2PKH;
         return true;
     }
 
@@ -335,10 +392,8 @@ bool AddressGenerator::ExtractAddress(const bytes& scriptPubKey, Address& addr)
         scriptPubKey[1] == 20 &&
         scriptPubKey[22] == static_cast<byte>(OpCode::OP_EQUAL)) {
 
-        Hash160 hash;
         std::copy(scriptPubKey.begin() + 2, scriptPubKey.begin() + 22, hash.begin());
-
-        addr = Address(hash, AddressType::P2SH);
+        type = AddressType::P2SH;
         return true;
     }
 
@@ -348,10 +403,8 @@ bool AddressGenerator::ExtractAddress(const bytes& scriptPubKey, Address& addr)
         if (pubKeyLen == scriptPubKey.size() - 2 &&
             scriptPubKey[scriptPubKey.size() - 1] == static_cast<byte>(OpCode::OP_CHECKSIG)) {
 
-            bytes pubKey(scriptPubKey.begin() + 1, scriptPubKey.end() - 1);
-            Hash160 hash = crypto::Hash::ComputeHash160(pubKey);
-
-            addr = Address(hash, AddressType::P2PK);
+            hash = crypto::Hash::ComputeHash160(scriptPubKey.data() + 1, pubKeyLen);
+            type = AddressType::P2PK;
             return true;
         }
     }
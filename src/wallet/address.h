@@ -7,6 +7,8 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 
 namespace dinari {
@@ -110,10 +112,25 @@ private:
     AddressType type;
 };
 
+} // namespace dinari
+
+namespace std {
+    template<>
+    struct hash<dinari::Address> {
+        size_t operator()(const dinari::Address& addr) const noexcept {
+            return std::hash<dinari::Hash160>{}(addr.GetHash()) ^
+                   static_cast<size_t>(addr.GetType());
+        }
+    };
+}
+
+namespace dinari {
+
 /**
  * @brief Address book manager
  *
- * Manages address metadata, labels, and lookups
+ * Manages address metadata, labels, and lookups. Owned addresses are also
+ * indexed by hash so scripts can be matched without building an Address.
  */
 class AddressBook {
 public:
@@ -165,6 +182,22 @@ public:
      */
     bool IsMine(const Address& addr) const;
 
+    /**
+     * @brief Check if a key or script hash belongs to an owned address
+     *
+     * Lookup is by (type, hash) via OwnershipKey, so a P2PK output is found
+     * through the P2PKH address of the same key but a P2SH output is not.
+     */
+    bool IsMineHash(const Hash160& hash, AddressType type) const;
+
+    /**
+     * @brief Index key for an owned script hash
+     *
+     * P2PK folds into P2PKH since both pay to a key hash. P2SH stays
+     * separate: a script hash equal to one of our key hashes is not ours.
+     */
+    static Address OwnershipKey(const Hash160& hash, AddressType type);
+
     /**
      * @brief Get all addresses
      */
@@ -180,6 +213,11 @@ public:
      */
     std::vector<Address> GetMyAddresses() const;
 
+    /**
+     * @brief Get owned (type, hash) keys, as built by OwnershipKey
+     */
+    std::unordered_set<Address> GetMyHashes() const;
+
     /**
      * @brief Get change addresses
      */
@@ -201,8 +239,11 @@ public:
     void Clear();
 
 private:
-    std::map<Address, AddressMetadata> addresses;
+    std::unordered_map<Address, AddressMetadata> addresses;
+    std::unordered_set<Address> ownedHashes;  // Keyed by OwnershipKey
     mutable std::mutex mutex;
+
+    void UpdateOwnedHash(const Address& addr);
 };
 
 /**
@@ -236,6 +277,14 @@ public:
      * @brief Extract address from script pub key
      */
     static bool ExtractAddress(const bytes& scriptPubKey, Address& addr);
+
+    /**
+     * @brief Extract the key or script hash of a standard script pub key
+     *
+     * Reads the hash straight from the script bytes; only P2PK needs a
+     * hash computation.
+     */
+    static bool ExtractScriptHash(const bytes& scriptPubKey, Hash160& hash, AddressType& type);
 };
 
 } // namespace dinari
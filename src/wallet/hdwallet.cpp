@@ -173,16 +173,20 @@ bool HDWallet::DeriveChildPrivate(const ExtendedKey& parent, uint32_t index, Ext
     bytes IR(hmac.begin() + 32, hmac.end());
 
     // Child private key = (IL + parent_private_key) mod n
-    // For simplicity, we'll use a basic addition (proper implementation needs secp256k1 arithmetic)
-    // This is a simplified version - production code should use proper elliptic curve math
-    bytes childKey = parent.key;
-    uint32_t carry = 0;
-    for (int i = 31; i >= 0; --i) {
-        uint32_t sum = childKey[i] + IL[i] + carry;
-        childKey[i] = sum & 0xFF;
-        carry = sum >> 8;
+    Hash256 tweak;
+    std::copy(IL.begin(), IL.end(), tweak.begin());
+    if (!crypto::ECDSA::IsValidPrivateKey(tweak)) {
+        return false;  // IL >= n, caller moves on to the next index
     }
 
+    Hash256 parentKey;
+    std::copy(parent.key.begin(), parent.key.begin() + 32, parentKey.begin());
+    Hash256 childPriv = crypto::ECDSA::PrivKeyAdd(parentKey, tweak);
+    if (!crypto::ECDSA::IsValidPrivateKey(childPriv)) {
+        return false;
+    }
+    bytes childKey(childPriv.begin(), childPriv.end());
+
     child.version = parent.version;
     child.depth = parent.depth + 1;
     child.fingerprint = GetFingerprint(parent);
@@ -223,15 +227,26 @@ bool HDWallet::DeriveChildPublic(const ExtendedKey& parent, uint32_t index, Exte
     bytes IR(hmac.begin() + 32, hmac.end());
 
     // Child public key = point(IL) + parent_public_key
-    // This requires elliptic curve point addition - simplified here
-    // Production code should use proper EC math
+    Hash256 tweak;
+    std::copy(IL.begin(), IL.end(), tweak.begin());
+    if (!crypto::ECDSA::IsValidPrivateKey(tweak)) {
+        return false;  // IL >= n, caller moves on to the next index
+    }
+
+    bytes childKey;
+    try {
+        childKey = crypto::ECDSA::PubKeyAdd(parent.key, tweak);
+    } catch (const std::exception&) {
+        LOG_ERROR("HDWallet", "Invalid parent public key");
+        return false;
+    }
 
     child.version = parent.version;
     child.depth = parent.depth + 1;
     child.fingerprint = GetFingerprint(parent);
     child.childNumber = index;
     child.chainCode = IR;
-    child.key = parent.key;  // Simplified - should be proper EC point addition
+    child.key = childKey;
 
     return true;
 }
@@ -3,6 +3,7 @@
 #include "util/logger.h"
 #include "util/security.h"
 #include <algorithm>
+#include <chrono>
 #include <openssl/rand.h>
 
 namespace dinari {
@@ -82,6 +83,18 @@ std::set<Hash160> BasicKeyStore::GetKeys() const {
     return keySet;
 }
 
+bool BasicKeyStore::GetKeyMetadata(const Hash160& keyID, KeyMetadata& metadata) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = keys.find(keyID);
+    if (it == keys.end()) {
+        return false;
+    }
+
+    metadata = it->second.metadata;
+    return true;
+}
+
 size_t BasicKeyStore::GetKeyCount() const {
     std::lock_guard<std::mutex> lock(mutex);
     return keys.size();
@@ -99,16 +112,64 @@ Hash160 BasicKeyStore::GetKeyID(const bytes& pubKey) const {
 
 // CryptoKeyStore implementation
 
+namespace {
+
+constexpr size_t MASTER_KEY_SIZE = 32;
+constexpr size_t MASTER_KEY_CHECKSUM_SIZE = 4;
+
+// Passphrase stretching: aim for this much work per unlock, never less
+// than the minimum iteration count
+constexpr int64_t KDF_TARGET_MS = 100;
+constexpr uint32_t KDF_MIN_ITERATIONS = 25000;
+constexpr uint32_t KDF_CALIBRATION_ITERATIONS = 5000;
+
+Hash256 ToAESKey(const byte* key) {
+    Hash256 keyArray;
+    std::copy(key, key + 32, keyArray.begin());
+    return keyArray;
+}
+
+bytes EncryptWithKey(const bytes& plaintext, const Hash256& key) {
+    bytes iv = Security::SecureRandomBytes(16);
+    if (iv.size() != 16) {
+        LOG_ERROR("KeyStore", "Failed to generate secure random IV");
+        return bytes();
+    }
+
+    bytes ciphertext = crypto::AES::Encrypt(plaintext, key, iv);
+    if (ciphertext.empty()) {
+        return bytes();
+    }
+
+    // Prepend IV
+    bytes result;
+    result.reserve(iv.size() + ciphertext.size());
+    result.insert(result.end(), iv.begin(), iv.end());
+    result.insert(result.end(), ciphertext.begin(), ciphertext.end());
+    return result;
+}
+
+bytes DecryptWithKey(const bytes& encrypted, const Hash256& key) {
+    if (encrypted.size() < 16) {
+        return bytes();
+    }
+
+    bytes iv(encrypted.begin(), encrypted.begin() + 16);
+    bytes ciphertext(encrypted.begin() + 16, encrypted.end());
+    return crypto::AES::Decrypt(ciphertext, key, iv);
+}
+
+} // anonymous namespace
+
 CryptoKeyStore::CryptoKeyStore()
     : encrypted(false)
-    , unlocked(false) {
+    , unlocked(false)
+    , secretPool(sizeof(Hash256)) {
 }
 
 CryptoKeyStore::~CryptoKeyStore() {
-    // Clear sensitive data
-    if (!masterKey.empty()) {
-        std::fill(masterKey.begin(), masterKey.end(), 0);
-    }
+    // LockedBuffer and LockedSlotPool wipe themselves
+    decryptedKeys.clear();
 }
 
 bool CryptoKeyStore::EncryptWallet(const std::string& passphrase) {
@@ -124,33 +185,48 @@ bool CryptoKeyStore::EncryptWallet(const std::string& passphrase) {
 
     std::lock_guard<std::mutex> lock(mutex);
 
-    // Generate cryptographically secure random salt using OpenSSL
-    masterKeySalt = Security::SecureRandomBytes(32);
-    if (masterKeySalt.empty() || masterKeySalt.size() != 32) {
-        LOG_ERROR("KeyStore", "Failed to generate secure random salt");
+    // Generate a random master key and wrap it with the passphrase
+    auto newMasterKey = std::make_unique<LockedBuffer>(MASTER_KEY_SIZE);
+    bytes random = Security::SecureRandomBytes(MASTER_KEY_SIZE);
+    if (random.size() != MASTER_KEY_SIZE) {
+        LOG_ERROR("KeyStore", "Failed to generate master key");
+        return false;
+    }
+    std::copy(random.begin(), random.end(), newMasterKey->data());
+    Security::SecureWipe(random.data(), random.size());
+
+    MasterKey wrapped;
+    if (!WrapMasterKey(passphrase, newMasterKey->data(), wrapped)) {
         return false;
     }
 
-    // Derive master key
-    masterKey = DeriveMasterKey(passphrase, masterKeySalt);
+    masterKey = std::move(newMasterKey);
 
-    // Encrypt all existing keys
+    // Encrypt all existing keys; the plaintext moves into the locked cache
+    std::map<Hash160, bytes> newEncryptedKeys;
     for (const auto& pair : keys) {
         bytes encryptedKey = EncryptKey(pair.second.privKey);
         if (encryptedKey.empty()) {
             LOG_ERROR("KeyStore", "Failed to encrypt key");
-            masterKey.clear();
-            masterKeySalt.clear();
+            masterKey.reset();
             return false;
         }
 
-        encryptedKeys[pair.first] = encryptedKey;
+        newEncryptedKeys[pair.first] = encryptedKey;
     }
 
+    for (auto& pair : keys) {
+        CacheKey(pair.first, pair.second.privKey);
+        Security::SecureWipe(pair.second.privKey.data(), pair.second.privKey.size());
+    }
+
+    encryptedKeys = std::move(newEncryptedKeys);
+    wrappedMasterKey = wrapped;
     encrypted = true;
     unlocked = true;
 
-    LOG_INFO("KeyStore", "Wallet encrypted with " + std::to_string(keys.size()) + " keys");
+    LOG_INFO("KeyStore", "Wallet encrypted with " + std::to_string(keys.size()) + " keys (" +
+             std::to_string(wrapped.iterations) + " KDF iterations)");
 
     return true;
 }
@@ -162,13 +238,8 @@ void CryptoKeyStore::Lock() {
 
     std::lock_guard<std::mutex> lock(mutex);
 
-    // Clear master key
-    std::fill(masterKey.begin(), masterKey.end(), 0);
-    masterKey.clear();
-
-    // Clear unencrypted keys
-    keys.clear();
-
+    masterKey.reset();
+    ClearCache();
     unlocked = false;
 
     LOG_INFO("KeyStore", "Wallet locked");
@@ -180,45 +251,23 @@ bool CryptoKeyStore::Unlock(const std::string& passphrase) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(mutex);
+
     if (unlocked) {
         return true;
     }
 
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // Derive master key from passphrase
-    bytes derivedKey = DeriveMasterKey(passphrase, masterKeySalt);
-
-    // Try to decrypt keys
-    std::map<Hash160, Key> decryptedKeys;
-
-    for (const auto& pair : encryptedKeys) {
-        Hash256 privKey;
-
-        // Temporarily set master key for decryption
-        masterKey = derivedKey;
-
-        if (!DecryptKey(pair.second, privKey)) {
-            // Wrong passphrase
-            std::fill(derivedKey.begin(), derivedKey.end(), 0);
-            std::fill(masterKey.begin(), masterKey.end(), 0);
-            masterKey.clear();
-            LOG_ERROR("KeyStore", "Failed to unlock wallet: incorrect passphrase");
-            return false;
-        }
-
-        bytes pubKey = crypto::ECDSA::GetPublicKey(privKey, true);
-        Key key(privKey, pubKey);
-
-        decryptedKeys[pair.first] = key;
+    // Only the master key is unwrapped here; keys are decrypted on first use
+    auto key = UnwrapMasterKey(passphrase, wrappedMasterKey);
+    if (!key) {
+        LOG_ERROR("KeyStore", "Failed to unlock wallet: incorrect passphrase");
+        return false;
     }
 
-    // Success - store decrypted keys
-    keys = decryptedKeys;
-    masterKey = derivedKey;
+    masterKey = std::move(key);
     unlocked = true;
 
-    LOG_INFO("KeyStore", "Wallet unlocked with " + std::to_string(keys.size()) + " keys");
+    LOG_INFO("KeyStore", "Wallet unlocked");
 
     return true;
 }
@@ -234,43 +283,21 @@ bool CryptoKeyStore::ChangePassphrase(const std::string& oldPassphrase, const st
         return false;
     }
 
-    // Unlock with old passphrase
-    if (!Unlock(oldPassphrase)) {
-        return false;
-    }
-
     std::lock_guard<std::mutex> lock(mutex);
 
-    // Generate new cryptographically secure random salt using OpenSSL
-    masterKeySalt = Security::SecureRandomBytes(32);
-    if (masterKeySalt.empty() || masterKeySalt.size() != 32) {
-        LOG_ERROR("KeyStore", "Failed to generate secure random salt");
+    auto key = UnwrapMasterKey(oldPassphrase, wrappedMasterKey);
+    if (!key) {
+        LOG_ERROR("KeyStore", "Failed to change passphrase: incorrect passphrase");
         return false;
     }
 
-    // Derive new master key
-    bytes oldMasterKey = masterKey;
-    masterKey = DeriveMasterKey(newPassphrase, masterKeySalt);
-
-    // Re-encrypt all keys with new master key
-    std::map<Hash160, bytes> newEncryptedKeys;
-
-    for (const auto& pair : keys) {
-        bytes encryptedKey = EncryptKey(pair.second.privKey);
-        if (encryptedKey.empty()) {
-            LOG_ERROR("KeyStore", "Failed to re-encrypt key");
-            // Restore old master key
-            masterKey = oldMasterKey;
-            return false;
-        }
-
-        newEncryptedKeys[pair.first] = encryptedKey;
+    // Re-wrap the same master key; per-key ciphertexts stay valid
+    MasterKey wrapped;
+    if (!WrapMasterKey(newPassphrase, key->data(), wrapped)) {
+        return false;
     }
 
-    // Clear old master key
-    std::fill(oldMasterKey.begin(), oldMasterKey.end(), 0);
-
-    encryptedKeys = newEncryptedKeys;
+    wrappedMasterKey = wrapped;
 
     LOG_INFO("KeyStore", "Passphrase changed successfully");
 
@@ -278,27 +305,31 @@ bool CryptoKeyStore::ChangePassphrase(const std::string& oldPassphrase, const st
 }
 
 bool CryptoKeyStore::AddKey(const Key& key) {
-    if (encrypted && !unlocked) {
-        LOG_ERROR("KeyStore", "Wallet is locked");
-        return false;
+    if (!encrypted) {
+        return BasicKeyStore::AddKey(key);
     }
 
     std::lock_guard<std::mutex> lock(mutex);
 
-    Hash160 keyID = GetKeyID(key.pubKey);
+    if (!unlocked) {
+        LOG_ERROR("KeyStore", "Wallet is locked");
+        return false;
+    }
 
-    if (encrypted) {
-        // Encrypt and store
-        bytes encryptedKey = EncryptKey(key.privKey);
-        if (encryptedKey.empty()) {
-            return false;
-        }
+    Hash160 keyID = GetKeyID(key.pubKey);
 
-        encryptedKeys[keyID] = encryptedKey;
+    bytes encryptedKey = EncryptKey(key.privKey);
+    if (encryptedKey.empty()) {
+        return false;
     }
 
-    // Store unencrypted for use
-    keys[keyID] = key;
+    encryptedKeys[keyID] = encryptedKey;
+    CacheKey(keyID, key.privKey);
+
+    // Public part only; the secret lives in encryptedKeys and the cache
+    Key publicKey = key;
+    publicKey.privKey.fill(0);
+    keys[keyID] = publicKey;
 
     LOG_DEBUG("KeyStore", "Added key: " + crypto::Hash::ToHex(keyID));
 
@@ -306,12 +337,38 @@ bool CryptoKeyStore::AddKey(const Key& key) {
 }
 
 bool CryptoKeyStore::GetKey(const Hash160& keyID, Key& key) const {
-    if (encrypted && !unlocked) {
+    if (!encrypted) {
+        return BasicKeyStore::GetKey(keyID, key);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!unlocked) {
         LOG_ERROR("KeyStore", "Wallet is locked");
         return false;
     }
 
-    return BasicKeyStore::GetKey(keyID, key);
+    auto it = keys.find(keyID);
+    if (it == keys.end()) {
+        return false;
+    }
+
+    key = it->second;
+
+    auto cached = decryptedKeys.find(keyID);
+    if (cached != decryptedKeys.end()) {
+        std::copy(cached->second, cached->second + key.privKey.size(), key.privKey.begin());
+        return true;
+    }
+
+    auto enc = encryptedKeys.find(keyID);
+    if (enc == encryptedKeys.end() || !DecryptKey(enc->second, key.privKey)) {
+        LOG_ERROR("KeyStore", "Failed to decrypt key: " + crypto::Hash::ToHex(keyID));
+        return false;
+    }
+
+    CacheKey(keyID, key.privKey);
+    return true;
 }
 
 std::map<Hash160, bytes> CryptoKeyStore::GetEncryptedKeys() const {
@@ -319,93 +376,172 @@ std::map<Hash160, bytes> CryptoKeyStore::GetEncryptedKeys() const {
     return encryptedKeys;
 }
 
-bool CryptoKeyStore::AddEncryptedKey(const Hash160& keyID, const bytes& encryptedKey, const KeyMetadata& metadata) {
+bool CryptoKeyStore::GetEncryptedKey(const Hash160& keyID, bytes& encryptedKey) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = encryptedKeys.find(keyID);
+    if (it == encryptedKeys.end()) {
+        return false;
+    }
+
+    encryptedKey = it->second;
+    return true;
+}
+
+bytes CryptoKeyStore::EncryptSecret(const Hash256& secret) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return EncryptKey(secret);
+}
+
+bool CryptoKeyStore::DecryptSecret(const bytes& encryptedSecret, Hash256& secret) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return DecryptKey(encryptedSecret, secret);
+}
+
+bool CryptoKeyStore::AddEncryptedKey(const Hash160& keyID, const bytes& pubKey,
+                                     const bytes& encryptedKey, const KeyMetadata& metadata) {
     std::lock_guard<std::mutex> lock(mutex);
 
     encryptedKeys[keyID] = encryptedKey;
+    keys[keyID] = Key(Hash256{}, pubKey, metadata);
     encrypted = true;
 
-    // If unlocked, decrypt and add to keys
-    if (unlocked) {
-        Hash256 privKey;
-        if (DecryptKey(encryptedKey, privKey)) {
-            bytes pubKey = crypto::ECDSA::GetPublicKey(privKey, true);
-            Key key(privKey, pubKey, metadata);
-            keys[keyID] = key;
-        }
-    }
-
     return true;
 }
 
-bytes CryptoKeyStore::DeriveMasterKey(const std::string& passphrase, const bytes& salt) const {
-    // Use PBKDF2 with 100,000 iterations
+CryptoKeyStore::MasterKey CryptoKeyStore::GetMasterKey() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return wrappedMasterKey;
+}
+
+void CryptoKeyStore::SetMasterKey(const MasterKey& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    wrappedMasterKey = key;
+    encrypted = true;
+}
+
+bytes CryptoKeyStore::DeriveWrappingKey(const std::string& passphrase, const bytes& salt,
+                                        uint32_t iterations) {
     bytes passphraseBytes(passphrase.begin(), passphrase.end());
-    return crypto::Hash::PBKDF2_SHA512(passphraseBytes, salt, 100000, 32);
+    bytes derived = crypto::Hash::PBKDF2_SHA512(passphraseBytes, salt,
+                                                static_cast<int>(iterations), 32);
+    Security::SecureWipe(passphraseBytes.data(), passphraseBytes.size());
+    return derived;
 }
 
-bytes CryptoKeyStore::EncryptKey(const Hash256& privKey) const {
-    if (masterKey.empty()) {
-        return bytes();
+uint32_t CryptoKeyStore::CalibrateIterations() {
+    bytes salt(32, 0);
+    auto start = std::chrono::steady_clock::now();
+    DeriveWrappingKey("calibration", salt, KDF_CALIBRATION_ITERATIONS);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (elapsed <= 0) {
+        return KDF_MIN_ITERATIONS;
     }
 
-    // Convert Hash256 to bytes
-    bytes plaintext(privKey.begin(), privKey.end());
+    uint64_t iterations = static_cast<uint64_t>(KDF_CALIBRATION_ITERATIONS) *
+                          KDF_TARGET_MS * 1000 / static_cast<uint64_t>(elapsed);
+    iterations = std::min<uint64_t>(iterations, UINT32_MAX);
+    return std::max(KDF_MIN_ITERATIONS, static_cast<uint32_t>(iterations));
+}
 
-    // Generate cryptographically secure random IV using OpenSSL
-    bytes iv = Security::SecureRandomBytes(16);
-    if (iv.empty() || iv.size() != 16) {
-        LOG_ERROR("KeyStore", "Failed to generate secure random IV");
-        return bytes();
+bool CryptoKeyStore::WrapMasterKey(const std::string& passphrase, const byte* key, MasterKey& wrapped) {
+    wrapped.salt = Security::SecureRandomBytes(32);
+    if (wrapped.salt.size() != 32) {
+        LOG_ERROR("KeyStore", "Failed to generate secure random salt");
+        return false;
     }
+    wrapped.iterations = CalibrateIterations();
 
-    // Convert masterKey bytes to Hash256
-    Hash256 keyArray;
-    std::copy(masterKey.begin(), masterKey.begin() + 32, keyArray.begin());
+    // Master key followed by a short checksum to detect a wrong passphrase
+    bytes plaintext(key, key + MASTER_KEY_SIZE);
+    Hash256 check = crypto::Hash::DoubleSHA256(key, MASTER_KEY_SIZE);
+    plaintext.insert(plaintext.end(), check.begin(), check.begin() + MASTER_KEY_CHECKSUM_SIZE);
 
-    // Encrypt
-    bytes ciphertext = crypto::AES::Encrypt(plaintext, keyArray, iv);
-    if (ciphertext.empty()) {
-        return bytes();
+    bytes wrappingKey = DeriveWrappingKey(passphrase, wrapped.salt, wrapped.iterations);
+    wrapped.encryptedKey = EncryptWithKey(plaintext, ToAESKey(wrappingKey.data()));
+
+    Security::SecureWipe(plaintext.data(), plaintext.size());
+    Security::SecureWipe(wrappingKey.data(), wrappingKey.size());
+
+    if (wrapped.encryptedKey.empty()) {
+        LOG_ERROR("KeyStore", "Failed to encrypt master key");
+        return false;
     }
 
-    // Prepend IV
-    bytes result;
-    result.reserve(iv.size() + ciphertext.size());
-    result.insert(result.end(), iv.begin(), iv.end());
-    result.insert(result.end(), ciphertext.begin(), ciphertext.end());
+    return true;
+}
 
-    return result;
+std::unique_ptr<LockedBuffer> CryptoKeyStore::UnwrapMasterKey(const std::string& passphrase,
+                                                              const MasterKey& wrapped) {
+    if (wrapped.encryptedKey.empty() || wrapped.iterations == 0) {
+        return nullptr;
+    }
+
+    bytes wrappingKey = DeriveWrappingKey(passphrase, wrapped.salt, wrapped.iterations);
+    bytes plaintext = DecryptWithKey(wrapped.encryptedKey, ToAESKey(wrappingKey.data()));
+    Security::SecureWipe(wrappingKey.data(), wrappingKey.size());
+
+    std::unique_ptr<LockedBuffer> key;
+    if (plaintext.size() == MASTER_KEY_SIZE + MASTER_KEY_CHECKSUM_SIZE) {
+        Hash256 check = crypto::Hash::DoubleSHA256(plaintext.data(), MASTER_KEY_SIZE);
+        if (std::equal(check.begin(), check.begin() + MASTER_KEY_CHECKSUM_SIZE,
+                       plaintext.begin() + MASTER_KEY_SIZE)) {
+            key = std::make_unique<LockedBuffer>(MASTER_KEY_SIZE);
+            std::copy(plaintext.begin(), plaintext.begin() + MASTER_KEY_SIZE, key->data());
+        }
+    }
+
+    Security::SecureWipe(plaintext.data(), plaintext.size());
+    return key;
 }
 
-bool CryptoKeyStore::DecryptKey(const bytes& encrypted, Hash256& privKey) const {
-    if (masterKey.empty() || encrypted.size() < 16) {
-        return false;
+bytes CryptoKeyStore::EncryptKey(const Hash256& privKey) const {
+    if (!masterKey) {
+        return bytes();
     }
 
-    // Extract IV
-    bytes iv(encrypted.begin(), encrypted.begin() + 16);
+    bytes plaintext(privKey.begin(), privKey.end());
+    Hash256 keyArray = ToAESKey(masterKey->data());
+    bytes result = EncryptWithKey(plaintext, keyArray);
 
-    // Extract ciphertext
-    bytes ciphertext(encrypted.begin() + 16, encrypted.end());
+    Security::SecureWipe(plaintext.data(), plaintext.size());
+    Security::SecureWipe(keyArray.data(), keyArray.size());
 
-    // Convert masterKey bytes to Hash256
-    Hash256 keyArray;
-    std::copy(masterKey.begin(), masterKey.begin() + 32, keyArray.begin());
+    return result;
+}
 
-    // Decrypt
-    bytes plaintext = crypto::AES::Decrypt(ciphertext, keyArray, iv);
-    if (plaintext.size() != 32) {
+bool CryptoKeyStore::DecryptKey(const bytes& encrypted, Hash256& privKey) const {
+    if (!masterKey) {
         return false;
     }
 
-    // Convert to Hash256
-    std::copy(plaintext.begin(), plaintext.end(), privKey.begin());
+    Hash256 keyArray = ToAESKey(masterKey->data());
+    bytes plaintext = DecryptWithKey(encrypted, keyArray);
+    Security::SecureWipe(keyArray.data(), keyArray.size());
+
+    bool ok = plaintext.size() == privKey.size();
+    if (ok) {
+        std::copy(plaintext.begin(), plaintext.end(), privKey.begin());
+    }
 
     // Clear plaintext
-    std::fill(plaintext.begin(), plaintext.end(), 0);
+    Security::SecureWipe(plaintext.data(), plaintext.size());
 
-    return true;
+    return ok;
+}
+
+void CryptoKeyStore::CacheKey(const Hash160& keyID, const Hash256& privKey) const {
+    auto it = decryptedKeys.find(keyID);
+    byte* slot = it != decryptedKeys.end() ? it->second : secretPool.Allocate();
+    std::copy(privKey.begin(), privKey.end(), slot);
+    decryptedKeys[keyID] = slot;
+}
+
+void CryptoKeyStore::ClearCache() {
+    decryptedKeys.clear();
+    secretPool.Clear();
 }
 
 } // namespace dinari
@@ -4,10 +4,13 @@
 #include "dinari/types.h"
 #include "crypto/hash.h"
 #include "crypto/ecdsa.h"
+#include "util/security.h"
 #include <map>
 #include <set>
 #include <mutex>
 #include <optional>
+#include <memory>
+#include <unordered_map>
 
 namespace dinari {
 
@@ -104,6 +107,11 @@ public:
     bool GetPubKey(const Hash160& keyID, bytes& pubKey) const override;
     std::set<Hash160> GetKeys() const override;
 
+    /**
+     * @brief Get key metadata
+     */
+    bool GetKeyMetadata(const Hash160& keyID, KeyMetadata& metadata) const;
+
     /**
      * @brief Get key count
      */
@@ -124,11 +132,25 @@ protected:
 /**
  * @brief Encrypted key store
  *
- * Stores keys encrypted with a master key derived from passphrase.
- * Uses AES-256-CBC encryption.
+ * Keys are encrypted with AES-256-CBC under a random master key. The
+ * master key is itself wrapped with a key derived from the passphrase, so
+ * changing the passphrase only re-wraps the master key. Unlocking unwraps
+ * the master key; individual keys are decrypted on first use into a
+ * locked-memory cache that is wiped on Lock().
  */
 class CryptoKeyStore : public BasicKeyStore {
 public:
+    /**
+     * @brief Passphrase-wrapped master key, as stored on disk
+     */
+    struct MasterKey {
+        bytes encryptedKey;     // IV + ciphertext of master key and checksum
+        bytes salt;
+        uint32_t iterations;    // PBKDF2 iterations
+
+        MasterKey() : iterations(0) {}
+    };
+
     CryptoKeyStore();
     virtual ~CryptoKeyStore();
 
@@ -138,7 +160,7 @@ public:
     bool EncryptWallet(const std::string& passphrase);
 
     /**
-     * @brief Lock wallet (clear master key from memory)
+     * @brief Lock wallet (clear master key and decrypted keys from memory)
      */
     void Lock();
 
@@ -148,7 +170,7 @@ public:
     bool Unlock(const std::string& passphrase);
 
     /**
-     * @brief Change passphrase
+     * @brief Change passphrase (re-wraps the master key only)
      */
     bool ChangePassphrase(const std::string& oldPassphrase, const std::string& newPassphrase);
 
@@ -171,38 +193,71 @@ public:
      */
     std::map<Hash160, bytes> GetEncryptedKeys() const;
 
+    /**
+     * @brief Get a single encrypted key
+     */
+    bool GetEncryptedKey(const Hash160& keyID, bytes& encryptedKey) const;
+
+    /**
+     * @brief Encrypt a secret with the master key (requires unlocked wallet)
+     */
+    bytes EncryptSecret(const Hash256& secret) const;
+
+    /**
+     * @brief Decrypt a secret produced by EncryptSecret
+     */
+    bool DecryptSecret(const bytes& encryptedSecret, Hash256& secret) const;
+
     /**
      * @brief Add encrypted key (for deserialization)
      */
-    bool AddEncryptedKey(const Hash160& keyID, const bytes& encryptedKey, const KeyMetadata& metadata);
+    bool AddEncryptedKey(const Hash160& keyID, const bytes& pubKey,
+                         const bytes& encryptedKey, const KeyMetadata& metadata);
 
     /**
-     * @brief Get master key salt
+     * @brief Get wrapped master key for serialization
      */
-    const bytes& GetMasterKeySalt() const { return masterKeySalt; }
+    MasterKey GetMasterKey() const;
 
     /**
-     * @brief Set master key salt (for deserialization)
+     * @brief Set wrapped master key (for deserialization)
      */
-    void SetMasterKeySalt(const bytes& salt) { masterKeySalt = salt; }
+    void SetMasterKey(const MasterKey& key);
 
 private:
     bool encrypted;
     bool unlocked;
 
-    // Master key for encryption (derived from passphrase)
-    bytes masterKey;
-    bytes masterKeySalt;
+    // Unwrapped master key, only while unlocked
+    std::unique_ptr<LockedBuffer> masterKey;
+    MasterKey wrappedMasterKey;
 
-    // Encrypted private keys
+    // Encrypted private keys; public keys and metadata stay in keys
     std::map<Hash160, bytes> encryptedKeys;
 
-    // Derive master key from passphrase
-    bytes DeriveMasterKey(const std::string& passphrase, const bytes& salt) const;
+    // Keys decrypted since the last unlock
+    mutable LockedSlotPool secretPool;
+    mutable std::unordered_map<Hash160, byte*> decryptedKeys;
+
+    // Derive the wrapping key from passphrase
+    static bytes DeriveWrappingKey(const std::string& passphrase, const bytes& salt,
+                                   uint32_t iterations);
+
+    // PBKDF2 iterations that take about the target time on this machine
+    static uint32_t CalibrateIterations();
+
+    // Wrap and unwrap the master key
+    static bool WrapMasterKey(const std::string& passphrase, const byte* key, MasterKey& wrapped);
+    static std::unique_ptr<LockedBuffer> UnwrapMasterKey(const std::string& passphrase,
+                                                         const MasterKey& wrapped);
 
     // Encrypt/decrypt key
     bytes EncryptKey(const Hash256& privKey) const;
     bool DecryptKey(const bytes& encrypted, Hash256& privKey) const;
+
+    // Remember a decrypted key until Lock()
+    void CacheKey(const Hash160& keyID, const Hash256& privKey) const;
+    void ClearCache();
 };
 
 } // namespace dinari
@@ -2,12 +2,40 @@
 #include "util/logger.h"
 #include "util/time.h"
 #include "util/serialize.h"
+#include "util/security.h"
 #include "core/script.h"
+#include "blockchain/blockchain.h"
 #include <fstream>
 #include <algorithm>
+#include <limits>
 
 namespace dinari {
 
+namespace {
+
+// Spent wallet outputs are kept this many blocks so a reorg can restore them
+constexpr BlockHeight SPENT_OUTPUT_KEEP_DEPTH = 100;
+
+// Lookahead keys derived per keypool lock release
+constexpr size_t KEYPOOL_BATCH_SIZE = 64;
+
+// Minimum inputs per signing thread, so small transactions sign inline
+constexpr size_t SIGN_INPUTS_PER_THREAD = 16;
+
+// Fee rate (sat/byte) used when no estimate is available
+constexpr Amount DEFAULT_FEE_RATE = 10;
+
+// Match a standard scriptPubKey (P2PKH, P2SH or P2PK) against a set of
+// wallet (type, hash) keys built by AddressBook::OwnershipKey
+bool ScriptMatchesKeyHashes(const bytes& script, const std::unordered_set<Address>& keyHashes) {
+    Hash160 hash;
+    AddressType type;
+    return AddressGenerator::ExtractScriptHash(script, hash, type) &&
+           keyHashes.count(AddressBook::OwnershipKey(hash, type)) > 0;
+}
+
+} // namespace
+
 // WalletTransactionBuilder implementation
 
 WalletTransactionBuilder::WalletTransactionBuilder()
@@ -59,7 +87,7 @@ bool WalletTransactionBuilder::Build(Transaction& tx, Amount& fee) {
         return false;
     }
 
-    // Estimate transaction size
+    // Estimate transaction size without a change output
     size_t estimatedSize = EstimateTransactionSize();
     fee = EstimateFee(estimatedSize);
 
@@ -89,8 +117,12 @@ bool WalletTransactionBuilder::Build(Transaction& tx, Amount& fee) {
     // Add outputs
     tx.outputs = outputs;
 
-    // Add change output if significant
-    if (change >= DUST_THRESHOLD && changeAddress.IsValid()) {
+    // Add change output only if it is still above dust after paying for itself
+    Amount changeOutputFee = EstimateFee(34);
+    if (change >= DUST_THRESHOLD + changeOutputFee && changeAddress.IsValid()) {
+        change -= changeOutputFee;
+        fee += changeOutputFee;
+
         TxOut changeOut;
         changeOut.value = change;
         changeOut.scriptPubKey = AddressGenerator::GenerateScriptPubKey(changeAddress);
@@ -108,50 +140,114 @@ bool WalletTransactionBuilder::Build(Transaction& tx, Amount& fee) {
 }
 
 bool WalletTransactionBuilder::Sign(Transaction& tx, const KeyStore& keystore) {
-    for (size_t i = 0; i < tx.inputs.size(); ++i) {
-        if (i >= inputs.size()) {
-            LOG_ERROR("TxBuilder", "Input index out of range");
-            return false;
-        }
+    size_t numInputs = tx.inputs.size();
+    if (numInputs > inputs.size()) {
+        LOG_ERROR("TxBuilder", "Input index out of range");
+        return false;
+    }
 
-        const TxOut& prevOut = inputs[i].prevOut;
+    // Map each input to a key slot, one slot per distinct key
+    std::unordered_map<Hash160, size_t> keySlots;
+    std::vector<Hash160> slotKeyIDs;
+    std::vector<size_t> inputSlots(numInputs);
 
-        // Extract address from scriptPubKey
-        Address addr;
-        if (!AddressGenerator::ExtractAddress(prevOut.scriptPubKey, addr)) {
+    for (size_t i = 0; i < numInputs; ++i) {
+        Hash160 keyID;
+        AddressType type;
+        if (!AddressGenerator::ExtractScriptHash(inputs[i].prevOut.scriptPubKey, keyID, type)) {
             LOG_ERROR("TxBuilder", "Failed to extract address from scriptPubKey");
             return false;
         }
 
-        // Get key for address
-        Hash160 keyID = addr.GetHash();
+        auto inserted = keySlots.emplace(keyID, slotKeyIDs.size());
+        if (inserted.second) {
+            slotKeyIDs.push_back(keyID);
+        }
+        inputSlots[i] = inserted.first->second;
+    }
+
+    // Fetch every key once for the whole session; secrets stay in locked memory
+    LockedBuffer secrets(slotKeyIDs.size() * sizeof(Hash256));
+    std::vector<bytes> pubKeys(slotKeyIDs.size());
+
+    for (size_t slot = 0; slot < slotKeyIDs.size(); ++slot) {
         Key key;
-        if (!keystore.GetKey(keyID, key)) {
-            LOG_ERROR("TxBuilder", "Key not found for address: " + addr.ToString());
+        if (!keystore.GetKey(slotKeyIDs[slot], key)) {
+            LOG_ERROR("TxBuilder", "Key not found for address: " + Address(slotKeyIDs[slot]).ToString());
             return false;
         }
 
-        // Create signature
-        Hash256 sighash = tx.GetSignatureHash(i, prevOut.scriptPubKey);
-        bytes signature = crypto::ECDSA::Sign(sighash, key.privKey);
+        std::copy(key.privKey.begin(), key.privKey.end(), secrets.data() + slot * sizeof(Hash256));
+        Security::SecureWipe(key.privKey.data(), key.privKey.size());
+        pubKeys[slot] = std::move(key.pubKey);
+    }
+
+    PrecomputedSignatureHash sighashes(tx);
 
-        if (signature.empty()) {
-            LOG_ERROR("TxBuilder", "Failed to sign input " + std::to_string(i));
-            return false;
+    std::vector<bytes> scriptSigs(numInputs);
+    std::atomic<size_t> nextInput(0);
+    std::atomic<bool> failed(false);
+
+    auto signInputs = [&]() {
+        Hash256 privKey;
+
+        for (size_t i = nextInput++; i < numInputs && !failed.load(); i = nextInput++) {
+            const byte* secret = secrets.data() + inputSlots[i] * sizeof(Hash256);
+            std::copy(secret, secret + sizeof(Hash256), privKey.begin());
+
+            // Create signature
+            Hash256 sighash = sighashes.GetSignatureHash(i, inputs[i].prevOut.scriptPubKey);
+            bytes signature;
+            try {
+                signature = crypto::ECDSA::Sign(sighash, privKey);
+            } catch (const std::exception&) {
+                signature.clear();
+            }
+
+            if (signature.empty()) {
+                LOG_ERROR("TxBuilder", "Failed to sign input " + std::to_string(i));
+                failed = true;
+                break;
+            }
+
+            // Add SIGHASH_ALL flag
+            signature.push_back(0x01);
+
+            // Build scriptSig for P2PKH
+            const bytes& pubKey = pubKeys[inputSlots[i]];
+            bytes& scriptSig = scriptSigs[i];
+            scriptSig.reserve(2 + signature.size() + pubKey.size());
+            scriptSig.push_back(static_cast<byte>(signature.size()));
+            scriptSig.insert(scriptSig.end(), signature.begin(), signature.end());
+            scriptSig.push_back(static_cast<byte>(pubKey.size()));
+            scriptSig.insert(scriptSig.end(), pubKey.begin(), pubKey.end());
         }
 
-        // Add SIGHASH_ALL flag
-        signature.push_back(0x01);
+        Security::SecureWipe(privKey.data(), privKey.size());
+    };
+
+    // Inputs are handed out one at a time; the calling thread signs too
+    size_t numThreads = std::min<size_t>(
+        std::max<size_t>(1, std::thread::hardware_concurrency()),
+        (numInputs + SIGN_INPUTS_PER_THREAD - 1) / SIGN_INPUTS_PER_THREAD);
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < numThreads; ++t) {
+        workers.emplace_back(signInputs);
+    }
+    signInputs();
+    for (auto& worker : workers) {
+        worker.join();
+    }
 
-        // Build scriptSig for P2PKH
-        bytes scriptSig;
-        scriptSig.push_back(static_cast<byte>(signature.size()));
-        scriptSig.insert(scriptSig.end(), signature.begin(), signature.end());
-        scriptSig.push_back(static_cast<byte>(key.pubKey.size()));
-        scriptSig.insert(scriptSig.end(), key.pubKey.begin(), key.pubKey.end());
+    if (failed.load()) {
+        return false;
+    }
 
-        tx.inputs[i].scriptSig = scriptSig;
+    for (size_t i = 0; i < numInputs; ++i) {
+        tx.inputs[i].scriptSig = std::move(scriptSigs[i]);
     }
+    tx.hashCached = false;
 
     LOG_INFO("TxBuilder", "Transaction signed");
 
@@ -174,7 +270,6 @@ size_t WalletTransactionBuilder::EstimateTransactionSize() const {
     size_t size = 4 + 1 + 1 + 4;  // Version + in count + out count + locktime
     size += inputs.size() * 148;
     size += outputs.size() * 34;
-    size += 34;  // Change output
 
     return size;
 }
@@ -192,10 +287,19 @@ void WalletTransactionBuilder::Clear() {
 Wallet::Wallet(const WalletConfig& cfg)
     : config(cfg)
     , keystore(std::make_unique<CryptoKeyStore>())
+    , walletDB(std::make_unique<WalletDB>())
     , nextReceivingIndex(0)
     , nextChangeIndex(0)
+    , keyPoolGeneration(0)
+    , keyPoolRunning(false)
+    , confirmedBalance(0)
+    , unconfirmedBalance(0)
+    , immatureBalance(0)
+    , chainHeight(0)
+    , nextTxSequence(0)
     , unlockUntil(0)
-    , autoLockRunning(false) {
+    , autoLockRunning(false)
+    , schedulerRunning(false) {
 }
 
 Wallet::~Wallet() {
@@ -205,6 +309,9 @@ Wallet::~Wallet() {
         autoLockThread.join();
     }
 
+    StopScheduler();
+    StopKeyPool();
+
     Save();
 }
 
@@ -255,7 +362,7 @@ std::vector<std::string> Wallet::GenerateNewMnemonic(size_t words) {
 }
 
 bool Wallet::ImportSeed(const bytes& seed) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::mutex> lock(mutex);
 
     if (!hdWallet) {
         hdWallet = std::make_unique<HDWallet>();
@@ -272,13 +379,28 @@ bool Wallet::ImportSeed(const bytes& seed) {
         return false;
     }
 
-    // Generate initial keypool
-    for (size_t i = 0; i < config.keyPoolSize; ++i) {
-        Address addr;
-        ExtendedKey key;
-        DeriveNextAddress(false, addr, key);
+    accountPubKey = HDWallet::GetPublicKey(accountKey);
+    cryptedAccountKey.clear();
+
+    if (keystore->IsEncrypted()) {
+        cryptedAccountKey = keystore->EncryptSecret(HDWallet::GetPrivateKey(accountKey));
+        if (cryptedAccountKey.empty()) {
+            LOG_ERROR("Wallet", "Failed to encrypt account key");
+            return false;
+        }
+    }
+
+    if (!SetupHDChains()) {
+        return false;
     }
 
+    WriteHDChainRecord();
+
+    // Fill the lookahead window now so an immediate rescan can see it
+    TopUpKeyPool(false, lock);
+    TopUpKeyPool(true, lock);
+    StartKeyPool();
+
     LOG_INFO("Wallet", "HD wallet initialized with BIP44 account " +
              std::to_string(config.hdAccount));
 
@@ -308,6 +430,11 @@ bool Wallet::ImportPrivateKey(const Hash256& privKey, const std::string& label)
 
     addressBook.AddAddress(addr, addrMetadata);
 
+    walletDB->TxnBegin();
+    WriteKeyRecord(Key(privKey, pubKey, metadata));
+    walletDB->WriteAddress(addr, addrMetadata);
+    walletDB->TxnCommit();
+
     LOG_INFO("Wallet", "Imported private key: " + addr.ToString());
 
     return true;
@@ -317,9 +444,11 @@ Address Wallet::GetNewAddress(const std::string& label) {
     std::lock_guard<std::mutex> lock(mutex);
 
     Address addr;
-    ExtendedKey key;
 
-    if (!DeriveNextAddress(false, addr, key)) {
+    walletDB->TxnBegin();
+
+    if (!DeriveNextAddress(false, addr)) {
+        walletDB->TxnCommit(false);
         LOG_ERROR("Wallet", "Failed to generate new address");
         return Address();
     }
@@ -327,8 +456,15 @@ Address Wallet::GetNewAddress(const std::string& label) {
     // Set label if provided
     if (!label.empty()) {
         addressBook.SetLabel(addr, label);
+
+        AddressMetadata metadata;
+        if (addressBook.GetMetadata(addr, metadata)) {
+            walletDB->WriteAddress(addr, metadata);
+        }
     }
 
+    walletDB->TxnCommit(false);
+
     LOG_INFO("Wallet", "Generated new address: " + addr.ToString());
 
     return addr;
@@ -338,9 +474,8 @@ Address Wallet::GetNewChangeAddress() {
     std::lock_guard<std::mutex> lock(mutex);
 
     Address addr;
-    ExtendedKey key;
 
-    if (!DeriveNextAddress(true, addr, key)) {
+    if (!DeriveNextAddress(true, addr)) {
         LOG_ERROR("Wallet", "Failed to generate new change address");
         return Address();
     }
@@ -369,7 +504,14 @@ bool Wallet::EncryptWallet(const std::string& passphrase) {
         return false;
     }
 
-    Save();
+    if (accountKey.IsPrivate()) {
+        cryptedAccountKey = keystore->EncryptSecret(HDWallet::GetPrivateKey(accountKey));
+    }
+
+    if (!RewriteKeyRecords()) {
+        LOG_ERROR("Wallet", "Failed to write encrypted keys");
+        return false;
+    }
 
     LOG_INFO("Wallet", "Wallet encrypted");
 
@@ -378,6 +520,17 @@ bool Wallet::EncryptWallet(const std::string& passphrase) {
 
 void Wallet::Lock() {
     keystore->Lock();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Only the encrypted copy of the account key survives while locked
+        if (!cryptedAccountKey.empty() && accountKey.IsPrivate()) {
+            std::fill(accountKey.key.begin(), accountKey.key.end(), 0);
+            accountKey.key.clear();
+        }
+    }
+
     LOG_INFO("Wallet", "Wallet locked");
 }
 
@@ -387,6 +540,11 @@ bool Wallet::Unlock(const std::string& passphrase) {
         return false;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        RestoreAccountKey();
+    }
+
     // Cancel any existing auto-lock
     unlockUntil = 0;
 
@@ -401,6 +559,11 @@ bool Wallet::UnlockWithTimeout(const std::string& passphrase, uint32_t timeoutSe
         return false;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        RestoreAccountKey();
+    }
+
     if (timeoutSeconds > 0) {
         unlockUntil = Time::GetCurrentTime() + timeoutSeconds;
 
@@ -452,11 +615,15 @@ bool Wallet::IsEncrypted() const {
 bool Wallet::ChangePassphrase(const std::string& oldPassphrase, const std::string& newPassphrase) {
     std::lock_guard<std::mutex> lock(mutex);
 
+    // Only the master key is re-wrapped; key and account key ciphertexts are unchanged
     if (!keystore->ChangePassphrase(oldPassphrase, newPassphrase)) {
         return false;
     }
 
-    Save();
+    if (!walletDB->WriteMasterKey(keystore->GetMasterKey())) {
+        LOG_ERROR("Wallet", "Failed to write master key");
+        return false;
+    }
 
     LOG_INFO("Wallet", "Passphrase changed");
 
@@ -465,40 +632,27 @@ bool Wallet::ChangePassphrase(const std::string& oldPassphrase, const std::strin
 
 Amount Wallet::GetBalance() const {
     std::lock_guard<std::mutex> lock(mutex);
-
-    Amount balance = 0;
-
-    for (const auto& pair : walletUTXOs) {
-        balance += pair.second.value;
-    }
-
-    return balance;
+    return confirmedBalance + unconfirmedBalance + immatureBalance;
 }
 
 Amount Wallet::GetUnconfirmedBalance() const {
-    // Note: Unconfirmed transaction tracking requires mempool integration
-    return 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    return unconfirmedBalance;
 }
 
 Amount Wallet::GetAvailableBalance() const {
     std::lock_guard<std::mutex> lock(mutex);
+    return confirmedBalance;
+}
 
-    Amount balance = 0;
-
-    for (const auto& pair : walletUTXOs) {
-        // Check if mature (for coinbase outputs)
-        const OutPoint& outpoint = pair.first;
-        auto heightIt = utxoHeights.find(outpoint);
-
-        if (heightIt != utxoHeights.end()) {
-            // Note: Coinbase maturity check (100 blocks) should be added for production
-            balance += pair.second.value;
-        } else {
-            balance += pair.second.value;
-        }
-    }
+Amount Wallet::GetImmatureBalance() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return immatureBalance;
+}
 
-    return balance;
+void Wallet::SetChainHeight(BlockHeight height) {
+    std::lock_guard<std::mutex> lock(mutex);
+    SetChainHeightInternal(height);
 }
 
 bool Wallet::CreateTransaction(const std::map<Address, Amount>& recipients,
@@ -521,7 +675,7 @@ bool Wallet::CreateTransaction(const std::map<Address, Amount>& recipients,
     std::vector<std::pair<OutPoint, TxOut>> selectedCoins;
     Amount selectedValue;
 
-    if (!SelectCoins(totalOutput, feeRate, selectedCoins, selectedValue)) {
+    if (!SelectCoins(totalOutput, feeRate, recipients.size(), selectedCoins, selectedValue)) {
         LOG_ERROR("Wallet", "Insufficient funds");
         return false;
     }
@@ -541,7 +695,11 @@ bool Wallet::CreateTransaction(const std::map<Address, Amount>& recipients,
     }
 
     // Set change address
-    Address changeAddr = GetNewChangeAddress();
+    Address changeAddr;
+    if (!DeriveNextAddress(true, changeAddr)) {
+        LOG_ERROR("Wallet", "Failed to generate change address");
+        return false;
+    }
     builder.SetChangeAddress(changeAddr);
 
     // Build
@@ -559,11 +717,255 @@ bool Wallet::CreateTransaction(const std::map<Address, Amount>& recipients,
 bool Wallet::SendTransaction(const std::map<Address, Amount>& recipients,
                              Amount feeRate,
                              Transaction& tx) {
+    // Keep concurrent sends from selecting the same coins
+    std::lock_guard<std::mutex> sendLock(sendMutex);
+
     if (!CreateTransaction(recipients, feeRate, tx)) {
         return false;
     }
 
-    return SignTransaction(tx);
+    if (!SignTransaction(tx)) {
+        return false;
+    }
+
+    CommitTransaction(tx);
+
+    return true;
+}
+
+void Wallet::CommitTransaction(const Transaction& tx) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Spend the inputs and credit change right away, unconfirmed
+    walletDB->TxnBegin();
+    ProcessTransactionInternal(tx, 0);
+    walletDB->TxnCommit();
+}
+
+void Wallet::RelayTransaction(const Transaction& tx) {
+    BroadcastCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        callback = broadcastCallback;
+    }
+
+    if (callback) {
+        callback(tx);
+    } else {
+        LOG_WARNING("Wallet", "No broadcast callback set, transaction not relayed");
+    }
+}
+
+void Wallet::SetBroadcastCallback(BroadcastCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    broadcastCallback = std::move(callback);
+}
+
+void Wallet::SetFeeRateCallback(FeeRateCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    feeRateCallback = std::move(callback);
+}
+
+Amount Wallet::GetFeeRateEstimate() const {
+    FeeRateCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        callback = feeRateCallback;
+    }
+
+    if (!callback) {
+        return DEFAULT_FEE_RATE;
+    }
+
+    // Never go below the minimum relay fee
+    return std::max<Amount>(callback(), MIN_RELAY_TX_FEE / 1000);
+}
+
+bool Wallet::QueuePayment(const Address& addr, Amount amount) {
+    if (!addr.IsValid() || amount == 0 || amount > MAX_MONEY) {
+        LOG_ERROR("Wallet", "Invalid queued payment");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Amount& queued = queuedPayments[addr];
+    if (queued + amount > MAX_MONEY) {
+        LOG_ERROR("Wallet", "Queued payment total out of range");
+        return false;
+    }
+    queued += amount;
+
+    LOG_DEBUG("Wallet", "Queued payment of " + std::to_string(amount) + " satoshis");
+
+    return true;
+}
+
+size_t Wallet::GetQueuedPaymentCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedPayments.size();
+}
+
+bool Wallet::FlushPayments(Transaction& tx) {
+    std::map<Address, Amount> payments;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queuedPayments.empty() || IsLocked()) {
+            return false;
+        }
+        payments.swap(queuedPayments);
+    }
+
+    if (!SendTransaction(payments, GetFeeRateEstimate(), tx)) {
+        // Put the payments back, merging with any queued meanwhile
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& payment : payments) {
+            queuedPayments[payment.first] += payment.second;
+        }
+        LOG_ERROR("Wallet", "Failed to send batched payout of " +
+                  std::to_string(payments.size()) + " payments");
+        return false;
+    }
+
+    RelayTransaction(tx);
+
+    LOG_INFO("Wallet", "Sent batched payout to " + std::to_string(payments.size()) +
+             " recipients: " + crypto::Hash::ToHex(tx.GetHash()));
+
+    return true;
+}
+
+bool Wallet::ConsolidateCoins(Amount feeRate, Transaction& tx) {
+    std::lock_guard<std::mutex> sendLock(sendMutex);
+
+    WalletTransactionBuilder builder;
+    builder.SetFeeRate(feeRate);
+
+    Amount total = 0;
+    size_t numInputs = 0;
+    Address destination;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (IsLocked()) {
+            LOG_ERROR("Wallet", "Wallet is locked");
+            return false;
+        }
+
+        // Smallest first, skipping coins that cost more to spend than they hold
+        std::vector<CoinSelector::Candidate> candidates;
+        candidates.reserve(walletUTXOs.size());
+        for (const auto& pair : walletUTXOs) {
+            if (IsImmatureCoinbase(pair.first, utxoHeights[pair.first])) {
+                continue;
+            }
+            CoinSelector::Candidate candidate = CoinSelector::MakeCandidate(pair.first, pair.second, feeRate * 1000);
+            if (candidate.effectiveValue > 0) {
+                candidates.push_back(std::move(candidate));
+            }
+        }
+
+        size_t count = std::min(candidates.size(), config.consolidateMaxInputs);
+        if (count < 2) {
+            return false;
+        }
+
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                          [](const CoinSelector::Candidate& a, const CoinSelector::Candidate& b) {
+                              return a.value < b.value;
+                          });
+
+        for (size_t i = 0; i < count; ++i) {
+            builder.AddInput(candidates[i].outpoint, walletUTXOs[candidates[i].outpoint]);
+            total += candidates[i].value;
+        }
+        numInputs = count;
+
+        if (!DeriveNextAddress(true, destination)) {
+            LOG_ERROR("Wallet", "Failed to generate consolidation address");
+            return false;
+        }
+    }
+
+    // One output, no change: the builder's size estimate gives the exact fee
+    Amount fee = CoinSelector::EstimateTransactionSize(numInputs, 1) * feeRate;
+    if (total < fee + DUST_THRESHOLD) {
+        return false;
+    }
+    builder.AddOutput(destination, total - fee);
+
+    if (!builder.Build(tx, fee) || !SignTransaction(tx)) {
+        LOG_ERROR("Wallet", "Failed to create consolidation transaction");
+        return false;
+    }
+
+    CommitTransaction(tx);
+    RelayTransaction(tx);
+
+    LOG_INFO("Wallet", "Consolidated " + std::to_string(numInputs) + " UTXOs: " +
+             crypto::Hash::ToHex(tx.GetHash()));
+
+    return true;
+}
+
+void Wallet::StartScheduler() {
+    if (schedulerRunning.load()) {
+        return;
+    }
+
+    schedulerRunning = true;
+    schedulerThread = std::thread(&Wallet::SchedulerThreadFunc, this);
+}
+
+void Wallet::StopScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        schedulerRunning = false;
+    }
+    schedulerCondition.notify_all();
+
+    if (schedulerThread.joinable()) {
+        schedulerThread.join();
+    }
+}
+
+void Wallet::SchedulerThreadFunc() {
+    LOG_DEBUG("Wallet", "Scheduler thread started");
+
+    auto interval = std::chrono::seconds(std::max<uint32_t>(1, config.payoutInterval));
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (schedulerRunning.load()) {
+        schedulerCondition.wait_for(lock, interval, [this] { return !schedulerRunning.load(); });
+
+        if (!schedulerRunning.load()) {
+            break;
+        }
+
+        bool havePayments = !queuedPayments.empty();
+        bool consolidate = config.consolidateMinUTXOs > 0 &&
+                           walletUTXOs.size() > config.consolidateMinUTXOs;
+
+        lock.unlock();
+
+        Transaction tx;
+        if (havePayments) {
+            FlushPayments(tx);
+        }
+
+        if (consolidate) {
+            Amount feeRate = GetFeeRateEstimate();
+            if (feeRate <= config.consolidateMaxFeeRate) {
+                Transaction consolidation;
+                ConsolidateCoins(feeRate, consolidation);
+            }
+        }
+
+        lock.lock();
+    }
+
+    LOG_DEBUG("Wallet", "Scheduler thread stopped");
 }
 
 bool Wallet::SignTransaction(Transaction& tx) {
@@ -587,6 +989,12 @@ bool Wallet::SignTransaction(Transaction& tx) {
             return false;
         }
 
+        // HD keys are only held as public keys until they sign
+        Address prevAddr;
+        if (AddressGenerator::ExtractAddress(it->second.scriptPubKey, prevAddr)) {
+            EnsureSigningKey(prevAddr.GetHash());
+        }
+
         builder.AddInput(txin.prevOut, it->second);
     }
 
@@ -624,10 +1032,7 @@ std::vector<std::pair<OutPoint, TxOut>> Wallet::GetUTXOs() const {
 bool Wallet::AddUTXO(const OutPoint& outpoint, const TxOut& txout, BlockHeight height) {
     std::lock_guard<std::mutex> lock(mutex);
 
-    walletUTXOs[outpoint] = txout;
-    utxoHeights[outpoint] = height;
-
-    LOG_DEBUG("Wallet", "Added UTXO: " + std::to_string(txout.value) + " satoshis");
+    AddUTXOInternal(outpoint, txout, height);
 
     return true;
 }
@@ -635,8 +1040,7 @@ bool Wallet::AddUTXO(const OutPoint& outpoint, const TxOut& txout, BlockHeight h
 bool Wallet::RemoveUTXO(const OutPoint& outpoint) {
     std::lock_guard<std::mutex> lock(mutex);
 
-    walletUTXOs.erase(outpoint);
-    utxoHeights.erase(outpoint);
+    RemoveUTXOInternal(outpoint);
 
     return true;
 }
@@ -644,169 +1048,1088 @@ bool Wallet::RemoveUTXO(const OutPoint& outpoint) {
 bool Wallet::ProcessTransaction(const Transaction& tx, BlockHeight height) {
     std::lock_guard<std::mutex> lock(mutex);
 
-    // Check outputs for payments to our addresses
-    for (size_t i = 0; i < tx.outputs.size(); ++i) {
-        const TxOut& txout = tx.outputs[i];
+    walletDB->TxnBegin();
+    bool relevant = ProcessTransactionInternal(tx, height);
+    walletDB->TxnCommit();
 
-        Address addr;
-        if (AddressGenerator::ExtractAddress(txout.scriptPubKey, addr) && IsMine(addr)) {
-            OutPoint outpoint;
-            outpoint.txHash = tx.GetHash();
-            outpoint.index = static_cast<uint32_t>(i);
+    return relevant;
+}
 
-            AddUTXO(outpoint, txout, height);
+void Wallet::BlockConnected(const Block& block, BlockHeight height) {
+    std::lock_guard<std::mutex> lock(mutex);
 
-            LOG_INFO("Wallet", "Received " + std::to_string(txout.value) +
-                     " satoshis to " + addr.ToString());
-        }
-    }
+    SetChainHeightInternal(height);
 
-    // Remove spent outputs
-    for (const TxIn& txin : tx.inputs) {
-        if (walletUTXOs.count(txin.prevOut) > 0) {
-            RemoveUTXO(txin.prevOut);
+    // All changes from one block land in a single batch
+    walletDB->TxnBegin();
 
-            LOG_INFO("Wallet", "Spent UTXO");
-        }
+    for (const auto& tx : block.transactions) {
+        ProcessTransactionInternal(*tx, height);
     }
 
-    // Add to transaction history
-    transactions.push_back(tx);
+    // Forget spends that are too deep to be reorganized away. Unconfirmed
+    // spends (spentHeight 0) stay until they confirm or are abandoned.
+    for (auto it = spentUTXOs.begin(); it != spentUTXOs.end();) {
+        if (it->second.spentHeight > 0 &&
+            it->second.spentHeight + SPENT_OUTPUT_KEEP_DEPTH < height) {
+            walletDB->EraseSpentOutput(it->first);
+            it = spentUTXOs.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    return true;
+    walletDB->TxnCommit();
 }
 
-std::vector<Transaction> Wallet::GetTransactions() const {
+void Wallet::BlockDisconnected(const Block& block, BlockHeight height) {
     std::lock_guard<std::mutex> lock(mutex);
-    return transactions;
-}
 
-bool Wallet::Save() {
-    std::lock_guard<std::mutex> lock(mutex);
+    walletDB->TxnBegin();
 
-    std::string filepath = GetWalletFilePath();
-    return SaveToFile(filepath);
-}
+    // Undo transactions in reverse order
+    for (auto txIt = block.transactions.rbegin(); txIt != block.transactions.rend(); ++txIt) {
+        const Transaction& tx = **txIt;
+        Hash256 txHash = tx.GetHash();
 
-bool Wallet::Load() {
-    std::lock_guard<std::mutex> lock(mutex);
+        if (!EraseWalletTx(txHash)) {
+            continue;
+        }
 
-    std::string filepath = GetWalletFilePath();
-    return LoadFromFile(filepath);
-}
+        // Remove outputs created by this transaction
+        for (size_t i = 0; i < tx.outputs.size(); ++i) {
+            RemoveUTXOInternal(OutPoint(txHash, static_cast<TxOutIndex>(i)));
+        }
 
-Wallet::WalletInfo Wallet::GetInfo() const {
-    std::lock_guard<std::mutex> lock(mutex);
+        // Restore outputs it spent
+        if (!tx.IsCoinbase()) {
+            for (const TxIn& txin : tx.inputs) {
+                auto spentIt = spentUTXOs.find(txin.prevOut);
+                if (spentIt != spentUTXOs.end()) {
+                    AddUTXOInternal(txin.prevOut, spentIt->second.txout, spentIt->second.height);
+                    walletDB->EraseSpentOutput(txin.prevOut);
+                    spentUTXOs.erase(spentIt);
+                }
+            }
+        }
 
-    WalletInfo info;
-    info.keyCount = keystore->GetKeyCount();
-    info.addressCount = addressBook.GetAddressCount();
-    info.utxoCount = walletUTXOs.size();
-    info.balance = GetBalance();
-    info.encrypted = keystore->IsEncrypted();
-    info.locked = keystore->IsLocked();
-    info.hdEnabled = (hdWallet != nullptr);
+        walletDB->EraseTx(txHash);
+        coinbaseTxHashes.erase(txHash);
+    }
 
-    return info;
-}
+    walletDB->TxnCommit();
 
-// Private helper methods
+    if (height > 0) {
+        SetChainHeightInternal(height - 1);
+    }
 
-bool Wallet::DeriveNextAddress(bool isChange, Address& addr, ExtendedKey& key) {
-    if (!hdWallet) {
-        LOG_ERROR("Wallet", "HD wallet not initialized");
+    LOG_DEBUG("Wallet", "Disconnected block at height " + std::to_string(height));
+}
+
+std::optional<size_t> Wallet::RescanBlockchain(const Blockchain& chain, BlockHeight startHeight,
+                                               size_t numThreads) {
+    BlockHeight tipHeight = chain.GetHeight();
+    if (startHeight > tipHeight) {
+        return 0;
+    }
+
+    // Pruned (or snapshot-loaded) heights have no bodies to scan
+    BlockHeight pruneHeight = chain.GetPruneHeight();
+    if (startHeight < pruneHeight) {
+        LOG_ERROR("Wallet", "Rescan from height " + std::to_string(startHeight) +
+                  " refused: block data below height " + std::to_string(pruneHeight) +
+                  " has been pruned");
+        return std::nullopt;
+    }
+
+    // Snapshot wallet key hashes for the output pre-filter
+    std::unordered_set<Address> keyHashes = addressBook.GetMyHashes();
+    {
+        // Lookahead keys catch payments to addresses not issued here yet
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& pair : keyPoolLookup) {
+            keyHashes.insert(AddressBook::OwnershipKey(pair.first, AddressType::P2PKH));
+        }
+    }
+
+    if (keyHashes.empty()) {
+        return 0;
+    }
+
+    size_t totalBlocks = static_cast<size_t>(tipHeight - startHeight) + 1;
+    if (numThreads == 0) {
+        numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, totalBlocks);
+
+    LOG_INFO("Wallet", "Rescanning blocks " + std::to_string(startHeight) + "-" +
+             std::to_string(tipHeight) + " with " + std::to_string(numThreads) + " threads");
+
+    const BlockStore& store = chain.GetBlockStore();
+    auto readBlock = [&chain, &store](BlockHeight height) -> std::optional<Block> {
+        if (store.IsOpen()) {
+            return store.ReadBlock(height);
+        }
+        SharedPtr<Block> block = chain.GetBlockAtHeight(height);
+        if (!block) {
+            return std::nullopt;
+        }
+        return *block;
+    };
+
+    struct RescanHit {
+        BlockHeight height;
+        size_t position;
+        TransactionRef tx;
+    };
+
+    // Set if a block vanishes mid-scan, e.g. pruned after the check above
+    std::atomic<bool> incomplete(false);
+
+    // Run a per-transaction filter over [fromHeight, tipHeight], sharded by height range
+    auto scan = [&](BlockHeight fromHeight, const auto& isRelevant) {
+        size_t blockCount = static_cast<size_t>(tipHeight - fromHeight) + 1;
+        size_t shards = std::min(numThreads, blockCount);
+        std::vector<std::vector<RescanHit>> shardHits(shards);
+        std::vector<std::thread> workers;
+
+        for (size_t t = 0; t < shards; ++t) {
+            BlockHeight first = fromHeight + static_cast<BlockHeight>(t * blockCount / shards);
+            BlockHeight last = fromHeight + static_cast<BlockHeight>((t + 1) * blockCount / shards);
+
+            workers.emplace_back([&, t, first, last]() {
+                for (BlockHeight h = first; h < last; ++h) {
+                    auto block = readBlock(h);
+                    if (!block) {
+                        LOG_ERROR("Wallet", "Rescan: block " + std::to_string(h) + " unavailable");
+                        incomplete = true;
+                        continue;
+                    }
+                    for (size_t i = 0; i < block->transactions.size(); ++i) {
+                        if (isRelevant(*block->transactions[i])) {
+                            shardHits[t].push_back({h, i, block->transactions[i]});
+                        }
+                    }
+                }
+            });
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        std::vector<RescanHit> hits;
+        for (auto& shard : shardHits) {
+            std::move(shard.begin(), shard.end(), std::back_inserter(hits));
+        }
+        return hits;
+    };
+
+    // Pass 1: transactions paying to wallet keys
+    std::vector<RescanHit> hits = scan(startHeight, [&keyHashes](const Transaction& tx) {
+        for (const TxOut& txout : tx.outputs) {
+            if (ScriptMatchesKeyHashes(txout.scriptPubKey, keyHashes)) {
+                return true;
+            }
+        }
         return false;
+    });
+
+    // Pass 2: transactions spending wallet outputs (found or already known)
+    std::unordered_set<OutPoint> watched;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& pair : walletUTXOs) {
+            watched.insert(pair.first);
+        }
+    }
+
+    BlockHeight spendScanStart = tipHeight + 1;
+    if (!watched.empty()) {
+        spendScanStart = startHeight;
+    }
+    std::unordered_set<Hash256> creditTxs;
+    for (const auto& hit : hits) {
+        Hash256 txHash = hit.tx->GetHash();
+        creditTxs.insert(txHash);
+        for (size_t i = 0; i < hit.tx->outputs.size(); ++i) {
+            watched.insert(OutPoint(txHash, static_cast<TxOutIndex>(i)));
+        }
+        spendScanStart = std::min(spendScanStart, hit.height);
+    }
+
+    if (spendScanStart <= tipHeight) {
+        std::vector<RescanHit> spends = scan(spendScanStart, [&](const Transaction& tx) {
+            if (tx.IsCoinbase() || creditTxs.count(tx.GetHash()) > 0) {
+                return false;
+            }
+            for (const TxIn& txin : tx.inputs) {
+                if (watched.count(txin.prevOut) > 0) {
+                    return true;
+                }
+            }
+            return false;
+        });
+        std::move(spends.begin(), spends.end(), std::back_inserter(hits));
     }
 
-    uint32_t& index = isChange ? nextChangeIndex : nextReceivingIndex;
+    if (incomplete) {
+        LOG_ERROR("Wallet", "Rescan aborted: block data missing");
+        return std::nullopt;
+    }
+
+    // Apply in chain order
+    std::sort(hits.begin(), hits.end(), [](const RescanHit& a, const RescanHit& b) {
+        return a.height != b.height ? a.height < b.height : a.position < b.position;
+    });
+
+    size_t found = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SetChainHeightInternal(std::max(chainHeight, tipHeight));
+        walletDB->TxnBegin();
+        for (const auto& hit : hits) {
+            if (ProcessTransactionInternal(*hit.tx, hit.height)) {
+                found++;
+            }
+        }
+        walletDB->TxnCommit();
+    }
+
+    LOG_INFO("Wallet", "Rescan complete: " + std::to_string(found) + " wallet transactions");
 
-    // Derive address key
-    if (!BIP44::DeriveAddress(accountKey, isChange ? 1 : 0, index, key)) {
+    return found;
+}
+
+std::vector<Wallet::WalletTx> Wallet::ListTransactions(size_t count, size_t skip,
+                                                       BlockHeight sinceHeight,
+                                                       const Hash256* after) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<WalletTx> result;
+
+    // Walk the order index backwards from the cursor (or the newest entry)
+    auto it = txOrder.end();
+    if (after) {
+        auto cursor = walletTxs.find(*after);
+        if (cursor == walletTxs.end()) {
+            return result;
+        }
+        it = txOrder.find(GetTxOrderKey(cursor->second));
+    }
+
+    while (it != txOrder.begin() && result.size() < count) {
+        --it;
+        if (it->first.first < sinceHeight) {
+            break;
+        }
+        if (skip > 0) {
+            --skip;
+            continue;
+        }
+        result.push_back(walletTxs.at(it->second));
+    }
+
+    return result;
+}
+
+bool Wallet::GetWalletTransaction(const Hash256& txHash, WalletTx& wtx) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = walletTxs.find(txHash);
+    if (it == walletTxs.end()) {
+        return false;
+    }
+
+    wtx = it->second;
+    return true;
+}
+
+size_t Wallet::GetTransactionCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return walletTxs.size();
+}
+
+Wallet::TxOrderKey Wallet::GetTxOrderKey(const WalletTx& wtx) {
+    // Unconfirmed transactions sort after every block
+    BlockHeight height = wtx.height == 0 ? std::numeric_limits<BlockHeight>::max() : wtx.height;
+    return {height, wtx.sequence};
+}
+
+void Wallet::AddWalletTx(const Transaction& tx, BlockHeight height, uint64_t sequence) {
+    Hash256 txHash = tx.GetHash();
+
+    WalletTx& wtx = walletTxs[txHash];
+    wtx.tx = tx;
+    wtx.height = height;
+    wtx.sequence = sequence;
+    txOrder[GetTxOrderKey(wtx)] = txHash;
+
+    nextTxSequence = std::max(nextTxSequence, sequence + 1);
+}
+
+void Wallet::SetWalletTxHeight(const Hash256& txHash, BlockHeight height) {
+    auto it = walletTxs.find(txHash);
+    if (it == walletTxs.end() || it->second.height == height) {
+        return;
+    }
+
+    txOrder.erase(GetTxOrderKey(it->second));
+    it->second.height = height;
+    txOrder[GetTxOrderKey(it->second)] = txHash;
+
+    walletDB->WriteTx(it->second.tx, height, it->second.sequence);
+}
+
+bool Wallet::AbandonTransaction(const Hash256& txHash) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = walletTxs.find(txHash);
+    if (it == walletTxs.end()) {
+        return false;
+    }
+    if (it->second.height > 0) {
+        LOG_ERROR("Wallet", "Cannot abandon a confirmed transaction");
+        return false;
+    }
+
+    // A descendant would be left spending outputs that no longer exist
+    for (const auto& pair : spentUTXOs) {
+        if (pair.first.txHash == txHash) {
+            LOG_ERROR("Wallet", "Cannot abandon a transaction with wallet descendants");
+            return false;
+        }
+    }
+
+    Transaction tx = it->second.tx;
+
+    walletDB->TxnBegin();
+
+    for (size_t i = 0; i < tx.outputs.size(); ++i) {
+        RemoveUTXOInternal(OutPoint(txHash, static_cast<TxOutIndex>(i)));
+    }
+
+    for (const TxIn& txin : tx.inputs) {
+        auto spentIt = spentUTXOs.find(txin.prevOut);
+        if (spentIt != spentUTXOs.end() && spentIt->second.spentHeight == 0) {
+            AddUTXOInternal(txin.prevOut, spentIt->second.txout, spentIt->second.height);
+            walletDB->EraseSpentOutput(txin.prevOut);
+            spentUTXOs.erase(spentIt);
+        }
+    }
+
+    EraseWalletTx(txHash);
+    walletDB->EraseTx(txHash);
+
+    if (!walletDB->TxnCommit()) {
+        LOG_ERROR("Wallet", "Failed to persist abandoned transaction");
+        return false;
+    }
+
+    LOG_INFO("Wallet", "Abandoned transaction " + crypto::Hash::ToHex(txHash));
+    return true;
+}
+
+bool Wallet::EraseWalletTx(const Hash256& txHash) {
+    auto it = walletTxs.find(txHash);
+    if (it == walletTxs.end()) {
+        return false;
+    }
+
+    txOrder.erase(GetTxOrderKey(it->second));
+    walletTxs.erase(it);
+    return true;
+}
+
+bool Wallet::Save() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string filepath = GetWalletFilePath();
+    return SaveToFile(filepath);
+}
+
+bool Wallet::Load() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string filepath = GetWalletFilePath();
+    return LoadFromFile(filepath);
+}
+
+Wallet::WalletInfo Wallet::GetInfo() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    WalletInfo info;
+    info.keyCount = keystore->GetKeyCount();
+    info.addressCount = addressBook.GetAddressCount();
+    info.utxoCount = walletUTXOs.size();
+    info.balance = confirmedBalance;
+    info.unconfirmedBalance = unconfirmedBalance;
+    info.immatureBalance = immatureBalance;
+    info.encrypted = keystore->IsEncrypted();
+    info.locked = keystore->IsLocked();
+    info.hdEnabled = (hdWallet != nullptr);
+
+    return info;
+}
+
+// Private helper methods
+
+void Wallet::AddUTXOInternal(const OutPoint& outpoint, const TxOut& txout, BlockHeight height) {
+    if (walletUTXOs.count(outpoint) > 0) {
+        RemoveUTXOInternal(outpoint);
+    }
+
+    walletUTXOs[outpoint] = txout;
+    utxoHeights[outpoint] = height;
+    walletDB->WriteUTXO(outpoint, txout, height);
+
+    BalanceBucket(outpoint, height) += txout.value;
+    if (height > 0 && coinbaseTxHashes.count(outpoint.txHash) > 0) {
+        coinbaseValueByHeight[height] += txout.value;
+    }
+
+    LOG_DEBUG("Wallet", "Added UTXO: " + std::to_string(txout.value) + " satoshis");
+}
+
+void Wallet::RemoveUTXOInternal(const OutPoint& outpoint) {
+    auto it = walletUTXOs.find(outpoint);
+    if (it == walletUTXOs.end()) {
+        return;
+    }
+
+    Amount value = it->second.value;
+    BlockHeight height = utxoHeights[outpoint];
+
+    BalanceBucket(outpoint, height) -= value;
+    if (height > 0 && coinbaseTxHashes.count(outpoint.txHash) > 0) {
+        auto heightIt = coinbaseValueByHeight.find(height);
+        if (heightIt != coinbaseValueByHeight.end()) {
+            heightIt->second -= value;
+            if (heightIt->second == 0) {
+                coinbaseValueByHeight.erase(heightIt);
+            }
+        }
+    }
+
+    walletUTXOs.erase(it);
+    utxoHeights.erase(outpoint);
+    walletDB->EraseUTXO(outpoint);
+}
+
+bool Wallet::IsImmatureCoinbase(const OutPoint& outpoint, BlockHeight height) const {
+    return height > 0 && height + COINBASE_MATURITY > chainHeight &&
+           coinbaseTxHashes.count(outpoint.txHash) > 0;
+}
+
+Amount& Wallet::BalanceBucket(const OutPoint& outpoint, BlockHeight height) {
+    if (height == 0) {
+        return unconfirmedBalance;
+    }
+    return IsImmatureCoinbase(outpoint, height) ? immatureBalance : confirmedBalance;
+}
+
+void Wallet::SetChainHeightInternal(BlockHeight height) {
+    if (height == chainHeight) {
+        return;
+    }
+
+    // Coinbase outputs created at or below this height are mature
+    auto matureLimit = [](BlockHeight tip) -> int64_t {
+        return static_cast<int64_t>(tip) - COINBASE_MATURITY;
+    };
+
+    int64_t oldLimit = matureLimit(chainHeight);
+    int64_t newLimit = matureLimit(height);
+    chainHeight = height;
+
+    // Only the heights between the two limits change bucket
+    int64_t low = std::min(oldLimit, newLimit);
+    int64_t high = std::max(oldLimit, newLimit);
+    if (high <= 0) {
+        return;
+    }
+
+    auto it = coinbaseValueByHeight.upper_bound(static_cast<BlockHeight>(std::max<int64_t>(low, 0)));
+    for (; it != coinbaseValueByHeight.end() && it->first <= high; ++it) {
+        if (newLimit > oldLimit) {
+            immatureBalance -= it->second;
+            confirmedBalance += it->second;
+        } else {
+            confirmedBalance -= it->second;
+            immatureBalance += it->second;
+        }
+    }
+}
+
+bool Wallet::ProcessTransactionInternal(const Transaction& tx, BlockHeight height) {
+    Hash256 txHash = tx.GetHash();
+    if (walletTxs.count(txHash) > 0) {
+        if (height > 0) {
+            SetWalletTxHeight(txHash, height);
+
+            // A transaction we committed unconfirmed is now in a block
+            for (size_t i = 0; i < tx.outputs.size(); ++i) {
+                OutPoint outpoint(txHash, static_cast<TxOutIndex>(i));
+                auto heightIt = utxoHeights.find(outpoint);
+                if (heightIt != utxoHeights.end() && heightIt->second == 0) {
+                    TxOut txout = walletUTXOs[outpoint];
+                    AddUTXOInternal(outpoint, txout, height);
+                }
+            }
+            for (const TxIn& txin : tx.inputs) {
+                auto spentIt = spentUTXOs.find(txin.prevOut);
+                if (spentIt != spentUTXOs.end() && spentIt->second.spentHeight == 0) {
+                    spentIt->second.spentHeight = height;
+                    walletDB->WriteSpentOutput(txin.prevOut, spentIt->second.txout,
+                                               spentIt->second.height, height);
+                }
+            }
+        }
+        return false;
+    }
+
+    bool relevant = false;
+
+    // Needed before crediting so coinbase outputs land in the immature bucket
+    bool coinbase = tx.IsCoinbase();
+    if (coinbase) {
+        coinbaseTxHashes.insert(txHash);
+    }
+
+    // Check outputs for payments to our addresses
+    for (size_t i = 0; i < tx.outputs.size(); ++i) {
+        const TxOut& txout = tx.outputs[i];
+
+        // Probe the owned hash index straight from the script bytes
+        Hash160 hash;
+        AddressType type;
+        if (!AddressGenerator::ExtractScriptHash(txout.scriptPubKey, hash, type)) {
+            continue;
+        }
+
+        bool mine = addressBook.IsMineHash(hash, type);
+        if (!mine && type != AddressType::P2SH) {
+            // Lookahead entries are key hashes, never script hashes
+            auto poolIt = keyPoolLookup.find(hash);
+            if (poolIt != keyPoolLookup.end()) {
+                // Paid to a lookahead key: it and every key before it count as used
+                HDKeyPath path = poolIt->second;
+                MarkKeyPoolUsed(path);
+                mine = true;
+            }
+        }
+
+        if (mine) {
+            AddUTXOInternal(OutPoint(txHash, static_cast<TxOutIndex>(i)), txout, height);
+            relevant = true;
+
+            LOG_INFO("Wallet", "Received " + std::to_string(txout.value) +
+                     " satoshis to " + Address(hash, type).ToString());
+        }
+    }
+
+    // Remove spent outputs
+    if (!tx.IsCoinbase()) {
+        for (const TxIn& txin : tx.inputs) {
+            auto it = walletUTXOs.find(txin.prevOut);
+            if (it == walletUTXOs.end()) {
+                continue;
+            }
+
+            SpentOutput spent;
+            spent.txout = it->second;
+            spent.height = utxoHeights[txin.prevOut];
+            spent.spentHeight = height;
+            spentUTXOs[txin.prevOut] = spent;
+            walletDB->WriteSpentOutput(txin.prevOut, spent.txout, spent.height, spent.spentHeight);
+
+            RemoveUTXOInternal(txin.prevOut);
+            relevant = true;
+
+            LOG_INFO("Wallet", "Spent UTXO");
+        }
+    }
+
+    // Add to transaction history
+    if (relevant) {
+        uint64_t sequence = nextTxSequence;
+        AddWalletTx(tx, height, sequence);
+        walletDB->WriteTx(tx, height, sequence);
+    } else if (coinbase) {
+        coinbaseTxHashes.erase(txHash);
+    }
+
+    return relevant;
+}
+
+bool Wallet::DeriveNextAddress(bool isChange, Address& addr) {
+    const ExtendedKey& chainKey = isChange ? internalChainKey : externalChainKey;
+    if (!hdWallet || chainKey.key.empty()) {
+        LOG_ERROR("Wallet", "HD wallet not initialized");
+        return false;
+    }
+
+    std::deque<KeyPoolEntry>& pool = isChange ? internalPool : externalPool;
+    uint32_t index = isChange ? nextChangeIndex : nextReceivingIndex;
+
+    KeyPoolEntry entry;
+    if (!pool.empty()) {
+        entry = std::move(pool.front());
+        pool.pop_front();
+        keyPoolLookup.erase(entry.keyID);
+    } else if (!DeriveKeyPoolEntry(chainKey, index, entry) &&
+               !DeriveKeyPoolEntry(chainKey, index + 1, entry)) {
+        // Pool drained faster than the keypool thread refills it and
+        // the inline derivation failed too
         LOG_ERROR("Wallet", "Failed to derive address");
         return false;
     }
 
-    // Get private and public keys
-    Hash256 privKey = HDWallet::GetPrivateKey(key);
-    bytes pubKey = HDWallet::GetPublicKey(key);
+    IssueHDKey(isChange, entry);
+    addr = Address(entry.keyID, AddressType::P2PKH);
 
-    // Generate address
-    addr = AddressGenerator::GenerateP2PKH(pubKey);
+    keyPoolCondition.notify_one();
 
-    // Add key to keystore
-    KeyMetadata keyMetadata;
-    keyMetadata.creationTime = Time::GetCurrentTime();
-    keyMetadata.hdPath = BIP44::GetPath(config.hdAccount, isChange ? 1 : 0, index);
-    keyMetadata.isChange = isChange;
+    return true;
+}
 
-    Key walletKey(privKey, pubKey, keyMetadata);
-    keystore->AddKey(walletKey);
+bool Wallet::DeriveKeyPoolEntry(const ExtendedKey& chainKey, uint32_t index, KeyPoolEntry& entry) {
+    ExtendedKey child;
+    if (!HDWallet::DeriveChildPublic(chainKey, index, child)) {
+        return false;
+    }
 
-    // Add address to address book
-    AddressMetadata addrMetadata;
-    addrMetadata.creationTime = keyMetadata.creationTime;
-    addrMetadata.isChange = isChange;
-    addrMetadata.isMine = true;
-    addrMetadata.derivationIndex = index;
+    entry.index = index;
+    entry.pubKey = child.key;
+    entry.keyID = crypto::Hash::ComputeHash160(child.key);
 
-    addressBook.AddAddress(addr, addrMetadata);
+    return true;
+}
 
-    index++;
+bool Wallet::SetupHDChains() {
+    // Account xpub from the stored public key, so this also works while locked
+    ExtendedKey accountXpub = accountKey;
+    accountXpub.key = accountPubKey;
+
+    if (!HDWallet::DeriveChildPublic(accountXpub, 0, externalChainKey) ||
+        !HDWallet::DeriveChildPublic(accountXpub, 1, internalChainKey)) {
+        LOG_ERROR("Wallet", "Failed to derive HD chain keys");
+        externalChainKey.key.clear();
+        internalChainKey.key.clear();
+        return false;
+    }
+
+    // Lookahead derived from a previous chain no longer applies
+    externalPool.clear();
+    internalPool.clear();
+    keyPoolLookup.clear();
+    keyPoolGeneration++;
 
     return true;
 }
 
-bool Wallet::SelectCoins(Amount targetValue, Amount feeRate,
+void Wallet::StartKeyPool() {
+    if (keyPoolRunning.load()) {
+        keyPoolCondition.notify_one();
+        return;
+    }
+
+    keyPoolRunning = true;
+    keyPoolThread = std::thread(&Wallet::KeyPoolThreadFunc, this);
+}
+
+void Wallet::StopKeyPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        keyPoolRunning = false;
+    }
+    keyPoolCondition.notify_all();
+
+    if (keyPoolThread.joinable()) {
+        keyPoolThread.join();
+    }
+}
+
+bool Wallet::KeyPoolNeedsTopUp() const {
+    return (!externalChainKey.key.empty() && externalPool.size() < config.keyPoolSize) ||
+           (!internalChainKey.key.empty() && internalPool.size() < config.keyPoolSize);
+}
+
+void Wallet::KeyPoolThreadFunc() {
+    LOG_DEBUG("Wallet", "Keypool thread started");
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (keyPoolRunning.load()) {
+        keyPoolCondition.wait(lock, [this] {
+            return !keyPoolRunning.load() || KeyPoolNeedsTopUp();
+        });
+
+        if (!keyPoolRunning.load()) {
+            break;
+        }
+
+        TopUpKeyPool(false, lock);
+        TopUpKeyPool(true, lock);
+    }
+
+    LOG_DEBUG("Wallet", "Keypool thread stopped");
+}
+
+void Wallet::TopUpKeyPool(bool isChange, std::unique_lock<std::mutex>& lock) {
+    std::deque<KeyPoolEntry>& pool = isChange ? internalPool : externalPool;
+    ExtendedKey& chainKey = isChange ? internalChainKey : externalChainKey;
+    const uint32_t& nextIndex = isChange ? nextChangeIndex : nextReceivingIndex;
+
+    while (!chainKey.key.empty() && pool.size() < config.keyPoolSize) {
+        size_t count = std::min(config.keyPoolSize - pool.size(), KEYPOOL_BATCH_SIZE);
+        uint32_t start = pool.empty() ? nextIndex : pool.back().index + 1;
+        ExtendedKey parent = chainKey;
+        uint64_t generation = keyPoolGeneration;
+
+        // EC work runs without the wallet lock so address requests never wait on it
+        lock.unlock();
+
+        std::vector<KeyPoolEntry> derived;
+        derived.reserve(count);
+        for (uint32_t index = start; derived.size() < count && index - start < 2 * count; ++index) {
+            KeyPoolEntry entry;
+            if (DeriveKeyPoolEntry(parent, index, entry)) {
+                derived.push_back(std::move(entry));
+            }
+        }
+
+        lock.lock();
+
+        if (generation != keyPoolGeneration) {
+            return;  // Chains were replaced meanwhile
+        }
+
+        if (derived.empty()) {
+            LOG_ERROR("Wallet", "Keypool derivation failed, disabling lookahead");
+            chainKey.key.clear();
+            return;
+        }
+
+        // Skip keys issued inline while the lock was released
+        uint32_t expected = pool.empty() ? nextIndex : pool.back().index + 1;
+        for (auto& entry : derived) {
+            if (entry.index < expected) {
+                continue;
+            }
+            keyPoolLookup[entry.keyID] = HDKeyPath{isChange, entry.index};
+            pool.push_back(std::move(entry));
+        }
+    }
+}
+
+void Wallet::IssueHDKey(bool isChange, const KeyPoolEntry& entry) {
+    Address addr(entry.keyID, AddressType::P2PKH);
+
+    AddressMetadata metadata;
+    metadata.creationTime = Time::GetCurrentTime();
+    metadata.isChange = isChange;
+    metadata.isMine = true;
+    metadata.derivationIndex = entry.index;
+
+    addressBook.AddAddress(addr, metadata);
+    hdKeyPaths[entry.keyID] = HDKeyPath{isChange, entry.index};
+
+    uint32_t& nextIndex = isChange ? nextChangeIndex : nextReceivingIndex;
+    nextIndex = std::max(nextIndex, entry.index + 1);
+
+    // Not synced: survives a process crash without an fsync per address
+    walletDB->TxnBegin();
+    walletDB->WriteAddress(addr, metadata);
+    WriteHDChainRecord();
+    walletDB->TxnCommit(false);
+}
+
+void Wallet::MarkKeyPoolUsed(const HDKeyPath& path) {
+    std::deque<KeyPoolEntry>& pool = path.isChange ? internalPool : externalPool;
+
+    while (!pool.empty() && pool.front().index <= path.index) {
+        KeyPoolEntry entry = std::move(pool.front());
+        pool.pop_front();
+        keyPoolLookup.erase(entry.keyID);
+        IssueHDKey(path.isChange, entry);
+    }
+
+    keyPoolCondition.notify_one();
+}
+
+bool Wallet::EnsureSigningKey(const Hash160& keyID) {
+    if (keystore->HaveKey(keyID)) {
+        return true;
+    }
+
+    auto it = hdKeyPaths.find(keyID);
+    if (it == hdKeyPaths.end() || !accountKey.IsPrivate()) {
+        return false;
+    }
+
+    uint32_t change = it->second.isChange ? 1 : 0;
+
+    ExtendedKey key;
+    if (!BIP44::DeriveAddress(accountKey, change, it->second.index, key)) {
+        LOG_ERROR("Wallet", "Failed to derive signing key");
+        return false;
+    }
+
+    KeyMetadata metadata;
+    metadata.creationTime = Time::GetCurrentTime();
+    metadata.hdPath = BIP44::GetPath(config.hdAccount, change, it->second.index);
+    metadata.isChange = it->second.isChange;
+
+    return keystore->AddKey(Key(HDWallet::GetPrivateKey(key), HDWallet::GetPublicKey(key), metadata));
+}
+
+bool Wallet::SelectCoins(Amount targetValue, Amount feeRate, size_t numOutputs,
                          std::vector<std::pair<OutPoint, TxOut>>& selected,
                          Amount& selectedValue) {
     selected.clear();
     selectedValue = 0;
 
-    // Simple coin selection: largest first
-    std::vector<std::pair<OutPoint, TxOut>> candidates;
+    // Wallet fee rates are per byte, the selector works per KB
+    Amount feeRatePerKB = feeRate * 1000;
+
+    // Effective values are computed once per coin up front
+    std::vector<CoinSelector::Candidate> candidates;
+    candidates.reserve(walletUTXOs.size());
 
     for (const auto& pair : walletUTXOs) {
-        candidates.push_back(pair);
+        if (IsImmatureCoinbase(pair.first, utxoHeights[pair.first])) {
+            continue;
+        }
+        candidates.push_back(CoinSelector::MakeCandidate(pair.first, pair.second, feeRatePerKB));
     }
 
-    std::sort(candidates.begin(), candidates.end(),
-              [](const auto& a, const auto& b) {
-                  return a.second.value > b.second.value;
-              });
+    CoinSelector selector;
+    CoinSelector::SelectionResult result = selector.SelectCoins(
+        targetValue, feeRatePerKB, std::move(candidates),
+        CoinSelector::Strategy::BRANCH_AND_BOUND, numOutputs);
 
-    // Estimate fee per input
-    Amount feePerInput = 148 * feeRate;
+    if (!result.success) {
+        return false;
+    }
+
+    for (const auto& outpoint : result.selected) {
+        auto it = walletUTXOs.find(outpoint);
+        if (it == walletUTXOs.end()) {
+            selected.clear();
+            return false;
+        }
+        selected.push_back(*it);
+    }
+
+    selectedValue = result.totalValue;
+
+    LOG_DEBUG("Wallet", "Selected " + std::to_string(selected.size()) + " coins, " +
+              (result.change == 0 ? "no change" : "change " + std::to_string(result.change)));
 
-    for (const auto& coin : candidates) {
-        selected.push_back(coin);
-        selectedValue += coin.second.value;
+    return true;
+}
 
-        // Estimate current fee
-        size_t numInputs = selected.size();
-        Amount estimatedFee = (numInputs * 148 + 34 + 10) * feeRate;
+void Wallet::WriteKeyRecord(const Key& key) {
+    Hash160 keyID = crypto::Hash::ComputeHash160(key.pubKey);
 
-        if (selectedValue >= targetValue + estimatedFee + feePerInput) {
-            return true;
+    if (keystore->IsEncrypted()) {
+        bytes encryptedKey;
+        if (keystore->GetEncryptedKey(keyID, encryptedKey)) {
+            walletDB->WriteCryptedKey(keyID, key.pubKey, encryptedKey, key.metadata);
         }
+    } else {
+        walletDB->WriteKey(keyID, key);
+    }
+}
+
+void Wallet::WriteHDChainRecord() {
+    if (!hdWallet || accountPubKey.empty()) {
+        return;
+    }
+
+    WalletDB::HDChain chain;
+    chain.account = config.hdAccount;
+    chain.accountKey = accountKey;
+    chain.accountKey.key.clear();
+    chain.accountPubKey = accountPubKey;
+    chain.encrypted = !cryptedAccountKey.empty();
+    chain.accountPrivKey = chain.encrypted ? cryptedAccountKey : accountKey.key;
+    chain.nextReceivingIndex = nextReceivingIndex;
+    chain.nextChangeIndex = nextChangeIndex;
+
+    walletDB->WriteHDChain(chain);
+}
+
+bool Wallet::RewriteKeyRecords() {
+    walletDB->TxnBegin();
+
+    walletDB->WriteMasterKey(keystore->GetMasterKey());
+
+    for (const auto& pair : keystore->GetEncryptedKeys()) {
+        bytes pubKey;
+        KeyMetadata metadata;
+        if (!keystore->GetPubKey(pair.first, pubKey) ||
+            !keystore->GetKeyMetadata(pair.first, metadata)) {
+            walletDB->TxnAbort();
+            return false;
+        }
+        walletDB->WriteCryptedKey(pair.first, pubKey, pair.second, metadata);
+    }
+
+    WriteHDChainRecord();
+
+    if (!walletDB->TxnCommit()) {
+        return false;
+    }
+
+    // Rewrite table files so no plaintext keys linger on disk
+    walletDB->Compact();
+
+    return true;
+}
+
+void Wallet::RestoreAccountKey() {
+    if (cryptedAccountKey.empty() || accountKey.IsPrivate()) {
+        return;
+    }
+
+    Hash256 privKey;
+    if (!keystore->DecryptSecret(cryptedAccountKey, privKey)) {
+        LOG_ERROR("Wallet", "Failed to decrypt account key");
+        return;
     }
 
-    return false;
+    accountKey.key.assign(privKey.begin(), privKey.end());
+    std::fill(privKey.begin(), privKey.end(), 0);
 }
 
 std::string Wallet::GetWalletFilePath() const {
-    return config.dataDir + "/wallet.dat";
+    return config.dataDir + "/walletdb";
 }
 
 bool Wallet::SaveToFile(const std::string& filepath) {
-    // Note: Wallet persistence format should be defined (JSON, Protocol Buffers, or custom binary)
-    LOG_INFO("Wallet", "Saving wallet to " + filepath);
+    // Records are written as they change; only the HD counters are refreshed here
+    if (!walletDB->IsOpen()) {
+        LOG_DEBUG("Wallet", "Wallet database not open, nothing to save");
+        return false;
+    }
+
+    WriteHDChainRecord();
+
+    LOG_DEBUG("Wallet", "Saved wallet to " + filepath);
     return true;
 }
 
 bool Wallet::LoadFromFile(const std::string& filepath) {
-    // Note: Wallet loading format should match serialization format
-    LOG_DEBUG("Wallet", "Loading wallet from " + filepath);
-    return false;
+    if (!walletDB->IsOpen() && !walletDB->Open(filepath)) {
+        return false;
+    }
+
+    WalletDB::Contents contents;
+    if (!walletDB->LoadWallet(contents)) {
+        LOG_ERROR("Wallet", "Failed to read wallet database");
+        return false;
+    }
+
+    if (contents.keys.empty() && contents.addresses.empty() && !contents.hdChain) {
+        LOG_DEBUG("Wallet", "No existing wallet at " + filepath);
+        return false;
+    }
+
+    // Keys
+    if (contents.masterKey) {
+        keystore->SetMasterKey(*contents.masterKey);
+    }
+
+    std::unordered_set<Hash160> storedKeys;
+    for (const auto& record : contents.keys) {
+        storedKeys.insert(record.keyID);
+        if (record.encrypted) {
+            keystore->AddEncryptedKey(record.keyID, record.pubKey, record.encryptedKey,
+                                      record.metadata);
+        } else {
+            keystore->AddKey(Key(record.privKey, record.pubKey, record.metadata));
+        }
+    }
+
+    // Addresses
+    for (const auto& entry : contents.addresses) {
+        addressBook.AddAddress(entry.first, entry.second);
+
+        // HD addresses without a stored key are re-derived when they sign
+        const AddressMetadata& metadata = entry.second;
+        if (contents.hdChain && metadata.isMine && storedKeys.count(entry.first.GetHash()) == 0) {
+            hdKeyPaths[entry.first.GetHash()] = HDKeyPath{metadata.isChange, metadata.derivationIndex};
+        }
+    }
+
+    // HD chain
+    if (contents.hdChain) {
+        const WalletDB::HDChain& chain = *contents.hdChain;
+
+        if (!hdWallet) {
+            hdWallet = std::make_unique<HDWallet>();
+        }
+
+        config.hdAccount = chain.account;
+        accountKey = chain.accountKey;
+        accountPubKey = chain.accountPubKey;
+
+        if (chain.encrypted) {
+            cryptedAccountKey = chain.accountPrivKey;
+            accountKey.key.clear();
+        } else {
+            cryptedAccountKey.clear();
+            accountKey.key = chain.accountPrivKey;
+        }
+
+        nextReceivingIndex = chain.nextReceivingIndex;
+        nextChangeIndex = chain.nextChangeIndex;
+
+        if (SetupHDChains()) {
+            StartKeyPool();
+        }
+    }
+
+    // Outputs and history
+    for (const auto& record : contents.transactions) {
+        AddWalletTx(record.tx, record.height, record.sequence);
+        if (record.tx.IsCoinbase()) {
+            coinbaseTxHashes.insert(record.tx.GetHash());
+        }
+    }
+
+    // Best guess of the tip until the chain reports it
+    for (const auto& record : contents.utxos) {
+        chainHeight = std::max(chainHeight, record.height);
+    }
+
+    for (const auto& record : contents.utxos) {
+        walletUTXOs[record.outpoint] = record.txout;
+        utxoHeights[record.outpoint] = record.height;
+
+        BalanceBucket(record.outpoint, record.height) += record.txout.value;
+        if (record.height > 0 && coinbaseTxHashes.count(record.outpoint.txHash) > 0) {
+            coinbaseValueByHeight[record.height] += record.txout.value;
+        }
+    }
+
+    for (const auto& record : contents.spentOutputs) {
+        SpentOutput spent;
+        spent.txout = record.txout;
+        spent.height = record.height;
+        spent.spentHeight = record.spentHeight;
+        spentUTXOs[record.outpoint] = spent;
+    }
+
+    LOG_INFO("Wallet", "Loaded wallet from " + filepath + ": " +
+             std::to_string(contents.keys.size()) + " keys, " +
+             std::to_string(contents.addresses.size()) + " addresses, " +
+             std::to_string(walletUTXOs.size()) + " UTXOs, " +
+             std::to_string(walletTxs.size()) + " transactions");
+
+    return true;
 }
 
 } // namespace dinari
@@ -4,6 +4,7 @@
 #include "keystore.h"
 #include "hdwallet.h"
 #include "address.h"
+#include "walletdb.h"
 #include "core/transaction.h"
 #include "core/utxo.h"
 #include <memory>
@@ -11,6 +12,11 @@
 #include <optional>
 #include <atomic>
 #include <thread>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
 
 namespace dinari {
 
@@ -21,13 +27,21 @@ struct WalletConfig {
     std::string dataDir;
     bool useHDWallet;
     uint32_t hdAccount;
-    size_t keyPoolSize;
+    size_t keyPoolSize;         // Lookahead keys kept ready per HD chain
+    uint32_t payoutInterval;    // Seconds between batched payout transactions
+    size_t consolidateMinUTXOs; // Consolidate once the wallet holds more UTXOs (0 = never)
+    size_t consolidateMaxInputs;
+    Amount consolidateMaxFeeRate; // Consolidate only at or below this fee rate (sat/byte)
 
     WalletConfig()
         : dataDir(".")
         , useHDWallet(true)
         , hdAccount(0)
-        , keyPoolSize(100) {}
+        , keyPoolSize(100)
+        , payoutInterval(60)
+        , consolidateMinUTXOs(0)
+        , consolidateMaxInputs(200)
+        , consolidateMaxFeeRate(2) {}
 };
 
 /**
@@ -207,12 +221,12 @@ public:
     bool ChangePassphrase(const std::string& oldPassphrase, const std::string& newPassphrase);
 
     /**
-     * @brief Get balance
+     * @brief Get total balance (confirmed, unconfirmed and immature)
      */
     Amount GetBalance() const;
 
     /**
-     * @brief Get unconfirmed balance
+     * @brief Get unconfirmed balance (outputs recorded at height 0)
      */
     Amount GetUnconfirmedBalance() const;
 
@@ -221,6 +235,16 @@ public:
      */
     Amount GetAvailableBalance() const;
 
+    /**
+     * @brief Get balance of coinbase outputs not yet mature
+     */
+    Amount GetImmatureBalance() const;
+
+    /**
+     * @brief Set the active chain height used for coinbase maturity
+     */
+    void SetChainHeight(BlockHeight height);
+
     /**
      * @brief Create transaction
      *
@@ -247,6 +271,55 @@ public:
      */
     bool SignTransaction(Transaction& tx);
 
+    /**
+     * @brief Callback to relay wallet-created transactions
+     */
+    using BroadcastCallback = std::function<void(const Transaction&)>;
+
+    /**
+     * @brief Callback returning the current fee rate estimate (sat/byte)
+     */
+    using FeeRateCallback = std::function<Amount()>;
+
+    void SetBroadcastCallback(BroadcastCallback callback);
+    void SetFeeRateCallback(FeeRateCallback callback);
+
+    /**
+     * @brief Queue a payment for the next batched payout transaction
+     *
+     * Payments to the same address are merged.
+     */
+    bool QueuePayment(const Address& addr, Amount amount);
+
+    /**
+     * @brief Get number of recipients waiting in the payout queue
+     */
+    size_t GetQueuedPaymentCount() const;
+
+    /**
+     * @brief Send all queued payments now as one transaction
+     *
+     * Payments stay queued if the transaction cannot be created.
+     */
+    bool FlushPayments(Transaction& tx);
+
+    /**
+     * @brief Merge the smallest wallet UTXOs into a single output
+     *
+     * Only outputs worth more than the fee to spend them are merged.
+     */
+    bool ConsolidateCoins(Amount feeRate, Transaction& tx);
+
+    /**
+     * @brief Start the payout and consolidation scheduler
+     */
+    void StartScheduler();
+
+    /**
+     * @brief Stop the payout and consolidation scheduler
+     */
+    void StopScheduler();
+
     /**
      * @brief Get wallet UTXOs
      */
@@ -268,9 +341,77 @@ public:
     bool ProcessTransaction(const Transaction& tx, BlockHeight height);
 
     /**
-     * @brief Get transaction history
+     * @brief Handle block connected to the active chain
      */
-    std::vector<Transaction> GetTransactions() const;
+    void BlockConnected(const Block& block, BlockHeight height);
+
+    /**
+     * @brief Handle block disconnected from the active chain (reorg)
+     */
+    void BlockDisconnected(const Block& block, BlockHeight height);
+
+    /**
+     * @brief Rescan blockchain for wallet transactions
+     *
+     * Streams blocks from the block store with the height range split
+     * across worker threads. Outputs are matched against the wallet's key
+     * hashes straight from the script bytes, so only relevant transactions
+     * ever reach address extraction.
+     *
+     * Refuses to start below the chain's prune height, and applies nothing
+     * if a block in the range turns out to be unavailable.
+     *
+     * @param chain Blockchain to scan
+     * @param startHeight First height to scan
+     * @param numThreads Worker threads (0 = hardware concurrency)
+     * @return Number of wallet transactions found, or nullopt if block data
+     *         in the range is missing
+     */
+    std::optional<size_t> RescanBlockchain(const Blockchain& chain, BlockHeight startHeight = 0,
+                                           size_t numThreads = 0);
+
+    /**
+     * @brief Transaction in the wallet history
+     */
+    struct WalletTx {
+        Transaction tx;
+        BlockHeight height;     // 0 while unconfirmed
+        uint64_t sequence;      // Insertion order, orders transactions within a block
+    };
+
+    /**
+     * @brief Page through transaction history, newest first
+     *
+     * Unconfirmed transactions come first, then confirmed ones by
+     * descending height. Only the requested window is visited.
+     *
+     * @param count Maximum number of transactions to return
+     * @param skip Number of transactions to skip before the first returned one
+     * @param sinceHeight Stop before transactions confirmed below this height
+     * @param after Start after this transaction (the last one of a previous page)
+     */
+    std::vector<WalletTx> ListTransactions(size_t count, size_t skip = 0,
+                                           BlockHeight sinceHeight = 0,
+                                           const Hash256* after = nullptr) const;
+
+    /**
+     * @brief Look up a wallet transaction by hash
+     */
+    bool GetWalletTransaction(const Hash256& txHash, WalletTx& wtx) const;
+
+    /**
+     * @brief Get number of wallet transactions
+     */
+    size_t GetTransactionCount() const;
+
+    /**
+     * @brief Forget an unconfirmed wallet transaction
+     *
+     * Drops its outputs and makes the inputs it spent available again.
+     * Fails for confirmed transactions and for ones whose outputs are
+     * spent by another wallet transaction; abandon those first.
+     */
+    bool AbandonTransaction(const Hash256& txHash);
 
     /**
      * @brief Save wallet to disk
@@ -289,7 +430,9 @@ public:
         size_t keyCount;
         size_t addressCount;
         size_t utxoCount;
-        Amount balance;
+        Amount balance;             // Confirmed and spendable
+        Amount unconfirmedBalance;
+        Amount immatureBalance;
         bool encrypted;
         bool locked;
         bool hdEnabled;
@@ -303,12 +446,38 @@ private:
     // Key management
     std::unique_ptr<CryptoKeyStore> keystore;
 
+    // Persistent storage
+    std::unique_ptr<WalletDB> walletDB;
+
     // HD wallet
     std::unique_ptr<HDWallet> hdWallet;
     ExtendedKey accountKey;
+    bytes accountPubKey;
+    bytes cryptedAccountKey;  // Account private key under the master key
     uint32_t nextReceivingIndex;
     uint32_t nextChangeIndex;
 
+    // HD keypool: public keys derived ahead of use from the chain xpubs
+    struct HDKeyPath {
+        bool isChange;
+        uint32_t index;
+    };
+    struct KeyPoolEntry {
+        uint32_t index;
+        bytes pubKey;
+        Hash160 keyID;
+    };
+    ExtendedKey externalChainKey;  // account/0 (public)
+    ExtendedKey internalChainKey;  // account/1 (public)
+    std::deque<KeyPoolEntry> externalPool;
+    std::deque<KeyPoolEntry> internalPool;
+    std::unordered_map<Hash160, HDKeyPath> keyPoolLookup;  // Lookahead keys not yet issued
+    std::unordered_map<Hash160, HDKeyPath> hdKeyPaths;     // Issued keys derived on demand for signing
+    uint64_t keyPoolGeneration;
+    std::atomic<bool> keyPoolRunning;
+    std::thread keyPoolThread;
+    std::condition_variable keyPoolCondition;
+
     // Address management
     AddressBook addressBook;
 
@@ -316,8 +485,27 @@ private:
     std::map<OutPoint, TxOut> walletUTXOs;
     std::map<OutPoint, BlockHeight> utxoHeights;
 
-    // Transaction history
-    std::vector<Transaction> transactions;
+    // Recently spent outputs (restored if the spending block is disconnected)
+    struct SpentOutput {
+        TxOut txout;
+        BlockHeight height;
+        BlockHeight spentHeight;
+    };
+    std::map<OutPoint, SpentOutput> spentUTXOs;
+
+    // Running balance totals, adjusted on every UTXO add and remove
+    Amount confirmedBalance;
+    Amount unconfirmedBalance;
+    Amount immatureBalance;
+    std::map<BlockHeight, Amount> coinbaseValueByHeight;  // Wallet coinbase UTXO value by creation height
+    std::unordered_set<Hash256> coinbaseTxHashes;
+    BlockHeight chainHeight;
+
+    // Transaction history, indexed by hash and by (height, sequence)
+    using TxOrderKey = std::pair<BlockHeight, uint64_t>;
+    std::unordered_map<Hash256, WalletTx> walletTxs;
+    std::map<TxOrderKey, Hash256> txOrder;
+    uint64_t nextTxSequence;
 
     // Synchronization
     mutable std::mutex mutex;
@@ -328,14 +516,54 @@ private:
     std::thread autoLockThread;
     void AutoLockThreadFunc();
 
+    // Batched payouts and consolidation
+    std::map<Address, Amount> queuedPayments;
+    BroadcastCallback broadcastCallback;
+    FeeRateCallback feeRateCallback;
+    std::mutex sendMutex;                   // Serializes create, sign and commit
+    std::atomic<bool> schedulerRunning;
+    std::thread schedulerThread;
+    std::condition_variable schedulerCondition;
+    void SchedulerThreadFunc();
+    Amount GetFeeRateEstimate() const;
+    void CommitTransaction(const Transaction& tx);
+    void RelayTransaction(const Transaction& tx);
+    void KeyPoolThreadFunc();
+
     // Helper methods
-    bool DeriveNextAddress(bool isChange, Address& addr, ExtendedKey& key);
-    bool SelectCoins(Amount targetValue, Amount feeRate,
+    bool ProcessTransactionInternal(const Transaction& tx, BlockHeight height);
+
+    // Transaction history index
+    static TxOrderKey GetTxOrderKey(const WalletTx& wtx);
+    void AddWalletTx(const Transaction& tx, BlockHeight height, uint64_t sequence);
+    void SetWalletTxHeight(const Hash256& txHash, BlockHeight height);
+    bool EraseWalletTx(const Hash256& txHash);
+    void AddUTXOInternal(const OutPoint& outpoint, const TxOut& txout, BlockHeight height);
+    void RemoveUTXOInternal(const OutPoint& outpoint);
+    Amount& BalanceBucket(const OutPoint& outpoint, BlockHeight height);
+    void SetChainHeightInternal(BlockHeight height);
+    bool IsImmatureCoinbase(const OutPoint& outpoint, BlockHeight height) const;
+    bool DeriveNextAddress(bool isChange, Address& addr);
+    bool SetupHDChains();
+    void StartKeyPool();
+    void StopKeyPool();
+    bool KeyPoolNeedsTopUp() const;
+    void TopUpKeyPool(bool isChange, std::unique_lock<std::mutex>& lock);
+    void IssueHDKey(bool isChange, const KeyPoolEntry& entry);
+    void MarkKeyPoolUsed(const HDKeyPath& path);
+    bool EnsureSigningKey(const Hash160& keyID);
+    static bool DeriveKeyPoolEntry(const ExtendedKey& chainKey, uint32_t index, KeyPoolEntry& entry);
+    bool SelectCoins(Amount targetValue, Amount feeRate, size_t numOutputs,
                     std::vector<std::pair<OutPoint, TxOut>>& selected,
                     Amount& selectedValue);
     bytes GetScriptPubKeyForAddress(const Address& addr);
     bool ExtractAddressFromScriptPubKey(const bytes& scriptPubKey, Address& addr);
 
+    void WriteKeyRecord(const Key& key);
+    void WriteHDChainRecord();
+    bool RewriteKeyRecords();
+    void RestoreAccountKey();
+
     std::string GetWalletFilePath() const;
     bool SaveToFile(const std::string& filepath);
     bool LoadFromFile(const std::string& filepath);
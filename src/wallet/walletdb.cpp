@@ -0,0 +1,468 @@
+#include "walletdb.h"
+#include "util/logger.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace dinari {
+
+WalletDB::WalletDB()
+    : txnDepth(0)
+    , pendingWrites(0)
+    , writesSinceCompact(0) {
+}
+
+WalletDB::~WalletDB() {
+    Close();
+}
+
+bool WalletDB::Open(const std::string& path) {
+    std::filesystem::create_directories(path);
+
+    db = std::make_unique<Database>();
+    if (!db->Open(path, true)) {
+        LOG_ERROR("WalletDB", "Failed to open wallet database at " + path);
+        db.reset();
+        return false;
+    }
+
+    // Stamp format version on first open
+    bytes versionKey{PREFIX_VERSION};
+    auto version = db->Read(versionKey);
+    if (!version) {
+        Serializer s;
+        s.WriteUInt32(WALLET_DB_VERSION);
+        if (!Put(versionKey, s.GetData())) {
+            return false;
+        }
+    } else if (version->size() != 4 || Deserializer(*version).ReadUInt32() > WALLET_DB_VERSION) {
+        LOG_ERROR("WalletDB", "Unsupported wallet database version");
+        db.reset();
+        return false;
+    }
+
+    LOG_INFO("WalletDB", "Opened wallet database at " + path);
+
+    return true;
+}
+
+void WalletDB::Close() {
+    if (pending) {
+        LOG_WARNING("WalletDB", "Discarding uncommitted wallet batch");
+        TxnAbort();
+    }
+
+    if (db) {
+        db->Close();
+        db.reset();
+    }
+}
+
+// Transactions
+
+void WalletDB::TxnBegin() {
+    if (txnDepth++ == 0) {
+        pending = std::make_unique<Database::Batch>();
+        pendingWrites = 0;
+    }
+}
+
+bool WalletDB::TxnCommit(bool sync) {
+    if (txnDepth == 0) {
+        LOG_ERROR("WalletDB", "TxnCommit without TxnBegin");
+        return false;
+    }
+
+    if (--txnDepth > 0) {
+        return true;
+    }
+
+    std::unique_ptr<Database::Batch> batch = std::move(pending);
+    size_t writes = pendingWrites;
+    pendingWrites = 0;
+
+    if (writes == 0) {
+        return true;
+    }
+
+    if (!db || !db->WriteBatch(*batch, sync)) {
+        LOG_ERROR("WalletDB", "Failed to write wallet batch");
+        return false;
+    }
+
+    NoteWrites(writes);
+
+    return true;
+}
+
+void WalletDB::TxnAbort() {
+    pending.reset();
+    pendingWrites = 0;
+    txnDepth = 0;
+}
+
+bool WalletDB::Put(const bytes& key, const bytes& value) {
+    if (!IsOpen()) return false;
+
+    if (pending) {
+        pending->Put(key, value);
+        pendingWrites++;
+        return true;
+    }
+
+    // Single records still go through a synced batch
+    Database::Batch batch;
+    batch.Put(key, value);
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
+
+    NoteWrites(1);
+
+    return true;
+}
+
+bool WalletDB::Erase(const bytes& key) {
+    if (!IsOpen()) return false;
+
+    if (pending) {
+        pending->Delete(key);
+        pendingWrites++;
+        return true;
+    }
+
+    Database::Batch batch;
+    batch.Delete(key);
+    if (!db->WriteBatch(batch)) {
+        return false;
+    }
+
+    NoteWrites(1);
+
+    return true;
+}
+
+void WalletDB::NoteWrites(size_t count) {
+    writesSinceCompact += count;
+
+    // Churn from spent outputs and HD counter updates leaves dead entries
+    if (writesSinceCompact >= COMPACT_INTERVAL) {
+        Compact();
+    }
+}
+
+void WalletDB::Compact() {
+    if (!IsOpen()) return;
+
+    db->Compact();
+    writesSinceCompact = 0;
+
+    LOG_DEBUG("WalletDB", "Compacted wallet database");
+}
+
+// Keys
+
+bytes WalletDB::MakeKeyIDKey(char prefix, const Hash160& keyID) const {
+    bytes key(1 + keyID.size());
+    key[0] = prefix;
+    std::copy(keyID.begin(), keyID.end(), key.begin() + 1);
+    return key;
+}
+
+bytes WalletDB::MakeOutPointKey(char prefix, const OutPoint& outpoint) const {
+    bytes key(1 + outpoint.txHash.size() + sizeof(TxOutIndex));
+    key[0] = prefix;
+    std::copy(outpoint.txHash.begin(), outpoint.txHash.end(), key.begin() + 1);
+
+    // Index in big-endian so outputs of a transaction sort together in order
+    size_t offset = 1 + outpoint.txHash.size();
+    for (size_t i = 0; i < sizeof(TxOutIndex); ++i) {
+        key[offset + i] = static_cast<byte>(
+            (outpoint.index >> (8 * (sizeof(TxOutIndex) - 1 - i))) & 0xFF);
+    }
+
+    return key;
+}
+
+bytes WalletDB::MakeTxKey(const Hash256& txHash) const {
+    bytes key(1 + txHash.size());
+    key[0] = PREFIX_TX;
+    std::copy(txHash.begin(), txHash.end(), key.begin() + 1);
+    return key;
+}
+
+bytes WalletDB::MakeAddressKey(const Address& addr) const {
+    const Hash160& hash = addr.GetHash();
+    bytes key(2 + hash.size());
+    key[0] = PREFIX_ADDRESS;
+    key[1] = static_cast<byte>(addr.GetType());
+    std::copy(hash.begin(), hash.end(), key.begin() + 2);
+    return key;
+}
+
+void WalletDB::WriteMetadata(Serializer& s, const KeyMetadata& metadata) {
+    s.WriteUInt64(metadata.creationTime);
+    s.WriteString(metadata.label);
+    s.WriteString(metadata.hdPath);
+    s.WriteBool(metadata.isChange);
+}
+
+KeyMetadata WalletDB::ReadMetadata(Deserializer& d) {
+    KeyMetadata metadata;
+    metadata.creationTime = d.ReadUInt64();
+    metadata.label = d.ReadString(d.ReadCompactSize());
+    metadata.hdPath = d.ReadString(d.ReadCompactSize());
+    metadata.isChange = d.ReadBool();
+    return metadata;
+}
+
+bool WalletDB::WriteKey(const Hash160& keyID, const Key& key) {
+    Serializer s;
+    s.WriteCompactSize(key.pubKey.size());
+    s.WriteBytes(key.pubKey);
+    s.WriteHash256(key.privKey);
+    WriteMetadata(s, key.metadata);
+
+    return Put(MakeKeyIDKey(PREFIX_KEY, keyID), s.GetData());
+}
+
+bool WalletDB::WriteCryptedKey(const Hash160& keyID, const bytes& pubKey,
+                               const bytes& encryptedKey, const KeyMetadata& metadata) {
+    Serializer s;
+    s.WriteCompactSize(pubKey.size());
+    s.WriteBytes(pubKey);
+    s.WriteCompactSize(encryptedKey.size());
+    s.WriteBytes(encryptedKey);
+    WriteMetadata(s, metadata);
+
+    TxnBegin();
+
+    // Never leave a plaintext copy next to the encrypted one
+    Put(MakeKeyIDKey(PREFIX_CRYPTED_KEY, keyID), s.GetData());
+    Erase(MakeKeyIDKey(PREFIX_KEY, keyID));
+
+    return TxnCommit();
+}
+
+bool WalletDB::WriteMasterKey(const CryptoKeyStore::MasterKey& masterKey) {
+    Serializer s;
+    s.WriteCompactSize(masterKey.salt.size());
+    s.WriteBytes(masterKey.salt);
+    s.WriteUInt32(masterKey.iterations);
+    s.WriteCompactSize(masterKey.encryptedKey.size());
+    s.WriteBytes(masterKey.encryptedKey);
+
+    return Put(bytes{PREFIX_MASTER_KEY}, s.GetData());
+}
+
+bool WalletDB::WriteHDChain(const HDChain& chain) {
+    Serializer s;
+    s.WriteUInt32(chain.account);
+    s.WriteUInt32(chain.accountKey.version);
+    s.WriteUInt8(chain.accountKey.depth);
+    s.WriteUInt32(chain.accountKey.fingerprint);
+    s.WriteUInt32(chain.accountKey.childNumber);
+    s.WriteCompactSize(chain.accountKey.chainCode.size());
+    s.WriteBytes(chain.accountKey.chainCode);
+    s.WriteCompactSize(chain.accountPubKey.size());
+    s.WriteBytes(chain.accountPubKey);
+    s.WriteBool(chain.encrypted);
+    s.WriteCompactSize(chain.accountPrivKey.size());
+    s.WriteBytes(chain.accountPrivKey);
+    s.WriteUInt32(chain.nextReceivingIndex);
+    s.WriteUInt32(chain.nextChangeIndex);
+
+    return Put(bytes{PREFIX_HD_CHAIN}, s.GetData());
+}
+
+// Addresses
+
+bool WalletDB::WriteAddress(const Address& addr, const AddressMetadata& metadata) {
+    Serializer s;
+    s.WriteString(metadata.label);
+    s.WriteUInt64(metadata.creationTime);
+    s.WriteUInt8(static_cast<uint8_t>(metadata.type));
+    s.WriteBool(metadata.isChange);
+    s.WriteBool(metadata.isMine);
+    s.WriteUInt32(metadata.derivationIndex);
+
+    return Put(MakeAddressKey(addr), s.GetData());
+}
+
+// Outputs
+
+bool WalletDB::WriteUTXO(const OutPoint& outpoint, const TxOut& txout, BlockHeight height) {
+    Serializer s;
+    txout.SerializeImpl(s);
+    s.WriteUInt32(height);
+
+    return Put(MakeOutPointKey(PREFIX_UTXO, outpoint), s.GetData());
+}
+
+bool WalletDB::EraseUTXO(const OutPoint& outpoint) {
+    return Erase(MakeOutPointKey(PREFIX_UTXO, outpoint));
+}
+
+bool WalletDB::WriteSpentOutput(const OutPoint& outpoint, const TxOut& txout,
+                                BlockHeight height, BlockHeight spentHeight) {
+    Serializer s;
+    txout.SerializeImpl(s);
+    s.WriteUInt32(height);
+    s.WriteUInt32(spentHeight);
+
+    return Put(MakeOutPointKey(PREFIX_SPENT, outpoint), s.GetData());
+}
+
+bool WalletDB::EraseSpentOutput(const OutPoint& outpoint) {
+    return Erase(MakeOutPointKey(PREFIX_SPENT, outpoint));
+}
+
+// Transactions
+
+bool WalletDB::WriteTx(const Transaction& tx, BlockHeight height, uint64_t sequence) {
+    Serializer s;
+    s.WriteUInt64(sequence);
+    s.WriteUInt32(height);
+    tx.SerializeImpl(s);
+
+    return Put(MakeTxKey(tx.GetHash()), s.GetData());
+}
+
+bool WalletDB::EraseTx(const Hash256& txHash) {
+    return Erase(MakeTxKey(txHash));
+}
+
+// Loading
+
+bool WalletDB::LoadWallet(Contents& contents) {
+    if (!IsOpen()) return false;
+
+    auto it = db->NewIterator();
+    if (!it) return false;
+
+    size_t records = 0;
+
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        bytes key = it->Key();
+        if (key.empty()) {
+            continue;
+        }
+
+        try {
+            Deserializer d(it->Value());
+
+            switch (static_cast<char>(key[0])) {
+                case PREFIX_KEY:
+                case PREFIX_CRYPTED_KEY: {
+                    if (key.size() != 1 + sizeof(Hash160)) break;
+
+                    KeyRecord record;
+                    std::copy(key.begin() + 1, key.end(), record.keyID.begin());
+                    record.pubKey = d.ReadBytes(d.ReadCompactSize());
+                    record.encrypted = (key[0] == PREFIX_CRYPTED_KEY);
+                    if (record.encrypted) {
+                        record.encryptedKey = d.ReadBytes(d.ReadCompactSize());
+                    } else {
+                        record.privKey = d.ReadHash256();
+                    }
+                    record.metadata = ReadMetadata(d);
+                    contents.keys.push_back(std::move(record));
+                    break;
+                }
+
+                case PREFIX_MASTER_KEY: {
+                    CryptoKeyStore::MasterKey masterKey;
+                    masterKey.salt = d.ReadBytes(d.ReadCompactSize());
+                    masterKey.iterations = d.ReadUInt32();
+                    masterKey.encryptedKey = d.ReadBytes(d.ReadCompactSize());
+                    contents.masterKey = std::move(masterKey);
+                    break;
+                }
+
+                case PREFIX_HD_CHAIN: {
+                    HDChain chain;
+                    chain.account = d.ReadUInt32();
+                    chain.accountKey.version = d.ReadUInt32();
+                    chain.accountKey.depth = d.ReadUInt8();
+                    chain.accountKey.fingerprint = d.ReadUInt32();
+                    chain.accountKey.childNumber = d.ReadUInt32();
+                    chain.accountKey.chainCode = d.ReadBytes(d.ReadCompactSize());
+                    chain.accountPubKey = d.ReadBytes(d.ReadCompactSize());
+                    chain.encrypted = d.ReadBool();
+                    chain.accountPrivKey = d.ReadBytes(d.ReadCompactSize());
+                    chain.nextReceivingIndex = d.ReadUInt32();
+                    chain.nextChangeIndex = d.ReadUInt32();
+                    contents.hdChain = std::move(chain);
+                    break;
+                }
+
+                case PREFIX_ADDRESS: {
+                    if (key.size() != 2 + sizeof(Hash160)) break;
+
+                    Hash160 hash;
+                    std::copy(key.begin() + 2, key.end(), hash.begin());
+                    Address addr(hash, static_cast<AddressType>(key[1]));
+                    AddressMetadata metadata;
+                    metadata.label = d.ReadString(d.ReadCompactSize());
+                    metadata.creationTime = d.ReadUInt64();
+                    metadata.type = static_cast<AddressType>(d.ReadUInt8());
+                    metadata.isChange = d.ReadBool();
+                    metadata.isMine = d.ReadBool();
+                    metadata.derivationIndex = d.ReadUInt32();
+                    contents.addresses.emplace_back(addr, metadata);
+                    break;
+                }
+
+                case PREFIX_UTXO:
+                case PREFIX_SPENT: {
+                    if (key.size() != 1 + sizeof(Hash256) + sizeof(TxOutIndex)) break;
+
+                    OutputRecord record;
+                    std::copy(key.begin() + 1, key.begin() + 1 + sizeof(Hash256),
+                              record.outpoint.txHash.begin());
+                    record.outpoint.index = 0;
+                    for (size_t i = 1 + sizeof(Hash256); i < key.size(); ++i) {
+                        record.outpoint.index = (record.outpoint.index << 8) | key[i];
+                    }
+                    record.txout.DeserializeImpl(d);
+                    record.height = d.ReadUInt32();
+                    if (key[0] == PREFIX_SPENT) {
+                        record.spentHeight = d.ReadUInt32();
+                        contents.spentOutputs.push_back(std::move(record));
+                    } else {
+                        record.spentHeight = 0;
+                        contents.utxos.push_back(std::move(record));
+                    }
+                    break;
+                }
+
+                case PREFIX_TX: {
+                    TxRecord record;
+                    record.sequence = d.ReadUInt64();
+                    record.height = d.ReadUInt32();
+                    record.tx.DeserializeImpl(d);
+                    contents.transactions.push_back(std::move(record));
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("WalletDB", "Corrupt wallet record: " + std::string(e.what()));
+            return false;
+        }
+
+        records++;
+    }
+
+    std::sort(contents.transactions.begin(), contents.transactions.end(),
+              [](const TxRecord& a, const TxRecord& b) {
+                  return a.sequence < b.sequence;
+              });
+
+    LOG_INFO("WalletDB", "Loaded " + std::to_string(records) + " wallet records");
+
+    return true;
+}
+
+} // namespace dinari
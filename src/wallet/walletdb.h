@@ -0,0 +1,208 @@
+#ifndef DINARI_WALLET_WALLETDB_H
+#define DINARI_WALLET_WALLETDB_H
+
+#include "dinari/types.h"
+#include "storage/database.h"
+#include "util/serialize.h"
+#include "core/transaction.h"
+#include "keystore.h"
+#include "hdwallet.h"
+#include "address.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace dinari {
+
+/**
+ * @brief Persistent wallet storage
+ *
+ * Stores wallet state as individual records so that every change is a
+ * small incremental write rather than a rewrite of the whole wallet:
+ * - Key ID → private key (plain or encrypted) with metadata
+ * - Address → address metadata
+ * - Outpoint → unspent wallet output
+ * - Outpoint → recently spent output (kept for reorgs)
+ * - Transaction hash → wallet transaction
+ * - HD chain state and passphrase-wrapped master key
+ *
+ * Writes made between TxnBegin() and TxnCommit() are applied as one
+ * atomic, synced batch. Outside a transaction each write is its own batch.
+ * Not thread-safe; the owning Wallet serializes access under its mutex.
+ */
+class WalletDB {
+public:
+    /**
+     * @brief Stored private key
+     */
+    struct KeyRecord {
+        Hash160 keyID;
+        bytes pubKey;
+        Hash256 privKey;        // Set when not encrypted
+        bytes encryptedKey;     // IV + ciphertext when encrypted
+        bool encrypted;
+        KeyMetadata metadata;
+
+        KeyRecord() : keyID{}, privKey{}, encrypted(false) {}
+    };
+
+    /**
+     * @brief HD account state
+     */
+    struct HDChain {
+        uint32_t account;
+        ExtendedKey accountKey;     // Header and chain code; key bytes not stored here
+        bytes accountPubKey;        // 33-byte compressed public key
+        bytes accountPrivKey;       // 32-byte key, or IV + ciphertext when encrypted
+        bool encrypted;
+        uint32_t nextReceivingIndex;
+        uint32_t nextChangeIndex;
+
+        HDChain()
+            : account(0)
+            , encrypted(false)
+            , nextReceivingIndex(0)
+            , nextChangeIndex(0) {}
+    };
+
+    /**
+     * @brief Stored wallet output
+     */
+    struct OutputRecord {
+        OutPoint outpoint;
+        TxOut txout;
+        BlockHeight height;
+        BlockHeight spentHeight;  // Only meaningful for spent outputs
+    };
+
+    /**
+     * @brief Stored wallet transaction
+     */
+    struct TxRecord {
+        Transaction tx;
+        BlockHeight height;
+        uint64_t sequence;  // Insertion order, assigned by the wallet
+    };
+
+    /**
+     * @brief Everything read back by LoadWallet()
+     */
+    struct Contents {
+        std::vector<KeyRecord> keys;
+        std::optional<CryptoKeyStore::MasterKey> masterKey;
+        std::vector<std::pair<Address, AddressMetadata>> addresses;
+        std::optional<HDChain> hdChain;
+        std::vector<OutputRecord> utxos;
+        std::vector<OutputRecord> spentOutputs;
+        std::vector<TxRecord> transactions;  // Sorted by sequence
+    };
+
+    WalletDB();
+    ~WalletDB();
+
+    /**
+     * @brief Open wallet database
+     * @param path Database directory path
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Close wallet database
+     */
+    void Close();
+
+    /**
+     * @brief Check if open
+     */
+    bool IsOpen() const { return db && db->IsOpen(); }
+
+    /**
+     * @brief Start grouping writes into one atomic batch (nestable)
+     */
+    void TxnBegin();
+
+    /**
+     * @brief Write the grouped batch once the outermost transaction ends
+     * @param sync Wait for the batch to reach disk (an unsynced batch still
+     *             survives a process crash, only not an OS crash)
+     */
+    bool TxnCommit(bool sync = true);
+
+    /**
+     * @brief Discard the grouped batch
+     */
+    void TxnAbort();
+
+    // Key records
+    bool WriteKey(const Hash160& keyID, const Key& key);
+    bool WriteCryptedKey(const Hash160& keyID, const bytes& pubKey,
+                         const bytes& encryptedKey, const KeyMetadata& metadata);
+    bool WriteMasterKey(const CryptoKeyStore::MasterKey& masterKey);
+    bool WriteHDChain(const HDChain& chain);
+
+    // Address records
+    bool WriteAddress(const Address& addr, const AddressMetadata& metadata);
+
+    // Output records
+    bool WriteUTXO(const OutPoint& outpoint, const TxOut& txout, BlockHeight height);
+    bool EraseUTXO(const OutPoint& outpoint);
+    bool WriteSpentOutput(const OutPoint& outpoint, const TxOut& txout,
+                          BlockHeight height, BlockHeight spentHeight);
+    bool EraseSpentOutput(const OutPoint& outpoint);
+
+    // Transaction records
+    bool WriteTx(const Transaction& tx, BlockHeight height, uint64_t sequence);
+    bool EraseTx(const Hash256& txHash);
+
+    /**
+     * @brief Read all wallet records
+     */
+    bool LoadWallet(Contents& contents);
+
+    /**
+     * @brief Compact database, dropping overwritten and erased records
+     */
+    void Compact();
+
+private:
+    std::unique_ptr<Database> db;
+
+    // Pending atomic batch
+    std::unique_ptr<Database::Batch> pending;
+    size_t txnDepth;
+    size_t pendingWrites;
+
+    // Compact after this many record writes
+    static constexpr uint64_t COMPACT_INTERVAL = 50000;
+    uint64_t writesSinceCompact;
+
+    // Key prefixes
+    static constexpr char PREFIX_KEY = 'k';         // k<keyID> → key
+    static constexpr char PREFIX_CRYPTED_KEY = 'c'; // c<keyID> → encrypted key
+    static constexpr char PREFIX_MASTER_KEY = 'M';  // M → wrapped master key
+    static constexpr char PREFIX_HD_CHAIN = 'D';    // D → HD chain state
+    static constexpr char PREFIX_ADDRESS = 'a';     // a<type><hash160> → metadata
+    static constexpr char PREFIX_UTXO = 'u';        // u<outpoint> → output
+    static constexpr char PREFIX_SPENT = 's';       // s<outpoint> → spent output
+    static constexpr char PREFIX_TX = 't';          // t<txhash> → transaction
+    static constexpr char PREFIX_VERSION = 'V';     // V → format version
+
+    static constexpr uint32_t WALLET_DB_VERSION = 1;
+
+    bytes MakeKeyIDKey(char prefix, const Hash160& keyID) const;
+    bytes MakeOutPointKey(char prefix, const OutPoint& outpoint) const;
+    bytes MakeTxKey(const Hash256& txHash) const;
+    bytes MakeAddressKey(const Address& addr) const;
+
+    bool Put(const bytes& key, const bytes& value);
+    bool Erase(const bytes& key);
+    void NoteWrites(size_t count);
+
+    static void WriteMetadata(Serializer& s, const KeyMetadata& metadata);
+    static KeyMetadata ReadMetadata(Deserializer& d);
+};
+
+} // namespace dinari
+
+#endif // DINARI_WALLET_WALLETDB_H
@@ -89,7 +89,7 @@ TEST(Block_GenesisCreation) {
     Block genesis = Block::CreateGenesisBlock(0, 0x1d00ffff, 0, genesisMessage);
 
     ASSERT_FALSE(genesis.transactions.empty());
-    ASSERT_TRUE(genesis.transactions[0].IsCoinbase());
+    ASSERT_TRUE(genesis.transactions[0]->IsCoinbase());
 }
 
 TEST(Block_Serialization) {
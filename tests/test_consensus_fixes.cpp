@@ -240,7 +240,7 @@ TEST(test_chain_work_accumulation) {
     genesisIndex.UpdateChainWork();
 
     auto genesisWork = genesisIndex.chainWork;
-    ASSERT_TRUE(genesisWork > 0, "Genesis should have non-zero work");
+    ASSERT_TRUE(!genesisWork.IsZero(), "Genesis should have non-zero work");
 
     // Create a second block
     Block block2;
@@ -252,7 +252,7 @@ TEST(test_chain_work_accumulation) {
 
     // Add coinbase
     Transaction coinbase = CreateCoinbaseTransaction(1, "miner", 0, GetBlockReward(1));
-    block2.transactions.push_back(coinbase);
+    block2.transactions.push_back(MakeTransactionRef(coinbase));
     block2.header.merkleRoot = block2.CalculateMerkleRoot();
 
     auto block2Ptr = std::make_shared<Block>(block2);
@@ -262,7 +262,7 @@ TEST(test_chain_work_accumulation) {
 
     // Chain work should accumulate
     ASSERT_TRUE(block2Index.chainWork > genesisWork, "Chain work should accumulate");
-    ASSERT_EQ(block2Index.chainWork, genesisWork + block2.header.GetWork(),
+    ASSERT_EQ(block2Index.chainWork, genesisWork + ChainWork(block2.header.GetWork()),
               "Chain work should equal sum of block work");
 
     std::cout << "✓ Chain work accumulates correctly\n";
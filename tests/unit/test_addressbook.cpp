@@ -0,0 +1,80 @@
+/**
+ * @file test_addressbook.cpp
+ * @brief Unit tests for the address book ownership index
+ */
+
+#include "wallet/address.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+
+namespace {
+
+Hash160 MakeHash(byte seed) {
+    Hash160 hash{};
+    for (size_t i = 0; i < hash.size(); ++i) {
+        hash[i] = static_cast<byte>(seed + i);
+    }
+    return hash;
+}
+
+void AddMine(AddressBook& book, const Address& addr) {
+    AddressMetadata metadata;
+    metadata.type = addr.GetType();
+    metadata.isMine = true;
+    ASSERT_TRUE(book.AddAddress(addr, metadata));
+}
+
+bool ScriptIsMine(const AddressBook& book, const bytes& script) {
+    Hash160 hash;
+    AddressType type;
+    return AddressGenerator::ExtractScriptHash(script, hash, type) && book.IsMineHash(hash, type);
+}
+
+} // namespace
+
+TEST(AddressBookTest, KeyHashDoesNotMatchScriptHash) {
+    AddressBook book;
+    Hash160 keyHash = MakeHash(1);
+    AddMine(book, Address(keyHash, AddressType::P2PKH));
+
+    EXPECT_TRUE(book.IsMineHash(keyHash, AddressType::P2PKH));
+    EXPECT_TRUE(book.IsMineHash(keyHash, AddressType::P2PK));
+    EXPECT_FALSE(book.IsMineHash(keyHash, AddressType::P2SH));
+
+    bytes p2pkh = AddressGenerator::GenerateScriptPubKey(Address(keyHash, AddressType::P2PKH));
+    bytes p2sh = AddressGenerator::GenerateScriptPubKey(Address(keyHash, AddressType::P2SH));
+    EXPECT_TRUE(ScriptIsMine(book, p2pkh));
+    EXPECT_FALSE(ScriptIsMine(book, p2sh));
+}
+
+TEST(AddressBookTest, ScriptHashDoesNotMatchKeyHash) {
+    AddressBook book;
+    Hash160 scriptHash = MakeHash(2);
+    AddMine(book, Address(scriptHash, AddressType::P2SH));
+
+    EXPECT_TRUE(book.IsMineHash(scriptHash, AddressType::P2SH));
+    EXPECT_FALSE(book.IsMineHash(scriptHash, AddressType::P2PKH));
+    EXPECT_FALSE(book.IsMineHash(scriptHash, AddressType::P2PK));
+}
+
+TEST(AddressBookTest, OwnershipFollowsIsMineAndRemoval) {
+    AddressBook book;
+    Hash160 hash = MakeHash(3);
+    Address p2pkh(hash, AddressType::P2PKH);
+    Address p2sh(hash, AddressType::P2SH);
+    AddMine(book, p2pkh);
+    AddMine(book, p2sh);
+
+    auto owned = book.GetMyHashes();
+    EXPECT_EQ(owned.size(), 2u);
+    EXPECT_TRUE(owned.count(AddressBook::OwnershipKey(hash, AddressType::P2PK)) > 0);
+
+    ASSERT_TRUE(book.RemoveAddress(p2sh));
+    EXPECT_FALSE(book.IsMineHash(hash, AddressType::P2SH));
+    EXPECT_TRUE(book.IsMineHash(hash, AddressType::P2PKH));
+
+    ASSERT_TRUE(book.SetIsMine(p2pkh, false));
+    EXPECT_FALSE(book.IsMineHash(hash, AddressType::P2PKH));
+    EXPECT_TRUE(book.GetMyHashes().empty());
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_base58.cpp
+ * @brief Unit tests for Base58 and Base58Check
+ */
+
+#include "crypto/base58.h"
+#include "crypto/hex.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace dinari;
+using namespace dinari::crypto;
+
+namespace {
+
+bytes FromHex(const std::string& hex) {
+    bytes result;
+    EXPECT_TRUE(Hex::Decode(hex, result));
+    return result;
+}
+
+// Textbook digit-by-byte conversion, as a reference for the limb codec
+std::string ReferenceEncode(const bytes& data) {
+    const char* alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    size_t zeros = 0;
+    while (zeros < data.size() && data[zeros] == 0) {
+        ++zeros;
+    }
+
+    std::vector<int> digits;
+    for (size_t i = zeros; i < data.size(); ++i) {
+        int carry = data[i];
+        for (int& digit : digits) {
+            carry += 256 * digit;
+            digit = carry % 58;
+            carry /= 58;
+        }
+        while (carry) {
+            digits.push_back(carry % 58);
+            carry /= 58;
+        }
+    }
+
+    std::string result(zeros, '1');
+    for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+        result += alphabet[*it];
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(Base58Test, KnownVectors) {
+    const std::pair<const char*, const char*> vectors[] = {
+        {"", ""},
+        {"61", "2g"},
+        {"626262", "a3gV"},
+        {"636363", "aPEr"},
+        {"73696d706c792061206c6f6e6720737472696e67", "2cFupjhnEsSn59qHXstmK2ffpLv2"},
+        {"00eb15231dfceb60925886b67d065299925915aeb172c06647", "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L"},
+        {"516b6fcd0f", "ABnLTmg"},
+        {"bf4f89001e670274dd", "3SEo3LWLoPntC"},
+        {"572e4794", "3EFU7m"},
+        {"ecac89cad93923c02321", "EJDM8drfXA6uyA"},
+        {"10c8511e", "Rt5zm"},
+        {"00000000000000000000", "1111111111"},
+    };
+
+    for (const auto& vector : vectors) {
+        bytes data = FromHex(vector.first);
+        EXPECT_EQ(Base58::Encode(data), vector.second);
+        EXPECT_EQ(Base58::Decode(vector.second), data);
+    }
+
+    EXPECT_TRUE(Base58::Decode("3EFU0m").empty());  // '0' is not in the alphabet
+}
+
+TEST(Base58Test, MatchesReferenceAcrossLengths) {
+    std::mt19937 rng(58);
+    for (size_t len = 0; len <= 80; ++len) {
+        for (size_t zeros = 0; zeros <= 2 && zeros <= len; ++zeros) {
+            bytes data(len);
+            for (size_t i = zeros; i < len; ++i) {
+                data[i] = static_cast<byte>(rng());
+            }
+
+            std::string encoded = Base58::Encode(data);
+            ASSERT_EQ(encoded, ReferenceEncode(data));
+            ASSERT_LE(encoded.size(), Base58::MaxEncodedSize(len));
+            ASSERT_EQ(Base58::Decode(encoded), data);
+        }
+    }
+}
+
+TEST(Base58Test, AddressRoundTripAndChecksum) {
+    Hash160 hash;
+    for (size_t i = 0; i < hash.size(); ++i) {
+        hash[i] = static_cast<byte>(0xa0 + i);
+    }
+
+    std::string address = Base58::EncodeAddress(hash, 0x1e);
+    EXPECT_LE(address.size(), Base58::MAX_ADDRESS_LENGTH);
+
+    Hash160 decoded;
+    byte version = 0;
+    ASSERT_TRUE(Base58::DecodeAddress(address, decoded, version));
+    EXPECT_EQ(decoded, hash);
+    EXPECT_EQ(version, 0x1e);
+
+    std::string corrupt = address;
+    corrupt[5] = corrupt[5] == 'x' ? 'y' : 'x';
+    EXPECT_FALSE(Base58::DecodeAddress(corrupt, decoded, version));
+}
@@ -0,0 +1,112 @@
+/**
+ * @file test_blockindex.cpp
+ * @brief Unit tests for BlockIndex skip pointers and chain navigation
+ */
+
+#include "blockchain/blockchain.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace dinari;
+
+namespace {
+
+// Random tree: mostly extends recent blocks, sometimes forks from deep history
+class BlockIndexTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(71);
+        for (uint32_t i = 0; i < 5000; ++i) {
+            BlockIndex* parent = nullptr;
+            if (!tree.empty()) {
+                size_t pick = rng() % 8 == 0 ? rng() % tree.size()
+                                             : tree.size() - 1 - rng() % std::min<size_t>(tree.size(), 4);
+                parent = tree[pick];
+            }
+
+            auto block = std::make_shared<Block>();
+            block->header.nonce = i;
+            block->header.prevBlockHash = parent ? parent->GetBlockHash() : Hash256{};
+
+            BlockIndex* index = arena.Allocate(block, parent ? parent->height + 1 : 0);
+            index->prev = parent;
+            index->BuildSkip();
+            tree.push_back(index);
+        }
+    }
+
+    static const BlockIndex* NaiveAncestor(const BlockIndex* block, BlockHeight height) {
+        if (height > block->height) {
+            return nullptr;
+        }
+        while (block->height > height) {
+            block = block->prev;
+        }
+        return block;
+    }
+
+    static const BlockIndex* NaiveFork(const BlockIndex* a, const BlockIndex* b) {
+        while (a->height > b->height) a = a->prev;
+        while (b->height > a->height) b = b->prev;
+        while (a != b) {
+            a = a->prev;
+            b = b->prev;
+        }
+        return a;
+    }
+
+    static std::vector<Hash256> NaiveLocator(const BlockIndex* block) {
+        std::vector<Hash256> locator;
+        BlockHeight step = 1;
+        while (block) {
+            locator.push_back(block->GetBlockHash());
+            if (block->height == 0) {
+                break;
+            }
+            BlockHeight target = block->height > step ? block->height - step : 0;
+            block = NaiveAncestor(block, target);
+            if (locator.size() > 10) {
+                step *= 2;
+            }
+        }
+        return locator;
+    }
+
+    BlockIndexArena arena;
+    std::vector<BlockIndex*> tree;
+};
+
+} // namespace
+
+TEST_F(BlockIndexTreeTest, GetAncestorMatchesPrevWalk) {
+    std::mt19937 rng(1);
+    for (const BlockIndex* block : tree) {
+        EXPECT_EQ(block->GetAncestor(block->height), block);
+        EXPECT_EQ(block->GetAncestor(block->height + 1), nullptr);
+        for (int i = 0; i < 8; ++i) {
+            BlockHeight height = rng() % (block->height + 1);
+            ASSERT_EQ(block->GetAncestor(height), NaiveAncestor(block, height))
+                << "height " << height << " from " << block->height;
+        }
+    }
+}
+
+TEST_F(BlockIndexTreeTest, FindForkMatchesPrevWalk) {
+    Blockchain chain;
+    std::mt19937 rng(2);
+    for (int i = 0; i < 20000; ++i) {
+        const BlockIndex* a = tree[rng() % tree.size()];
+        const BlockIndex* b = tree[rng() % tree.size()];
+        ASSERT_EQ(chain.FindFork(a, b), NaiveFork(a, b));
+    }
+    EXPECT_EQ(chain.FindFork(tree.back(), nullptr), nullptr);
+}
+
+TEST_F(BlockIndexTreeTest, GetBlockLocatorMatchesPrevWalk) {
+    Blockchain chain;
+    for (size_t i = 0; i < tree.size(); i += 7) {
+        auto locator = chain.GetBlockLocator(tree[i]);
+        ASSERT_EQ(locator, NaiveLocator(tree[i]));
+        EXPECT_EQ(locator.back(), tree[0]->GetBlockHash());
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_blockstore.cpp
+ * @brief Unit tests for block store pruning
+ */
+
+#include "storage/blockstore.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace dinari;
+
+namespace {
+
+class BlockStorePruneTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dataDir = testing::TempDir() + "dinari_test_blockstore_" +
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(dataDir);
+        ASSERT_TRUE(store.Open(dataDir));
+
+        Hash256 prevHash{};
+        for (BlockHeight h = 0; h < BLOCKS; ++h) {
+            Block block;
+            block.header.prevBlockHash = prevHash;
+            block.header.timestamp = 1700000000 + h;
+            block.header.nonce = h;
+            ASSERT_TRUE(store.WriteBlock(block, h));
+            hashes.push_back(block.GetHash());
+            prevHash = block.GetHash();
+        }
+    }
+
+    void TearDown() override {
+        store.Close();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    static constexpr BlockHeight BLOCKS = 50;
+
+    std::string dataDir;
+    BlockStore store;
+    std::vector<Hash256> hashes;
+};
+
+} // namespace
+
+TEST_F(BlockStorePruneTest, TracksBodySize) {
+    uint64_t size = store.GetBlockDataSize();
+    EXPECT_GT(size, 0u);
+
+    // Rewriting a height replaces its body rather than adding to it
+    Block block;
+    block.header.nonce = 1;
+    ASSERT_TRUE(store.WriteBlock(block, BLOCKS - 1));
+    EXPECT_EQ(store.GetBlockDataSize(), size);
+
+    ASSERT_TRUE(store.DeleteBlock(BLOCKS - 1));
+    EXPECT_LT(store.GetBlockDataSize(), size);
+}
+
+TEST_F(BlockStorePruneTest, PrunesOldestBodiesToTarget) {
+    uint64_t perBlock = store.GetBlockDataSize() / BLOCKS;
+
+    ASSERT_TRUE(store.PruneToTarget(perBlock * 20, BLOCKS - 1));
+    EXPECT_EQ(store.GetPruneHeight(), BLOCKS - 20);
+    EXPECT_LE(store.GetBlockDataSize(), perBlock * 20);
+
+    // Bodies below the prune height are gone; headers and hashes stay
+    for (BlockHeight h = 0; h < BLOCKS; ++h) {
+        EXPECT_EQ(store.ReadBlock(h).has_value(), h >= store.GetPruneHeight());
+        auto header = store.ReadHeader(h);
+        ASSERT_TRUE(header.has_value());
+        EXPECT_EQ(header->GetHash(), hashes[h]);
+        EXPECT_EQ(store.GetBlockHeight(hashes[h]), h);
+    }
+}
+
+TEST_F(BlockStorePruneTest, KeepsBlocksAboveLastPrunable) {
+    ASSERT_TRUE(store.PruneToTarget(0, 9));
+    EXPECT_EQ(store.GetPruneHeight(), 10u);
+    EXPECT_TRUE(store.ReadBlock(10).has_value());
+}
+
+TEST_F(BlockStorePruneTest, PruneStateSurvivesReopen) {
+    ASSERT_TRUE(store.PruneToTarget(0, 29));
+    uint64_t size = store.GetBlockDataSize();
+
+    store.Close();
+    BlockStore reopened;
+    ASSERT_TRUE(reopened.Open(dataDir));
+    EXPECT_EQ(reopened.GetPruneHeight(), 30u);
+    EXPECT_EQ(reopened.GetBlockDataSize(), size);
+    EXPECT_EQ(reopened.ReadHeader(5)->GetHash(), hashes[5]);
+    reopened.Close();
+}
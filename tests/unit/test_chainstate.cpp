@@ -0,0 +1,84 @@
+/**
+ * @file test_chainstate.cpp
+ * @brief Unit tests for chain state rebuilt from a persistent data directory
+ */
+
+#include "chaingen.h"
+#include "blockchain/blockchain.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+class ChainStateTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        ChainGenParams params;
+        params.blocks = 20;
+        params.txsPerBlock = 10;
+        chain = new GeneratedChain(ChainGenerator::Generate(params));
+    }
+
+    static void TearDownTestSuite() {
+        delete chain;
+        chain = nullptr;
+    }
+
+    void SetUp() override {
+        dataDir = testing::TempDir() + "dinari_test_chainstate_" +
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dataDir);
+    }
+
+    std::unique_ptr<Blockchain> Open() const {
+        auto blockchain = std::make_unique<Blockchain>();
+        EXPECT_TRUE(blockchain->Initialize(chain->genesis, dataDir));
+        return blockchain;
+    }
+
+    static GeneratedChain* chain;
+    std::string dataDir;
+};
+
+GeneratedChain* ChainStateTest::chain = nullptr;
+
+} // namespace
+
+TEST_F(ChainStateTest, ReloadKeepsUTXOCommitmentAndStats) {
+    Hash256 commitment;
+    UTXOSet::Stats stats;
+    BlockHeight height;
+    {
+        auto blockchain = Open();
+        for (const auto& block : chain->blocks) {
+            ASSERT_TRUE(blockchain->AcceptBlock(block));
+        }
+        height = blockchain->GetHeight();
+        commitment = blockchain->GetUTXOSet().GetCommitment();
+        stats = blockchain->GetUTXOSet().GetStats(height);
+    }
+
+    // Coinbases from the funding blocks must still be counted as coinbases
+    ASSERT_GT(stats.coinbaseUTXOs, 0u);
+    ASSERT_GT(stats.immatureUTXOs, 0u);
+
+    auto reloaded = Open();
+    ASSERT_EQ(reloaded->GetHeight(), height);
+    EXPECT_EQ(reloaded->GetUTXOSet().GetCommitment(), commitment);
+
+    UTXOSet::Stats reloadedStats = reloaded->GetUTXOSet().GetStats(height);
+    EXPECT_EQ(reloadedStats.totalUTXOs, stats.totalUTXOs);
+    EXPECT_EQ(reloadedStats.totalValue, stats.totalValue);
+    EXPECT_EQ(reloadedStats.coinbaseUTXOs, stats.coinbaseUTXOs);
+    EXPECT_EQ(reloadedStats.regularUTXOs, stats.regularUTXOs);
+    EXPECT_EQ(reloadedStats.matureUTXOs, stats.matureUTXOs);
+    EXPECT_EQ(reloadedStats.immatureUTXOs, stats.immatureUTXOs);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file test_chainwork.cpp
+ * @brief Unit tests for fixed-width chain work
+ */
+
+#include "blockchain/chainwork.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace dinari;
+using boost::multiprecision::uint256_t;
+
+namespace {
+
+uint256_t RandomValue(std::mt19937_64& rng, int limbs) {
+    uint256_t value = 0;
+    for (int i = 0; i < limbs; ++i) {
+        value <<= 64;
+        // Mix in all-ones limbs so carries cross limb boundaries
+        value |= (rng() % 4 == 0) ? ~uint64_t(0) : rng();
+    }
+    return value;
+}
+
+} // namespace
+
+TEST(ChainWorkTest, MatchesBigIntArithmetic) {
+    std::mt19937_64 rng(256);
+    for (int i = 0; i < 2000; ++i) {
+        uint256_t a = RandomValue(rng, 1 + i % 4);
+        uint256_t b = RandomValue(rng, 1 + (i / 4) % 4);
+
+        ChainWork workA(a);
+        ChainWork workB(b);
+        ASSERT_EQ(workA.ToBigInt(), a);
+        ASSERT_EQ((workA + workB).ToBigInt(), uint256_t(a + b));
+        ASSERT_EQ(workA < workB, a < b);
+        ASSERT_EQ(workA > workB, a > b);
+        ASSERT_EQ(workA == workB, a == b);
+    }
+}
+
+TEST(ChainWorkTest, Formatting) {
+    ChainWork work(uint256_t(0x100010001ULL));
+    EXPECT_EQ(work.ToString(), "4295032833");
+    EXPECT_EQ(work.ToHex(), std::string(55, '0') + "100010001");
+    EXPECT_TRUE(ChainWork().IsZero());
+    EXPECT_FALSE(work.IsZero());
+}
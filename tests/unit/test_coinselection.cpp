@@ -0,0 +1,122 @@
+/**
+ * @file test_coinselection.cpp
+ * @brief Unit tests for branch-and-bound coin selection
+ */
+
+#include "core/utxo.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+
+using namespace dinari;
+
+namespace {
+
+std::vector<CoinSelector::Candidate> MakeCandidates(const std::vector<Amount>& values,
+                                                    Amount feeRate) {
+    std::vector<CoinSelector::Candidate> candidates;
+    for (size_t i = 0; i < values.size(); ++i) {
+        Hash256 txHash{};
+        txHash[0] = static_cast<uint8_t>(i);
+        txHash[1] = static_cast<uint8_t>(i >> 8);
+        candidates.push_back(CoinSelector::MakeCandidate(OutPoint(txHash, 0),
+                                                         TxOut(values[i], bytes{}), feeRate));
+    }
+    return candidates;
+}
+
+Amount SelectedValue(const CoinSelector::SelectionResult& result,
+                     const std::vector<CoinSelector::Candidate>& candidates) {
+    Amount total = 0;
+    for (const auto& outpoint : result.selected) {
+        for (const auto& candidate : candidates) {
+            if (candidate.outpoint == outpoint) {
+                total += candidate.value;
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+TEST(CoinSelectionTest, BranchAndBound_ExactMatch) {
+    CoinSelector selector;
+    auto candidates = MakeCandidates({1 * COIN, 3 * COIN, 7 * COIN, 12 * COIN, 20 * COIN}, 0);
+
+    auto result = selector.SelectCoins(10 * COIN, 0, candidates);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.selected.size(), 2u);
+    EXPECT_EQ(result.totalValue, 10 * COIN);
+    EXPECT_EQ(SelectedValue(result, candidates), 10 * COIN);
+    EXPECT_EQ(result.change, 0);
+    EXPECT_EQ(result.fee, 0);
+}
+
+TEST(CoinSelectionTest, BranchAndBound_ExactMatchCoversFees) {
+    const Amount feeRate = 1000;  // 1 satoshi per byte
+    const Amount inputFee = CoinSelector::CalculateFee(CoinSelector::INPUT_SIZE, feeRate);
+    const Amount baseFee = CoinSelector::CalculateFee(
+        CoinSelector::EstimateTransactionSize(0, 1), feeRate);
+
+    // Two coins whose effective values add up to exactly the payment plus base fee
+    CoinSelector selector;
+    auto candidates = MakeCandidates({4 * COIN + inputFee, 6 * COIN + inputFee + baseFee,
+                                      50 * COIN, 3 * COIN}, feeRate);
+
+    auto result = selector.SelectCoins(10 * COIN, feeRate, candidates);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.selected.size(), 2u);
+    EXPECT_EQ(result.change, 0);
+    EXPECT_EQ(result.fee, 2 * inputFee + baseFee);
+    EXPECT_EQ(result.totalValue, 10 * COIN + result.fee);
+}
+
+TEST(CoinSelectionTest, BranchAndBound_NoSolutionFallsBack) {
+    const Amount feeRate = 1000;
+
+    // Any subset overshoots 15 coins by far more than the cost of change
+    CoinSelector selector;
+    auto candidates = MakeCandidates({10 * COIN, 10 * COIN, 10 * COIN}, feeRate);
+
+    auto result = selector.SelectCoins(15 * COIN, feeRate, candidates);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.selected.size(), 2u);
+    EXPECT_EQ(result.totalValue, 20 * COIN);
+    EXPECT_GT(result.change, 0);
+    EXPECT_EQ(result.totalValue, 15 * COIN + result.fee + result.change);
+}
+
+TEST(CoinSelectionTest, BranchAndBound_InsufficientFunds) {
+    CoinSelector selector;
+    auto candidates = MakeCandidates({1 * COIN, 2 * COIN}, 1000);
+
+    auto result = selector.SelectCoins(5 * COIN, 1000, candidates);
+
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.selected.empty());
+}
+
+TEST(CoinSelectionTest, BranchAndBound_IterationCap) {
+    // Even values can never hit an odd target exactly, and with no fee
+    // there is no slack, so only BNB_MAX_TRIES stops an exponential search
+    std::vector<Amount> values;
+    for (Amount i = 1; i <= 200; ++i) {
+        values.push_back(2 * i * 1000);
+    }
+    Amount target = 0;
+    for (Amount value : values) {
+        target += value;
+    }
+    target = target / 2 + 1;
+
+    CoinSelector selector;
+    auto candidates = MakeCandidates(values, 0);
+    auto result = selector.SelectCoins(target, 0, candidates);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.change, 0);
+    EXPECT_GE(SelectedValue(result, candidates), target);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_hdwallet.cpp
+ * @brief Unit tests for BIP32 key derivation against the BIP32 test vectors
+ */
+
+#include "wallet/hdwallet.h"
+#include "crypto/hex.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+
+namespace {
+
+struct VectorStep {
+    const char* path;
+    const char* xpub;
+    const char* xprv;
+};
+
+bytes FromHex(const std::string& hex) {
+    bytes result;
+    EXPECT_TRUE(crypto::Hex::Decode(hex, result));
+    return result;
+}
+
+void CheckVector(const std::string& seedHex, const std::vector<VectorStep>& steps) {
+    HDWallet wallet;
+    ASSERT_TRUE(wallet.SetSeed(FromHex(seedHex)));
+
+    for (const auto& step : steps) {
+        SCOPED_TRACE(step.path);
+
+        ExtendedKey key;
+        ASSERT_TRUE(wallet.DerivePath(step.path, key));
+        EXPECT_EQ(key.Serialize(), step.xprv);
+        EXPECT_EQ(HDWallet::GetExtendedPublicKey(key).Serialize(), step.xpub);
+
+        // Deserializing gives back the same key
+        ExtendedKey parsed;
+        ASSERT_TRUE(parsed.Deserialize(step.xprv));
+        EXPECT_EQ(parsed.key, key.key);
+        EXPECT_EQ(parsed.chainCode, key.chainCode);
+    }
+}
+
+} // namespace
+
+TEST(HDWalletTest, Vector1) {
+    CheckVector("000102030405060708090a0b0c0d0e0f", {
+        {"m",
+         "xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ29ESFjqJoCu1Rupje8YtGqsefD265TMg7usUDFdp6W1EGMcet8",
+         "xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNKmPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi"},
+        {"m/0'",
+         "xpub68Gmy5EdvgibQVfPdqkBBCHxA5htiqg55crXYuXoQRKfDBFA1WEjWgP6LHhwBZeNK1VTsfTFUHCdrfp1bgwQ9xv5ski8PX9rL2dZXvgGDnw",
+         "xprv9uHRZZhk6KAJC1avXpDAp4MDc3sQKNxDiPvvkX8Br5ngLNv1TxvUxt4cV1rGL5hj6KCesnDYUhd7oWgT11eZG7XnxHrnYeSvkzY7d2bhkJ7"},
+        {"m/0'/1",
+         "xpub6ASuArnXKPbfEwhqN6e3mwBcDTgzisQN1wXN9BJcM47sSikHjJf3UFHKkNAWbWMiGj7Wf5uMash7SyYq527Hqck2AxYysAA7xmALppuCkwQ",
+         "xprv9wTYmMFdV23N2TdNG573QoEsfRrWKQgWeibmLntzniatZvR9BmLnvSxqu53Kw1UmYPxLgboyZQaXwTCg8MSY3H2EU4pWcQDnRnrVA1xe8fs"},
+        {"m/0'/1/2'",
+         "xpub6D4BDPcP2GT577Vvch3R8wDkScZWzQzMMUm3PWbmWvVJrZwQY4VUNgqFJPMM3No2dFDFGTsxxpG5uJh7n7epu4trkrX7x7DogT5Uv6fcLW5",
+         "xprv9z4pot5VBttmtdRTWfWQmoH1taj2axGVzFqSb8C9xaxKymcFzXBDptWmT7FwuEzG3ryjH4ktypQSAewRiNMjANTtpgP4mLTj34bhnZX7UiM"},
+        {"m/0'/1/2'/2",
+         "xpub6FHa3pjLCk84BayeJxFW2SP4XRrFd1JYnxeLeU8EqN3vDfZmbqBqaGJAyiLjTAwm6ZLRQUMv1ZACTj37sR62cfN7fe5JnJ7dh8zL4fiyLHV",
+         "xprvA2JDeKCSNNZky6uBCviVfJSKyQ1mDYahRjijr5idH2WwLsEd4Hsb2Tyh8RfQMuPh7f7RtyzTtdrbdqqsunu5Mm3wDvUAKRHSC34sJ7in334"},
+        {"m/0'/1/2'/2/1000000000",
+         "xpub6H1LXWLaKsWFhvm6RVpEL9P4KfRZSW7abD2ttkWP3SSQvnyA8FSVqNTEcYFgJS2UaFcxupHiYkro49S8yGasTvXEYBVPamhGW6cFJodrTHy",
+         "xprvA41z7zogVVwxVSgdKUHDy1SKmdb533PjDz7J6N6mV6uS3ze1ai8FHa8kmHScGpWmj4WggLyQjgPie1rFSruoUihUZREPSL39UNdE3BBDu76"},
+    });
+}
+
+TEST(HDWalletTest, Vector2) {
+    CheckVector("fffcf9f6f3f0edeae7e4e1dedbd8d5d2cfccc9c6c3c0bdbab7b4b1aeaba8a5a2"
+                "9f9c999693908d8a8784817e7b7875726f6c696663605d5a5754514e4b484542", {
+        {"m",
+         "xpub661MyMwAqRbcFW31YEwpkMuc5THy2PSt5bDMsktWQcFF8syAmRUapSCGu8ED9W6oDMSgv6Zz8idoc4a6mr8BDzTJY47LJhkJ8UB7WEGuduB",
+         "xprv9s21ZrQH143K31xYSDQpPDxsXRTUcvj2iNHm5NUtrGiGG5e2DtALGdso3pGz6ssrdK4PFmM8NSpSBHNqPqm55Qn3LqFtT2emdEXVYsCzC2U"},
+        {"m/0",
+         "xpub69H7F5d8KSRgmmdJg2KhpAK8SR3DjMwAdkxj3ZuxV27CprR9LgpeyGmXUbC6wb7ERfvrnKZjXoUmmDznezpbZb7ap6r1D3tgFxHmwMkQTPH",
+         "xprv9vHkqa6EV4sPZHYqZznhT2NPtPCjKuDKGY38FBWLvgaDx45zo9WQRUT3dKYnjwih2yJD9mkrocEZXo1ex8G81dwSM1fwqWpWkeS3v86pgKt"},
+        {"m/0/2147483647'",
+         "xpub6ASAVgeehLbnwdqV6UKMHVzgqAG8Gr6riv3Fxxpj8ksbH9ebxaEyBLZ85ySDhKiLDBrQSARLq1uNRts8RuJiHjaDMBU4Zn9h8LZNnBC5y4a",
+         "xprv9wSp6B7kry3Vj9m1zSnLvN3xH8RdsPP1Mh7fAaR7aRLcQMKTR2vidYEeEg2mUCTAwCd6vnxVrcjfy2kRgVsFawNzmjuHc2YmYRmagcEPdU9"},
+        {"m/0/2147483647'/1",
+         "xpub6DF8uhdarytz3FWdA8TvFSvvAh8dP3283MY7p2V4SeE2wyWmG5mg5EwVvmdMVCQcoNJxGoWaU9DCWh89LojfZ537wTfunKau47EL2dhHKon",
+         "xprv9zFnWC6h2cLgpmSA46vutJzBcfJ8yaJGg8cX1e5StJh45BBciYTRXSd25UEPVuesF9yog62tGAQtHjXajPPdbRCHuWS6T8XA2ECKADdw4Ef"},
+        {"m/0/2147483647'/1/2147483646'",
+         "xpub6ERApfZwUNrhLCkDtcHTcxd75RbzS1ed54G1LkBUHQVHQKqhMkhgbmJbZRkrgZw4koxb5JaHWkY4ALHY2grBGRjaDMzQLcgJvLJuZZvRcEL",
+         "xprvA1RpRA33e1JQ7ifknakTFpgNXPmW2YvmhqLQYMmrj4xJXXWYpDPS3xz7iAxn8L39njGVyuoseXzU6rcxFLJ8HFsTjSyQbLYnMpCqE2VbFWc"},
+        {"m/0/2147483647'/1/2147483646'/2",
+         "xpub6FnCn6nSzZAw5Tw7cgR9bi15UV96gLZhjDstkXXxvCLsUXBGXPdSnLFbdpq8p9HmGsApME5hQTZ3emM2rnY5agb9rXpVGyy3bdW6EEgAtqt",
+         "xprvA2nrNbFZABcdryreWet9Ea4LvTJcGsqrMzxHx98MMrotbir7yrKCEXw7nadnHM8Dq38EGfSh6dqA9QWTyefMLEcBYJUuekgW4BYPJcr9E7j"},
+    });
+}
+
+TEST(HDWalletTest, PublicDerivationMatchesPrivate) {
+    HDWallet wallet;
+    ASSERT_TRUE(wallet.SetSeed(FromHex("000102030405060708090a0b0c0d0e0f")));
+
+    ExtendedKey parent;
+    ASSERT_TRUE(wallet.DerivePath("m/0'/1", parent));
+    ExtendedKey parentPub = HDWallet::GetExtendedPublicKey(parent);
+
+    for (uint32_t index : {0u, 1u, 2u, 1000000000u}) {
+        ExtendedKey privChild;
+        ExtendedKey pubChild;
+        ASSERT_TRUE(HDWallet::DeriveChildPrivate(parent, index, privChild));
+        ASSERT_TRUE(HDWallet::DeriveChildPublic(parentPub, index, pubChild));
+        EXPECT_EQ(HDWallet::GetExtendedPublicKey(privChild).Serialize(), pubChild.Serialize());
+    }
+
+    // Hardened children cannot come from a public parent
+    ExtendedKey child;
+    EXPECT_FALSE(HDWallet::DeriveChildPublic(parentPub, HDWallet::HardenIndex(0), child));
+}
@@ -0,0 +1,52 @@
+/**
+ * @file test_hex.cpp
+ * @brief Unit tests for hex encoding
+ */
+
+#include "crypto/hex.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+using namespace dinari::crypto;
+
+TEST(HexTest, RoundTripAcrossKernelBoundaries) {
+    // Lengths straddle the 16- and 32-byte vector blocks and their tails
+    for (size_t len = 0; len <= 100; ++len) {
+        bytes data(len);
+        for (size_t i = 0; i < len; ++i) {
+            data[i] = static_cast<byte>(i * 37 + len);
+        }
+
+        std::string hex = Hex::Encode(data);
+        ASSERT_EQ(hex.size(), 2 * len);
+        for (size_t i = 0; i < len; ++i) {
+            const char* digits = "0123456789abcdef";
+            ASSERT_EQ(hex[2 * i], digits[data[i] >> 4]);
+            ASSERT_EQ(hex[2 * i + 1], digits[data[i] & 0x0f]);
+        }
+
+        bytes decoded;
+        ASSERT_TRUE(Hex::Decode(hex, decoded));
+        EXPECT_EQ(decoded, data);
+    }
+}
+
+TEST(HexTest, DecodeAcceptsUppercaseAndRejectsInvalid) {
+    bytes decoded;
+    ASSERT_TRUE(Hex::Decode("00FFaB10", decoded));
+    EXPECT_EQ(decoded, (bytes{0x00, 0xff, 0xab, 0x10}));
+
+    EXPECT_FALSE(Hex::Decode("abc", decoded));
+
+    // Bad characters inside a vector block and in the scalar tail
+    std::string hex(128, 'a');
+    for (size_t pos : {0u, 17u, 40u, 63u, 100u, 127u}) {
+        for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\x80', '\xff'}) {
+            std::string corrupt = hex;
+            corrupt[pos] = bad;
+            EXPECT_FALSE(Hex::Decode(corrupt, decoded)) << "pos " << pos << " char " << int(bad);
+        }
+    }
+
+    EXPECT_NE(std::string(Hex::Implementation()), "");
+}
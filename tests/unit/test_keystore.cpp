@@ -0,0 +1,94 @@
+/**
+ * @file test_keystore.cpp
+ * @brief Unit tests for master key wrapping in the encrypted key store
+ */
+
+#include "wallet/keystore.h"
+#include "crypto/ecdsa.h"
+#include <gtest/gtest.h>
+#include <optional>
+
+using namespace dinari;
+
+namespace {
+
+class CryptoKeyStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        privKey[31] = 0x2A;
+        pubKey = crypto::ECDSA::GetPublicKey(privKey, true);
+        keyID = crypto::Hash::ComputeHash160(pubKey);
+        ASSERT_TRUE(store.AddKey(Key(privKey, pubKey)));
+    }
+
+    // The stored private key, or nullopt if it cannot be read
+    std::optional<Hash256> ReadKey(const CryptoKeyStore& keystore) const {
+        Key key;
+        if (!keystore.GetKey(keyID, key)) {
+            return std::nullopt;
+        }
+        return key.privKey;
+    }
+
+    Hash256 privKey{};
+    bytes pubKey;
+    Hash160 keyID;
+    CryptoKeyStore store;
+};
+
+} // namespace
+
+TEST_F(CryptoKeyStoreTest, WrongPassphraseIsRejected) {
+    ASSERT_TRUE(store.EncryptWallet("correct horse"));
+    EXPECT_FALSE(store.EncryptWallet("again"));
+
+    store.Lock();
+    EXPECT_TRUE(store.IsLocked());
+    EXPECT_FALSE(ReadKey(store).has_value());
+
+    EXPECT_FALSE(store.Unlock("wrong horse"));
+    EXPECT_FALSE(store.Unlock(""));
+    EXPECT_TRUE(store.IsLocked());
+
+    ASSERT_TRUE(store.Unlock("correct horse"));
+    EXPECT_EQ(ReadKey(store), privKey);
+}
+
+TEST_F(CryptoKeyStoreTest, ChangePassphraseRewrapsMasterKey) {
+    ASSERT_TRUE(store.EncryptWallet("old passphrase"));
+    CryptoKeyStore::MasterKey before = store.GetMasterKey();
+    std::map<Hash160, bytes> encryptedBefore = store.GetEncryptedKeys();
+
+    EXPECT_FALSE(store.ChangePassphrase("not it", "new passphrase"));
+    EXPECT_FALSE(store.ChangePassphrase("old passphrase", ""));
+    ASSERT_TRUE(store.ChangePassphrase("old passphrase", "new passphrase"));
+
+    // Only the master key wrapping changes, never the per-key ciphertexts
+    CryptoKeyStore::MasterKey after = store.GetMasterKey();
+    EXPECT_NE(after.salt, before.salt);
+    EXPECT_NE(after.encryptedKey, before.encryptedKey);
+    EXPECT_EQ(store.GetEncryptedKeys(), encryptedBefore);
+
+    store.Lock();
+    EXPECT_FALSE(store.Unlock("old passphrase"));
+    ASSERT_TRUE(store.Unlock("new passphrase"));
+    EXPECT_EQ(ReadKey(store), privKey);
+}
+
+TEST_F(CryptoKeyStoreTest, ReloadedStoreUnlocksWithRewrappedKey) {
+    ASSERT_TRUE(store.EncryptWallet("first"));
+    ASSERT_TRUE(store.ChangePassphrase("first", "second"));
+
+    // Rebuild from what the wallet database would hold
+    CryptoKeyStore loaded;
+    loaded.SetMasterKey(store.GetMasterKey());
+    for (const auto& pair : store.GetEncryptedKeys()) {
+        ASSERT_TRUE(loaded.AddEncryptedKey(pair.first, pubKey, pair.second, KeyMetadata()));
+    }
+
+    EXPECT_TRUE(loaded.IsLocked());
+    EXPECT_FALSE(ReadKey(loaded).has_value());
+    EXPECT_FALSE(loaded.Unlock("first"));
+    ASSERT_TRUE(loaded.Unlock("second"));
+    EXPECT_EQ(ReadKey(loaded), privKey);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file test_logger.cpp
+ * @brief Unit tests for the asynchronous logger
+ */
+
+#include "util/logger.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace dinari;
+
+namespace {
+
+int evaluations = 0;
+
+std::string Expensive() {
+    ++evaluations;
+    return "expensive";
+}
+
+} // namespace
+
+TEST(LoggerTest, DisabledLevelSkipsArguments) {
+    Logger::Instance().SetConsoleOutput(false);
+    Logger::Instance().SetLevel(LogLevel::WARNING);
+
+    evaluations = 0;
+    LOG_DEBUG("Test", Expensive());
+    LOG_INFO_STREAM("Test") << Expensive();
+    EXPECT_EQ(evaluations, 0);
+
+    LOG_WARNING("Test", Expensive());
+    EXPECT_EQ(evaluations, 1);
+}
+
+TEST(LoggerTest, ConcurrentRecordsReachBinaryLog) {
+    std::string textPath = testing::TempDir() + "dinari_test_logger.log";
+    std::string binaryPath = testing::TempDir() + "dinari_test_logger.bin";
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+
+    Logger& logger = Logger::Instance();
+    logger.Initialize(textPath, LogLevel::INFO);
+    logger.SetConsoleOutput(false);
+    ASSERT_TRUE(logger.OpenBinaryLog(binaryPath));
+
+    // More records than the ring holds, so producers must wait for the writer
+    const int threads = 4;
+    const int perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t]() {
+            for (int i = 0; i < perThread; ++i) {
+                LOG_INFO("T" + std::to_string(t), std::to_string(i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    logger.Close();
+
+    std::vector<LogRecord> records;
+    ASSERT_TRUE(Logger::ReadBinaryLog(binaryPath, records));
+    ASSERT_EQ(records.size(), static_cast<size_t>(threads * perThread));
+
+    // Each producer's records stay in order
+    std::vector<int> next(threads, 0);
+    for (const auto& record : records) {
+        int t = std::stoi(record.category.substr(1));
+        EXPECT_EQ(record.level, LogLevel::INFO);
+        EXPECT_EQ(std::stoi(record.message), next[t]);
+        ++next[t];
+    }
+
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_merkle.cpp
+ * @brief Unit tests for multi-lane double SHA-256 and merkle root computation
+ */
+
+#include "crypto/hash.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace dinari::crypto;
+
+namespace {
+
+// Merkle root by one MerkleHash call per pair, as a reference
+dinari::Hash256 NaiveMerkleRoot(std::vector<dinari::Hash256> level) {
+    while (level.size() > 1) {
+        std::vector<dinari::Hash256> parents;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            const auto& right = i + 1 < level.size() ? level[i + 1] : level[i];
+            parents.push_back(Hash::MerkleHash(level[i], right));
+        }
+        level.swap(parents);
+    }
+    return level[0];
+}
+
+} // namespace
+
+TEST(MerkleTest, DoubleSHA256_64_MatchesScalar) {
+    // Enough inputs to cover every SIMD width plus a scalar tail
+    std::vector<uint8_t> input(64 * 37);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    std::vector<uint8_t> output(32 * 37);
+    Hash::DoubleSHA256_64(output.data(), input.data(), 37);
+
+    for (size_t i = 0; i < 37; ++i) {
+        auto expected = Hash::DoubleSHA256(input.data() + 64 * i, 64);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.begin() + 32 * i))
+            << "input " << i << " using " << Hash::DoubleSHA256_64Implementation();
+    }
+}
+
+TEST(MerkleTest, MerkleRoot_OddLevels) {
+    std::vector<dinari::Hash256> hashes;
+    for (int i = 0; i < 5; ++i) {
+        hashes.push_back(Hash::SHA256("tx" + std::to_string(i)));
+    }
+
+    // Odd nodes are paired with themselves at every level
+    auto h01 = Hash::MerkleHash(hashes[0], hashes[1]);
+    auto h23 = Hash::MerkleHash(hashes[2], hashes[3]);
+    auto h44 = Hash::MerkleHash(hashes[4], hashes[4]);
+    auto h0123 = Hash::MerkleHash(h01, h23);
+    auto h4444 = Hash::MerkleHash(h44, h44);
+
+    EXPECT_EQ(Hash::ComputeMerkleRoot(hashes), Hash::MerkleHash(h0123, h4444));
+}
+
+TEST(MerkleTest, MerkleRoot_LargeLevelsMatchNaive) {
+    // Large enough that the leaf level is split across threads
+    std::vector<dinari::Hash256> hashes;
+    for (int i = 0; i < 20001; ++i) {
+        hashes.push_back(Hash::SHA256("tx" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(Hash::ComputeMerkleRoot(hashes), NaiveMerkleRoot(hashes));
+
+    // Every size around the lane widths and the odd-node duplication
+    for (size_t count = 2; count <= 40; ++count) {
+        std::vector<dinari::Hash256> prefix(hashes.begin(), hashes.begin() + count);
+        EXPECT_EQ(Hash::ComputeMerkleRoot(prefix), NaiveMerkleRoot(prefix)) << count << " leaves";
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for the metrics registry and Prometheus export
+ */
+
+#include "util/metrics.h"
+#include "rpc/metricsserver.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace dinari;
+
+TEST(MetricsTest, CounterSumsAcrossThreads) {
+    Counter& counter = Metrics::Instance().GetCounter(
+        "test_counter_total", "Test counter", "case=\"threads\"");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.Inc();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.Value(), 80000u);
+    EXPECT_EQ(&counter, &Metrics::Instance().GetCounter(
+        "test_counter_total", "Test counter", "case=\"threads\""));
+    EXPECT_THROW(Metrics::Instance().GetGauge("test_counter_total", "Wrong type"),
+                 std::invalid_argument);
+}
+
+TEST(MetricsTest, HistogramBucketsAndExport) {
+    Histogram& histogram = Metrics::Instance().GetHistogram(
+        "test_latency_seconds", "Test histogram", "", {0.1, 1.0});
+
+    histogram.Observe(0.05);
+    histogram.Observe(0.1);
+    histogram.Observe(0.5);
+    histogram.Observe(5.0);
+
+    Histogram::Snapshot snapshot = histogram.GetSnapshot();
+    ASSERT_EQ(snapshot.bucketCounts.size(), 3u);
+    EXPECT_EQ(snapshot.bucketCounts[0], 2u);
+    EXPECT_EQ(snapshot.bucketCounts[1], 1u);
+    EXPECT_EQ(snapshot.bucketCounts[2], 1u);
+    EXPECT_EQ(snapshot.count, 4u);
+    EXPECT_DOUBLE_EQ(snapshot.sum, 5.65);
+
+    std::string text = Metrics::Instance().RenderPrometheus();
+    EXPECT_NE(text.find("# TYPE test_latency_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"0.1\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"1\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count 4\n"), std::string::npos);
+}
+
+TEST(MetricsTest, ServerRoutesRequests) {
+    std::string ok = MetricsServer::HandleHTTPRequest("GET /metrics HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ok.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+
+    std::string missing = MetricsServer::HandleHTTPRequest("GET / HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(missing.rfind("HTTP/1.1 404", 0), 0u);
+
+    std::string post = MetricsServer::HandleHTTPRequest("POST /metrics HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(post.rfind("HTTP/1.1 405", 0), 0u);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_muhash.cpp
+ * @brief Unit tests for MuHash and the UTXO set's running totals
+ */
+
+#include "crypto/muhash.h"
+#include "core/utxo.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+using crypto::MuHash3072;
+
+namespace {
+
+bytes Element(uint8_t tag) {
+    return bytes(40, tag);
+}
+
+Transaction MakeCoinbase(uint32_t tag) {
+    Transaction tx;
+    tx.inputs.emplace_back(OutPoint());
+    tx.inputs[0].scriptSig = bytes{static_cast<byte>(tag), static_cast<byte>(tag >> 8)};
+    tx.outputs.emplace_back(50 * COIN, bytes(25, 0x01));
+    return tx;
+}
+
+} // namespace
+
+TEST(MuHashTest, OrderIndependent) {
+    MuHash3072 a;
+    a.Insert(Element(1)).Insert(Element(2)).Insert(Element(3));
+
+    MuHash3072 b;
+    b.Insert(Element(3)).Insert(Element(1)).Insert(Element(2));
+
+    EXPECT_EQ(a.Finalize(), b.Finalize());
+    EXPECT_NE(a.Finalize(), MuHash3072().Finalize());
+}
+
+TEST(MuHashTest, RemoveUndoesInsert) {
+    MuHash3072 a;
+    a.Insert(Element(1)).Insert(Element(2)).Remove(Element(1));
+
+    MuHash3072 b;
+    b.Insert(Element(2));
+    EXPECT_EQ(a.Finalize(), b.Finalize());
+
+    MuHash3072 c;
+    c.Remove(Element(7)).Insert(Element(7));
+    EXPECT_EQ(c.Finalize(), MuHash3072().Finalize());
+}
+
+TEST(MuHashTest, CombineIsUnion) {
+    MuHash3072 a;
+    a.Insert(Element(1));
+    MuHash3072 b;
+    b.Insert(Element(2)).Remove(Element(3));
+    a *= b;
+
+    MuHash3072 all;
+    all.Insert(Element(2)).Insert(Element(1)).Remove(Element(3));
+    EXPECT_EQ(a.Finalize(), all.Finalize());
+}
+
+TEST(UTXOSetTotalsTest, TrackApplyAndRevert) {
+    UTXOSet utxos;
+    Hash256 emptyCommitment = utxos.GetCommitment();
+
+    Transaction coinbase = MakeCoinbase(1);
+    ASSERT_TRUE(utxos.ApplyTransaction(coinbase, 1));
+
+    Transaction spend;
+    spend.inputs.emplace_back(OutPoint(coinbase.GetHash(), 0));
+    spend.outputs.emplace_back(20 * COIN, bytes(25, 0x02));
+    spend.outputs.emplace_back(29 * COIN, bytes(25, 0x03));
+    ASSERT_TRUE(utxos.ApplyTransaction(spend, 2));
+
+    auto stats = utxos.GetStats(2);
+    EXPECT_EQ(stats.totalUTXOs, 2u);
+    EXPECT_EQ(stats.totalValue, 49 * COIN);
+    EXPECT_EQ(stats.coinbaseUTXOs, 0u);
+    EXPECT_EQ(stats.regularUTXOs, 2u);
+    EXPECT_EQ(utxos.GetTotalValue(), 49 * COIN);
+
+    // The commitment depends only on the coins, not how they got there
+    UTXOSet rebuilt;
+    rebuilt.AddUTXOs(utxos.GetAllUTXOs());
+    EXPECT_EQ(rebuilt.GetCommitment(), utxos.GetCommitment());
+
+    std::map<OutPoint, UTXOEntry> previous;
+    previous[OutPoint(coinbase.GetHash(), 0)] = UTXOEntry(coinbase.outputs[0], 1, true);
+    ASSERT_TRUE(utxos.RevertTransaction(spend, previous));
+
+    stats = utxos.GetStats(2);
+    EXPECT_EQ(stats.totalUTXOs, 1u);
+    EXPECT_EQ(stats.totalValue, 50 * COIN);
+    EXPECT_EQ(stats.coinbaseUTXOs, 1u);
+    EXPECT_EQ(stats.immatureUTXOs, 1u);
+
+    ASSERT_TRUE(utxos.RemoveUTXO(OutPoint(coinbase.GetHash(), 0)));
+    EXPECT_EQ(utxos.GetCommitment(), emptyCommitment);
+    EXPECT_EQ(utxos.GetTotalValue(), 0u);
+}
+
+TEST(UTXOSetTotalsTest, MaturitySplit) {
+    UTXOSet utxos;
+    for (uint32_t h = 0; h < 150; ++h) {
+        ASSERT_TRUE(utxos.ApplyTransaction(MakeCoinbase(h), h));
+    }
+
+    // Coinbases from heights 50..149 are still immature at height 149
+    auto stats = utxos.GetStats(149);
+    EXPECT_EQ(stats.immatureUTXOs, COINBASE_MATURITY);
+    EXPECT_EQ(stats.matureUTXOs, 150u - COINBASE_MATURITY);
+
+    utxos.Clear();
+    EXPECT_EQ(utxos.GetStats(149).immatureUTXOs, 0u);
+    EXPECT_EQ(utxos.GetCommitment(), UTXOSet().GetCommitment());
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_serialize.cpp
+ * @brief Unit tests for binary serialization
+ */
+
+#include "util/serialize.h"
+#include "core/transaction.h"
+#include "blockchain/block.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+
+namespace {
+
+Transaction MakeTransaction() {
+    Transaction tx;
+    TxIn input;
+    input.prevOut = OutPoint(Hash256{{1, 2, 3}}, 7);
+    input.scriptSig = bytes(107, 0x42);
+    tx.inputs.push_back(input);
+
+    TxOut output;
+    output.value = 5000;
+    output.scriptPubKey = bytes(25, 0x76);
+    tx.outputs.push_back(output);
+    tx.outputs.push_back(output);
+    return tx;
+}
+
+} // namespace
+
+TEST(SerializeTest, IntegerRoundTrip) {
+    Serializer s;
+    s.WriteUInt8(0xAB);
+    s.WriteUInt16(0x1234);
+    s.WriteUInt32(0xDEADBEEF);
+    s.WriteUInt64(0x0102030405060708ULL);
+    s.WriteInt32(-5);
+    s.WriteBool(true);
+
+    EXPECT_EQ(s.Size(), 1u + 2 + 4 + 8 + 4 + 1);
+
+    Deserializer d(s.GetData());
+    EXPECT_EQ(d.ReadUInt8(), 0xAB);
+    EXPECT_EQ(d.ReadUInt16(), 0x1234);
+    EXPECT_EQ(d.ReadUInt32(), 0xDEADBEEFu);
+    EXPECT_EQ(d.ReadUInt64(), 0x0102030405060708ULL);
+    EXPECT_EQ(d.ReadInt32(), -5);
+    EXPECT_TRUE(d.ReadBool());
+    EXPECT_FALSE(d.Available());
+}
+
+TEST(SerializeTest, CompactSizeEncoding) {
+    const uint64_t values[] = {0, 0xFC, 0xFD, 0xFFFF, 0x10000, 0xFFFFFFFFULL, 0x100000000ULL};
+
+    for (uint64_t value : values) {
+        Serializer s;
+        s.WriteCompactSize(value);
+        EXPECT_EQ(s.Size(), Serializer::GetCompactSizeSize(value));
+
+        Deserializer d(s.GetData());
+        EXPECT_EQ(d.ReadCompactSize(), value);
+    }
+}
+
+TEST(SerializeTest, ReadPastEndThrows) {
+    bytes data = {0x01, 0x02};
+    Deserializer d(data);
+    EXPECT_THROW(d.ReadUInt32(), std::runtime_error);
+    EXPECT_THROW(d.ReadSpan(3), std::runtime_error);
+}
+
+TEST(SerializeTest, SpanReadsInPlace) {
+    bytes data = {0x03, 0xAA, 0xBB, 0xCC, 0xDD};
+    Deserializer d(data);
+
+    uint64_t len = d.ReadCompactSize();
+    ByteSpan span = d.ReadSpan(len);
+
+    EXPECT_EQ(span.data(), data.data() + 1);
+    EXPECT_EQ(span.size(), 3u);
+    EXPECT_EQ(span.ToBytes(), bytes({0xAA, 0xBB, 0xCC}));
+    EXPECT_EQ(d.Remaining(), 1u);
+}
+
+TEST(SerializeTest, SizeComputerStoresNothing) {
+    Transaction tx = MakeTransaction();
+
+    Serializer counter = Serializer::SizeComputer();
+    tx.SerializeImpl(counter);
+
+    EXPECT_TRUE(counter.GetData().empty());
+    EXPECT_EQ(counter.Size(), Serialize(tx).size());
+    EXPECT_EQ(tx.GetSize(), Serialize(tx).size());
+    EXPECT_EQ(tx.outputs[0].GetSize(), 8u + 1 + 25);
+}
+
+TEST(SerializeTest, AppendsToCallerBuffer) {
+    bytes buffer = {0xFF};
+    Serializer s(buffer);
+    s.WriteUInt32(1);
+    s.WriteString("dinari");
+
+    EXPECT_EQ(s.Size(), 4u + 1 + 6);
+    EXPECT_EQ(buffer.size(), 1u + s.Size());
+    EXPECT_EQ(buffer[0], 0xFF);
+
+    s.Clear();
+    EXPECT_EQ(buffer.size(), 1u);
+}
+
+TEST(SerializeTest, TransactionRoundTrip) {
+    Transaction tx = MakeTransaction();
+    bytes data = Serialize(tx);
+
+    Transaction decoded = Deserialize<Transaction>(data);
+    EXPECT_EQ(decoded.GetHash(), tx.GetHash());
+    EXPECT_EQ(decoded.inputs[0].scriptSig, tx.inputs[0].scriptSig);
+    EXPECT_EQ(decoded.outputs.size(), 2u);
+}
+
+TEST(SerializeTest, DeserializeCachesHashAndSize) {
+    Transaction tx = MakeTransaction();
+    bytes data = Serialize(tx);
+
+    Transaction decoded = Deserialize<Transaction>(data);
+    EXPECT_TRUE(decoded.hashCached);
+    EXPECT_EQ(decoded.cachedHash, crypto::Hash::DoubleSHA256(data));
+    EXPECT_EQ(decoded.GetSize(), data.size());
+
+    // Shared handles carry the cache from construction
+    TransactionRef ref = MakeTransactionRef(tx);
+    EXPECT_TRUE(ref->hashCached);
+    EXPECT_EQ(ref->GetHash(), decoded.GetHash());
+}
+
+TEST(SerializeTest, BlockSizeMatchesSerialization) {
+    Block block;
+    block.transactions.push_back(MakeTransactionRef(MakeTransaction()));
+
+    Serializer s;
+    block.SerializeImpl(s);
+
+    EXPECT_EQ(block.GetSerializedSize(), s.Size());
+
+    Serializer header;
+    block.header.SerializeImpl(header);
+    EXPECT_EQ(header.Size(), BlockHeader::HEADER_SIZE);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_sighash.cpp
+ * @brief Unit tests for signature hashes and parallel input signing
+ */
+
+#include "core/transaction.h"
+#include "core/script.h"
+#include "crypto/hash.h"
+#include "wallet/wallet.h"
+#include <gtest/gtest.h>
+
+using namespace dinari;
+
+namespace {
+
+// Signature hash by full re-serialization, as computed before
+// PrecomputedSignatureHash was introduced
+Hash256 ReferenceSignatureHash(const Transaction& tx, size_t inputIndex,
+                               const bytes& scriptCode, uint32_t hashType) {
+    Serializer s;
+
+    s.WriteUInt32(tx.version);
+    s.WriteCompactSize(tx.inputs.size());
+
+    for (size_t i = 0; i < tx.inputs.size(); ++i) {
+        tx.inputs[i].prevOut.SerializeImpl(s);
+
+        if (i == inputIndex) {
+            s.WriteCompactSize(scriptCode.size());
+            s.WriteBytes(scriptCode);
+        } else {
+            s.WriteCompactSize(0);
+        }
+
+        s.WriteUInt32(tx.inputs[i].sequence);
+    }
+
+    s.WriteCompactSize(tx.outputs.size());
+    for (const auto& output : tx.outputs) {
+        output.SerializeImpl(s);
+    }
+
+    s.WriteUInt32(tx.lockTime);
+    s.WriteUInt32(hashType);
+
+    return crypto::Hash::DoubleSHA256(s.GetData());
+}
+
+Transaction MakeTx(size_t numInputs, size_t numOutputs) {
+    Transaction tx;
+    tx.version = 2;
+    tx.lockTime = 12345;
+    for (size_t i = 0; i < numInputs; ++i) {
+        Hash256 prevHash{};
+        prevHash[0] = static_cast<byte>(i);
+        prevHash[31] = static_cast<byte>(i * 7 + 1);
+        // Scripts already present on the inputs must not leak into the hash
+        tx.inputs.push_back(TxIn(OutPoint(prevHash, static_cast<TxOutIndex>(i % 3)),
+                                 bytes(i * 11, static_cast<byte>(i)),
+                                 0xFFFFFFFF - static_cast<uint32_t>(i)));
+    }
+    for (size_t i = 0; i < numOutputs; ++i) {
+        tx.outputs.push_back(TxOut(1000 * (i + 1), bytes(25, static_cast<byte>(0xA0 + i))));
+    }
+    return tx;
+}
+
+} // namespace
+
+TEST(SignatureHashTest, MatchesFullReserialization) {
+    // Script lengths straddle the one-byte and three-byte CompactSize encodings
+    const std::vector<size_t> scriptLengths = {0, 1, 25, 252, 253, 300, 70000};
+    const std::vector<uint32_t> hashTypes = {1, 2, 3, 0x81};
+
+    for (size_t numInputs : {1u, 2u, 5u, 260u}) {
+        Transaction tx = MakeTx(numInputs, 3);
+        PrecomputedSignatureHash precomputed(tx);
+
+        for (size_t inputIndex : {size_t{0}, numInputs / 2, numInputs - 1}) {
+            for (size_t length : scriptLengths) {
+                bytes scriptCode(length, static_cast<byte>(length & 0xFF));
+                for (uint32_t hashType : hashTypes) {
+                    SCOPED_TRACE("inputs " + std::to_string(numInputs) + " index " +
+                                 std::to_string(inputIndex) + " script " +
+                                 std::to_string(length) + " type " + std::to_string(hashType));
+
+                    Hash256 expected = ReferenceSignatureHash(tx, inputIndex, scriptCode, hashType);
+                    EXPECT_EQ(precomputed.GetSignatureHash(inputIndex, scriptCode, hashType), expected);
+                    EXPECT_EQ(tx.GetSignatureHash(inputIndex, scriptCode, hashType), expected);
+                }
+            }
+        }
+    }
+}
+
+TEST(SignatureHashTest, OutOfRangeIndexLeavesEveryScriptEmpty) {
+    Transaction tx = MakeTx(4, 2);
+    PrecomputedSignatureHash precomputed(tx);
+    bytes scriptCode(25, 0x76);
+
+    for (size_t inputIndex : {size_t{4}, size_t{100}, SIZE_MAX}) {
+        Hash256 expected = ReferenceSignatureHash(tx, inputIndex, scriptCode, 1);
+        EXPECT_EQ(precomputed.GetSignatureHash(inputIndex, scriptCode, 1), expected);
+        EXPECT_EQ(tx.GetSignatureHash(inputIndex, scriptCode, 1), expected);
+    }
+
+    // The script code plays no part once the index is out of range
+    EXPECT_EQ(precomputed.GetSignatureHash(4, scriptCode, 1),
+              precomputed.GetSignatureHash(4, bytes(), 1));
+}
+
+TEST(SignatureHashTest, ParallelSignedInputsVerify) {
+    // Several keys, and enough inputs that signing is spread over threads
+    BasicKeyStore keystore;
+    std::vector<Address> addresses;
+    for (byte k = 1; k <= 5; ++k) {
+        Hash256 privKey{};
+        privKey[31] = k;
+        ASSERT_TRUE(keystore.AddKeyFromPrivate(privKey));
+        addresses.push_back(AddressGenerator::GenerateP2PKH(crypto::ECDSA::GetPublicKey(privKey, true)));
+    }
+
+    WalletTransactionBuilder builder;
+    builder.SetFeeRate(1);
+
+    std::vector<TxOut> prevOuts;
+    for (size_t i = 0; i < 70; ++i) {
+        Hash256 prevHash{};
+        prevHash[0] = static_cast<byte>(i);
+        prevHash[1] = 0x5A;
+        TxOut prevOut(100000 + i,
+                      AddressGenerator::GenerateScriptPubKey(addresses[i % addresses.size()]));
+        builder.AddInput(OutPoint(prevHash, static_cast<TxOutIndex>(i % 2)), prevOut);
+        prevOuts.push_back(prevOut);
+    }
+    builder.AddOutput(addresses[0], 1000000);
+    builder.SetChangeAddress(addresses[1]);
+
+    Transaction tx;
+    Amount fee = 0;
+    ASSERT_TRUE(builder.Build(tx, fee));
+    ASSERT_TRUE(builder.Sign(tx, keystore));
+
+    ASSERT_EQ(tx.inputs.size(), prevOuts.size());
+    for (size_t i = 0; i < tx.inputs.size(); ++i) {
+        SCOPED_TRACE("input " + std::to_string(i));
+        ASSERT_FALSE(tx.inputs[i].scriptSig.empty());
+        EXPECT_TRUE(VerifyScript(tx.inputs[i].scriptSig, prevOuts[i].scriptPubKey, tx, i));
+    }
+
+    // A signature does not carry over to another input
+    EXPECT_FALSE(VerifyScript(tx.inputs[0].scriptSig, prevOuts[5].scriptPubKey, tx, 5));
+}
@@ -0,0 +1,53 @@
+/**
+ * @file test_trace.cpp
+ * @brief Unit tests for scoped tracing
+ */
+
+#include "util/trace.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace dinari;
+
+TEST(TraceTest, SpansFromThreadsReachChromeJSON) {
+    Tracer& tracer = Tracer::Instance();
+    tracer.Clear();
+
+    std::thread worker([&tracer]() {
+        tracer.SetThreadName("worker");
+        TraceScope scope("Worker::Run");
+    });
+    worker.join();
+
+    {
+        TraceScope outer("Test::Outer");
+        TraceScope inner("Test::Inner");
+    }
+
+    EXPECT_EQ(tracer.GetEventCount(), 3u);
+
+    std::string json = tracer.DumpChromeJSON();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"Worker::Run\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Test::Outer\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Test::Inner\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+}
+
+TEST(TraceTest, RingKeepsMostRecentSpans) {
+    Tracer& tracer = Tracer::Instance();
+    tracer.Clear();
+
+    for (size_t i = 0; i < TRACE_BUFFER_CAPACITY; ++i) {
+        tracer.Record("Old", i, i + 1);
+    }
+    tracer.Record("New", TRACE_BUFFER_CAPACITY, TRACE_BUFFER_CAPACITY + 1);
+
+    EXPECT_EQ(tracer.GetEventCount(), TRACE_BUFFER_CAPACITY);
+
+    // The oldest span was overwritten and the newest is dumped last
+    std::string json = tracer.DumpChromeJSON();
+    EXPECT_EQ(json.find("\"ts\":0.000,"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"New\""), std::string::npos);
+    EXPECT_GT(json.find("\"name\":\"New\""), json.rfind("\"name\":\"Old\""));
+}
@@ -0,0 +1,116 @@
+/**
+ * @file test_utxosnapshot.cpp
+ * @brief Unit tests for UTXO set snapshot files
+ */
+
+#include "storage/utxosnapshot.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace dinari;
+
+namespace {
+
+class UTXOSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = testing::TempDir() + "dinari_test_utxosnapshot_" +
+               testing::UnitTest::GetInstance()->current_test_info()->name();
+
+        Hash256 prevHash{};
+        for (uint32_t h = 0; h < 10; ++h) {
+            BlockHeader header;
+            header.prevBlockHash = prevHash;
+            header.timestamp = 1700000000 + h;
+            header.nonce = h;
+            headers.push_back(header);
+            prevHash = header.GetHash();
+        }
+
+        // Enough coins for several chunks, several outputs per transaction
+        for (uint32_t i = 0; i < UTXOSnapshot::COINS_PER_CHUNK * 2 + 100; ++i) {
+            Hash256 txHash{};
+            txHash[0] = static_cast<byte>((i / 3) & 0xFF);
+            txHash[1] = static_cast<byte>(((i / 3) >> 8) & 0xFF);
+            txHash[2] = static_cast<byte>(((i / 3) >> 16) & 0xFF);
+            TxOut output(1000 + i, bytes(25, static_cast<byte>(i & 0xFF)));
+            coins.emplace_back(OutPoint(txHash, i % 3), UTXOEntry(output, i % 10, i % 7 == 0));
+        }
+
+        metadata.networkMagic = MAINNET_MAGIC;
+        metadata.baseBlockHash = headers.back().GetHash();
+        metadata.baseHeight = 9;
+        metadata.moneySupply = 123456789;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+    std::vector<BlockHeader> headers;
+    std::vector<SnapshotCoin> coins;
+    UTXOSnapshotMetadata metadata;
+};
+
+} // namespace
+
+TEST_F(UTXOSnapshotTest, RoundTrip) {
+    std::vector<SnapshotCoin> written = coins;
+    ASSERT_TRUE(UTXOSnapshot::Write(path, metadata, headers, written));
+    EXPECT_EQ(metadata.coinCount, coins.size());
+
+    UTXOSnapshotMetadata readMetadata;
+    std::vector<BlockHeader> readHeaders;
+    std::vector<SnapshotCoin> readCoins;
+    ASSERT_TRUE(UTXOSnapshot::Read(path, readMetadata, readHeaders, readCoins));
+
+    EXPECT_EQ(readMetadata.networkMagic, metadata.networkMagic);
+    EXPECT_EQ(readMetadata.baseBlockHash, metadata.baseBlockHash);
+    EXPECT_EQ(readMetadata.baseHeight, metadata.baseHeight);
+    EXPECT_EQ(readMetadata.moneySupply, metadata.moneySupply);
+    EXPECT_EQ(readMetadata.commitment, metadata.commitment);
+
+    ASSERT_EQ(readHeaders.size(), headers.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        EXPECT_EQ(readHeaders[i].GetHash(), headers[i].GetHash());
+    }
+
+    // Coins come back sorted by outpoint with every field intact
+    ASSERT_EQ(readCoins.size(), written.size());
+    for (size_t i = 0; i < readCoins.size(); ++i) {
+        EXPECT_EQ(readCoins[i].first, written[i].first);
+        EXPECT_EQ(readCoins[i].second.output, written[i].second.output);
+        EXPECT_EQ(readCoins[i].second.height, written[i].second.height);
+        EXPECT_EQ(readCoins[i].second.isCoinbase, written[i].second.isCoinbase);
+        if (i > 0) {
+            EXPECT_TRUE(readCoins[i - 1].first < readCoins[i].first);
+        }
+    }
+}
+
+TEST_F(UTXOSnapshotTest, RejectsCorruption) {
+    ASSERT_TRUE(UTXOSnapshot::Write(path, metadata, headers, coins));
+    auto size = std::filesystem::file_size(path);
+
+    // Flip one byte in the middle of the coin data
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(size / 2));
+        char c = 0;
+        file.read(&c, 1);
+        file.seekp(static_cast<std::streamoff>(size / 2));
+        c = static_cast<char>(c ^ 0x01);
+        file.write(&c, 1);
+    }
+
+    UTXOSnapshotMetadata readMetadata;
+    std::vector<BlockHeader> readHeaders;
+    std::vector<SnapshotCoin> readCoins;
+    EXPECT_FALSE(UTXOSnapshot::Read(path, readMetadata, readHeaders, readCoins));
+
+    // A truncated file is rejected too
+    std::filesystem::resize_file(path, size - 1);
+    EXPECT_FALSE(UTXOSnapshot::Read(path, readMetadata, readHeaders, readCoins));
+}
@@ -0,0 +1,202 @@
+/**
+ * @file test_walletbalance.cpp
+ * @brief Unit tests for the wallet's running balance buckets
+ */
+
+#include "wallet/wallet.h"
+#include "blockchain/block.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+using namespace dinari;
+
+namespace {
+
+class WalletBalanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        WalletConfig config;
+        config.dataDir = testing::TempDir() + "dinari_test_walletbalance_" +
+                         testing::UnitTest::GetInstance()->current_test_info()->name();
+        config.useHDWallet = false;
+        dataDir = config.dataDir;
+        std::filesystem::remove_all(dataDir);
+        std::filesystem::create_directories(dataDir);
+
+        wallet = std::make_unique<Wallet>(config);
+        ASSERT_TRUE(wallet->Initialize());
+
+        Hash256 privKey{};
+        privKey[31] = 0x56;
+        ASSERT_TRUE(wallet->ImportPrivateKey(privKey));
+        script = AddressGenerator::GenerateScriptPubKey(
+            AddressGenerator::GenerateP2PKH(crypto::ECDSA::GetPublicKey(privKey, true)));
+    }
+
+    void TearDown() override {
+        wallet.reset();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    // Block at `height` whose coinbase pays the wallet, plus an optional
+    // regular payment to the wallet
+    Block MakeBlock(BlockHeight height, Amount coinbaseValue, Amount paymentValue = 0) {
+        Transaction coinbase;
+        coinbase.inputs.push_back(TxIn(OutPoint(), bytes{0x02, static_cast<byte>(height),
+                                                         static_cast<byte>(height >> 8)}));
+        coinbase.outputs.push_back(TxOut(coinbaseValue, script));
+
+        Block block;
+        block.transactions.push_back(MakeTransactionRef(coinbase));
+        coins.push_back({height, coinbaseValue, true});
+
+        if (paymentValue > 0) {
+            Hash256 prevHash{};
+            prevHash[0] = static_cast<byte>(height);
+            prevHash[1] = static_cast<byte>(height >> 8);
+            prevHash[2] = 0xF0;
+            Transaction payment;
+            payment.inputs.push_back(TxIn(OutPoint(prevHash, 0)));
+            payment.outputs.push_back(TxOut(paymentValue, script));
+            block.transactions.push_back(MakeTransactionRef(payment));
+            coins.push_back({height, paymentValue, false});
+        }
+
+        return block;
+    }
+
+    // Balances recomputed from scratch for every coin the wallet holds
+    void ExpectBalances(BlockHeight tip) {
+        SCOPED_TRACE("tip " + std::to_string(tip));
+
+        Amount confirmed = 0;
+        Amount immature = 0;
+        for (const auto& coin : coins) {
+            if (coin.height > tip) {
+                continue;
+            }
+            if (coin.coinbase && coin.height + COINBASE_MATURITY > tip) {
+                immature += coin.value;
+            } else {
+                confirmed += coin.value;
+            }
+        }
+
+        EXPECT_EQ(wallet->GetAvailableBalance(), confirmed);
+        EXPECT_EQ(wallet->GetImmatureBalance(), immature);
+        EXPECT_EQ(wallet->GetBalance(), confirmed + immature + wallet->GetUnconfirmedBalance());
+    }
+
+    struct Coin {
+        BlockHeight height;
+        Amount value;
+        bool coinbase;
+    };
+
+    std::string dataDir;
+    std::unique_ptr<Wallet> wallet;
+    bytes script;
+    std::vector<Coin> coins;
+};
+
+} // namespace
+
+TEST_F(WalletBalanceTest, CoinbaseMaturesAtTheBoundary) {
+    wallet->BlockConnected(MakeBlock(1, 50 * COIN), 1);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 50 * COIN);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 0);
+
+    wallet->SetChainHeight(COINBASE_MATURITY);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 50 * COIN);
+
+    wallet->SetChainHeight(COINBASE_MATURITY + 1);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 0);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 50 * COIN);
+
+    // A shorter chain makes it immature again
+    wallet->SetChainHeight(COINBASE_MATURITY);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 50 * COIN);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 0);
+}
+
+TEST_F(WalletBalanceTest, HeightChangesRebucketOnlyCrossedHeights) {
+    const BlockHeight tip = 60;
+    for (BlockHeight h = 1; h <= tip; ++h) {
+        Amount payment = (h % 3 == 0) ? h * 1000 : 0;
+        wallet->BlockConnected(MakeBlock(h, 50 * COIN + h, payment), h);
+    }
+    ExpectBalances(tip);
+
+    // Step forward one height at a time, then jump, then step back down
+    for (BlockHeight h = tip + 1; h <= tip + COINBASE_MATURITY + 5; ++h) {
+        wallet->SetChainHeight(h);
+        ExpectBalances(h);
+    }
+    for (BlockHeight h : {BlockHeight(500), BlockHeight(tip + 20), BlockHeight(1000),
+                          BlockHeight(COINBASE_MATURITY + 30), BlockHeight(tip)}) {
+        wallet->SetChainHeight(h);
+        ExpectBalances(h);
+    }
+}
+
+TEST_F(WalletBalanceTest, ReorgRemovesDisconnectedCoinbases) {
+    std::vector<Block> blocks;
+    const BlockHeight tip = COINBASE_MATURITY + 10;
+    for (BlockHeight h = 1; h <= tip; ++h) {
+        blocks.push_back(MakeBlock(h, 50 * COIN + h, h % 7 == 0 ? 5000 : 0));
+        wallet->BlockConnected(blocks.back(), h);
+    }
+    ExpectBalances(tip);
+
+    // Unwind past the point where early coinbases were mature
+    for (BlockHeight h = tip; h > 80; --h) {
+        wallet->BlockDisconnected(blocks[h - 1], h);
+        ExpectBalances(h - 1);
+    }
+
+    // A competing branch with different coinbase values
+    auto staleEnd = std::remove_if(coins.begin(), coins.end(),
+                                   [](const Coin& coin) { return coin.height > 80; });
+    coins.erase(staleEnd, coins.end());
+    for (BlockHeight h = 81; h <= tip + 5; ++h) {
+        wallet->BlockConnected(MakeBlock(h, 40 * COIN + h), h);
+        ExpectBalances(h);
+    }
+}
+
+TEST_F(WalletBalanceTest, SpendingAMatureCoinbaseLeavesTheConfirmedBucket) {
+    Block first = MakeBlock(1, 50 * COIN);
+    wallet->BlockConnected(first, 1);
+    wallet->SetChainHeight(COINBASE_MATURITY + 1);
+    ASSERT_EQ(wallet->GetAvailableBalance(), 50 * COIN);
+
+    Transaction spend;
+    spend.inputs.push_back(TxIn(OutPoint(first.transactions[0]->GetHash(), 0)));
+    spend.outputs.push_back(TxOut(10 * COIN, script));
+    spend.outputs.push_back(TxOut(39 * COIN, bytes(25, 0xEE)));
+
+    // Unconfirmed first, then mined
+    ASSERT_TRUE(wallet->ProcessTransaction(spend, 0));
+    EXPECT_EQ(wallet->GetAvailableBalance(), 0);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), 10 * COIN);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 0);
+
+    Block block;
+    Transaction coinbase;
+    coinbase.inputs.push_back(TxIn(OutPoint(), bytes{0x03}));
+    coinbase.outputs.push_back(TxOut(50 * COIN, bytes(25, 0xEE)));
+    block.transactions.push_back(MakeTransactionRef(coinbase));
+    block.transactions.push_back(MakeTransactionRef(spend));
+    wallet->BlockConnected(block, COINBASE_MATURITY + 2);
+
+    EXPECT_EQ(wallet->GetAvailableBalance(), 10 * COIN);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), 0);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 0);
+
+    // Lowering the tip does not resurrect the spent coinbase
+    wallet->SetChainHeight(5);
+    EXPECT_EQ(wallet->GetImmatureBalance(), 0);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 10 * COIN);
+}
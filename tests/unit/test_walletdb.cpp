@@ -0,0 +1,184 @@
+/**
+ * @file test_walletdb.cpp
+ * @brief Unit tests for wallet database records and batches
+ */
+
+#include "wallet/walletdb.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace dinari;
+
+namespace {
+
+class WalletDBTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dataDir = testing::TempDir() + "dinari_test_walletdb_" +
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(dataDir);
+        ASSERT_TRUE(db.Open(dataDir));
+    }
+
+    void TearDown() override {
+        db.Close();
+        std::filesystem::remove_all(dataDir);
+    }
+
+    // Reopen the database and read everything back
+    WalletDB::Contents Reload() {
+        db.Close();
+        EXPECT_TRUE(db.Open(dataDir));
+        WalletDB::Contents contents;
+        EXPECT_TRUE(db.LoadWallet(contents));
+        return contents;
+    }
+
+    static OutPoint MakeOutPoint(byte seed, TxOutIndex index) {
+        Hash256 txHash{};
+        txHash[0] = seed;
+        return OutPoint(txHash, index);
+    }
+
+    static Transaction MakeTx(byte seed) {
+        Transaction tx;
+        tx.inputs.push_back(TxIn(MakeOutPoint(seed, 0)));
+        tx.outputs.push_back(TxOut(1000 + seed, bytes(25, seed)));
+        return tx;
+    }
+
+    std::string dataDir;
+    WalletDB db;
+};
+
+} // namespace
+
+TEST_F(WalletDBTest, RoundTripsKeys) {
+    Hash160 plainID{};
+    plainID[0] = 1;
+    Hash256 privKey{};
+    privKey[31] = 7;
+    KeyMetadata metadata;
+    metadata.label = "plain";
+    metadata.hdPath = "m/0'/0/1";
+    metadata.creationTime = 1700000000;
+    ASSERT_TRUE(db.WriteKey(plainID, Key(privKey, bytes(33, 0x02), metadata)));
+
+    Hash160 cryptedID{};
+    cryptedID[0] = 2;
+    KeyMetadata cryptedMetadata;
+    cryptedMetadata.isChange = true;
+    ASSERT_TRUE(db.WriteCryptedKey(cryptedID, bytes(33, 0x03), bytes(48, 0xAB), cryptedMetadata));
+
+    CryptoKeyStore::MasterKey masterKey;
+    masterKey.encryptedKey = bytes(64, 0xCD);
+    masterKey.salt = bytes(8, 0x11);
+    masterKey.iterations = 25000;
+    ASSERT_TRUE(db.WriteMasterKey(masterKey));
+
+    WalletDB::Contents contents = Reload();
+    ASSERT_EQ(contents.keys.size(), 2u);
+    for (const auto& record : contents.keys) {
+        if (record.keyID == plainID) {
+            EXPECT_FALSE(record.encrypted);
+            EXPECT_EQ(record.privKey, privKey);
+            EXPECT_EQ(record.pubKey, bytes(33, 0x02));
+            EXPECT_EQ(record.metadata.label, "plain");
+            EXPECT_EQ(record.metadata.hdPath, "m/0'/0/1");
+            EXPECT_EQ(record.metadata.creationTime, 1700000000);
+        } else {
+            EXPECT_EQ(record.keyID, cryptedID);
+            EXPECT_TRUE(record.encrypted);
+            EXPECT_EQ(record.encryptedKey, bytes(48, 0xAB));
+            EXPECT_TRUE(record.metadata.isChange);
+        }
+    }
+
+    ASSERT_TRUE(contents.masterKey.has_value());
+    EXPECT_EQ(contents.masterKey->encryptedKey, masterKey.encryptedKey);
+    EXPECT_EQ(contents.masterKey->salt, masterKey.salt);
+    EXPECT_EQ(contents.masterKey->iterations, masterKey.iterations);
+}
+
+TEST_F(WalletDBTest, RoundTripsOutputsAndTransactions) {
+    OutPoint unspent = MakeOutPoint(1, 0);
+    OutPoint spent = MakeOutPoint(2, 3);
+    ASSERT_TRUE(db.WriteUTXO(unspent, TxOut(5000, bytes(25, 0x01)), 10));
+    ASSERT_TRUE(db.WriteSpentOutput(spent, TxOut(7000, bytes(25, 0x02)), 11, 0));
+
+    // Written out of order; loaded back sorted by sequence
+    Transaction later = MakeTx(3);
+    Transaction earlier = MakeTx(4);
+    ASSERT_TRUE(db.WriteTx(later, 12, 2));
+    ASSERT_TRUE(db.WriteTx(earlier, 0, 1));
+
+    WalletDB::Contents contents = Reload();
+    ASSERT_EQ(contents.utxos.size(), 1u);
+    EXPECT_EQ(contents.utxos[0].outpoint, unspent);
+    EXPECT_EQ(contents.utxos[0].txout.value, 5000);
+    EXPECT_EQ(contents.utxos[0].height, 10u);
+
+    // An unconfirmed spend keeps spentHeight 0
+    ASSERT_EQ(contents.spentOutputs.size(), 1u);
+    EXPECT_EQ(contents.spentOutputs[0].outpoint, spent);
+    EXPECT_EQ(contents.spentOutputs[0].txout.value, 7000);
+    EXPECT_EQ(contents.spentOutputs[0].height, 11u);
+    EXPECT_EQ(contents.spentOutputs[0].spentHeight, 0u);
+
+    ASSERT_EQ(contents.transactions.size(), 2u);
+    EXPECT_EQ(contents.transactions[0].tx.GetHash(), earlier.GetHash());
+    EXPECT_EQ(contents.transactions[0].height, 0u);
+    EXPECT_EQ(contents.transactions[1].tx.GetHash(), later.GetHash());
+    EXPECT_EQ(contents.transactions[1].height, 12u);
+    EXPECT_EQ(contents.transactions[1].sequence, 2u);
+
+    ASSERT_TRUE(db.EraseUTXO(unspent));
+    ASSERT_TRUE(db.EraseSpentOutput(spent));
+    ASSERT_TRUE(db.EraseTx(later.GetHash()));
+
+    contents = Reload();
+    EXPECT_TRUE(contents.utxos.empty());
+    EXPECT_TRUE(contents.spentOutputs.empty());
+    ASSERT_EQ(contents.transactions.size(), 1u);
+    EXPECT_EQ(contents.transactions[0].tx.GetHash(), earlier.GetHash());
+}
+
+TEST_F(WalletDBTest, BatchCommitWritesEverything) {
+    db.TxnBegin();
+    ASSERT_TRUE(db.WriteUTXO(MakeOutPoint(1, 0), TxOut(100, bytes(25, 0x01)), 5));
+
+    // A nested commit leaves the batch pending until the outermost one
+    db.TxnBegin();
+    ASSERT_TRUE(db.WriteTx(MakeTx(2), 5, 1));
+    ASSERT_TRUE(db.TxnCommit());
+
+    ASSERT_TRUE(db.WriteSpentOutput(MakeOutPoint(3, 1), TxOut(200, bytes(25, 0x03)), 4, 5));
+    ASSERT_TRUE(db.TxnCommit());
+
+    WalletDB::Contents contents = Reload();
+    EXPECT_EQ(contents.utxos.size(), 1u);
+    EXPECT_EQ(contents.transactions.size(), 1u);
+    EXPECT_EQ(contents.spentOutputs.size(), 1u);
+
+    // Commit without a matching begin is refused
+    EXPECT_FALSE(db.TxnCommit());
+}
+
+TEST_F(WalletDBTest, BatchAbortDiscardsEverything) {
+    ASSERT_TRUE(db.WriteUTXO(MakeOutPoint(1, 0), TxOut(100, bytes(25, 0x01)), 5));
+
+    db.TxnBegin();
+    ASSERT_TRUE(db.EraseUTXO(MakeOutPoint(1, 0)));
+    ASSERT_TRUE(db.WriteUTXO(MakeOutPoint(2, 0), TxOut(300, bytes(25, 0x02)), 6));
+    ASSERT_TRUE(db.WriteTx(MakeTx(3), 6, 1));
+    db.TxnAbort();
+
+    WalletDB::Contents contents = Reload();
+    ASSERT_EQ(contents.utxos.size(), 1u);
+    EXPECT_EQ(contents.utxos[0].outpoint, MakeOutPoint(1, 0));
+    EXPECT_TRUE(contents.transactions.empty());
+
+    // Writes after an abort go straight to disk again
+    ASSERT_TRUE(db.WriteTx(MakeTx(4), 7, 2));
+    EXPECT_EQ(Reload().transactions.size(), 1u);
+}
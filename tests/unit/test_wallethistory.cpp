@@ -0,0 +1,189 @@
+/**
+ * @file test_wallethistory.cpp
+ * @brief Unit tests for the wallet transaction history index and paging
+ */
+
+#include "wallet/wallet.h"
+#include "blockchain/block.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+using namespace dinari;
+
+namespace {
+
+class WalletHistoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.dataDir = testing::TempDir() + "dinari_test_wallethistory_" +
+                         testing::UnitTest::GetInstance()->current_test_info()->name();
+        config.useHDWallet = false;
+        std::filesystem::remove_all(config.dataDir);
+        std::filesystem::create_directories(config.dataDir);
+
+        wallet = std::make_unique<Wallet>(config);
+        ASSERT_TRUE(wallet->Initialize());
+
+        Hash256 privKey{};
+        privKey[31] = 0x60;
+        ASSERT_TRUE(wallet->ImportPrivateKey(privKey));
+        script = AddressGenerator::GenerateScriptPubKey(
+            AddressGenerator::GenerateP2PKH(crypto::ECDSA::GetPublicKey(privKey, true)));
+
+        // Two payments in each of ten blocks, then two unconfirmed ones
+        for (BlockHeight h = 1; h <= 10; ++h) {
+            Block block;
+            block.transactions.push_back(MakeTransactionRef(Payment()));
+            block.transactions.push_back(MakeTransactionRef(Payment()));
+            wallet->BlockConnected(block, h);
+            blocks.push_back(block);
+            for (const auto& tx : block.transactions) {
+                inserted.push_back(tx->GetHash());
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            Transaction tx = Payment();
+            ASSERT_TRUE(wallet->ProcessTransaction(tx, 0));
+            unconfirmed.push_back(tx);
+            inserted.push_back(tx.GetHash());
+        }
+    }
+
+    void TearDown() override {
+        wallet.reset();
+        std::filesystem::remove_all(config.dataDir);
+    }
+
+    Transaction Payment() {
+        Hash256 prevHash{};
+        prevHash[0] = static_cast<byte>(++payments);
+        prevHash[1] = 0xF0;
+        Transaction tx;
+        tx.inputs.push_back(TxIn(OutPoint(prevHash, 0)));
+        tx.outputs.push_back(TxOut(1000 * payments, script));
+        return tx;
+    }
+
+    // History is recorded in chain order, so newest first is the reverse
+    std::vector<Hash256> NewestFirst() const {
+        return std::vector<Hash256>(inserted.rbegin(), inserted.rend());
+    }
+
+    static std::vector<Hash256> Hashes(const std::vector<Wallet::WalletTx>& page) {
+        std::vector<Hash256> hashes;
+        for (const auto& wtx : page) {
+            hashes.push_back(wtx.tx.GetHash());
+        }
+        return hashes;
+    }
+
+    static std::vector<Hash256> Slice(const std::vector<Hash256>& all, size_t from, size_t count) {
+        from = std::min(from, all.size());
+        size_t to = std::min(all.size(), from + count);
+        return std::vector<Hash256>(all.begin() + from, all.begin() + to);
+    }
+
+    WalletConfig config;
+    std::unique_ptr<Wallet> wallet;
+    bytes script;
+    int payments = 0;
+    std::vector<Block> blocks;
+    std::vector<Transaction> unconfirmed;
+    std::vector<Hash256> inserted;
+};
+
+} // namespace
+
+TEST_F(WalletHistoryTest, NewestFirstWithUnconfirmedOnTop) {
+    std::vector<Wallet::WalletTx> all = wallet->ListTransactions(100);
+    EXPECT_EQ(Hashes(all), NewestFirst());
+    ASSERT_EQ(all.size(), 22u);
+
+    EXPECT_EQ(all[0].height, 0u);
+    EXPECT_EQ(all[1].height, 0u);
+    EXPECT_EQ(all[2].height, 10u);
+    EXPECT_EQ(all.back().height, 1u);
+}
+
+TEST_F(WalletHistoryTest, CountAndSkip) {
+    std::vector<Hash256> all = NewestFirst();
+
+    EXPECT_EQ(Hashes(wallet->ListTransactions(5)), Slice(all, 0, 5));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(5, 3)), Slice(all, 3, 5));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(5, 20)), Slice(all, 20, 5));
+    EXPECT_TRUE(wallet->ListTransactions(5, 22).empty());
+    EXPECT_TRUE(wallet->ListTransactions(0).empty());
+}
+
+TEST_F(WalletHistoryTest, SinceHeightStopsAtOlderBlocks) {
+    std::vector<Hash256> all = NewestFirst();
+
+    // Unconfirmed, then blocks 10 down to 7
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100, 0, 7)), Slice(all, 0, 2 + 4 * 2));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(3, 1, 7)), Slice(all, 1, 3));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100, 0, 11)), Slice(all, 0, 2));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100, 0, 1)), all);
+}
+
+TEST_F(WalletHistoryTest, AfterCursorPagesThroughEverything) {
+    std::vector<Hash256> all = NewestFirst();
+
+    std::vector<Hash256> paged;
+    std::vector<Wallet::WalletTx> page = wallet->ListTransactions(4);
+    while (!page.empty()) {
+        std::vector<Hash256> hashes = Hashes(page);
+        paged.insert(paged.end(), hashes.begin(), hashes.end());
+        Hash256 cursor = hashes.back();
+        page = wallet->ListTransactions(4, 0, 0, &cursor);
+    }
+    EXPECT_EQ(paged, all);
+
+    // Cursor combined with skip and sinceHeight
+    EXPECT_EQ(Hashes(wallet->ListTransactions(3, 2, 0, &all[5])), Slice(all, 8, 3));
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100, 0, 9, &all[2])), Slice(all, 3, 3));
+
+    Hash256 unknown{};
+    unknown[0] = 0x77;
+    EXPECT_TRUE(wallet->ListTransactions(4, 0, 0, &unknown).empty());
+}
+
+TEST_F(WalletHistoryTest, OrderFollowsConfirmationsAndReorgs) {
+    // The newer unconfirmed transaction confirms in block 11 and drops
+    // below the one still waiting
+    Block block;
+    block.transactions.push_back(MakeTransactionRef(unconfirmed[1]));
+    wallet->BlockConnected(block, 11);
+
+    std::vector<Hash256> expected = NewestFirst();
+    std::swap(expected[0], expected[1]);
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100)), expected);
+
+    Wallet::WalletTx wtx;
+    ASSERT_TRUE(wallet->GetWalletTransaction(unconfirmed[1].GetHash(), wtx));
+    EXPECT_EQ(wtx.height, 11u);
+
+    // Block 10 is disconnected; its transactions leave the history
+    wallet->BlockDisconnected(blocks[9], 10);
+    expected.erase(expected.begin() + 2, expected.begin() + 4);
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100)), expected);
+    EXPECT_EQ(wallet->GetTransactionCount(), expected.size());
+}
+
+TEST_F(WalletHistoryTest, OrderSurvivesReload) {
+    std::vector<Hash256> all = NewestFirst();
+
+    wallet.reset();
+    wallet = std::make_unique<Wallet>(config);
+    ASSERT_TRUE(wallet->Initialize());
+
+    EXPECT_EQ(Hashes(wallet->ListTransactions(100)), all);
+
+    // New transactions still sort after the reloaded ones
+    Transaction tx = Payment();
+    ASSERT_TRUE(wallet->ProcessTransaction(tx, 0));
+    std::vector<Wallet::WalletTx> page = wallet->ListTransactions(1);
+    ASSERT_EQ(page.size(), 1u);
+    EXPECT_EQ(page[0].tx.GetHash(), tx.GetHash());
+}
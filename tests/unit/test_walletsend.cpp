@@ -0,0 +1,297 @@
+/**
+ * @file test_walletsend.cpp
+ * @brief Unit tests for wallet sends, batched payouts, consolidation and abandon
+ */
+
+#include "wallet/wallet.h"
+#include "blockchain/block.h"
+#include "core/script.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+
+using namespace dinari;
+
+namespace {
+
+class WalletSendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.dataDir = testing::TempDir() + "dinari_test_walletsend_" +
+                         testing::UnitTest::GetInstance()->current_test_info()->name();
+        config.keyPoolSize = 10;
+        std::filesystem::remove_all(config.dataDir);
+        std::filesystem::create_directories(config.dataDir);
+
+        wallet = std::make_unique<Wallet>(config);
+        ASSERT_TRUE(wallet->Initialize());
+        ASSERT_TRUE(wallet->ImportSeed(bytes(32, 0x42)));
+        address = wallet->GetNewAddress();
+        ASSERT_TRUE(address.IsValid());
+
+        wallet->SetBroadcastCallback([this](const Transaction& tx) {
+            broadcasts.push_back(tx);
+        });
+    }
+
+    void TearDown() override {
+        wallet.reset();
+        std::filesystem::remove_all(config.dataDir);
+    }
+
+    void Reopen() {
+        wallet.reset();
+        wallet = std::make_unique<Wallet>(config);
+        ASSERT_TRUE(wallet->Initialize());
+    }
+
+    static Address Foreign(byte seed) {
+        Hash160 hash{};
+        hash.fill(seed);
+        return Address(hash, AddressType::P2PKH);
+    }
+
+    // Connect a block holding the given transactions after a coinbase
+    // paying the given script
+    void ConnectBlock(std::vector<Transaction> txs, const bytes& coinbaseScript = bytes(25, 0xEE),
+                      Amount coinbaseValue = 50 * COIN) {
+        Transaction coinbase;
+        coinbase.inputs.push_back(TxIn(OutPoint(), bytes{0x01, static_cast<byte>(height + 1)}));
+        coinbase.outputs.push_back(TxOut(coinbaseValue, coinbaseScript));
+
+        Block block;
+        block.transactions.push_back(MakeTransactionRef(coinbase));
+        for (auto& tx : txs) {
+            block.transactions.push_back(MakeTransactionRef(std::move(tx)));
+        }
+        wallet->BlockConnected(block, ++height);
+    }
+
+    // Confirm payments from outside the wallet to our address
+    std::vector<OutPoint> Fund(const std::vector<Amount>& values) {
+        Transaction tx;
+        Hash256 prevHash{};
+        prevHash[0] = static_cast<byte>(height);
+        prevHash[1] = 0xF0;
+        tx.inputs.push_back(TxIn(OutPoint(prevHash, 0)));
+        for (Amount value : values) {
+            tx.outputs.push_back(TxOut(value, AddressGenerator::GenerateScriptPubKey(address)));
+        }
+
+        std::vector<OutPoint> outpoints;
+        for (size_t i = 0; i < values.size(); ++i) {
+            outpoints.push_back(OutPoint(tx.GetHash(), static_cast<TxOutIndex>(i)));
+        }
+        ConnectBlock({tx});
+        return outpoints;
+    }
+
+    // Every input is a wallet output whose script the signature satisfies
+    static void ExpectSigned(const Transaction& tx, const std::map<OutPoint, TxOut>& prevOuts) {
+        for (size_t i = 0; i < tx.inputs.size(); ++i) {
+            auto it = prevOuts.find(tx.inputs[i].prevOut);
+            ASSERT_NE(it, prevOuts.end());
+            EXPECT_TRUE(VerifyScript(tx.inputs[i].scriptSig, it->second.scriptPubKey, tx, i));
+        }
+    }
+
+    std::map<OutPoint, TxOut> UTXOMap() const {
+        std::map<OutPoint, TxOut> utxos;
+        for (const auto& pair : wallet->GetUTXOs()) {
+            utxos.insert(pair);
+        }
+        return utxos;
+    }
+
+    static Amount PaidTo(const Transaction& tx, const Address& addr) {
+        bytes script = AddressGenerator::GenerateScriptPubKey(addr);
+        Amount total = 0;
+        for (const auto& output : tx.outputs) {
+            if (output.scriptPubKey == script) {
+                total += output.value;
+            }
+        }
+        return total;
+    }
+
+    WalletConfig config;
+    std::unique_ptr<Wallet> wallet;
+    Address address;
+    BlockHeight height = 0;
+    std::vector<Transaction> broadcasts;
+};
+
+} // namespace
+
+TEST_F(WalletSendTest, SendSpendsInputsAndCreditsChangeUnconfirmed) {
+    Fund({COIN, COIN});
+    ASSERT_EQ(wallet->GetAvailableBalance(), 2 * COIN);
+    std::map<OutPoint, TxOut> before = UTXOMap();
+
+    Transaction tx;
+    ASSERT_TRUE(wallet->SendTransaction({{Foreign(1), COIN / 2}}, 10, tx));
+    ExpectSigned(tx, before);
+    EXPECT_EQ(PaidTo(tx, Foreign(1)), COIN / 2);
+
+    // Spent inputs leave the confirmed balance; change waits unconfirmed
+    Amount spent = 0;
+    for (const auto& input : tx.inputs) {
+        spent += before.at(input.prevOut).value;
+    }
+    Amount change = tx.GetOutputValue() - COIN / 2;
+    EXPECT_GT(change, 0);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 2 * COIN - spent);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), change);
+
+    Wallet::WalletTx wtx;
+    ASSERT_TRUE(wallet->GetWalletTransaction(tx.GetHash(), wtx));
+    EXPECT_EQ(wtx.height, 0u);
+
+    // Once mined, the change is confirmed and the transaction has a height
+    ConnectBlock({tx});
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), 0);
+    EXPECT_EQ(wallet->GetAvailableBalance(), 2 * COIN - spent + change);
+    ASSERT_TRUE(wallet->GetWalletTransaction(tx.GetHash(), wtx));
+    EXPECT_EQ(wtx.height, height);
+
+    // Sending more than the wallet holds fails without touching it
+    Transaction tooBig;
+    EXPECT_FALSE(wallet->SendTransaction({{Foreign(1), 3 * COIN}}, 10, tooBig));
+    EXPECT_EQ(wallet->GetTransactionCount(), 2u);
+}
+
+TEST_F(WalletSendTest, UnconfirmedSpendOutlivesDeepBlocks) {
+    OutPoint funded = Fund({COIN})[0];
+
+    Transaction tx;
+    ASSERT_TRUE(wallet->SendTransaction({{Foreign(2), COIN / 4}}, 10, tx));
+    ASSERT_EQ(tx.inputs.size(), 1u);
+    EXPECT_EQ(tx.inputs[0].prevOut, funded);
+
+    // Unrelated blocks well past the reorg keep depth must not forget the
+    // spent input, or abandoning could never give it back
+    for (int i = 0; i < 110; ++i) {
+        ConnectBlock({});
+    }
+
+    // Nor may a restart
+    Reopen();
+    EXPECT_EQ(wallet->GetAvailableBalance(), 0);
+
+    ASSERT_TRUE(wallet->AbandonTransaction(tx.GetHash()));
+    EXPECT_EQ(wallet->GetAvailableBalance(), COIN);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), 0);
+    EXPECT_EQ(UTXOMap().count(funded), 1u);
+}
+
+TEST_F(WalletSendTest, AbandonRestoresInputsInDependencyOrder) {
+    Fund({COIN});
+
+    // The second send can only spend the first one's change
+    Transaction first;
+    ASSERT_TRUE(wallet->SendTransaction({{Foreign(3), COIN / 4}}, 10, first));
+    Transaction second;
+    ASSERT_TRUE(wallet->SendTransaction({{Foreign(3), COIN / 4}}, 10, second));
+    ASSERT_EQ(second.inputs.size(), 1u);
+    EXPECT_EQ(second.inputs[0].prevOut.txHash, first.GetHash());
+    EXPECT_EQ(wallet->GetTransactionCount(), 3u);
+
+    EXPECT_FALSE(wallet->AbandonTransaction(first.GetHash()));
+    Hash256 unknown{};
+    unknown[0] = 0x99;
+    EXPECT_FALSE(wallet->AbandonTransaction(unknown));
+
+    ASSERT_TRUE(wallet->AbandonTransaction(second.GetHash()));
+    EXPECT_EQ(wallet->GetTransactionCount(), 2u);
+    ASSERT_TRUE(wallet->AbandonTransaction(first.GetHash()));
+    EXPECT_EQ(wallet->GetTransactionCount(), 1u);
+
+    EXPECT_EQ(wallet->GetAvailableBalance(), COIN);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), 0);
+    EXPECT_EQ(wallet->GetUTXOs().size(), 1u);
+}
+
+TEST_F(WalletSendTest, ConfirmedTransactionCannotBeAbandoned) {
+    Fund({COIN});
+
+    Transaction tx;
+    ASSERT_TRUE(wallet->SendTransaction({{Foreign(4), COIN / 4}}, 10, tx));
+    ConnectBlock({tx});
+
+    EXPECT_FALSE(wallet->AbandonTransaction(tx.GetHash()));
+    Wallet::WalletTx wtx;
+    EXPECT_TRUE(wallet->GetWalletTransaction(tx.GetHash(), wtx));
+}
+
+TEST_F(WalletSendTest, FlushPaymentsBatchesAndRequeuesOnFailure) {
+    wallet->SetFeeRateCallback([]() { return Amount(5); });
+
+    EXPECT_FALSE(wallet->QueuePayment(Foreign(5), 0));
+    EXPECT_FALSE(wallet->QueuePayment(Address(), 1000));
+    ASSERT_TRUE(wallet->QueuePayment(Foreign(5), 10000));
+    ASSERT_TRUE(wallet->QueuePayment(Foreign(6), 20000));
+    ASSERT_TRUE(wallet->QueuePayment(Foreign(5), 5000));
+    EXPECT_EQ(wallet->GetQueuedPaymentCount(), 2u);
+
+    // Nothing to spend yet: the payments stay queued and nothing is relayed
+    Transaction tx;
+    EXPECT_FALSE(wallet->FlushPayments(tx));
+    EXPECT_EQ(wallet->GetQueuedPaymentCount(), 2u);
+    EXPECT_TRUE(broadcasts.empty());
+
+    // Queued after the failure; merged with the requeued payment
+    ASSERT_TRUE(wallet->QueuePayment(Foreign(6), 1000));
+
+    Fund({COIN});
+    std::map<OutPoint, TxOut> before = UTXOMap();
+    ASSERT_TRUE(wallet->FlushPayments(tx));
+    EXPECT_EQ(wallet->GetQueuedPaymentCount(), 0u);
+
+    EXPECT_EQ(PaidTo(tx, Foreign(5)), 15000);
+    EXPECT_EQ(PaidTo(tx, Foreign(6)), 21000);
+    ExpectSigned(tx, before);
+
+    ASSERT_EQ(broadcasts.size(), 1u);
+    EXPECT_EQ(broadcasts[0].GetHash(), tx.GetHash());
+
+    // An empty queue has nothing to flush
+    Transaction empty;
+    EXPECT_FALSE(wallet->FlushPayments(empty));
+    EXPECT_EQ(broadcasts.size(), 1u);
+}
+
+TEST_F(WalletSendTest, ConsolidateMergesSpendableCoins) {
+    const Amount feeRate = 1;
+
+    // One coin has to be merged with something
+    Fund({20000});
+    Transaction tx;
+    EXPECT_FALSE(wallet->ConsolidateCoins(feeRate, tx));
+
+    // Dust costs more to spend than it holds; the coinbase is immature
+    Fund({30000, 40000, 50000, 100});
+    ConnectBlock({}, AddressGenerator::GenerateScriptPubKey(address), 50 * COIN);
+    std::map<OutPoint, TxOut> before = UTXOMap();
+    ASSERT_EQ(before.size(), 6u);
+    ASSERT_GT(wallet->GetImmatureBalance(), 0);
+
+    ASSERT_TRUE(wallet->ConsolidateCoins(feeRate, tx));
+    ASSERT_EQ(tx.inputs.size(), 4u);
+    ASSERT_EQ(tx.outputs.size(), 1u);
+    for (const auto& input : tx.inputs) {
+        Amount value = before.at(input.prevOut).value;
+        EXPECT_GE(value, 20000);
+        EXPECT_NE(value, 50 * COIN);
+    }
+    ExpectSigned(tx, before);
+
+    Amount fee = 140000 - tx.outputs[0].value;
+    EXPECT_EQ(fee, static_cast<Amount>(CoinSelector::EstimateTransactionSize(4, 1)) * feeRate);
+
+    // The merged output comes back to the wallet, unconfirmed
+    EXPECT_EQ(wallet->GetUTXOs().size(), 3u);
+    EXPECT_EQ(wallet->GetUnconfirmedBalance(), tx.outputs[0].value);
+
+    ASSERT_EQ(broadcasts.size(), 1u);
+    EXPECT_EQ(broadcasts[0].GetHash(), tx.GetHash());
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_walletsync.cpp
+ * @brief Unit tests for wallet block connect/disconnect handling and rescans
+ */
+
+#include "chaingen.h"
+#include "blockchain/blockchain.h"
+#include "wallet/wallet.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+
+using namespace dinari;
+using namespace dinari::bench;
+
+namespace {
+
+class WalletSyncTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        ChainGenParams params;
+        params.blocks = 30;
+        params.txsPerBlock = 20;
+        chain = new GeneratedChain(ChainGenerator::Generate(params));
+    }
+
+    static void TearDownTestSuite() {
+        delete chain;
+        chain = nullptr;
+    }
+
+    void SetUp() override {
+        baseDir = testing::TempDir() + "dinari_test_walletsync_" +
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(baseDir);
+    }
+
+    void TearDown() override {
+        wallets.clear();
+        std::filesystem::remove_all(baseDir);
+    }
+
+    Wallet& NewWallet() {
+        WalletConfig config;
+        config.dataDir = baseDir + "/wallet" + std::to_string(wallets.size());
+        config.useHDWallet = false;
+        std::filesystem::create_directories(config.dataDir);
+
+        wallets.push_back(std::make_unique<Wallet>(config));
+        EXPECT_TRUE(wallets.back()->Initialize());
+        return *wallets.back();
+    }
+
+    // Private key of one of the chain generator's coinbase and change keys
+    static Hash256 GeneratorKey(size_t index) {
+        return crypto::Hash::SHA256("dinari chaingen key 1/" + std::to_string(index));
+    }
+
+    static std::map<OutPoint, TxOut> UTXOMap(const Wallet& wallet) {
+        std::map<OutPoint, TxOut> utxos;
+        for (const auto& pair : wallet.GetUTXOs()) {
+            utxos.insert(pair);
+        }
+        return utxos;
+    }
+
+    static void ExpectSameState(const Wallet& a, const Wallet& b) {
+        EXPECT_EQ(UTXOMap(a), UTXOMap(b));
+        EXPECT_EQ(a.GetTransactionCount(), b.GetTransactionCount());
+        EXPECT_EQ(a.GetAvailableBalance(), b.GetAvailableBalance());
+        EXPECT_EQ(a.GetImmatureBalance(), b.GetImmatureBalance());
+        EXPECT_EQ(a.GetUnconfirmedBalance(), b.GetUnconfirmedBalance());
+    }
+
+    static GeneratedChain* chain;
+    std::string baseDir;
+    std::vector<std::unique_ptr<Wallet>> wallets;
+};
+
+GeneratedChain* WalletSyncTest::chain = nullptr;
+
+} // namespace
+
+TEST_F(WalletSyncTest, DisconnectUndoesConnect) {
+    Wallet& wallet = NewWallet();
+    Hash256 privKey = GeneratorKey(0);
+    ASSERT_TRUE(wallet.ImportPrivateKey(privKey));
+    Address address = AddressGenerator::GenerateP2PKH(crypto::ECDSA::GetPublicKey(privKey, true));
+    bytes script = AddressGenerator::GenerateScriptPubKey(address);
+
+    Hash256 prevHash{};
+    prevHash[0] = 0xF0;
+    Transaction receive;
+    receive.inputs.push_back(TxIn(OutPoint(prevHash, 0)));
+    receive.outputs.push_back(TxOut(COIN, script));
+    receive.outputs.push_back(TxOut(2 * COIN, bytes(25, 0xEE)));
+
+    Transaction spend;
+    spend.inputs.push_back(TxIn(OutPoint(receive.GetHash(), 0)));
+    spend.outputs.push_back(TxOut(COIN / 4, script));
+    spend.outputs.push_back(TxOut(COIN / 2, bytes(25, 0xEE)));
+
+    Block first;
+    first.transactions.push_back(MakeTransactionRef(receive));
+    Block second;
+    second.transactions.push_back(MakeTransactionRef(spend));
+
+    wallet.BlockConnected(first, 1);
+    EXPECT_EQ(wallet.GetAvailableBalance(), COIN);
+    std::map<OutPoint, TxOut> afterFirst = UTXOMap(wallet);
+
+    wallet.BlockConnected(second, 2);
+    EXPECT_EQ(wallet.GetAvailableBalance(), COIN / 4);
+    EXPECT_EQ(wallet.GetTransactionCount(), 2u);
+    EXPECT_EQ(UTXOMap(wallet).count(OutPoint(receive.GetHash(), 0)), 0u);
+
+    // Disconnecting the spend gives the spent output back
+    wallet.BlockDisconnected(second, 2);
+    EXPECT_EQ(UTXOMap(wallet), afterFirst);
+    EXPECT_EQ(wallet.GetAvailableBalance(), COIN);
+    EXPECT_EQ(wallet.GetTransactionCount(), 1u);
+    Wallet::WalletTx wtx;
+    EXPECT_FALSE(wallet.GetWalletTransaction(spend.GetHash(), wtx));
+
+    wallet.BlockDisconnected(first, 1);
+    EXPECT_TRUE(wallet.GetUTXOs().empty());
+    EXPECT_EQ(wallet.GetBalance(), 0);
+    EXPECT_EQ(wallet.GetTransactionCount(), 0u);
+
+    // Reconnecting lands in the same place
+    wallet.BlockConnected(first, 1);
+    wallet.BlockConnected(second, 2);
+    EXPECT_EQ(wallet.GetAvailableBalance(), COIN / 4);
+    EXPECT_EQ(wallet.GetTransactionCount(), 2u);
+}
+
+TEST_F(WalletSyncTest, ParallelRescanMatchesBlockReplay) {
+    Blockchain blockchain;
+    ASSERT_TRUE(blockchain.Initialize(chain->genesis, baseDir + "/chain"));
+    for (const auto& block : chain->blocks) {
+        ASSERT_TRUE(blockchain.AcceptBlock(block));
+    }
+
+    // Two of the generator's keys, so the wallet sees coinbases, payments
+    // and spends of its own outputs
+    std::vector<Hash256> keys = {GeneratorKey(0), GeneratorKey(5)};
+
+    Wallet& replayed = NewWallet();
+    for (const auto& key : keys) {
+        ASSERT_TRUE(replayed.ImportPrivateKey(key));
+    }
+    for (BlockHeight h = 0; h <= blockchain.GetHeight(); ++h) {
+        SharedPtr<Block> block = blockchain.GetBlockAtHeight(h);
+        ASSERT_TRUE(block);
+        replayed.BlockConnected(*block, h);
+    }
+    ASSERT_GT(replayed.GetTransactionCount(), 0u);
+    ASSERT_GT(replayed.GetUTXOs().size(), 0u);
+
+    for (size_t threads : {1u, 4u, 7u}) {
+        SCOPED_TRACE("threads " + std::to_string(threads));
+
+        Wallet& rescanned = NewWallet();
+        for (const auto& key : keys) {
+            ASSERT_TRUE(rescanned.ImportPrivateKey(key));
+        }
+
+        std::optional<size_t> found = rescanned.RescanBlockchain(blockchain, 0, threads);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(*found, replayed.GetTransactionCount());
+        ExpectSameState(rescanned, replayed);
+
+        // A second pass finds nothing new and changes nothing
+        found = rescanned.RescanBlockchain(blockchain, 0, threads);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(*found, 0u);
+        ExpectSameState(rescanned, replayed);
+    }
+
+    // Nothing to scan above the tip
+    Wallet& empty = NewWallet();
+    ASSERT_TRUE(empty.ImportPrivateKey(keys[0]));
+    std::optional<size_t> found = empty.RescanBlockchain(blockchain, blockchain.GetHeight() + 1);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, 0u);
+}